@@ -0,0 +1,153 @@
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+// Synthetic inputs shared by the benchmarks
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Build a synthetic header with many classes, methods and members
+inline std::string generateHeader(int classCount, int methodsPerClass, int membersPerClass) {
+    std::ostringstream out;
+    out << "#ifndef GENERATED_H\n#define GENERATED_H\n\n";
+    out << "#include <string>\n#include <vector>\n#include \"Base.h\"\n\n";
+    out << "namespace Generated {\n\n";
+    for (int c = 0; c < classCount; ++c) {
+        out << "    // Generated class " << c << "\n";
+        out << "    enum class State" << c << " { Idle, Running, Done };\n\n";
+        out << "    class Widget" << c << " : public Base, protected Observer {\n";
+        out << "    public:\n";
+        out << "        Widget" << c << "();\n";
+        out << "        virtual ~Widget" << c << "();\n";
+        for (int m = 0; m < methodsPerClass; ++m) {
+            switch (m % 4) {
+                case 0: out << "        virtual void update" << m << "(const std::string& name, int count) = 0;\n"; break;
+                case 1: out << "        static inline int compute" << m << "(double x, double* out);\n"; break;
+                case 2: out << "        std::vector<int> values" << m << "() const;\n"; break;
+                default: out << "        bool check" << m << "(const Widget" << c << "& other) const;\n"; break;
+            }
+        }
+        out << "    private:\n";
+        for (int v = 0; v < membersPerClass; ++v) {
+            switch (v % 3) {
+                case 0: out << "        static int s_counter" << v << ";\n"; break;
+                case 1: out << "        mutable std::string m_name" << v << ";\n"; break;
+                default: out << "        const double m_ratio" << v << ";\n"; break;
+            }
+        }
+        out << "    };\n\n";
+    }
+    out << "} // namespace Generated\n\n#endif // GENERATED_H\n";
+    return out.str();
+}
+
+// Build a header of namespaces nested depth deep, each with a template class holding a nested class
+inline std::string generateNestedHeader(int namespaceCount, int depth, int membersPerClass) {
+    std::ostringstream out;
+    for (int n = 0; n < namespaceCount; ++n) {
+        for (int d = 0; d < depth; ++d) {
+            out << "namespace ns" << n << "_" << d << " {\n";
+        }
+        out << "template <typename T, int N = " << n << ">\n";
+        out << "class Outer" << n << " : public Base {\n";
+        out << "public:\n";
+        out << "    struct Node {\n";
+        for (int v = 0; v < membersPerClass; ++v) {
+            out << "        T value" << v << ";\n";
+        }
+        out << "    };\n";
+        out << "    void insert(const T& value);\n";
+        out << "private:\n";
+        out << "    Node* m_root;\n";
+        out << "};\n";
+        for (int d = 0; d < depth; ++d) {
+            out << "}\n";
+        }
+    }
+    return out.str();
+}
+
+// Build a PlantUML class diagram with an inheritance chain and associations between neighbours
+inline std::string generateClassDiagram(int classCount, int attributesPerClass, int methodsPerClass) {
+    std::ostringstream out;
+    out << "@startuml\ntitle Generated Class Diagram\n\n";
+    for (int c = 0; c < classCount; ++c) {
+        if (c % 10 == 0) {
+            out << "abstract class Shape" << c << " {\n";
+        } else if (c % 10 == 5) {
+            out << "interface Shape" << c << " {\n";
+        } else {
+            out << "class Shape" << c << " {\n";
+        }
+        for (int a = 0; a < attributesPerClass; ++a) {
+            static const char* const visibility[] = {"-", "#", "+", "~"};
+            out << "    " << visibility[a % 4] << " field" << a << " : " << (a % 2 ? "double" : "String") << "\n";
+        }
+        out << "    + {static} count" << c << "() : int\n";
+        for (int m = 0; m < methodsPerClass; ++m) {
+            out << "    + operation" << m << "(x : double, name : String) : " << (m % 3 ? "void" : "bool") << "\n";
+        }
+        out << "}\n\n";
+    }
+    for (int c = 1; c < classCount; ++c) {
+        out << "Shape" << (c - 1) << " <|-- Shape" << c << "\n";
+        if (c % 3 == 0) {
+            out << "Shape" << c << " *-- \"0..*\" Shape" << (c - 2) << " : contains\n";
+        }
+    }
+    out << "\n@enduml\n";
+    return out.str();
+}
+
+// Build a PlantUML entity diagram where every entity references the previous one
+inline std::string generateEntityDiagram(int entityCount, int fieldsPerEntity) {
+    std::ostringstream out;
+    out << "@startuml\ntitle Generated Schema\n\n";
+    for (int e = 0; e < entityCount; ++e) {
+        out << "entity Table" << e << " {\n";
+        out << "    * table" << e << "_id : int <PK>\n";
+        out << "    --\n";
+        if (e > 0) {
+            out << "    + table" << (e - 1) << "_id : int <FK>\n";
+        }
+        for (int f = 0; f < fieldsPerEntity; ++f) {
+            switch (f % 4) {
+                case 0: out << "    name" << f << " : varchar(100)\n"; break;
+                case 1: out << "    amount" << f << " : decimal(10,2)\n"; break;
+                case 2: out << "    code" << f << " : varchar(20) <UK>\n"; break;
+                default: out << "    created" << f << " : datetime\n"; break;
+            }
+        }
+        out << "}\n\n";
+    }
+    for (int e = 1; e < entityCount; ++e) {
+        out << "Table" << (e - 1) << " ||--o{ Table" << e << " : owns\n";
+    }
+    out << "\n@enduml\n";
+    return out.str();
+}
+
+// Write a directory tree 'depth' levels deep with 'fanout' subdirectories per level.
+// Every directory gets headersPerDirectory headers of classesPerHeader classes and
+// as many .cpp files. Returns the number of headers written.
+inline int generateSourceTree(const std::filesystem::path& directory, int depth, int fanout,
+                              int headersPerDirectory, int classesPerHeader) {
+    std::filesystem::create_directories(directory);
+    int headers = 0;
+    for (int i = 0; i < headersPerDirectory; ++i) {
+        std::ofstream(directory / ("header" + std::to_string(i) + ".h")) << generateHeader(classesPerHeader, 8, 4);
+        std::ofstream(directory / ("source" + std::to_string(i) + ".cpp")) << "// source\n";
+        headers++;
+    }
+    if (depth > 0) {
+        for (int d = 0; d < fanout; ++d) {
+            headers += generateSourceTree(directory / ("dir" + std::to_string(d)), depth - 1, fanout,
+                                          headersPerDirectory, classesPerHeader);
+        }
+    }
+    return headers;
+}
+
+#endif // BENCH_CORPUS_H
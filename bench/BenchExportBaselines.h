@@ -0,0 +1,134 @@
+#ifndef BENCH_EXPORT_BASELINES_H
+#define BENCH_EXPORT_BASELINES_H
+
+// Reference implementations the diagram exports are measured against: the
+// std::stringstream style the parsers used before the shared writers (no escaping,
+// so a lower bound on its cost), and building an nlohmann::json document to dump().
+// Both write the same fields as PUMLClassParser::exportToJson() (relationship
+// types as numbers).
+
+#include "../include/PUMLClassParser.h"
+#include "../include/third_party/json.hpp"
+#include <sstream>
+#include <string>
+
+inline const char* baselineVisibility(UFMTooling::UMLVisibility visibility) {
+    switch (visibility) {
+        case UFMTooling::UMLVisibility::Public: return "public";
+        case UFMTooling::UMLVisibility::Private: return "private";
+        case UFMTooling::UMLVisibility::Protected: return "protected";
+        default: return "package";
+    }
+}
+
+inline std::string stringstreamClassExport(const UFMTooling::PUMLClassDiagramResult& diagram) {
+    std::stringstream json;
+    json << "{\n  \"classes\": [";
+    for (size_t i = 0; i < diagram.classes.size(); ++i) {
+        const auto& cls = diagram.classes[i];
+        json << (i ? ",\n" : "\n") << "    {\n      \"attributes\": [";
+        for (size_t a = 0; a < cls.attributes.size(); ++a) {
+            const auto& attribute = cls.attributes[a];
+            json << (a ? ",\n" : "\n") << "        {\n";
+            json << "          \"defaultValue\": \"" << attribute.defaultValue << "\",\n";
+            json << "          \"isStatic\": " << (attribute.isStatic ? "true" : "false") << ",\n";
+            json << "          \"name\": \"" << attribute.name << "\",\n";
+            json << "          \"stereotype\": \"" << attribute.stereotype << "\",\n";
+            json << "          \"type\": \"" << attribute.type << "\",\n";
+            json << "          \"visibility\": \"" << baselineVisibility(attribute.visibility) << "\"\n        }";
+        }
+        json << (cls.attributes.empty() ? "],\n" : "\n      ],\n");
+        json << "      \"isAbstract\": " << (cls.isAbstract ? "true" : "false") << ",\n";
+        json << "      \"isInterface\": " << (cls.isInterface ? "true" : "false") << ",\n";
+        json << "      \"methods\": [";
+        for (size_t m = 0; m < cls.methods.size(); ++m) {
+            const auto& method = cls.methods[m];
+            json << (m ? ",\n" : "\n") << "        {\n";
+            json << "          \"isAbstract\": " << (method.isAbstract ? "true" : "false") << ",\n";
+            json << "          \"isStatic\": " << (method.isStatic ? "true" : "false") << ",\n";
+            json << "          \"name\": \"" << method.name << "\",\n          \"parameters\": [";
+            for (size_t p = 0; p < method.parameters.size(); ++p) {
+                const auto& param = method.parameters[p];
+                json << (p ? ",\n" : "\n") << "            {\n";
+                json << "              \"defaultValue\": \"" << param.defaultValue << "\",\n";
+                json << "              \"direction\": \"" << param.direction << "\",\n";
+                json << "              \"name\": \"" << param.name << "\",\n";
+                json << "              \"type\": \"" << param.type << "\"\n            }";
+            }
+            json << (method.parameters.empty() ? "],\n" : "\n          ],\n");
+            json << "          \"returnType\": \"" << method.returnType << "\",\n";
+            json << "          \"stereotype\": \"" << method.stereotype << "\",\n";
+            json << "          \"visibility\": \"" << baselineVisibility(method.visibility) << "\"\n        }";
+        }
+        json << (cls.methods.empty() ? "],\n" : "\n      ],\n");
+        json << "      \"name\": \"" << cls.name << "\",\n";
+        json << "      \"note\": \"" << cls.note << "\",\n";
+        json << "      \"package\": \"" << cls.package << "\",\n";
+        json << "      \"stereotype\": \"" << cls.stereotype << "\"\n    }";
+    }
+    json << (diagram.classes.empty() ? "],\n" : "\n  ],\n");
+    json << "  \"notes\": {";
+    size_t n = 0;
+    for (const auto& note : diagram.notes) {
+        json << (n++ ? ",\n" : "\n") << "    \"" << note.first << "\": \"" << note.second << "\"";
+    }
+    json << (diagram.notes.empty() ? "},\n" : "\n  },\n");
+    json << "  \"relationships\": [";
+    for (size_t r = 0; r < diagram.relationships.size(); ++r) {
+        const auto& rel = diagram.relationships[r];
+        json << (r ? ",\n" : "\n") << "    {\n";
+        json << "      \"fromCardinality\": \"" << rel.fromCardinality << "\",\n";
+        json << "      \"fromClass\": \"" << rel.fromClass << "\",\n";
+        json << "      \"label\": \"" << rel.label << "\",\n";
+        json << "      \"toCardinality\": \"" << rel.toCardinality << "\",\n";
+        json << "      \"toClass\": \"" << rel.toClass << "\",\n";
+        json << "      \"type\": " << static_cast<int>(rel.type) << "\n    }";
+    }
+    json << (diagram.relationships.empty() ? "],\n" : "\n  ],\n");
+    json << "  \"title\": \"" << diagram.title << "\"\n}";
+    return json.str();
+}
+
+inline std::string nlohmannClassExport(const UFMTooling::PUMLClassDiagramResult& diagram) {
+    nlohmann::json doc;
+    nlohmann::json& classes = doc["classes"] = nlohmann::json::array();
+    for (const auto& cls : diagram.classes) {
+        nlohmann::json entry;
+        nlohmann::json& attributes = entry["attributes"] = nlohmann::json::array();
+        for (const auto& attribute : cls.attributes) {
+            attributes.push_back({ { "defaultValue", attribute.defaultValue }, { "isStatic", attribute.isStatic },
+                                   { "name", attribute.name }, { "stereotype", attribute.stereotype },
+                                   { "type", attribute.type }, { "visibility", baselineVisibility(attribute.visibility) } });
+        }
+        nlohmann::json& methods = entry["methods"] = nlohmann::json::array();
+        for (const auto& method : cls.methods) {
+            nlohmann::json parameters = nlohmann::json::array();
+            for (const auto& param : method.parameters) {
+                parameters.push_back({ { "defaultValue", param.defaultValue }, { "direction", param.direction },
+                                       { "name", param.name }, { "type", param.type } });
+            }
+            methods.push_back({ { "isAbstract", method.isAbstract }, { "isStatic", method.isStatic },
+                                { "name", method.name }, { "parameters", std::move(parameters) },
+                                { "returnType", method.returnType }, { "stereotype", method.stereotype },
+                                { "visibility", baselineVisibility(method.visibility) } });
+        }
+        entry["isAbstract"] = cls.isAbstract;
+        entry["isInterface"] = cls.isInterface;
+        entry["name"] = cls.name;
+        entry["note"] = cls.note;
+        entry["package"] = cls.package;
+        entry["stereotype"] = cls.stereotype;
+        classes.push_back(std::move(entry));
+    }
+    doc["notes"] = diagram.notes;
+    nlohmann::json& relationships = doc["relationships"] = nlohmann::json::array();
+    for (const auto& rel : diagram.relationships) {
+        relationships.push_back({ { "fromCardinality", rel.fromCardinality }, { "fromClass", rel.fromClass },
+                                  { "label", rel.label }, { "toCardinality", rel.toCardinality },
+                                  { "toClass", rel.toClass }, { "type", static_cast<int>(rel.type) } });
+    }
+    doc["title"] = diagram.title;
+    return doc.dump(2);
+}
+
+#endif // BENCH_EXPORT_BASELINES_H
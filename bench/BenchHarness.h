@@ -0,0 +1,227 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+// Timing, percentile and peak memory bookkeeping shared by the benchmarks
+
+#include "../include/JsonWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+// Peak resident set size of the process in bytes (0 if unknown)
+inline size_t peakRssBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    // VmHWM follows resetPeakRss(); ru_maxrss is the peak over the whole process
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(std::strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+        }
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Restart peak RSS tracking from the current RSS. Only Linux supports this; elsewhere
+// peaks are process-wide and a case reports the highest peak seen up to its end.
+inline bool resetPeakRss() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return static_cast<bool>(clearRefs);
+#else
+    return false;
+#endif
+}
+
+// Measurements of one benchmark case
+struct BenchCase {
+    std::string name;
+    size_t bytesPerRun;         // Input bytes processed by one run (0 = not applicable)
+    size_t itemsPerRun;         // Items (classes, files...) processed by one run
+    std::string itemName;
+    std::vector<double> samplesMs;
+    size_t peakRss;
+    bool bPeakPerCase;          // peakRss covers only this case
+
+    BenchCase() : bytesPerRun(0), itemsPerRun(0), peakRss(0), bPeakPerCase(false) {}
+
+    double totalMs() const {
+        double total = 0;
+        for (double sample : samplesMs) total += sample;
+        return total;
+    }
+
+    double meanMs() const { return samplesMs.empty() ? 0 : totalMs() / samplesMs.size(); }
+
+    // Nearest-rank percentile, p in [0, 100]
+    double percentileMs(double p) const {
+        if (samplesMs.empty()) return 0;
+        std::vector<double> sorted = samplesMs;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+        return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+    }
+
+    double megabytesPerSecond() const {
+        double seconds = totalMs() / 1000.0;
+        return seconds > 0 ? bytesPerRun * samplesMs.size() / (1024.0 * 1024.0) / seconds : 0;
+    }
+
+    double itemsPerSecond() const {
+        double seconds = totalMs() / 1000.0;
+        return seconds > 0 ? itemsPerRun * samplesMs.size() / seconds : 0;
+    }
+};
+
+// Runs cases, prints a table and optionally writes the results as JSON.
+// Command line: [--json file] [--filter text] [--iterations n]
+class BenchSuite {
+public:
+    BenchSuite(const std::string& suiteName, int argc, char** argv) : name(suiteName), iterations(0) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string option = argv[i];
+            if (option == "--json") jsonPath = argv[i + 1];
+            else if (option == "--filter") filter = argv[i + 1];
+            else if (option == "--iterations") iterations = std::atoi(argv[i + 1]);
+        }
+        if (jsonPath.empty()) {
+            if (const char* env = std::getenv("UFM_BENCH_JSON")) jsonPath = env;
+        }
+    }
+
+    // Whether a case should run (and its corpus be built at all)
+    bool enabled(const std::string& caseName) const {
+        return filter.empty() || caseName.find(filter) != std::string::npos;
+    }
+
+    // Run fn once to warm up, then 'runs' times (or --iterations), timing each run
+    template <typename Fn>
+    void run(const std::string& caseName, int runs, size_t bytesPerRun, size_t itemsPerRun,
+             const std::string& itemName, Fn fn) {
+        if (!enabled(caseName)) return;
+
+        BenchCase result;
+        result.name = caseName;
+        result.bytesPerRun = bytesPerRun;
+        result.itemsPerRun = itemsPerRun;
+        result.itemName = itemName;
+        result.bPeakPerCase = resetPeakRss();
+
+        fn();
+        int count = iterations > 0 ? iterations : runs;
+        for (int i = 0; i < count; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            result.samplesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        result.peakRss = peakRssBytes();
+
+        print(result);
+        cases.push_back(std::move(result));
+    }
+
+    // Write the JSON report if one was requested; returns false on write errors
+    bool finish() const {
+        if (jsonPath.empty()) return true;
+
+        std::ofstream out(jsonPath, std::ios::binary);
+        {
+            UFMTooling::JsonWriter writer(out);
+            writer.beginObject();
+            writer.key("cases");
+            writer.beginArray();
+            for (const auto& c : cases) {
+                writer.beginObject();
+                writer.member("bytesPerRun", c.bytesPerRun);
+                writer.member("itemName", c.itemName);
+                writer.member("itemsPerRun", c.itemsPerRun);
+                writer.member("itemsPerSecond", c.itemsPerSecond());
+                writer.member("iterations", c.samplesMs.size());
+                writer.member("maxMs", c.percentileMs(100));
+                writer.member("mbPerSecond", c.megabytesPerSecond());
+                writer.member("meanMs", c.meanMs());
+                writer.member("minMs", c.percentileMs(0));
+                writer.member("name", c.name);
+                writer.member("p50Ms", c.percentileMs(50));
+                writer.member("p90Ms", c.percentileMs(90));
+                writer.member("p99Ms", c.percentileMs(99));
+                writer.member("peakRssBytes", c.peakRss);
+                writer.member("peakRssPerCase", c.bPeakPerCase);
+                writer.endObject();
+            }
+            writer.endArray();
+            writer.member("suite", name);
+            writer.endObject();
+        }
+        if (!out) {
+            std::cerr << "Could not write benchmark results: " << jsonPath << std::endl;
+            return false;
+        }
+        std::cout << "Results written to " << jsonPath << std::endl;
+        return true;
+    }
+
+private:
+    std::string name;
+    std::string jsonPath;
+    std::string filter;
+    int iterations;
+    std::vector<BenchCase> cases;
+
+    static void print(const BenchCase& c) {
+        std::cout << c.name << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "  runs:        " << c.samplesMs.size() << std::endl;
+        std::cout << "  latency ms:  p50 " << c.percentileMs(50) << "  p90 " << c.percentileMs(90)
+                  << "  p99 " << c.percentileMs(99) << "  max " << c.percentileMs(100) << std::endl;
+        if (c.bytesPerRun > 0) {
+            std::cout << "  throughput:  " << c.megabytesPerSecond() << " MB/s" << std::endl;
+        }
+        if (c.itemsPerRun > 0) {
+            std::cout << "  " << c.itemName << "/s:" << std::string(c.itemName.size() < 9 ? 9 - c.itemName.size() : 1, ' ')
+                      << std::setprecision(0) << c.itemsPerSecond() << std::endl;
+        }
+        std::cout << std::setprecision(1) << "  peak RSS:    " << c.peakRss / (1024.0 * 1024.0) << " MB"
+                  << (c.bPeakPerCase ? "" : " (process)") << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+};
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,135 @@
+#include "../include/SimpleHeaderParser.h"
+#include "../include/ArenaParseResult.h"
+#include "../include/FileSystemExplorer.h"
+#include "../include/SourceExplorer.h"
+#include "BenchCorpus.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace UFMTooling;
+namespace fs = std::filesystem;
+
+// Count every heap allocation made by the process
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Allocations made while running fn
+template <typename Fn>
+size_t countAllocations(Fn fn) {
+    size_t before = allocationCount.load();
+    fn();
+    return allocationCount.load() - before;
+}
+
+void report(const char* label, size_t copied, size_t shared,
+            const char* copiedName = "copied", const char* sharedName = "shared") {
+    std::cout << "  " << label << std::endl;
+    std::cout << "    " << copiedName << ": " << copied << " allocations" << std::endl;
+    std::cout << "    " << sharedName << ": " << shared << " allocations";
+    if (copied > 0) {
+        std::cout << " (" << (100.0 * static_cast<double>(copied - std::min(copied, shared)) / static_cast<double>(copied))
+                  << "% fewer)";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int fileCount = argc > 1 ? std::stoi(argv[1]) : 200;
+
+    std::cout << "Allocation counts" << std::endl;
+
+    // One large header: by-value result versus the shared result
+    {
+        std::string content = generateHeader(200, 20, 12);
+        SimpleHeaderParser parser;
+        parser.parseContent(content, "generated.h");
+
+        size_t copied = countAllocations([&]() { ParseResult r = parser.parseContent(content, "generated.h"); });
+        size_t shared = countAllocations([&]() { auto r = parser.parseContentShared(content, "generated.h"); });
+        report("SimpleHeaderParser: parseContent vs parseContentShared (200 classes)", copied, shared);
+
+        // Arena result: one buffer per file instead of a std::string/vector per node
+        size_t arena = countAllocations([&]() { auto r = parser.parseContentArena(content, "generated.h"); });
+        report("SimpleHeaderParser: parseContentShared vs parseContentArena (200 classes)", shared, arena,
+               "shared", "arena");
+
+        // Time to free each result (the parser's own reference is dropped first)
+        auto heapResult = parser.parseContentShared(content, "generated.h");
+        auto arenaResult = parser.parseContentArena(content, "generated.h");
+        parser.parseContentShared("", "empty.h");
+        auto start = std::chrono::steady_clock::now();
+        heapResult.reset();
+        auto middle = std::chrono::steady_clock::now();
+        arenaResult.reset();
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "    teardown: " << std::chrono::duration<double, std::micro>(middle - start).count()
+                  << " us shared vs " << std::chrono::duration<double, std::micro>(end - middle).count()
+                  << " us arena" << std::endl;
+    }
+
+    // A tree of small headers for the explorers
+    fs::path root = fs::temp_directory_path() / "ufm_bench_allocations";
+    fs::remove_all(root);
+    for (int i = 0; i < fileCount; ++i) {
+        fs::path dir = root / ("module" + std::to_string(i % 10));
+        fs::create_directories(dir);
+        std::ofstream(dir / ("header" + std::to_string(i) + ".h")) << generateHeader(5, 10, 6);
+        std::ofstream(dir / ("source" + std::to_string(i) + ".cpp")) << "// source\n";
+    }
+
+    {
+        FileSystemExplorer explorer;
+        explorer.explore(root.string());
+
+        size_t copied = countAllocations([&]() { auto r = explorer.getFilesByExtension(".h"); });
+        size_t shared = countAllocations([&]() { auto r = explorer.viewFilesByExtension(".h"); });
+        report("FileSystemExplorer: getFilesByExtension vs viewFilesByExtension", copied, shared);
+
+        copied = countAllocations([&]() { FileSystemExplorerResult r = explorer.explore(root.string()); });
+        shared = countAllocations([&]() { const FileSystemExplorerResult& r = explorer.explore(root.string()); (void)r; });
+        report("FileSystemExplorer: explore() into a copy vs by reference", copied, shared);
+    }
+
+    {
+        // Warm cache: every header is a hit. Cached results used to be copied into
+        // each analysis; now the analysis shares the cache's result.
+        AnalysisCache cache;
+        SourceExplorerOptions options;
+        options.cache = &cache;
+        options.threadCount = 1;
+        SourceExplorer explorer;
+        explorer.explore(root.string(), options);
+
+        size_t resultCopies = countAllocations([&]() {
+            for (const auto& analysis : explorer.getLastResult().analyses) {
+                ParseResult copy = *analysis.parseResult;
+            }
+        });
+        size_t hit = countAllocations([&]() { explorer.explore(root.string(), options); });
+        report("SourceExplorer: warm-cache explore() with result copies vs shared", hit + resultCopies, hit);
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
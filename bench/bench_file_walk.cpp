@@ -0,0 +1,75 @@
+#include "../include/FileSystemExplorer.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace UFMTooling;
+namespace fs = std::filesystem;
+
+// Milliseconds per run of fn, averaged over iterations
+template <typename Fn>
+double timeRuns(int iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    int moduleCount = argc > 1 ? std::stoi(argv[1]) : 20;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    // A source tree next to much larger dependency and build directories
+    fs::path root = fs::temp_directory_path() / "ufm_bench_file_walk";
+    fs::remove_all(root);
+    for (int m = 0; m < moduleCount; ++m) {
+        fs::path src = root / "src" / ("module" + std::to_string(m));
+        fs::create_directories(src);
+        for (int i = 0; i < 10; ++i) {
+            std::ofstream(src / ("header" + std::to_string(i) + ".h")) << "// header\n";
+            std::ofstream(src / ("source" + std::to_string(i) + ".cpp")) << "// source\n";
+        }
+        for (const char* ignored : {"node_modules", "build"}) {
+            fs::path dir = root / ignored / ("package" + std::to_string(m));
+            fs::create_directories(dir);
+            for (int i = 0; i < 100; ++i) {
+                std::ofstream(dir / ("file" + std::to_string(i) + (i % 2 ? ".h" : ".js"))) << "x\n";
+            }
+        }
+    }
+
+    FileSystemExplorer explorer;
+    size_t headers = 0;
+
+    double full = timeRuns(iterations, [&]() {
+        explorer.explore(root.string());
+        headers = explorer.viewFilesByExtension(".h").size();
+    });
+    size_t fullEntries = explorer.getLastResult().entries.size();
+
+    FileSystemExplorerOptions options;
+    options.extensions = {".h"};
+    options.excludePatterns = {"build"};
+    options.bPruneIgnoredDirectories = true;
+    options.bIncludeDirectories = false;
+    options.bFileSizes = false;
+
+    double filtered = timeRuns(iterations, [&]() { explorer.explore(root.string(), options); });
+    size_t filteredEntries = explorer.getLastResult().entries.size();
+
+    options.threadCount = 0;
+    double parallel = timeRuns(iterations, [&]() { explorer.explore(root.string(), options); });
+
+    std::cout << "FileSystemExplorer::explore" << std::endl;
+    std::cout << "  full walk + filter:    " << full << " ms (" << fullEntries << " entries, "
+              << headers << " headers)" << std::endl;
+    std::cout << "  walk-time filter:      " << filtered << " ms (" << filteredEntries << " entries)" << std::endl;
+    std::cout << "  walk-time, all cores:  " << parallel << " ms" << std::endl;
+
+    fs::remove_all(root);
+    return 0;
+}
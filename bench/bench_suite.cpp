@@ -0,0 +1,502 @@
+#include "../include/SimpleHeaderParser.h"
+#include "../include/PUMLClassParser.h"
+#include "../include/PUMLEntityParser.h"
+#include "../include/FileSystemExplorer.h"
+#include "../include/SourceExplorer.h"
+#include "../include/SymbolIndex.h"
+#include "../include/IncludeGraph.h"
+#include "../include/EntityGraph.h"
+#include "../include/ResultDiff.h"
+#include "../include/StringInterner.h"
+#include "../include/ResultSnapshot.h"
+#include "../include/SourceServer.h"
+#include "BenchCorpus.h"
+#include "BenchExportBaselines.h"
+#include "BenchHarness.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using namespace UFMTooling;
+namespace fs = std::filesystem;
+
+// Throughput, latency percentiles and peak memory of the parsers and explorers.
+// See BenchSuite for the command line (--json writes machine-readable results).
+int main(int argc, char** argv) {
+    BenchSuite suite("ufm-tooling", argc, argv);
+
+    if (suite.enabled("SimpleHeaderParser::parseContent")) {
+        std::string content = generateHeader(500, 20, 12);
+        SimpleHeaderParser parser;
+        size_t classes = parser.parseContent(content, "generated.h").classes.size();
+        suite.run("SimpleHeaderParser::parseContent", 10, content.size(), classes, "classes", [&]() {
+            parser.parseContent(content, "generated.h");
+        });
+    }
+
+    if (suite.enabled("SimpleHeaderParser::parseContent (no methods)") ||
+        suite.enabled("SimpleHeaderParser::parseContent (types)") ||
+        suite.enabled("SimpleHeaderParser::parseContent (includes only)")) {
+        // The same header at the lighter ParseDetail levels
+        std::string content = generateHeader(500, 20, 12);
+        const std::pair<ParseDetail, const char*> levels[] = {
+            {ParseDetail::NoMethods, "SimpleHeaderParser::parseContent (no methods)"},
+            {ParseDetail::Types, "SimpleHeaderParser::parseContent (types)"},
+            {ParseDetail::IncludesOnly, "SimpleHeaderParser::parseContent (includes only)"}
+        };
+        for (const auto& level : levels) {
+            if (!suite.enabled(level.second)) continue;
+            SimpleHeaderParser parser;
+            parser.setParseDetail(level.first);
+            suite.run(level.second, 10, content.size(), 500, "classes", [&]() {
+                parser.parseContent(content, "generated.h");
+            });
+        }
+    }
+
+    if (suite.enabled("StringInterner::intern")) {
+        // Every type string of the 500-class header, interned by a fresh interner per run
+        SimpleHeaderParser parser;
+        ParseResult result = parser.parseContent(generateHeader(500, 20, 12), "generated.h");
+        std::vector<std::string> types;
+        for (const auto& cls : result.classes) {
+            for (const auto& member : cls.members) types.push_back(member.type);
+            for (const auto& method : cls.methods) {
+                types.push_back(method.returnType);
+                for (const auto& param : method.parameters) types.push_back(param.type);
+            }
+        }
+        suite.run("StringInterner::intern", 20, 0, types.size(), "strings", [&]() {
+            StringInterner interner;
+            for (const auto& type : types) {
+                interner.intern(type);
+            }
+        });
+    }
+
+    if (suite.enabled("SimpleHeaderParser::parseContent (parallel)")) {
+        // One 9 MB generated header split across the hardware threads
+        std::string content = generateHeader(5000, 20, 12);
+        SimpleHeaderParser parser;
+        ParallelParseOptions parallel;
+        parallel.threadCount = 0;
+        parser.setParallelOptions(parallel);
+        size_t classes = parser.parseContent(content, "generated.h").classes.size();
+        suite.run("SimpleHeaderParser::parseContent (parallel)", 5, content.size(), classes, "classes", [&]() {
+            parser.parseContent(content, "generated.h");
+        });
+    }
+
+    if (suite.enabled("SimpleHeaderParser::parseContent (nested scopes)")) {
+        std::string content = generateNestedHeader(1000, 8, 6);
+        SimpleHeaderParser parser;
+        size_t classes = parser.parseContent(content, "nested.h").classes.size();
+        suite.run("SimpleHeaderParser::parseContent (nested scopes)", 10, content.size(), classes, "classes", [&]() {
+            parser.parseContent(content, "nested.h");
+        });
+    }
+
+    if (suite.enabled("PUMLClassParser::parseContent")) {
+        std::string content = generateClassDiagram(2000, 6, 6);
+        PUMLClassParser parser;
+        size_t classes = parser.parseContent(content).classes.size();
+        suite.run("PUMLClassParser::parseContent", 10, content.size(), classes, "classes", [&]() {
+            parser.parseContent(content);
+        });
+    }
+
+    if (suite.enabled("PUMLClassParser::relationships")) {
+        // Relationship-heavy diagram: 50000 empty classes, 66666 relationship lines
+        std::string content = generateClassDiagram(50000, 0, 0);
+        PUMLClassParser parser;
+        size_t relationships = parser.parseContent(content).relationships.size();
+        suite.run("PUMLClassParser::relationships", 5, content.size(), relationships, "relationships", [&]() {
+            parser.parseContent(content);
+        });
+    }
+
+    if (suite.enabled("PUMLClassParser::findClass")) {
+        // Model validation: resolve both ends of every relationship
+        PUMLClassParser parser;
+        parser.parseContent(generateClassDiagram(5000, 2, 2));
+        const auto& relationships = parser.getRelationships();
+        size_t resolved = 0;
+        suite.run("PUMLClassParser::findClass", 20, 0, relationships.size() * 2, "lookups", [&]() {
+            for (const auto& relationship : relationships) {
+                resolved += parser.findClass(relationship.fromClass) != nullptr;
+                resolved += parser.findClass(relationship.toClass) != nullptr;
+            }
+        });
+    }
+
+    if (suite.enabled("PUMLClassParser::exportToJson") || suite.enabled("PUMLClassParser::exportToXML") ||
+        suite.enabled("baseline: stringstream export") || suite.enabled("baseline: nlohmann::json::dump")) {
+        // Full model export of one diagram: the shared writers against the former
+        // stringstream style and a DOM dump
+        PUMLClassParser parser;
+        PUMLClassDiagramResult diagram = parser.parseContent(generateClassDiagram(2000, 5, 5));
+        size_t classes = diagram.classes.size();
+        if (suite.enabled("PUMLClassParser::exportToJson")) {
+            size_t bytes = parser.exportToJson().size();
+            suite.run("PUMLClassParser::exportToJson", 10, bytes, classes, "classes", [&]() {
+                parser.exportToJson();
+            });
+        }
+        if (suite.enabled("PUMLClassParser::exportToXML")) {
+            size_t bytes = parser.exportToXML().size();
+            suite.run("PUMLClassParser::exportToXML", 10, bytes, classes, "classes", [&]() {
+                parser.exportToXML();
+            });
+        }
+        if (suite.enabled("baseline: stringstream export")) {
+            size_t bytes = stringstreamClassExport(diagram).size();
+            suite.run("baseline: stringstream export", 10, bytes, classes, "classes", [&]() {
+                stringstreamClassExport(diagram);
+            });
+        }
+        if (suite.enabled("baseline: nlohmann::json::dump")) {
+            size_t bytes = nlohmannClassExport(diagram).size();
+            suite.run("baseline: nlohmann::json::dump", 10, bytes, classes, "classes", [&]() {
+                nlohmannClassExport(diagram);
+            });
+        }
+    }
+
+    if (suite.enabled("PUMLEntityParser::parseContent")) {
+        std::string content = generateEntityDiagram(2000, 10);
+        PUMLEntityParser parser;
+        size_t entities = parser.parseContent(content).entities.size();
+        suite.run("PUMLEntityParser::parseContent", 10, content.size(), entities, "entities", [&]() {
+            parser.parseContent(content);
+        });
+    }
+
+    if (suite.enabled("PUMLEntityStreamParser::feed")) {
+        // Same diagram pushed in 64 KiB chunks; entities are counted, not kept
+        std::string content = generateEntityDiagram(2000, 10);
+        size_t entities = 0;
+        PUMLEntityCallbacks callbacks;
+        callbacks.onEntity = [&entities](Entity&) { entities++; };
+        PUMLEntityStreamParser parser(callbacks);
+        const size_t chunkSize = 64 * 1024;
+        suite.run("PUMLEntityStreamParser::feed", 10, content.size(), 2000, "entities", [&]() {
+            parser.reset();
+            for (size_t pos = 0; pos < content.size(); pos += chunkSize) {
+                parser.feed(std::string_view(content).substr(pos, chunkSize));
+            }
+            parser.finish();
+        });
+    }
+
+    if (suite.enabled("PUMLEntityParser::exportToDDL") || suite.enabled("PUMLEntityParser::exportToDDL (parallel)")) {
+        // PostgreSQL DDL for 5000 chained tables: 4999 foreign keys and their indexes
+        std::string content = generateEntityDiagram(5000, 10);
+        PUMLEntityParser parser;
+        size_t entities = parser.parseContent(content).entities.size();
+        DDLOptions options;
+        options.dialect = SQLDialect::PostgreSQL;
+        size_t bytes = parser.exportToDDL(options).size();
+        if (suite.enabled("PUMLEntityParser::exportToDDL")) {
+            suite.run("PUMLEntityParser::exportToDDL", 10, bytes, entities, "tables", [&]() {
+                parser.exportToDDL(options);
+            });
+        }
+        if (suite.enabled("PUMLEntityParser::exportToDDL (parallel)")) {
+            DDLOptions parallel = options;
+            parallel.threadCount = 0;
+            suite.run("PUMLEntityParser::exportToDDL (parallel)", 10, bytes, entities, "tables", [&]() {
+                parser.exportToDDL(parallel);
+            });
+        }
+    }
+
+    if (suite.enabled("IncludeGraph::build") || suite.enabled("IncludeGraph::dependents")) {
+        // 100k headers in 100 directories, each including up to 8 headers by relative path;
+        // resolved against the result only, the disk is not searched
+        const int nodes = 100000;
+        SourceExplorerResult result;
+        result.analyses.resize(nodes);
+        for (int i = 0; i < nodes; ++i) {
+            SourceFileAnalysis& analysis = result.analyses[i];
+            analysis.path = "/bench/dir" + std::to_string(i % 100) + "/header" + std::to_string(i) + ".h";
+            auto parsed = std::make_shared<ParseResult>();
+            for (int k = 1; k <= 8; ++k) {
+                int target = (i * 7 + k * 131) % nodes;
+                if (k == 1 || target < i) {
+                    parsed->includes.push_back("../dir" + std::to_string(target % 100) + "/header" +
+                                               std::to_string(target) + ".h");
+                }
+            }
+            analysis.parseResult = parsed;
+            analysis.success = true;
+        }
+        IncludeGraphOptions options;
+        options.bSearchFileSystem = false;
+        IncludeGraph graph;
+        graph.build(result, options);
+        suite.run("IncludeGraph::build", 5, 0, graph.edgeCount(), "edges", [&]() {
+            graph.build(result, options);
+        });
+
+        // Rebuild impact of 100 headers, each reaching most of the graph
+        size_t dependents = 0;
+        suite.run("IncludeGraph::dependents", 10, 0, 100, "queries", [&]() {
+            for (uint32_t node = 0; node < 100; ++node) {
+                dependents += graph.dependents(node).size();
+            }
+        });
+    }
+
+    if (suite.enabled("EntityGraph::build") || suite.enabled("EntityGraph::creationOrder") ||
+        suite.enabled("EntityGraph::joinPath")) {
+        // 50k tables and 200k one-to-many relationships, each table referencing up to 4
+        // lower tables, plus every 1000th table referencing a higher one (foreign key loops)
+        const int tables = 50000;
+        PUMLEntityDiagramResult diagram;
+        diagram.entities.resize(tables);
+        for (int i = 0; i < tables; ++i) {
+            diagram.entities[i].name = "table" + std::to_string(i);
+        }
+        for (int i = 0; i < tables; ++i) {
+            for (int k = 1; k <= 4; ++k) {
+                int parent = (i * 7 + k * 131) % tables;
+                if (parent >= i && !(k == 1 && i % 1000 == 0)) parent = (i * 13 + k) % (i + 1);
+                EntityRelationship relationship;
+                relationship.fromEntity = diagram.entities[parent].name;
+                relationship.toEntity = diagram.entities[i].name;
+                diagram.relationships.push_back(relationship);
+            }
+        }
+        EntityGraph graph;
+        graph.build(diagram);
+        suite.run("EntityGraph::build", 5, 0, diagram.relationships.size(), "relationships", [&]() {
+            graph.build(diagram);
+        });
+
+        size_t placed = 0;
+        suite.run("EntityGraph::creationOrder", 10, 0, graph.nodeCount(), "tables", [&]() {
+            placed += graph.creationOrder().size();
+        });
+
+        // 100 join paths between tables far apart
+        size_t joins = 0;
+        suite.run("EntityGraph::joinPath", 10, 0, 100, "queries", [&]() {
+            for (uint32_t node = 0; node < 100; ++node) {
+                joins += graph.joinPath(node * 17, tables - 1 - node * 31).relationships.size();
+            }
+        });
+    }
+
+    if (suite.enabled("ResultDiff::compare") || suite.enabled("ResultDiff::compare (fingerprints)")) {
+        // Two 40k-file scans of 100 distinct headers (4 classes each), as separate copies so
+        // every file is compared; every 100th file of the second scan has one method changed
+        const int files = 40000;
+        SimpleHeaderParser parser;
+        std::vector<std::shared_ptr<const ParseResult>> oldHeaders, newHeaders, editedHeaders;
+        for (int h = 0; h < 100; ++h) {
+            ParseResult parsed = parser.parseContent(generateHeader(4, 12, 8), "generated" + std::to_string(h) + ".h");
+            oldHeaders.push_back(std::make_shared<ParseResult>(parsed));
+            newHeaders.push_back(std::make_shared<ParseResult>(parsed));
+            parsed.classes[1].methods[3].returnType = "long";
+            editedHeaders.push_back(std::make_shared<ParseResult>(parsed));
+        }
+        SourceExplorerResult before, after;
+        before.success = after.success = true;
+        before.analyses.resize(files);
+        after.analyses.resize(files);
+        for (int i = 0; i < files; ++i) {
+            std::string path = "dir" + std::to_string(i % 200) + "/header" + std::to_string(i) + ".h";
+            bool bEdited = i % 100 == 0;
+            before.analyses[i].path = "/scan/before/" + path;
+            before.analyses[i].parseResult = oldHeaders[i % 100];
+            before.analyses[i].fingerprint.contentHash = i + 1;
+            after.analyses[i].path = "/scan/after/" + path;
+            after.analyses[i].parseResult = bEdited ? editedHeaders[i % 100] : newHeaders[i % 100];
+            after.analyses[i].fingerprint.contentHash = bEdited ? files + i : i + 1;
+            before.analyses[i].success = after.analyses[i].success = true;
+        }
+        ResultDiffOptions options;
+        options.beforeRoot = "/scan/before";
+        options.afterRoot = "/scan/after";
+        options.bSkipByFingerprint = false;
+        if (suite.enabled("ResultDiff::compare")) {
+            suite.run("ResultDiff::compare", 5, 0, files, "files", [&]() {
+                ResultDiff::compare(before, after, options);
+            });
+        }
+        options.bSkipByFingerprint = true;
+        if (suite.enabled("ResultDiff::compare (fingerprints)")) {
+            suite.run("ResultDiff::compare (fingerprints)", 10, 0, files, "files", [&]() {
+                ResultDiff::compare(before, after, options);
+            });
+        }
+    }
+
+    bool bIndexCases = suite.enabled("SymbolIndex::build") || suite.enabled("SymbolIndex::findClasses") ||
+                       suite.enabled("SymbolIndex::load");
+    bool bSnapshotCases = suite.enabled("ResultSnapshot::importJson") || suite.enabled("ResultSnapshot::load") ||
+                          suite.enabled("SourceExplorer::importFromJsonFile") ||
+                          suite.enabled("baseline: nlohmann::json::parse");
+    if (!suite.enabled("FileSystemExplorer::explore") && !suite.enabled("SourceExplorer::explore") &&
+        !suite.enabled("SourceExplorer::exportToJson") && !suite.enabled("SourceExplorer::explorePUML") &&
+        !suite.enabled("SourceServer::query") && !bIndexCases && !bSnapshotCases) {
+        return suite.finish() ? 0 : 1;
+    }
+
+    // Deep tree: 4 levels of 4 subdirectories, 3 headers and 3 sources per directory
+    fs::path root = fs::temp_directory_path() / "ufm_bench_suite";
+    fs::remove_all(root);
+    int headers = generateSourceTree(root, 4, 4, 3, 4);
+
+    if (suite.enabled("FileSystemExplorer::explore")) {
+        FileSystemExplorer explorer;
+        size_t entries = explorer.explore(root.string()).entries.size();
+        suite.run("FileSystemExplorer::explore", 20, 0, entries, "entries", [&]() {
+            explorer.explore(root.string());
+        });
+    }
+
+    if (suite.enabled("SourceExplorer::explore")) {
+        SourceExplorer explorer;
+        suite.run("SourceExplorer::explore", 5, 0, static_cast<size_t>(headers), "files", [&]() {
+            explorer.explore(root.string());
+        });
+
+        // Same exploration with every stage timed, to keep the cost of ParseStats visible
+        ParseStats stats;
+        SourceExplorerOptions options;
+        options.stats = &stats;
+        suite.run("SourceExplorer::explore (stats)", 5, 0, static_cast<size_t>(headers), "files", [&]() {
+            stats.reset();
+            explorer.explore(root.string(), options);
+        });
+
+        // Reads on I/O threads ahead of the parsers; on a local, cached tree this only shows
+        // what the pipeline itself costs, the gain is on slow file systems
+        SourceExplorerOptions pipelined;
+        pipelined.pipeline.bEnabled = true;
+        suite.run("SourceExplorer::explore (pipelined)", 5, 0, static_cast<size_t>(headers), "files", [&]() {
+            explorer.explore(root.string(), pipelined);
+        });
+
+        // Includes only, as for an IncludeGraph: no tokens, no declaration pass
+        SourceExplorerOptions includesOnly;
+        includesOnly.detail = ParseDetail::IncludesOnly;
+        suite.run("SourceExplorer::explore (includes only)", 5, 0, static_cast<size_t>(headers), "files", [&]() {
+            explorer.explore(root.string(), includesOnly);
+        });
+    }
+
+    if (suite.enabled("SourceExplorer::exportToJson")) {
+        SourceExplorer explorer;
+        explorer.explore(root.string());
+        size_t bytes = explorer.exportToJson().size();
+        suite.run("SourceExplorer::exportToJson", 10, bytes, static_cast<size_t>(headers), "files", [&]() {
+            explorer.exportToJson();
+        });
+    }
+
+    if (bIndexCases) {
+        SourceExplorer explorer;
+        const SourceExplorerResult& result = explorer.explore(root.string());
+        SymbolIndex index;
+        index.build(result);
+        suite.run("SymbolIndex::build", 10, 0, static_cast<size_t>(headers), "files", [&]() {
+            index.build(result);
+        });
+
+        // Lookups of every distinct class name; the generated headers reuse their class
+        // names, so each lookup resolves one declaration per header
+        std::vector<std::string> names;
+        for (uint32_t id = 0; id < index.classCount(); ++id) {
+            names.emplace_back(index.classAt(id).name);
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        size_t found = 0;
+        suite.run("SymbolIndex::findClasses", 20, 0, names.size(), "lookups", [&]() {
+            for (const auto& name : names) {
+                found += index.findClasses(name).size();
+            }
+        });
+
+        std::string indexPath = (root / "symbols.idx").string();
+        index.save(indexPath);
+        SymbolIndex loaded;
+        suite.run("SymbolIndex::load", 20, static_cast<size_t>(fs::file_size(indexPath)), index.classCount(), "classes", [&]() {
+            loaded.load(indexPath);
+        });
+    }
+
+    if (bSnapshotCases) {
+        // Reloading an exported result: JSON parse versus mapping the binary snapshot
+        SourceExplorer explorer;
+        explorer.explore(root.string());
+        std::string jsonPath = (root / "result.json").string();
+        std::string snapshotPath = (root / "result.snap").string();
+        explorer.exportToJsonFile(jsonPath);
+        ResultSnapshot snapshot;
+        snapshot.build(explorer.getLastResult());
+        snapshot.save(snapshotPath);
+
+        // Pull reader straight into the result, against only building nlohmann's DOM of the
+        // same file (the former import then copied the DOM into the result)
+        size_t jsonBytes = static_cast<size_t>(fs::file_size(jsonPath));
+        SourceExplorer importer;
+        suite.run("SourceExplorer::importFromJsonFile", 10, jsonBytes, static_cast<size_t>(headers), "files", [&]() {
+            importer.importFromJsonFile(jsonPath);
+        });
+        suite.run("baseline: nlohmann::json::parse", 5, jsonBytes, static_cast<size_t>(headers), "files", [&]() {
+            std::ifstream in(jsonPath, std::ios::binary);
+            nlohmann::json document = nlohmann::json::parse(in);
+        });
+
+        ResultSnapshot loaded;
+        suite.run("ResultSnapshot::importJson", 5, static_cast<size_t>(fs::file_size(jsonPath)),
+                  static_cast<size_t>(headers), "files", [&]() {
+            loaded.importJson(jsonPath);
+        });
+        suite.run("ResultSnapshot::load", 20, static_cast<size_t>(fs::file_size(snapshotPath)),
+                  static_cast<size_t>(headers), "files", [&]() {
+            loaded.load(snapshotPath);
+        });
+    }
+
+    if (suite.enabled("SourceServer::query")) {
+        // Round trips to a warm server over its socket, against exploring the tree per query
+        SourceServer server;
+        SourceServerOptions options;
+        options.endpoint = (root.parent_path() / "ufm_bench_suite.sock").string();
+        options.bPUML = false;
+        if (server.start(root.string(), options)) {
+            const size_t queries = 100;
+            std::string response;
+            suite.run("SourceServer::query", 10, 0, queries, "requests", [&]() {
+                for (size_t q = 0; q < queries; ++q) {
+                    SourceServer::query(options.endpoint, "class Widget0", response);
+                }
+            });
+            server.stop();
+        }
+    }
+
+    if (suite.enabled("SourceExplorer::explorePUML")) {
+        // Mixed directory of class and entity diagrams, parsed as one batch
+        fs::path pumlRoot = root / "diagrams";
+        fs::create_directories(pumlRoot);
+        const int diagrams = 200;
+        for (int d = 0; d < diagrams; ++d) {
+            std::ofstream out(pumlRoot / ("diagram" + std::to_string(d) + ".puml"), std::ios::binary);
+            out << (d % 2 == 0 ? generateClassDiagram(50, 4, 4) : generateEntityDiagram(30, 8));
+        }
+        SourceExplorer explorer;
+        PUMLBatchOptions options;
+        options.bMerge = true;
+        suite.run("SourceExplorer::explorePUML", 10, 0, static_cast<size_t>(diagrams), "files", [&]() {
+            explorer.explorePUML(pumlRoot.string(), options);
+        });
+    }
+
+    fs::remove_all(root);
+    return suite.finish() ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#ifndef UFM_TEST_SUPPORT_H
+#define UFM_TEST_SUPPORT_H
+
+// Small helpers shared by the examples/test_*.cpp checks (run by "make test" from the
+// repository root). Each check prints SUCCESS or FAILED; finish() returns the exit code.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace TestSupport {
+
+    inline int& failureCount() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void section(const std::string& title) {
+        std::cout << "\n" << title << std::endl;
+    }
+
+    inline bool check(bool bPassed, const std::string& what) {
+        std::cout << "   " << (bPassed ? "SUCCESS: " : "FAILED: ") << what << std::endl;
+        if (!bPassed) failureCount()++;
+        return bPassed;
+    }
+
+    // Exit code of the test program: 0 when every check passed
+    inline int finish() {
+        if (failureCount() == 0) {
+            std::cout << "\nAll checks passed" << std::endl;
+            return 0;
+        }
+        std::cout << "\n" << failureCount() << " check(s) FAILED" << std::endl;
+        return 1;
+    }
+
+    inline std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    // Set an environment variable for the rest of the program (empty value = unset)
+    inline void setEnvironment(const char* name, const std::string& value) {
+#ifdef _WIN32
+        _putenv_s(name, value.c_str());
+#else
+        if (value.empty()) {
+            unsetenv(name);
+        } else {
+            setenv(name, value.c_str(), 1);
+        }
+#endif
+    }
+
+    // Scratch directory under the system temp directory, removed on destruction
+    class TempDirectory {
+    public:
+        explicit TempDirectory(const std::string& name) {
+            auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+            root = std::filesystem::temp_directory_path() / ("ufm_" + name + "_" + std::to_string(stamp));
+            std::filesystem::create_directories(root);
+        }
+
+        ~TempDirectory() {
+            std::error_code ec;
+            std::filesystem::remove_all(root, ec);
+        }
+
+        TempDirectory(const TempDirectory&) = delete;
+        TempDirectory& operator=(const TempDirectory&) = delete;
+
+        std::string path() const { return root.string(); }
+
+        std::string path(const std::string& relative) const { return (root / relative).string(); }
+
+        // Write a file (and its parent directories) under the directory
+        std::string write(const std::string& relative, const std::string& content) const {
+            std::filesystem::path file = root / relative;
+            std::filesystem::create_directories(file.parent_path());
+            std::ofstream out(file, std::ios::binary);
+            out << content;
+            return file.string();
+        }
+
+    private:
+        std::filesystem::path root;
+    };
+
+} // namespace TestSupport
+
+#endif // UFM_TEST_SUPPORT_H
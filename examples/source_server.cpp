@@ -0,0 +1,54 @@
+#include "../include/SourceServer.h"
+#include <iostream>
+#include <string>
+
+using namespace UFMTooling;
+
+// Analysis server for a source tree, and its client:
+//   source_server serve <directory> [endpoint]      keep <directory> analyzed until "shutdown"
+//   source_server query <directory> <request...>    e.g. query src class SourceExplorer
+// The client finds the server of a directory through SourceServer::defaultEndpoint().
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: source_server serve <directory> [endpoint]\n"
+                  << "       source_server query <directory> <request...>\n";
+        return 2;
+    }
+    std::string mode = argv[1];
+    std::string directory = argv[2];
+
+    if (mode == "serve") {
+        SourceServerOptions options;
+        if (argc > 3) {
+            options.endpoint = argv[3];
+        }
+        SourceServer server;
+        if (!server.start(directory, options)) {
+            std::cerr << "Error: " << server.getErrorMessage() << std::endl;
+            return 1;
+        }
+        SourceServerStatus status = server.getStatus();
+        std::cout << "Serving " << status.files << " headers and " << status.pumlFiles << " diagrams on "
+                  << status.endpoint << " (" << status.watcher << ")" << std::endl;
+        server.wait();
+        return 0;
+    }
+
+    if (mode == "query" && argc > 3) {
+        std::string request = argv[3];
+        for (int i = 4; i < argc; ++i) {
+            request += std::string(" ") + argv[i];
+        }
+        std::string response;
+        if (!SourceServer::query(SourceServer::defaultEndpoint(directory), request, response)) {
+            std::cerr << "No server for " << directory << std::endl;
+            return 1;
+        }
+        std::cout << response << std::endl;
+        return 0;
+    }
+
+    std::cerr << "Unknown mode: " << mode << std::endl;
+    return 2;
+}
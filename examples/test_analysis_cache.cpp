@@ -0,0 +1,202 @@
+// Behavioural checks of AnalysisCache (run from the repository root by "make test")
+#include "../include/AnalysisCache.h"
+#include "../include/SourceExplorer.h"
+#include "TestSupport.h"
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    void writeTree(const TestSupport::TempDirectory& tree) {
+        tree.write("a.h", TestSupport::readFile("examples/sample_header.h"));
+        tree.write("sub/b.h", TestSupport::readFile("include/SimpleHeaderParser.h"));
+        tree.write("sub/c.h", "class Small {\n    int value;\n};\n");
+    }
+
+    const SourceFileAnalysis* findAnalysis(const SourceExplorerResult& result, const std::string& filename) {
+        for (const auto& analysis : result.analyses) {
+            if (analysis.filename == filename) return &analysis;
+        }
+        return nullptr;
+    }
+
+    void testIncrementalScan() {
+        TestSupport::section("Incremental scans");
+        TestSupport::TempDirectory tree("cache");
+        writeTree(tree);
+
+        AnalysisCache cache;
+        SourceExplorerOptions options;
+        options.cache = &cache;
+
+        SourceExplorer explorer;
+        const SourceExplorerResult& first = explorer.explore(tree.path(), options);
+        check(first.filesProcessed == 3 && first.filesFromCache == 0 && cache.size() == 3,
+              "first scan parses every file and fills the cache");
+        std::string firstJson = explorer.exportToJson();
+
+        const SourceExplorerResult& second = explorer.explore(tree.path(), options);
+        check(second.filesFromCache == 3, "second scan reuses every cached result");
+        check(explorer.exportToJson() == firstJson, "cached results export the same JSON");
+
+        tree.write("sub/c.h", "class Small {\n    int value;\n    int other;\n};\n");
+        const SourceExplorerResult& third = explorer.explore(tree.path(), options);
+        const SourceFileAnalysis* changed = findAnalysis(third, "c.h");
+        check(third.filesFromCache == 2 && changed != nullptr && !changed->fromCache &&
+              changed->parseResult->classes.size() == 1 && changed->parseResult->classes[0].members.size() == 2,
+              "a changed file is parsed again");
+
+        std::string cacheFile = tree.path("analysis.cache");
+        check(cache.save(cacheFile), "cache saves");
+        AnalysisCache loaded;
+        check(loaded.load(cacheFile) && loaded.size() == 3, "saved cache loads back");
+        SourceExplorerOptions loadedOptions;
+        loadedOptions.cache = &loaded;
+        SourceExplorer other;
+        const SourceExplorerResult& fourth = other.explore(tree.path(), loadedOptions);
+        check(fourth.filesFromCache == 3, "loaded cache serves a new explorer");
+
+        std::filesystem::remove(tree.path("sub/b.h"));
+        check(loaded.pruneMissing() == 1 && loaded.size() == 2, "pruneMissing() drops deleted files");
+    }
+
+    void testContentHash() {
+        TestSupport::section("Content hashes");
+        TestSupport::TempDirectory tree("cache_hash");
+        std::string path = tree.write("a.h", "class Hashed { int value; };\n");
+
+        AnalysisCache cache;
+        SourceExplorerOptions options;
+        options.cache = &cache;
+        options.bHashContents = true;
+        SourceExplorer explorer;
+        explorer.explore(tree.path(), options);
+
+        auto stamp = std::filesystem::last_write_time(path);
+        std::filesystem::last_write_time(path, stamp + std::chrono::seconds(10));
+        check(explorer.explore(tree.path(), options).filesFromCache == 1,
+              "a touched file with the same contents is reused when hashing");
+
+        options.bHashContents = false;
+        std::filesystem::last_write_time(path, stamp + std::chrono::seconds(20));
+        check(explorer.explore(tree.path(), options).filesFromCache == 0,
+              "a touched file is parsed again without hashing");
+
+        check(AnalysisCache::hashContent("abc") == AnalysisCache::hashContent(std::string("abc")) &&
+              AnalysisCache::hashContent("abc") != AnalysisCache::hashContent("abd"), "hashContent() is stable");
+    }
+
+    void testPreprocessorOptions() {
+        TestSupport::section("Preprocessor options");
+        TestSupport::TempDirectory tree("cache_options");
+        tree.write("a.h", "#ifdef FEATURE\n"
+                          "class Feature {\n"
+                          "    int x;\n"
+                          "};\n"
+                          "#endif\n"
+                          "class Always {\n"
+                          "    int y;\n"
+                          "};\n");
+
+        PreprocessorOptions evaluate;
+        evaluate.bSkipDisabledBlocks = true;
+        evaluate.bEvaluateDefines = true;
+        PreprocessorOptions defined = evaluate;
+        defined.defines.push_back("FEATURE");
+        PreprocessorOptions reordered = defined;
+        reordered.defines.insert(reordered.defines.begin(), "OTHER");
+        PreprocessorOptions swapped = reordered;
+        std::swap(swapped.defines[0], swapped.defines[1]);
+        PreprocessorOptions ignored;
+        ignored.defines.push_back("FEATURE");
+        check(AnalysisCache::hashOptions(PreprocessorOptions()) == 0 && AnalysisCache::hashOptions(ignored) == 0,
+              "options that keep every branch hash to 0");
+        check(AnalysisCache::hashOptions(evaluate) != AnalysisCache::hashOptions(defined) &&
+              AnalysisCache::hashOptions(reordered) == AnalysisCache::hashOptions(swapped),
+              "the hash follows the defines but not their order");
+
+        AnalysisCache cache;
+        SourceExplorerOptions options;
+        options.cache = &cache;
+        options.preprocessor = evaluate;
+        SourceExplorer explorer;
+        const SourceExplorerResult& first = explorer.explore(tree.path(), options);
+        check(first.analyses.size() == 1 && first.analyses[0].parseResult->classes.size() == 1,
+              "undefined FEATURE drops its block");
+        check(explorer.explore(tree.path(), options).filesFromCache == 1, "the same options reuse the entry");
+
+        options.preprocessor = defined;
+        const SourceExplorerResult& second = explorer.explore(tree.path(), options);
+        check(second.filesFromCache == 0 && second.analyses[0].parseResult->classes.size() == 2,
+              "other options miss the cache and parse again");
+        check(explorer.explore(tree.path(), options).filesFromCache == 1, "the new entry replaces the old one");
+
+        std::string cacheFile = tree.path("analysis.cache");
+        cache.save(cacheFile);
+        AnalysisCache loaded;
+        loaded.load(cacheFile);
+        options.cache = &loaded;
+        check(explorer.explore(tree.path(), options).filesFromCache == 1, "the options hash is saved with the entry");
+        options.preprocessor = PreprocessorOptions();
+        check(explorer.explore(tree.path(), options).filesFromCache == 0, "a loaded entry misses under other options");
+    }
+
+    void testSharedResults() {
+        TestSupport::section("Shared results");
+        TestSupport::TempDirectory tree("cache_shared");
+        writeTree(tree);
+
+        AnalysisCache cache;
+        SourceExplorerOptions options;
+        options.cache = &cache;
+        SourceExplorer explorer;
+        explorer.explore(tree.path(), options);
+        const SourceExplorerResult& result = explorer.explore(tree.path(), options);
+
+        bool bShared = result.analyses.size() == 3;
+        for (const auto& analysis : result.analyses) {
+            FileFingerprint fingerprint;
+            std::shared_ptr<const ParseResult> cached;
+            bShared = bShared && cache.find(analysis.path, fingerprint, &cached) && cached == analysis.parseResult;
+        }
+        check(bShared, "cache hits share the cached result instead of copying it");
+        check(&result == &explorer.getLastResult(), "explore() returns getLastResult()");
+    }
+
+    void testParseDetail() {
+        TestSupport::section("Parse detail levels");
+        TestSupport::TempDirectory tree("cache_detail");
+        writeTree(tree);
+
+        AnalysisCache cache;
+        SourceExplorerOptions light;
+        light.cache = &cache;
+        light.detail = ParseDetail::IncludesOnly;
+        SourceExplorer explorer;
+        const SourceExplorerResult& first = explorer.explore(tree.path(), light);
+        const SourceFileAnalysis* a = findAnalysis(first, "a.h");
+        check(first.filesProcessed == 3 && cache.size() == 0 && a != nullptr && a->parseResult->classes.empty() &&
+              !a->parseResult->includes.empty(), "lighter results are not recorded in the cache");
+
+        SourceExplorerOptions full;
+        full.cache = &cache;
+        explorer.explore(tree.path(), full);
+        std::string fullJson = explorer.exportToJson();
+        check(cache.size() == 3, "full results are recorded");
+
+        const SourceExplorerResult& reused = explorer.explore(tree.path(), light);
+        check(reused.filesFromCache == 3 && explorer.exportToJson() == fullJson, "lighter scans reuse full cached results");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "AnalysisCache checks" << std::endl;
+    testIncrementalScan();
+    testContentHash();
+    testPreprocessorOptions();
+    testSharedResults();
+    testParseDetail();
+    return TestSupport::finish();
+}
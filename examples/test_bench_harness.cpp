@@ -0,0 +1,58 @@
+// Behavioural checks of the benchmark harness (run from the repository root by "make test")
+#include "../bench/BenchHarness.h"
+#include "../include/third_party/json.hpp"
+#include "TestSupport.h"
+
+using TestSupport::check;
+
+namespace {
+
+    void testStatistics() {
+        TestSupport::section("Case statistics");
+        BenchCase c;
+        for (int i = 10; i >= 1; --i) c.samplesMs.push_back(i);
+        c.bytesPerRun = 1 << 20;
+        c.itemsPerRun = 100;
+        check(c.percentileMs(0) == 1 && c.percentileMs(100) == 10 && c.percentileMs(50) >= 5 && c.percentileMs(50) <= 6,
+              "percentiles of unsorted samples");
+        check(c.meanMs() == 5.5 && c.totalMs() == 55, "mean and total");
+        check(c.megabytesPerSecond() > 181 && c.megabytesPerSecond() < 182, "throughput in MB/s");
+        check(c.itemsPerSecond() > 18181 && c.itemsPerSecond() < 18182, "items per second");
+        check(BenchCase().percentileMs(50) == 0 && BenchCase().megabytesPerSecond() == 0, "empty case reports zeros");
+    }
+
+    void testSuite() {
+        TestSupport::section("Suite and JSON report");
+        TestSupport::TempDirectory dir("bench");
+        std::string jsonPath = dir.path("results.json");
+        std::string filter = "Parse";
+        std::string iterations = "3";
+        char* argv[] = {const_cast<char*>("bench"), const_cast<char*>("--json"), &jsonPath[0],
+                        const_cast<char*>("--filter"), &filter[0], const_cast<char*>("--iterations"), &iterations[0]};
+
+        BenchSuite suite("test", 7, argv);
+        int parseRuns = 0;
+        int skippedRuns = 0;
+        suite.run("Parse things", 10, 1000, 10, "things", [&]() { parseRuns++; });
+        suite.run("Walk things", 10, 1000, 10, "things", [&]() { skippedRuns++; });
+        check(parseRuns == 4 && skippedRuns == 0, "--filter selects cases, --iterations overrides runs (plus warm-up)");
+        check(suite.finish(), "report is written");
+
+        nlohmann::json report = nlohmann::json::parse(TestSupport::readFile(jsonPath));
+        check(report["suite"] == "test" && report["cases"].size() == 1, "report lists the cases that ran");
+        const nlohmann::json& parse = report["cases"][0];
+        check(parse["name"] == "Parse things" && parse["iterations"] == 3 && parse["bytesPerRun"] == 1000 &&
+              parse.contains("p99Ms") && parse.contains("peakRssBytes"), "case fields of the report");
+#ifdef __linux__
+        check(parse["peakRssBytes"].get<size_t>() > 0, "peak RSS is measured");
+#endif
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "Benchmark harness checks" << std::endl;
+    testStatistics();
+    testSuite();
+    return TestSupport::finish();
+}
@@ -0,0 +1,157 @@
+// Behavioural checks of EntityGraph (run from the repository root by "make test")
+#include "../include/EntityGraph.h"
+#include "TestSupport.h"
+#include <algorithm>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    using Nodes = std::vector<uint32_t>;
+
+    Entity makeEntity(const std::string& name, const std::string& alias = "") {
+        Entity entity;
+        entity.name = name;
+        entity.alias = alias;
+        return entity;
+    }
+
+    EntityRelationship relate(const std::string& from, Cardinality fromCardinality, const std::string& to,
+                              Cardinality toCardinality) {
+        EntityRelationship rel;
+        rel.fromEntity = from;
+        rel.fromCardinality = fromCardinality;
+        rel.toEntity = to;
+        rel.toCardinality = toCardinality;
+        return rel;
+    }
+
+    // 0 Customer (alias C), 1 Order, 2 OrderItem, 3 Product, 4 Category, 5 Tag, 6 Lonely,
+    // 7 A, 8 B, 9 Self
+    void buildShop(EntityGraph& graph) {
+        std::vector<Entity> entities = {makeEntity("Customer", "C"), makeEntity("Order"), makeEntity("OrderItem"),
+                                        makeEntity("Product"), makeEntity("Category"), makeEntity("Tag"),
+                                        makeEntity("Lonely"), makeEntity("A"), makeEntity("B"), makeEntity("Self")};
+        const Cardinality one = Cardinality::ExactlyOne;
+        const Cardinality many = Cardinality::ZeroOrMany;
+        std::vector<EntityRelationship> relationships = {
+            relate("C", one, "Order", many),                            // 0: Order -> Customer
+            relate("Order", one, "OrderItem", Cardinality::OneOrMany),  // 1: OrderItem -> Order
+            relate("OrderItem", many, "Product", one),                  // 2: OrderItem -> Product
+            relate("Product", many, "Category", one),                   // 3: Product -> Category
+            relate("Product", many, "Tag", many),                       // 4: many-to-many, no reference
+            relate("A", one, "B", Cardinality::ZeroOrOne),              // 5: one-to-one, B -> A
+            relate("A", many, "B", one),                                // 6: A -> B, a loop with 5
+            relate("Self", many, "Self", one),                          // 7: Self -> Self
+            relate("C", one, "Missing", many),                          // 8: unresolved
+            relate("OrderItem", many, "Product", Cardinality::ZeroOrOne) // 9: same pair as 2
+        };
+        graph.build(entities, relationships);
+    }
+
+    // True if every reference of order's nodes points to a node placed before it
+    bool respectsReferences(const EntityGraph& graph, const Nodes& order, const Nodes& ignored) {
+        std::vector<size_t> position(graph.nodeCount());
+        for (size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+        for (uint32_t node = 0; node < graph.nodeCount(); ++node) {
+            if (std::find(ignored.begin(), ignored.end(), node) != ignored.end()) continue;
+            for (uint32_t target : graph.references(node)) {
+                if (target != node && position[target] > position[node]) return false;
+            }
+        }
+        return true;
+    }
+
+    void testQueries() {
+        TestSupport::section("Queries");
+        EntityGraph graph;
+        buildShop(graph);
+        check(graph.nodeCount() == 10 && graph.find("Customer") == 0 && graph.find("C") == 0 &&
+              graph.find("Missing") == EntityGraph::npos && graph.name(3) == "Product",
+              "entities are nodes, found by name or alias");
+        check(graph.unresolved() == Nodes{8}, "relationships to unknown entities are unresolved");
+        check(graph.referenceCount() == 7 && graph.linkCount() == 6, "references and links count distinct pairs");
+
+        check(graph.references(1) == Nodes{0} && graph.references(2) == Nodes{1, 3} && graph.references(8) == Nodes{7},
+              "the many side references the one side, one-to-one targets reference their source");
+        check(graph.referencedBy(0) == Nodes{1} && graph.referencedBy(3) == Nodes{2} && graph.references(5).empty(),
+              "referrers, and no reference for many-to-many");
+        check(graph.neighbors(3) == Nodes{2, 4, 5} && graph.neighbors(9).empty() && graph.neighbors(6).empty(),
+              "neighbors over every relationship, self-references left out");
+        check(graph.transitiveReferences(2) == Nodes{0, 1, 3, 4} && graph.dependents(0) == Nodes{1, 2} &&
+              graph.dependents(4) == Nodes{2, 3}, "transitive references and dependents");
+        check(graph.transitiveReferences(7) == Nodes{8} && graph.transitiveReferences(9).empty(),
+              "a node is not its own reference");
+    }
+
+    void testOrderAndCycles() {
+        TestSupport::section("Order and cycles");
+        EntityGraph graph;
+        buildShop(graph);
+        Nodes order = graph.creationOrder();
+        Nodes sorted = order;
+        std::sort(sorted.begin(), sorted.end());
+        check(sorted == Nodes{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, "creation order holds every entity once");
+        check(respectsReferences(graph, order, Nodes{7, 8}), "referenced entities come first");
+        check(order == (Nodes{0, 1, 4, 3, 2, 5, 6, 9, 7, 8}), "ties go to the lowest node, cycles are broken at it");
+        check(!graph.isOrderable(), "a loop of two entities is not orderable");
+        check(graph.cycles() == (std::vector<Nodes>{{7, 8}, {9}}), "loops and self-references are cycles");
+
+        EntityGraph acyclic;
+        acyclic.build({makeEntity("Child"), makeEntity("Parent")},
+                      {relate("Parent", Cardinality::ExactlyOne, "Child", Cardinality::ZeroOrMany),
+                       relate("Child", Cardinality::ZeroOrMany, "Child", Cardinality::ZeroOrOne)});
+        check(acyclic.isOrderable() && acyclic.creationOrder() == (Nodes{1, 0}) &&
+              acyclic.cycles() == std::vector<Nodes>{{0}}, "a self-reference does not prevent ordering");
+    }
+
+    void testComponentsAndPaths() {
+        TestSupport::section("Components and join paths");
+        EntityGraph graph;
+        buildShop(graph);
+        check(graph.components() == (std::vector<Nodes>{{0, 1, 2, 3, 4, 5}, {6}, {7, 8}, {9}}),
+              "components by their lowest node, isolated entities alone");
+        check(graph.componentOf(5) == 0 && graph.componentOf(6) == 1 && graph.componentOf(9) == 3 &&
+              graph.componentOf(42) == EntityGraph::npos, "component of a node");
+
+        EntityJoinPath path = graph.joinPath(0, 5);
+        check(path.entities == (Nodes{0, 1, 2, 3, 5}) && path.relationships == (Nodes{0, 1, 2, 4}),
+              "join path lists entities and the relationships joining them");
+        EntityJoinPath back = graph.joinPath(4, 1);
+        check(back.entities == (Nodes{4, 3, 2, 1}) && back.relationships == (Nodes{3, 2, 1}),
+              "join paths follow relationships in either direction");
+        check(graph.joinPath(8, 7).relationships == Nodes{5}, "the lowest relationship stands for a pair");
+        check(graph.joinPath(0, 6).empty() && graph.joinPath(0, 42).empty(), "unconnected entities have no path");
+        check(graph.joinPath(3, 3).entities == Nodes{3} && graph.joinPath(3, 3).relationships.empty(),
+              "the path of an entity to itself is the entity alone");
+    }
+
+    void testSampleDiagram() {
+        TestSupport::section("Sample diagram");
+        PUMLEntityParser parser;
+        PUMLEntityDiagramResult diagram = parser.parseFile("examples/sample_entity_diagram.puml");
+        EntityGraph graph;
+        graph.build(diagram);
+        check(diagram.success && graph.nodeCount() == diagram.entities.size() && graph.unresolved().empty() &&
+              graph.linkCount() > 0, "the sample diagram resolves");
+        check(graph.isOrderable() && respectsReferences(graph, graph.creationOrder(), Nodes()),
+              "the sample diagram has a creation order");
+
+        EntityGraph moved(std::move(graph));
+        check(moved.nodeCount() == diagram.entities.size(), "graphs move");
+        moved.clear();
+        check(moved.nodeCount() == 0 && moved.creationOrder().empty() && moved.components().empty() &&
+              moved.find("Customer") == EntityGraph::npos, "clear() empties the graph");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "EntityGraph checks" << std::endl;
+    testQueries();
+    testOrderAndCycles();
+    testComponentsAndPaths();
+    testSampleDiagram();
+    return TestSupport::finish();
+}
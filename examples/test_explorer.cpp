@@ -73,19 +73,19 @@ void demonstrateSourceExplorer() {
             std::cout << "   Success: " << (analysis.success ? "Yes" : "No") << std::endl;
             
             if (analysis.success) {
-                std::cout << "   Classes found: " << analysis.parseResult.classes.size() << std::endl;
-                for (const auto& cls : analysis.parseResult.classes) {
+                std::cout << "   Classes found: " << analysis.parseResult->classes.size() << std::endl;
+                for (const auto& cls : analysis.parseResult->classes) {
                     std::cout << "     - Class: " << cls.name << std::endl;
                     std::cout << "       Members: " << cls.members.size() << std::endl;
                     std::cout << "       Methods: " << cls.methods.size() << std::endl;
                 }
                 
-                std::cout << "   Enums found: " << analysis.parseResult.enums.size() << std::endl;
-                for (const auto& enumInfo : analysis.parseResult.enums) {
+                std::cout << "   Enums found: " << analysis.parseResult->enums.size() << std::endl;
+                for (const auto& enumInfo : analysis.parseResult->enums) {
                     std::cout << "     - Enum: " << enumInfo.name << std::endl;
                 }
                 
-                std::cout << "   Includes found: " << analysis.parseResult.includes.size() << std::endl;
+                std::cout << "   Includes found: " << analysis.parseResult->includes.size() << std::endl;
             } else {
                 std::cout << "   Error: " << analysis.errorMessage << std::endl;
             }
@@ -0,0 +1,117 @@
+// Behavioural checks of FileSystemExplorer (run from the repository root by "make test")
+#include "../include/FileSystemExplorer.h"
+#include "TestSupport.h"
+#include <algorithm>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    // Relative paths of the recorded entries, in result order
+    std::vector<std::string> relativePaths(const FileSystemExplorerResult& result, const std::string& base) {
+        std::vector<std::string> paths;
+        for (const auto& entry : result.entries) {
+            paths.push_back(std::filesystem::path(entry.path).lexically_relative(base).generic_string());
+        }
+        return paths;
+    }
+
+    bool contains(const std::vector<std::string>& paths, const std::string& path) {
+        return std::find(paths.begin(), paths.end(), path) != paths.end();
+    }
+
+    void writeTree(const TestSupport::TempDirectory& tree) {
+        for (int m = 0; m < 8; ++m) {
+            std::string module = "src/module" + std::to_string(m) + "/";
+            tree.write(module + "a.h", "// a\n");
+            tree.write(module + "b.cpp", "// b\n");
+            tree.write(module + "deep/c.h", "// c\n");
+        }
+        tree.write(".git/objects/pack.h", "// not a source\n");
+        tree.write("node_modules/package/index.h", "// dependency\n");
+        tree.write("build/generated.h", "// generated\n");
+        tree.write("third_party/lib/lib.h", "// vendored\n");
+    }
+
+    void testFilters() {
+        TestSupport::section("Walk-time filters");
+        TestSupport::TempDirectory tree("walk");
+        writeTree(tree);
+
+        FileSystemExplorer explorer;
+        FileSystemExplorerOptions options;
+        options.extensions = {".h"};
+        options.bIncludeDirectories = false;
+        std::vector<std::string> all = relativePaths(explorer.explore(tree.path(), options), tree.path());
+        check(all.size() == 20, "extension filter records the 20 headers");
+
+        options.bPruneIgnoredDirectories = true;
+        std::vector<std::string> pruned = relativePaths(explorer.explore(tree.path(), options), tree.path());
+        check(!contains(pruned, ".git/objects/pack.h") && !contains(pruned, "node_modules/package/index.h"),
+              "VCS metadata and dependency folders are pruned");
+        check(contains(pruned, "build/generated.h"), "build directories are not pruned by default");
+
+        options.excludePatterns = {"build", "third_party/**"};
+        std::vector<std::string> excluded = relativePaths(explorer.explore(tree.path(), options), tree.path());
+        check(excluded.size() == 16 && !contains(excluded, "build/generated.h") &&
+              !contains(excluded, "third_party/lib/lib.h"), "excludePatterns prune build and path globs");
+
+        options.excludePatterns.clear();
+        options.includePatterns = {"src/*/deep/*.h"};
+        check(explorer.explore(tree.path(), options).entries.size() == 8, "includePatterns match relative paths");
+    }
+
+    void testParallelWalk() {
+        TestSupport::section("Parallel walk");
+        TestSupport::TempDirectory tree("walk_parallel");
+        writeTree(tree);
+
+        FileSystemExplorer serial;
+        std::vector<std::string> expected = relativePaths(serial.explore(tree.path(), FileSystemExplorerOptions()), tree.path());
+        for (unsigned int threads : {2u, 5u}) {
+            FileSystemExplorerOptions options;
+            options.threadCount = threads;
+            FileSystemExplorer parallel;
+            check(relativePaths(parallel.explore(tree.path(), options), tree.path()) == expected,
+                  std::to_string(threads) + " walker threads list the entries of a serial walk, in order");
+        }
+
+        TestSupport::setEnvironment("UFM_TOOLING_THREADS", "3");
+        FileSystemExplorerOptions options;
+        options.threadCount = 0;
+        FileSystemExplorer fromEnvironment;
+        check(relativePaths(fromEnvironment.explore(tree.path(), options), tree.path()) == expected,
+              "threadCount 0 with UFM_TOOLING_THREADS lists the same entries");
+        TestSupport::setEnvironment("UFM_TOOLING_THREADS", "");
+    }
+
+    void testBrokenEntries() {
+        TestSupport::section("Broken entries");
+        TestSupport::TempDirectory tree("walk_broken");
+        tree.write("a/first.h", "// first\n");
+        tree.write("z/last.h", "// last\n");
+        std::error_code ec;
+        std::filesystem::create_symlink("loop", tree.path("a/loop"), ec);
+        if (!check(!ec, "symlink loop created")) return;
+
+        for (unsigned int threads : {1u, 3u}) {
+            FileSystemExplorerOptions options;
+            options.threadCount = threads;
+            FileSystemExplorer explorer;
+            const FileSystemExplorerResult& result = explorer.explore(tree.path(), options);
+            std::vector<std::string> paths = relativePaths(result, tree.path());
+            check(result.success && contains(paths, "a/first.h") && contains(paths, "z/last.h"),
+                  "a symlink loop does not stop the walk (" + std::to_string(threads) + " thread(s))");
+        }
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "FileSystemExplorer checks" << std::endl;
+    testFilters();
+    testParallelWalk();
+    testBrokenEntries();
+    return TestSupport::finish();
+}
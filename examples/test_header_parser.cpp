@@ -0,0 +1,530 @@
+// Behavioural checks of SimpleHeaderParser (run from the repository root by "make test")
+#include "../include/SimpleHeaderParser.h"
+#include "../include/MappedFile.h"
+#include "../include/ArenaParseResult.h"
+#include "../include/ParseStats.h"
+#include "TestSupport.h"
+#include <sstream>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    const MemberInfo* findMember(const ClassInfo& info, const std::string& name) {
+        for (const auto& member : info.members) {
+            if (member.name == name) return &member;
+        }
+        return nullptr;
+    }
+
+    const MethodInfo* findMethod(const ClassInfo& info, const std::string& name) {
+        for (const auto& method : info.methods) {
+            if (method.name == name) return &method;
+        }
+        return nullptr;
+    }
+
+    void describeClass(const ClassInfo& info, std::ostream& out) {
+        out << (info.isStruct ? "struct " : "class ") << info.fullName << (info.isTemplate ? " template" : "");
+        for (const auto& parameter : info.templateParameters) out << " <" << parameter << ">";
+        for (const auto& base : info.baseClasses) out << " : " << static_cast<int>(base.access) << " " << base.name;
+        for (const auto& name : info.friendClasses) out << " friend " << name;
+        out << "\n";
+        for (const auto& member : info.members) {
+            out << "  member " << static_cast<int>(member.access) << member.isStatic << member.isConst << " "
+                << member.type << " " << member.name << " = " << member.defaultValue << "\n";
+        }
+        for (const auto& method : info.methods) {
+            out << "  method " << static_cast<int>(method.access) << method.isStatic << method.isConst << method.isVirtual
+                << method.isPureVirtual << method.isConstructor << method.isDestructor << method.isOperator << " "
+                << method.returnType << " " << method.name << "(";
+            for (const auto& parameter : method.parameters) {
+                out << parameter.isConst << parameter.isReference << parameter.isPointer << " " << parameter.type << " "
+                    << parameter.name << " = " << parameter.defaultValue << ", ";
+            }
+            out << ")\n";
+        }
+    }
+
+    void describeNamespace(const NamespaceInfo& info, const std::string& indent, std::ostream& out) {
+        out << indent << "namespace " << info.name << " (" << info.classes.size() << " classes)\n";
+        for (const auto& nested : info.nestedNamespaces) describeNamespace(nested, indent + "  ", out);
+    }
+
+    // Every field of a result as text, to compare two parses
+    std::string describe(const ParseResult& result) {
+        std::ostringstream out;
+        out << "success " << result.success << " " << result.errorMessage << "\n";
+        for (const auto& include : result.includes) out << "include " << include << "\n";
+        for (const auto& info : result.classes) describeClass(info, out);
+        for (const auto& info : result.enums) {
+            out << (info.isClass ? "enum class " : "enum ") << info.name;
+            for (const auto& value : info.values) out << " " << value.first << "=" << value.second;
+            out << "\n";
+        }
+        for (const auto& info : result.namespaces) describeNamespace(info, "", out);
+        return out.str();
+    }
+
+    void testLexer() {
+        TestSupport::section("Lexer");
+        const std::string content =
+            "#include <vector>\n"
+            "#include \"local.h\"\n"
+            "// class CommentedOut { };\n"
+            "/* struct Hidden {\n"
+            "   int x; } */\n"
+            "class Widget : public Base, private Other {\n"
+            "public:\n"
+            "    Widget();\n"
+            "    virtual ~Widget();\n"
+            "    const char* label = \"} class Fake {\";\n"
+            "    virtual int area(const Shape& shape, int* count) const = 0;\n"
+            "    static int counter;\n"
+            "protected:\n"
+            "    std::vector<int> values; // { unbalanced\n"
+            "private:\n"
+            "    char quote='{';\n"
+            "    int last;\n"
+            "};\n"
+            "struct After { int x; };\n";
+
+        SimpleHeaderParser parser;
+        ParseResult result = parser.parseContent(content, "lexer.h");
+        check(result.success, "content parses");
+        check(result.includes.size() == 2 && result.includes[0] == "vector" && result.includes[1] == "local.h",
+              "both include forms are recorded");
+        check(result.classes.size() == 2 && result.classes[0].name == "Widget" && result.classes[1].name == "After",
+              "classes in comments and strings are ignored");
+        if (result.classes.size() != 2) return;
+
+        const ClassInfo& widget = result.classes[0];
+        check(widget.baseClasses.size() == 2 && widget.baseClasses[0].name == "Base" &&
+              widget.baseClasses[1].access == AccessSpecifier::Private, "base classes and their access");
+
+        const MethodInfo* area = findMethod(widget, "area");
+        check(area != nullptr && area->isPureVirtual && area->isConst && area->returnType == "int",
+              "pure virtual const method");
+        check(area != nullptr && area->parameters.size() == 2 && area->parameters[0].isReference &&
+              area->parameters[1].isPointer, "parameter references and pointers");
+
+        const MethodInfo* destructor = findMethod(widget, "~Widget");
+        check(destructor != nullptr && destructor->isDestructor && destructor->isVirtual, "virtual destructor");
+        const MethodInfo* constructor = findMethod(widget, "Widget");
+        check(constructor != nullptr && constructor->isConstructor, "constructor");
+
+        const MemberInfo* values = findMember(widget, "values");
+        check(values != nullptr && values->access == AccessSpecifier::Protected &&
+              values->type == "std::vector<int>", "template member type and access after a comment brace");
+        const MemberInfo* counter = findMember(widget, "counter");
+        check(counter != nullptr && counter->isStatic, "static member");
+        const MemberInfo* quote = findMember(widget, "quote");
+        check(quote != nullptr && quote->defaultValue == "'{'" && findMember(widget, "last") != nullptr,
+              "character literal brace does not open a scope");
+    }
+
+    void testTemplateClauses() {
+        TestSupport::section("Template clauses");
+        SimpleHeaderParser parser;
+        ParseResult result = parser.parseContent("template<int A, int B, bool T = bool(X<B) > struct S { int v; };\n"
+                                                 "struct After { int x; };\n", "clauses.h");
+        check(result.classes.size() == 2 && result.classes[0].name == "S" && result.classes[0].isTemplate &&
+              result.classes[0].templateParameters.size() == 3 && result.classes[1].name == "After" &&
+              !result.classes[1].isTemplate, "comparisons in parenthesized default arguments do not open the clause");
+
+        result = parser.parseContent("template<int A, bool T = A < 3> struct Less { int v; };\n"
+                                     "template <typename T,\n"
+                                     "          typename U = decltype(f<T>(0))>\n"
+                                     "struct Split { T t; };\n"
+                                     "struct Last { int x; };\n", "clauses.h");
+        check(result.classes.size() == 3 && result.classes[0].name == "Less" && result.classes[1].name == "Split" &&
+              result.classes[1].isTemplate && result.classes[2].name == "Last" && !result.classes[2].isTemplate,
+              "an unbalanced '<' ends its clause at the declaration's '{'");
+    }
+
+    void testSampleHeader() {
+        TestSupport::section("examples/sample_header.h");
+        SimpleHeaderParser parser;
+        ParseResult result = parser.parseFile("examples/sample_header.h");
+        check(result.success && result.classes.size() == 8, "sample header has 8 classes");
+        check(parser.findClass("Circle") != nullptr && parser.findClass("Circle")->baseClasses.size() == 1,
+              "Circle derives from one base");
+    }
+
+    void testMappedFiles() {
+        TestSupport::section("Mapped files");
+        const char* headers[] = {"examples/sample_header.h", "include/SimpleHeaderParser.h",
+                                 "include/SourceExplorer.h", "include/FileSystemExplorer.h"};
+        for (const char* header : headers) {
+            MappedFile file;
+            check(file.open(header) && file.isMapped() && file.view() == TestSupport::readFile(header),
+                  std::string("mapping of ") + header + " matches its contents");
+
+            SimpleHeaderParser mapped;
+            SimpleHeaderParser copied;
+            ParseResult fromFile = mapped.parseFile(header);
+            ParseResult fromContent = copied.parseContent(TestSupport::readFile(header), header);
+            check(fromFile.success && describe(fromFile) == describe(fromContent),
+                  std::string("parseFile() of ") + header + " equals parseContent() of its text");
+        }
+
+        TestSupport::TempDirectory dir("mapped");
+        MappedFile empty;
+        check(empty.open(dir.write("empty.h", "")) && empty.isOpen() && empty.size() == 0, "empty file opens with size 0");
+
+        MappedFile missing;
+        check(!missing.open(dir.path("missing.h")) && !missing.getErrorMessage().empty(),
+              "missing file fails with a message");
+        SimpleHeaderParser parser;
+        check(!parser.parseFile(dir.path("missing.h")).success, "parseFile() of a missing file fails");
+
+        // A copy keeps the contents a truncation would take from under a mapping (SIGBUS on POSIX)
+        std::string text = TestSupport::readFile("examples/sample_header.h");
+        std::string rewritten = dir.write("rewritten.h", text);
+        MappedFile copy;
+        check(copy.open(rewritten, true) && !copy.isMapped(), "bCopy reads the file instead of mapping it");
+        std::filesystem::resize_file(rewritten, 0);
+        check(copy.view() == text, "a copy still holds the contents after the file is truncated");
+
+        SimpleHeaderParser copying;
+        copying.setCopyFiles(true);
+        dir.write("rewritten.h", text);
+        check(describe(copying.parseFile(rewritten)) == describe(parser.parseFile(rewritten)),
+              "setCopyFiles() parses the same as a mapping");
+    }
+
+    void testSharedResults() {
+        TestSupport::section("Shared results");
+        SimpleHeaderParser parser;
+        std::shared_ptr<const ParseResult> first = parser.parseFileShared("examples/sample_header.h");
+        check(first == parser.getLastResult(), "getLastResult() shares the last parse");
+        std::string before = describe(*first);
+        std::shared_ptr<const ParseResult> second = parser.parseContentShared("class Other {\n    int x;\n};\n", "other.h");
+        check(describe(*first) == before && first->classes.size() == 8, "a shared result survives the next parse");
+        check(second->classes.size() == 1 && parser.getClasses().size() == 1 && parser.findClass("Other") != nullptr,
+              "getters follow the last parse");
+    }
+
+    // Upstream of the arena results: counts what they take and give back
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0;
+        size_t bytesInUse = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            allocations++;
+            bytesInUse += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            bytesInUse -= bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    void testArenaResults() {
+        TestSupport::section("Arena results");
+        const char* headers[] = {"examples/sample_header.h", "include/SimpleHeaderParser.h", "include/ArenaParseResult.h"};
+        for (const char* header : headers) {
+            SimpleHeaderParser parser;
+            ParseResult regular = parser.parseFile(header);
+            CountingResource upstream;
+            {
+                std::shared_ptr<const ArenaParseResult> arena = parser.parseFileArena(header, &upstream);
+                check(arena->success && describe(arena->toParseResult()) == describe(regular),
+                      std::string("arena parse of ") + header + " equals the regular parse");
+                check(upstream.allocations > 0 && upstream.allocations < 16,
+                      std::string("arena parse of ") + header + " takes few upstream blocks (" +
+                      std::to_string(upstream.allocations) + ")");
+
+                std::shared_ptr<const ArenaParseResult> fromContent =
+                    parser.parseContentArena(TestSupport::readFile(header), header);
+                check(describe(fromContent->toParseResult()) == describe(regular),
+                      std::string("arena parse of the text of ") + header + " equals the regular parse");
+            }
+            check(upstream.bytesInUse == 0, std::string("arena of ") + header + " is released with the result");
+            check(parser.getLastResult()->classes.size() == regular.classes.size(),
+                  "arena parses leave getLastResult() alone");
+        }
+    }
+
+    void testFindClass() {
+        TestSupport::section("Class lookups");
+        SimpleHeaderParser parser;
+        parser.parseContent("namespace outer {\n"
+                            "    class Item {\n"
+                            "        int first;\n"
+                            "    };\n"
+                            "}\n"
+                            "class Item {\n"
+                            "    int second;\n"
+                            "};\n", "lookup.h");
+        const ClassInfo* byFullName = parser.findClass("outer::Item");
+        check(byFullName != nullptr && findMember(*byFullName, "first") != nullptr, "classes are found by full name");
+        const ClassInfo* byName = parser.findClass("Item");
+        check(byName == &parser.getClasses()[0], "the first class of a name wins");
+        check(parser.findClass("Missing") == nullptr && parser.findClass("") == nullptr,
+              "unknown and empty names are not found");
+
+        parser.parseContent("class Other {\n    int x;\n};\n", "other.h");
+        check(parser.findClass("Item") == nullptr && parser.findClass("Other") != nullptr,
+              "the index is rebuilt by the next parse");
+    }
+
+    void testPreprocessor() {
+        TestSupport::section("Conditional blocks");
+        const std::string content =
+            "#if 0\n"
+            "class Disabled {\n"
+            "    int x;\n"
+            "};\n"
+            "#endif\n"
+            "#ifdef FEATURE\n"
+            "class Feature {\n"
+            "    int y;\n"
+            "};\n"
+            "#else\n"
+            "class Fallback {\n"
+            "    int z;\n"
+            "};\n"
+            "#endif\n"
+            "class Always {\n"
+            "    int w;\n"
+            "};\n";
+        auto classNames = [](const ParseResult& result) {
+            std::string names;
+            for (const auto& info : result.classes) names += info.name + " ";
+            return names;
+        };
+
+        SimpleHeaderParser parser;
+        check(!PreprocessorOptions().bSkipDisabledBlocks && !PreprocessorOptions().bEvaluateDefines,
+              "conditional blocks are kept by default");
+        check(classNames(parser.parseContent(content, "blocks.h")) == "Disabled Feature Fallback Always ",
+              "the default options keep every branch");
+
+        PreprocessorOptions options;
+        options.bSkipDisabledBlocks = true;
+        parser.setPreprocessorOptions(options);
+        check(classNames(parser.parseContent(content, "blocks.h")) == "Feature Fallback Always ",
+              "bSkipDisabledBlocks drops #if 0 and keeps undecided branches");
+
+        options.bEvaluateDefines = true;
+        parser.setPreprocessorOptions(options);
+        check(classNames(parser.parseContent(content, "blocks.h")) == "Fallback Always ",
+              "bEvaluateDefines decides #ifdef");
+        options.defines.push_back("FEATURE");
+        parser.setPreprocessorOptions(options);
+        check(classNames(parser.parseContent(content, "blocks.h")) == "Feature Always ",
+              "initial defines select the branch");
+    }
+
+    void testParallelParse() {
+        TestSupport::section("Parallel parses");
+        std::string content = "#include <vector>\n";
+        for (int i = 0; i < 40; ++i) {
+            std::string n = std::to_string(i);
+            content += "namespace space" + std::to_string(i % 3) + " {\n"
+                       "    template <typename T>\n"
+                       "    class Item" + n + " : public Base {\n"
+                       "    public:\n"
+                       "        virtual T get(const T& fallback, int* count) const = 0;\n"
+                       "        static const int limit = " + n + ";\n"
+                       "    private:\n"
+                       "        std::vector<T> values;\n"
+                       "    };\n"
+                       "    enum class Mode" + n + " { On = 1, Off };\n"
+                       "}\n";
+        }
+
+        SimpleHeaderParser serial;
+        std::string expected = describe(*serial.parseContentShared(content, "big.h"));
+
+        ParallelParseOptions parallel;
+        parallel.threadCount = 4;
+        parallel.minFileBytes = 0;
+        parallel.minChunkBytes = 256;
+        SimpleHeaderParser parser;
+        parser.setParallelOptions(parallel);
+        ParseStats stats;
+        parser.setStats(&stats);
+        std::shared_ptr<const ParseResult> result = parser.parseContentShared(content, "big.h");
+        check(result->classes.size() == 40 && result->namespaces.size() == 3, "chunks are merged back");
+        check(describe(*result) == expected, "a parallel parse gives the serial result");
+
+        FileParseStats file = stats.getTotals();
+        check(stats.getFileCount() == 1 && file.bytes == content.size() && file.classes == 40 && file.methods == 40 &&
+              file.enums == 40, "parallel parses record the file's counts");
+        check(file.allocations > 0 && file.allocatedBytes > 0, "parallel parses count the arena allocations");
+    }
+
+    // Declarations as found in library headers (Eigen, fmt, gmock): template clauses over
+    // several lines, comparisons in default arguments, macros with braces, linkage blocks
+    std::string libraryShapedHeader(int copies) {
+        std::string content = "#pragma once\n#include <type_traits>\n";
+        for (int i = 0; i < copies; ++i) {
+            std::string n = std::to_string(i);
+            content += "namespace lib { namespace internal {\n"
+                       "#define LIB_FORWARD_" + n + "(T) \\\n"
+                       "    struct Forward##T { int x; };\n"
+                       "template<typename Derived, int Rows = Derived::Rows,\n"
+                       "         bool IsSmall = (Rows > 0 && Rows < 16),\n"
+                       "         int Align = (sizeof(Derived) % 16 == 0) ? 16 : 0>\n"
+                       "struct traits" + n + " {\n"
+                       "    enum { Size = Rows, Aligned = Align > 0 };\n"
+                       "    static constexpr bool value = bool(Rows<16) && !IsSmall;\n"
+                       "};\n"
+                       "template<int A, int B, bool T = bool(A<B) > struct compare" + n + " { int v; };\n"
+                       "template <typename T, typename = typename std::enable_if<(sizeof(T) > 4)>::type>\n"
+                       "struct wide" + n + " : std::true_type {};\n"
+                       "} // namespace internal\n"
+                       "/* a comment with a brace { and a template<int N */\n"
+                       "template <typename Char, typename Context =\n"
+                       "              basic_context<Char>>\n"
+                       "class formatter" + n + " : public internal::traits" + n + "<Char> {\n"
+                       " public:\n"
+                       "  template <typename ParseContext>\n"
+                       "  auto parse(ParseContext& ctx) -> decltype(ctx.begin());\n"
+                       "  const char* text = \"} struct Fake {\";\n"
+                       "};\n"
+                       "}  // namespace lib\n"
+                       "extern \"C\" {\n"
+                       "struct c_point" + n + " { int x, y; };\n"
+                       "}\n";
+        }
+        return content;
+    }
+
+    void testParallelLibraryHeaders() {
+        TestSupport::section("Parallel parses of library headers");
+        std::string content = libraryShapedHeader(30);
+        SimpleHeaderParser serial;
+        std::string expected = describe(*serial.parseContentShared(content, "library.h"));
+        check(serial.getClasses().size() == 150 && serial.findClass("lib::formatter29") != nullptr &&
+              serial.findClass("c_point29") != nullptr, "the serial parse finds every class");
+
+        for (size_t chunkBytes : {size_t(1), size_t(64), size_t(512)}) {
+            ParallelParseOptions parallel;
+            parallel.threadCount = 4;
+            parallel.minFileBytes = 0;
+            parallel.minChunkBytes = chunkBytes;
+            SimpleHeaderParser parser;
+            parser.setParallelOptions(parallel);
+            check(describe(*parser.parseContentShared(content, "library.h")) == expected,
+                  "chunks of " + std::to_string(chunkBytes) + " bytes give the serial result");
+        }
+
+        // The '(' left open makes every later line part of the template clause; the prescan
+        // cuts after its ';' all the same, and that chunk must not be parsed on its own
+        std::string unbalanced;
+        for (int i = 0; i < 20; ++i) unbalanced += "struct Before" + std::to_string(i) + " { int x; };\n";
+        unbalanced += "template <typename T, int N = (sizeof(T);\n";
+        for (int i = 0; i < 20; ++i) unbalanced += "struct After" + std::to_string(i) + " { int x; };\n";
+        SimpleHeaderParser unbalancedSerial;
+        std::string unbalancedExpected = describe(*unbalancedSerial.parseContentShared(unbalanced, "unbalanced.h"));
+        ParallelParseOptions parallel;
+        parallel.threadCount = 4;
+        parallel.minFileBytes = 0;
+        parallel.minChunkBytes = 64;
+        SimpleHeaderParser parser;
+        parser.setParallelOptions(parallel);
+        check(describe(*parser.parseContentShared(unbalanced, "unbalanced.h")) == unbalancedExpected,
+              "a chunk starting inside a declaration falls back to the serial parse");
+    }
+
+    // A full result without what a lighter ParseDetail level leaves out
+    void stripClass(ClassInfo& info, bool bMembers) {
+        info.methods.clear();
+        if (!bMembers) info.members.clear();
+    }
+
+    void stripNamespace(NamespaceInfo& info, bool bMembers) {
+        for (auto& cls : info.classes) stripClass(cls, bMembers);
+        for (auto& nested : info.nestedNamespaces) stripNamespace(nested, bMembers);
+    }
+
+    ParseResult stripped(ParseResult result, bool bMembers) {
+        for (auto& cls : result.classes) stripClass(cls, bMembers);
+        for (auto& info : result.namespaces) stripNamespace(info, bMembers);
+        return result;
+    }
+
+    void testParseDetail() {
+        TestSupport::section("Parse detail levels");
+        std::string content = TestSupport::readFile("examples/sample_header.h");
+        content += "#if 0\n#include \"disabled.h\"\n#endif\n"
+                   "namespace outer {\n"
+                   "    template <typename T>\n"
+                   "    struct Holder : public Base {\n"
+                   "        T value;\n"
+                   "        T get() const;\n"
+                   "    };\n"
+                   "}\n";
+
+        SimpleHeaderParser parser;
+        ParseResult full = parser.parseContent(content, "detail.h");
+        check(full.success && full.classes.size() > 5 && !full.includes.empty() && !full.enums.empty() &&
+              !full.namespaces.empty(), "the full parse finds every kind of declaration");
+
+        parser.setParseDetail(ParseDetail::NoMethods);
+        ParseResult noMethods = parser.parseContent(content, "detail.h");
+        check(describe(noMethods) == describe(stripped(full, true)), "NoMethods is the full result without methods");
+
+        parser.setParseDetail(ParseDetail::Types);
+        ParseResult types = parser.parseContent(content, "detail.h");
+        check(describe(types) == describe(stripped(full, false)),
+              "Types keeps classes, bases, template parameters, namespaces, enums and includes");
+
+        parser.setParseDetail(ParseDetail::IncludesOnly);
+        ParseResult includes = parser.parseContent(content, "detail.h");
+        check(includes.success && includes.includes == full.includes && includes.classes.empty() &&
+              includes.enums.empty() && includes.namespaces.empty(), "IncludesOnly only lists the includes");
+
+        PreprocessorOptions skip;
+        skip.bSkipDisabledBlocks = true;
+        parser.setPreprocessorOptions(skip);
+        ParseResult skipped = parser.parseContent(content, "detail.h");
+        parser.setParseDetail(ParseDetail::Full);
+        check(skipped.includes == parser.parseContent(content, "detail.h").includes &&
+              skipped.includes.size() + 1 == full.includes.size(), "IncludesOnly honours the preprocessor options");
+        parser.setPreprocessorOptions(PreprocessorOptions());
+
+        ParseResult again = parser.parseContent(content, "detail.h");
+        check(describe(again) == describe(full), "setting Full back restores the full result");
+
+        ParallelParseOptions parallel;
+        parallel.threadCount = 4;
+        parallel.minFileBytes = 0;
+        parallel.minChunkBytes = 256;
+        SimpleHeaderParser chunked;
+        chunked.setParallelOptions(parallel);
+        chunked.setParseDetail(ParseDetail::NoMethods);
+        check(describe(*chunked.parseContentShared(content, "detail.h")) == describe(noMethods),
+              "a parallel parse honours the detail level");
+        chunked.setParseDetail(ParseDetail::IncludesOnly);
+        check(chunked.parseContentShared(content, "detail.h")->includes == full.includes,
+              "IncludesOnly is not split across threads");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "SimpleHeaderParser checks" << std::endl;
+    testLexer();
+    testTemplateClauses();
+    testSampleHeader();
+    testMappedFiles();
+    testSharedResults();
+    testArenaResults();
+    testFindClass();
+    testPreprocessor();
+    testParallelParse();
+    testParallelLibraryHeaders();
+    testParseDetail();
+    return TestSupport::finish();
+}
@@ -0,0 +1,120 @@
+// Behavioural checks of IncludeGraph (run from the repository root by "make test")
+#include "../include/IncludeGraph.h"
+#include "TestSupport.h"
+#include <algorithm>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    std::vector<std::string> pathsOf(const IncludeGraph& graph, const std::vector<uint32_t>& nodes) {
+        std::vector<std::string> names;
+        for (uint32_t node : nodes) {
+            std::string path(graph.path(node));
+            size_t src = path.rfind("/src/");
+            names.push_back(src != std::string::npos ? path.substr(src + 5) : path);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    void writeTree(const TestSupport::TempDirectory& tree) {
+        tree.write("src/base.h", "class Base {\n    int x;\n};\n");
+        tree.write("src/util/str.h", "#include \"../base.h\"\nclass Str {\n    int y;\n};\n");
+        tree.write("src/app.h", "#include \"util/str.h\"\n#include <vector>\n#include <lib.h>\n");
+        tree.write("src/top.h", "#include \"app.h\"\n#include \"str.h\"\n");
+        tree.write("src/a.h", "#include \"b.h\"\n");
+        tree.write("src/b.h", "#include \"a.h\"\n#include \"base.h\"\n");
+        tree.write("src/self.h", "#include \"self.h\"\n");
+        tree.write("src/external.h", "#include \"../outside/extra.h\"\n");
+        tree.write("inc/lib.h", "class Lib {\n    int z;\n};\n");
+        tree.write("outside/extra.h", "class Extra {\n    int w;\n};\n");
+    }
+
+    void testQueries() {
+        TestSupport::section("Queries");
+        TestSupport::TempDirectory tree("include_graph");
+        writeTree(tree);
+        SourceExplorer explorer;
+        const SourceExplorerResult& result = explorer.explore(tree.path("src"), SourceExplorerOptions());
+
+        IncludeGraphOptions options;
+        options.includePaths.push_back(tree.path("inc"));
+        IncludeGraph graph;
+        graph.build(result, options);
+
+        uint32_t base = graph.find(tree.path("src/base.h"));
+        uint32_t str = graph.find(tree.path("src/util/./str.h"));
+        uint32_t app = graph.find(tree.path("src/app.h"));
+        uint32_t lib = graph.find(tree.path("inc/lib.h"));
+        uint32_t extra = graph.find(tree.path("outside/extra.h"));
+        check(base != IncludeGraph::npos && str != IncludeGraph::npos && app != IncludeGraph::npos,
+              "analyzed headers are nodes, found by normalized path");
+        check(graph.nodeCount() == result.analyses.size() + 2 && lib != IncludeGraph::npos &&
+              extra != IncludeGraph::npos && !graph.isAnalyzed(lib) && graph.isAnalyzed(app),
+              "headers found on disk are nodes that were not analyzed");
+
+        std::vector<uint32_t> appIncludes = {str, lib};
+        std::sort(appIncludes.begin(), appIncludes.end());
+        check(graph.includes(app) == appIncludes, "direct includes, relative and through include paths");
+        check(pathsOf(graph, graph.includers(base)) == std::vector<std::string>{"b.h", "util/str.h"},
+              "direct includers");
+        std::vector<uint32_t> transitive = graph.transitiveIncludes(app);
+        check(transitive.size() == 3 && std::is_sorted(transitive.begin(), transitive.end()),
+              "transitive includes are sorted and complete");
+        check(pathsOf(graph, graph.dependents(base)) == std::vector<std::string>{"a.h", "app.h", "b.h", "top.h", "util/str.h"},
+              "dependents follow includers, suffix matches and cycles");
+        check(pathsOf(graph, graph.dependents(std::vector<uint32_t>{str, app})) == std::vector<std::string>{"top.h"},
+              "changed nodes are not their own dependents");
+        check(graph.reaches(app, base) && !graph.reaches(base, app), "reaches() follows the include direction");
+
+        std::vector<std::vector<uint32_t>> cycles = graph.cycles();
+        bool bCycles = cycles.size() == 2;
+        for (const auto& cycle : cycles) {
+            std::vector<std::string> names = pathsOf(graph, cycle);
+            bCycles = bCycles && (names == std::vector<std::string>{"a.h", "b.h"} ||
+                                  names == std::vector<std::string>{"self.h"});
+        }
+        uint32_t self = graph.find(tree.path("src/self.h"));
+        check(bCycles, "cycles include a self-include");
+        check(graph.includes(self) == std::vector<uint32_t>{self} && graph.transitiveIncludes(self).empty() &&
+              graph.dependents(self).empty(), "transitive lists never hold the node itself");
+
+        check(graph.unresolved().size() == 1 && graph.unresolved()[0].target == "vector" &&
+              graph.unresolved()[0].file == app, "unresolved targets are reported with their includer");
+
+        std::vector<IncludeFanIn> heaviest = graph.heaviestFanIn(1);
+        check(heaviest.size() == 1 && heaviest[0].node == base && heaviest[0].includers == 2 &&
+              heaviest[0].dependents == 5, "heaviest fan-in counts includers and dependents");
+    }
+
+    void testOptions() {
+        TestSupport::section("Options");
+        TestSupport::TempDirectory tree("include_graph_options");
+        writeTree(tree);
+        SourceExplorer explorer;
+        const SourceExplorerResult& result = explorer.explore(tree.path("src"), SourceExplorerOptions());
+
+        IncludeGraphOptions options;
+        options.bSearchFileSystem = false;
+        options.bMatchBySuffix = false;
+        IncludeGraph graph;
+        graph.build(result, options);
+        check(graph.nodeCount() == result.analyses.size(), "without a disk search only analyzed headers are nodes");
+        uint32_t top = graph.find(tree.path("src/top.h"));
+        check(graph.includes(top).size() == 1 && graph.unresolved().size() == 4,
+              "without suffix matching str.h stays unresolved");
+
+        graph.clear();
+        check(graph.nodeCount() == 0 && graph.edgeCount() == 0 && graph.unresolved().empty(), "clear() empties the graph");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "IncludeGraph checks" << std::endl;
+    testQueries();
+    testOptions();
+    return TestSupport::finish();
+}
@@ -0,0 +1,111 @@
+// Behavioural checks of ParseStats (run from the repository root by "make test")
+#include "../include/ParseStats.h"
+#include "../include/SourceExplorer.h"
+#include "../include/third_party/json.hpp"
+#include "TestSupport.h"
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    void writeTree(const TestSupport::TempDirectory& tree) {
+        const char* sources[] = {"examples/sample_header.h", "include/SimpleHeaderParser.h", "include/ParseStats.h"};
+        for (int copy = 0; copy < 3; ++copy) {
+            for (const char* source : sources) {
+                tree.write("copy" + std::to_string(copy) + "/" + std::filesystem::path(source).filename().string(),
+                           TestSupport::readFile(source));
+            }
+        }
+    }
+
+    void testExplorationStats() {
+        TestSupport::section("Exploration stats");
+        TestSupport::TempDirectory tree("stats");
+        writeTree(tree);
+
+        SourceExplorer plain;
+        plain.explore(tree.path(), SourceExplorerOptions());
+        std::string expected = plain.exportToJson();
+
+        ParseStatsOptions statsOptions;
+        statsOptions.slowestFiles = 4;
+        ParseStats stats(statsOptions);
+        SourceExplorerOptions options;
+        options.stats = &stats;
+        options.threadCount = 3;
+        SourceExplorer explorer;
+        const SourceExplorerResult& result = explorer.explore(tree.path(), options);
+        check(explorer.exportToJson() == expected, "results are the same with stats on");
+
+        size_t classes = 0;
+        uint64_t bytes = 0;
+        for (const auto& analysis : result.analyses) {
+            classes += analysis.parseResult->classes.size();
+            bytes += std::filesystem::file_size(analysis.path);
+        }
+        FileParseStats totals = stats.getTotals();
+        check(stats.getFileCount() == 9 && stats.getFiles().size() == 9, "every file is recorded");
+        check(totals.classes == classes && totals.bytes == bytes, "totals add up the classes and bytes of the files");
+        check(totals.allocations > 0 && totals.allocatedBytes > 0, "arena allocations are counted");
+        check(stats.getStage(ParseStage::Walk).count == 1 && stats.getStage(ParseStage::Tokenize).count == 9 &&
+              stats.getStage(ParseStage::ParseClasses).count == 9, "stages are counted once per run or per file");
+        check(stats.getStage(ParseStage::Export).count == 1, "the export is recorded as a stage");
+
+        std::vector<FileParseStats> slowest = stats.getSlowestFiles();
+        bool bSorted = slowest.size() == 4;
+        for (size_t i = 1; bSorted && i < slowest.size(); ++i) bSorted = slowest[i - 1].totalMs >= slowest[i].totalMs;
+        check(bSorted, "slowest files are limited and sorted");
+
+        // Timings are written with the shortest round-trip digits, which nlohmann does not
+        // always pick, so the values are compared rather than the text
+        nlohmann::json json = nlohmann::json::parse(stats.exportToJson());
+        check(json.contains("stages") && json["files"].size() == 9, "JSON export lists stages and files");
+        bool bExact = json["files"].size() == stats.getFiles().size();
+        for (size_t i = 0; bExact && i < stats.getFiles().size(); ++i) {
+            bExact = json["files"][i]["path"] == stats.getFiles()[i].path &&
+                     json["files"][i]["totalMs"].get<double>() == stats.getFiles()[i].totalMs;
+        }
+        check(bExact, "timings read back exactly");
+        nlohmann::json trace = nlohmann::json::parse(stats.exportToChromeTrace());
+        check(trace.contains("traceEvents") && trace["traceEvents"].size() >= 9, "Chrome trace holds the events");
+
+        stats.reset();
+        check(stats.getFileCount() == 0 && stats.getStage(ParseStage::Walk).count == 0, "reset() forgets everything");
+    }
+
+    void testCollectorOptions() {
+        TestSupport::section("Collector options");
+        ParseStatsOptions options;
+        options.bRecordFiles = false;
+        options.slowestFiles = 2;
+        ParseStats stats(options);
+        for (int i = 0; i < 5; ++i) {
+            FileParseStats file;
+            file.path = "file" + std::to_string(i);
+            file.totalMs = i;
+            file.classes = 1;
+            stats.recordFile(file);
+        }
+        std::vector<FileParseStats> slowest = stats.getSlowestFiles();
+        check(stats.getFiles().empty() && stats.getFileCount() == 5 && stats.getTotals().classes == 5,
+              "without bRecordFiles only counters are kept");
+        check(slowest.size() == 2 && slowest[0].path == "file4" && slowest[1].path == "file3", "the slowest files stay");
+
+        SimpleHeaderParser parser;
+        ParseStats parserStats;
+        parser.setStats(&parserStats);
+        parser.parseFile("examples/sample_header.h");
+        parser.setStats(nullptr);
+        parser.parseFile("examples/sample_header.h");
+        check(parserStats.getFileCount() == 1 && parserStats.getTotals().classes == 8, "setStats(nullptr) stops recording");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "ParseStats checks" << std::endl;
+    testExplorationStats();
+    testCollectorOptions();
+    return TestSupport::finish();
+}
@@ -0,0 +1,383 @@
+// Behavioural checks of the PlantUML parsers (run from the repository root by "make test")
+#include "../include/PUMLClassParser.h"
+#include "../include/PUMLEntityParser.h"
+#include "../include/PUMLBatchParser.h"
+#include "../include/SourceExplorer.h"
+#include "../include/third_party/json.hpp"
+#include "TestSupport.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    void testLookups() {
+        TestSupport::section("Class and entity lookups");
+        PUMLClassParser classParser;
+        PUMLClassDiagramResult classes = classParser.parseFile("examples/sample_class_diagram.puml");
+        check(classes.success && !classes.classes.empty(), "sample class diagram parses");
+        bool bAllFound = true;
+        for (const auto& umlClass : classes.classes) {
+            const UMLClass* found = classParser.findClass(umlClass.name);
+            bAllFound = bAllFound && found != nullptr && found->name == umlClass.name;
+        }
+        check(bAllFound, "every class is found by name");
+        check(classParser.findClass("Vehicle") != nullptr && classParser.findClass("Vehicle")->isAbstract,
+              "findClass() returns the declared class");
+        check(classParser.findClass("NoSuchClass") == nullptr && classParser.findClass("") == nullptr,
+              "unknown and empty names are not found");
+
+        PUMLEntityParser entityParser;
+        PUMLEntityDiagramResult entities = entityParser.parseContent(
+            "@startuml\n"
+            "entity \"Customer Accounts\" as Customer {\n"
+            "    * id : int <PK>\n"
+            "}\n"
+            "entity Order {\n"
+            "    * id : int <PK>\n"
+            "}\n"
+            "entity Order {\n"
+            "    * other : int <PK>\n"
+            "}\n"
+            "@enduml\n");
+        check(entities.success && entities.entities.size() == 3, "entity diagram parses");
+        const Entity* byAlias = entityParser.findEntity("Customer");
+        check(byAlias != nullptr && byAlias->alias == "Customer", "entities are found by alias");
+        const Entity* byName = entityParser.findEntity(entities.entities[0].name);
+        check(byName == byAlias, "and by name");
+        const Entity* duplicate = entityParser.findEntity("Order");
+        check(duplicate == &entityParser.getEntities()[1], "the first of two entities with one name wins");
+        check(entityParser.findEntity("") == nullptr && entityParser.findEntity("Missing") == nullptr,
+              "unknown and empty names are not found");
+
+        entityParser.parseContent("@startuml\nentity Fresh {\n    * id : int\n}\n@enduml\n");
+        check(entityParser.findEntity("Order") == nullptr && entityParser.findEntity("Fresh") != nullptr,
+              "the index is rebuilt by the next parse");
+    }
+
+    const UMLClass* findUMLClass(const PUMLClassDiagramResult& result, const std::string& name) {
+        for (const auto& umlClass : result.classes) {
+            if (umlClass.name == name) return &umlClass;
+        }
+        return nullptr;
+    }
+
+    void testClassLines() {
+        TestSupport::section("Class diagram lines");
+        PUMLClassParser parser;
+        PUMLClassDiagramResult result = parser.parseContent(
+            "@startuml\n"
+            "title Shapes\n"
+            "abstract class Shape {\n"
+            "  - name : string\n"
+            "  # {static} count : int = 0\n"
+            "  + {abstract} area() : double\n"
+            "  ~ move(dx : int, dy : int) : void\n"
+            "}\n"
+            "interface Drawable {\n"
+            "  + draw() : void\n"
+            "}\n"
+            "class Circle <<entity>> {\n"
+            "  + radius : double\n"
+            "}\n"
+            "class Interfaces {\n"
+            "}\n"
+            "' class Commented {\n"
+            "Shape <|-- Circle\n"
+            "Drawable <|.. Circle\n"
+            "Circle \"1\" *-- \"many\" Point : center\n"
+            "Circle o-- Style\n"
+            "Circle ..> Canvas\n"
+            "Circle --> Brush : uses class\n"
+            "Circle -- Other\n"
+            "note right of Circle\n"
+            "@enduml\n");
+        check(result.success && result.title == "Shapes" && result.classes.size() == 4, "title and classes");
+        check(findUMLClass(result, "Commented") == nullptr, "commented lines are skipped");
+
+        const UMLClass* shape = findUMLClass(result, "Shape");
+        check(shape != nullptr && shape->isAbstract && shape->attributes.size() == 2 && shape->methods.size() == 2,
+              "abstract class body");
+        if (shape != nullptr && shape->attributes.size() == 2 && shape->methods.size() == 2) {
+            check(shape->attributes[0].visibility == UMLVisibility::Private && shape->attributes[0].type == "string",
+                  "private attribute and its type");
+            check(shape->attributes[1].visibility == UMLVisibility::Protected && shape->attributes[1].isStatic &&
+                  shape->attributes[1].defaultValue == "0", "static protected attribute with a default");
+            check(shape->methods[0].isAbstract && shape->methods[0].returnType == "double", "abstract method");
+            check(shape->methods[1].visibility == UMLVisibility::Package && shape->methods[1].parameters.size() == 2 &&
+                  shape->methods[1].parameters[1].name == "dy" && shape->methods[1].parameters[1].type == "int",
+                  "package method parameters");
+        }
+        const UMLClass* drawable = findUMLClass(result, "Drawable");
+        check(drawable != nullptr && drawable->isInterface, "interface");
+        const UMLClass* circle = findUMLClass(result, "Circle");
+        check(circle != nullptr && circle->stereotype == "entity", "stereotype");
+        const UMLClass* interfaces = findUMLClass(result, "Interfaces");
+        check(interfaces != nullptr && !interfaces->isInterface, "keywords only match whole words");
+
+        const UMLRelationship expected[] = {UMLRelationship::Inheritance, UMLRelationship::Realization,
+                                            UMLRelationship::Composition, UMLRelationship::Aggregation,
+                                            UMLRelationship::Dependency, UMLRelationship::DirectedAssociation,
+                                            UMLRelationship::Association};
+        bool bTypes = result.relationships.size() == 7;
+        for (size_t i = 0; bTypes && i < 7; ++i) bTypes = result.relationships[i].type == expected[i];
+        check(bTypes, "every arrow gets its relationship type");
+        if (bTypes) {
+            const UMLClassRelationship& composition = result.relationships[2];
+            check(composition.fromClass == "Circle" && composition.toClass == "Point" && composition.label == "center" &&
+                  composition.fromCardinality == "1" && composition.toCardinality == "many",
+                  "cardinalities and label");
+            check(result.relationships[0].fromClass == "Circle" && result.relationships[0].toClass == "Shape",
+                  "inheritance points from the derived class");
+            check(result.relationships[5].label == "uses class", "a keyword inside a label is not a declaration");
+        }
+        check(result.notes.count("Circle") == 1, "note attached to a class");
+    }
+
+    // Class and entity names of every analysis, to compare two batch runs
+    std::string describeBatch(const PUMLBatchResult& result) {
+        std::string text;
+        for (const auto& analysis : result.analyses) {
+            text += analysis.filename + " " + std::to_string(static_cast<int>(analysis.type)) +
+                    (analysis.success ? " ok:" : " failed:");
+            for (const auto& umlClass : analysis.classDiagram.classes) text += " " + umlClass.name;
+            for (const auto& entity : analysis.entityDiagram.entities) text += " " + entity.name;
+            text += "\n";
+        }
+        return text;
+    }
+
+    void testBatch() {
+        TestSupport::section("Batch parsing");
+        TestSupport::TempDirectory tree("puml_batch");
+        tree.write("classes.puml", TestSupport::readFile("examples/sample_class_diagram.puml"));
+        tree.write("db/entities.puml", TestSupport::readFile("examples/sample_entity_diagram.puml"));
+        tree.write("db/more.puml", "@startuml\nentity Customer {\n    * customer_id : int <PK>\n    nickname : text\n}\n"
+                                   "entity Coupon {\n    * id : int <PK>\n}\n@enduml\n");
+        tree.write("notes/readme.puml", "@startuml\nnote \"nothing to see\" as N\n@enduml\n");
+
+        check(PUMLBatchParser::detectDiagramType("@startuml\nentity A {\n}\nA ||--o{ B\n@enduml\n") == PUMLDiagramType::Entity &&
+              PUMLBatchParser::detectDiagramType("@startuml\nclass A {\n}\nA <|-- B\n@enduml\n") == PUMLDiagramType::Class &&
+              PUMLBatchParser::detectDiagramType("@startuml\n@enduml\nclass Outside\n") == PUMLDiagramType::Unknown,
+              "diagram types are detected inside @startuml blocks");
+
+        PUMLBatchOptions options;
+        options.threadCount = 1;
+        options.bMerge = true;
+        PUMLBatchParser serial;
+        const PUMLBatchResult& result = serial.explore(tree.path(), options);
+        check(result.filesProcessed == 4 && result.classDiagrams == 1 && result.entityDiagrams == 2 &&
+              result.filesWithErrors == 1, "files are counted by diagram type, unknown ones as errors");
+        check(result.analyses.size() == 4 && result.analyses[3].filename == "readme.puml" &&
+              !result.analyses[3].success && !result.analyses[3].errorMessage.empty(), "a failing file is reported");
+
+        const PUMLEntityDiagramResult& merged = result.entityModel;
+        const Entity* customer = nullptr;
+        for (const auto& entity : merged.entities) {
+            if (entity.name == "Customer") customer = &entity;
+        }
+        check(customer != nullptr && customer->fields.size() == 11, "entities with one name are merged, fields added once");
+        check(merged.entities.size() == PUMLEntityParser().parseFile("examples/sample_entity_diagram.puml").entities.size() + 1,
+              "merged model holds every distinct entity");
+        check(result.classModel.classes.size() == PUMLClassParser().parseFile("examples/sample_class_diagram.puml").classes.size(),
+              "class model holds the class diagram");
+
+        std::string expected = describeBatch(result);
+        options.threadCount = 3;
+        PUMLBatchParser threaded;
+        check(describeBatch(threaded.explore(tree.path(), options)) == expected, "threaded batch equals serial batch");
+
+        SourceExplorer explorer;
+        check(describeBatch(explorer.explorePUML(tree.path(), options)) == expected,
+              "SourceExplorer::explorePUML() equals the batch parser");
+
+        std::vector<std::string> files = {tree.path("db/more.puml"), tree.path("missing.puml")};
+        const PUMLBatchResult& listed = serial.parseFiles(files);
+        check(listed.analyses.size() == 2 && listed.analyses[0].success && !listed.analyses[1].success,
+              "parseFiles() keeps input order and reports unreadable files");
+    }
+
+    void describeEntity(const Entity& entity, std::ostream& out) {
+        out << "entity " << entity.name << " as " << entity.alias << " [" << entity.schema << "] <<" << entity.stereotype
+            << ">> " << entity.comment << "\n";
+        for (const auto& field : entity.fields) {
+            out << "  " << field.name << " : " << field.type << " = " << field.defaultValue << " // " << field.comment << " "
+                << field.isPrimaryKey << field.isForeignKey << field.isUnique << field.isNotNull;
+            for (EntityFieldType constraint : field.constraints) out << " " << static_cast<int>(constraint);
+            out << "\n";
+        }
+    }
+
+    void describeRelationship(const EntityRelationship& rel, std::ostream& out) {
+        out << rel.fromEntity << " " << static_cast<int>(rel.fromCardinality) << " -> " << static_cast<int>(rel.toCardinality)
+            << " " << rel.toEntity << " type " << static_cast<int>(rel.type) << " " << rel.isIdentifying << " : " << rel.label
+            << " (" << rel.fromFields.size() << ", " << rel.toFields.size() << ")\n";
+    }
+
+    // Every field of an entity diagram as text, to compare two parses
+    std::string describe(const PUMLEntityDiagramResult& result) {
+        std::ostringstream out;
+        out << "title " << result.title << "\n";
+        for (const auto& entity : result.entities) describeEntity(entity, out);
+        for (const auto& rel : result.relationships) describeRelationship(rel, out);
+        for (const auto& note : result.notes) out << "note " << note.first << " = " << note.second << "\n";
+        return out.str();
+    }
+
+    void testStreamParser() {
+        TestSupport::section("Entity stream parser");
+        std::string content = TestSupport::readFile("examples/sample_entity_diagram.puml");
+        PUMLEntityParser parser;
+        std::string expected = describe(parser.parseContent(content));
+
+        PUMLEntityDiagramResult streamed;
+        PUMLEntityCallbacks callbacks;
+        callbacks.onEntity = [&](Entity& entity) { streamed.entities.push_back(std::move(entity)); };
+        callbacks.onRelationship = [&](EntityRelationship& rel) { streamed.relationships.push_back(std::move(rel)); };
+        callbacks.onNote = [&](const std::string& key, const std::string& text) { streamed.notes[key] = text; };
+        callbacks.onTitle = [&](const std::string& title) { streamed.title = title; };
+        PUMLEntityStreamParser stream(callbacks);
+
+        for (size_t chunkSize : {size_t(1), size_t(7), size_t(100), content.size()}) {
+            streamed = PUMLEntityDiagramResult();
+            stream.reset();
+            bool bFed = true;
+            for (size_t pos = 0; pos < content.size(); pos += chunkSize) {
+                bFed = bFed && stream.feed(std::string_view(content).substr(pos, chunkSize));
+            }
+            check(bFed && stream.finish() && describe(streamed) == expected,
+                  "chunks of " + std::to_string(chunkSize) + " bytes give the parseContent() model");
+        }
+
+        streamed = PUMLEntityDiagramResult();
+        stream.reset();
+        std::istringstream in(content);
+        check(stream.parseStream(in, 13) && describe(streamed) == expected, "parseStream() gives the parseContent() model");
+        check(stream.getLineCount() == static_cast<size_t>(std::count(content.begin(), content.end(), '\n')),
+              "complete lines are counted");
+
+        // No trailing newline, entity left open at the end
+        streamed = PUMLEntityDiagramResult();
+        stream.reset();
+        std::string unterminated = "@startuml\nentity Last {\n    * id : int <PK>";
+        check(stream.feed(unterminated) && streamed.entities.empty() && stream.finish() && streamed.entities.size() == 1 &&
+              describe(streamed) == describe(PUMLEntityParser().parseContent(unterminated)),
+              "finish() parses the last line and hands over an open entity");
+    }
+
+    void testExports() {
+        TestSupport::section("Diagram exports");
+        PUMLClassParser classParser;
+        PUMLClassDiagramResult classes = classParser.parseFile("examples/sample_class_diagram.puml");
+        std::string classJson = classParser.exportToJson();
+        nlohmann::json classDoc = nlohmann::json::parse(classJson);
+        check(classDoc.dump(2) == classJson && classDoc.dump() == classParser.exportToJson(false),
+              "class diagram JSON is laid out as nlohmann::json::dump()");
+        size_t attributes = 0;
+        size_t exportedAttributes = 0;
+        for (const auto& umlClass : classes.classes) attributes += umlClass.attributes.size();
+        for (const auto& umlClass : classDoc["classes"]) exportedAttributes += umlClass["attributes"].size();
+        check(classDoc["classes"].size() == classes.classes.size() && exportedAttributes == attributes &&
+              classDoc["relationships"].size() == classes.relationships.size(), "class diagram JSON holds the whole model");
+
+        std::ostringstream classStream;
+        check(classParser.exportToJson(classStream) && classStream.str() == classJson, "stream export equals string export");
+        std::ostringstream xmlStream;
+        check(classParser.exportToXML(xmlStream) && xmlStream.str() == classParser.exportToXML(), "XML stream equals string");
+
+        PUMLEntityParser entityParser;
+        PUMLEntityDiagramResult entities = entityParser.parseContent(
+            "@startuml\n"
+            "title Orders & \"Items\" <draft>\n"
+            "entity Order {\n"
+            "    * id : int <PK>\n"
+            "    note : varchar(10) = 'a<b>&c'\n"
+            "}\n"
+            "entity Item {\n"
+            "    * id : int <PK>\n"
+            "    + order_id : int <FK>\n"
+            "}\n"
+            "Order ||--o{ Item : contains\n"
+            "@enduml\n");
+        nlohmann::json entityDoc = nlohmann::json::parse(entityParser.exportToJson());
+        check(entityDoc["title"] == entities.title && entityDoc["entities"].size() == 2 &&
+              entityDoc["entities"][1]["fields"].size() == 2 && entityDoc["relationships"].size() == 1,
+              "entity diagram JSON holds the whole model");
+        check(entityDoc.dump(2) == entityParser.exportToJson(), "entity JSON is laid out as nlohmann::json::dump(2)");
+
+        std::string xml = entityParser.exportToXML();
+        check(xml.find("Orders &amp; &quot;Items&quot; &lt;draft&gt;") != std::string::npos &&
+              xml.find("<draft>") == std::string::npos, "XML text is escaped");
+        check(xml.find("<?xml") == 0 && std::count(xml.begin(), xml.end(), '<') == std::count(xml.begin(), xml.end(), '>'),
+              "XML document is balanced");
+    }
+
+    void testDDL() {
+        TestSupport::section("DDL generation");
+        PUMLEntityParser parser;
+        parser.parseContent("@startuml\n"
+                            "entity Item {\n  * id : int <PK>\n  + order_id : int <FK>\n}\n"
+                            "entity Order {\n  * id : int <PK>\n  + item_id : int <FK>\n}\n"
+                            "entity Customer {\n  * id : int <PK>\n}\n"
+                            "Customer ||--o{ Order\n"
+                            "Order ||--o{ Item\n"
+                            "Item ||--o{ Order\n"
+                            "@enduml\n");
+        DDLOptions options;
+        std::string ddl = parser.exportToDDL(options);
+        size_t customer = ddl.find("CREATE TABLE Customer");
+        size_t order = ddl.find("CREATE TABLE Order");
+        check(customer != std::string::npos && order != std::string::npos && customer < order,
+              "referenced tables are created first");
+        size_t alter = ddl.find("ALTER TABLE Item\n    ADD CONSTRAINT fk_Item_Order FOREIGN KEY");
+        check(alter != std::string::npos && alter > order, "a foreign key cycle is closed by ALTER TABLE after both tables");
+        check(ddl.find("CREATE INDEX idx_Item_order_id ON Item (order_id);") != std::string::npos,
+              "foreign key columns are indexed");
+
+        options.dialect = SQLDialect::PostgreSQL;
+        std::string postgres = parser.exportToDDL(options);
+        check(postgres.find("CREATE TABLE \"Order\" (\n    \"id\" INTEGER PRIMARY KEY") != std::string::npos,
+              "PostgreSQL quotes names and maps types");
+        options.dialect = SQLDialect::MySQL;
+        check(parser.exportToDDL(options).find("`Order`") != std::string::npos, "MySQL quotes with backticks");
+        check(parser.exportToDDL("postgres") == postgres, "dialect names are accepted by exportToDDL()");
+
+        SQLDialect dialect;
+        check(PUMLEntityParser::dialectFromString("MSSQL", dialect) && dialect == SQLDialect::SQLServer &&
+              PUMLEntityParser::dialectFromString("mariadb", dialect) && dialect == SQLDialect::MySQL &&
+              !PUMLEntityParser::dialectFromString("oracle", dialect), "dialectFromString() aliases");
+
+        options.dialect = SQLDialect::PostgreSQL;
+        options.threadCount = 3;
+        check(parser.exportToDDL(options) == postgres, "threaded generation equals serial generation");
+        std::ostringstream out;
+        check(parser.exportToDDL(out, options) && out.str() == postgres, "stream export equals string export");
+
+        std::vector<std::string> tables;
+        parser.exportToDDL(options, [&](const DDLStatement& statement) {
+            tables.push_back(statement.table);
+            return tables.size() < 2;
+        });
+        check(tables == std::vector<std::string>({"Customer", "Item"}), "the sink gets tables in order and can stop");
+
+        options.bForeignKeys = false;
+        options.bIndexes = false;
+        std::string plain = parser.exportToDDL(options);
+        check(plain.find("FOREIGN KEY") == std::string::npos && plain.find("ALTER TABLE") == std::string::npos &&
+              plain.find("CREATE INDEX") == std::string::npos, "foreign keys and indexes can be left out");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "PlantUML parser checks" << std::endl;
+    testLookups();
+    testClassLines();
+    testBatch();
+    testStreamParser();
+    testExports();
+    testDDL();
+    return TestSupport::finish();
+}
@@ -0,0 +1,230 @@
+// Behavioural checks of ResultDiff (run from the repository root by "make test")
+#include "../include/ResultDiff.h"
+#include "../include/third_party/json.hpp"
+#include "TestSupport.h"
+#include <sstream>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    const char* const apiBefore =
+        "class Widget : public Base {\n"
+        "public:\n"
+        "    int width;\n"
+        "    int height=1;\n"
+        "    static int count;\n"
+        "    void draw(int x);\n"
+        "    void resize(int w, int h);\n"
+        "    int area() const;\n"
+        "};\n"
+        "class Removed {\n"
+        "public:\n"
+        "    int r;\n"
+        "};\n";
+
+    const char* const apiAfter =
+        "class Widget : public Base {\n"
+        "public:\n"
+        "    long width;\n"
+        "    int height=2;\n"
+        "    static int count;\n"
+        "    static int extra;\n"
+        "    int depth;\n"
+        "    void draw(int x);\n"
+        "    void resize(int w);\n"
+        "    int area() const;\n"
+        "    virtual void paint();\n"
+        "    void helper();\n"
+        "};\n"
+        "class Added {\n"
+        "public:\n"
+        "    int a;\n"
+        "};\n";
+
+    const char* const unchanged = "class Same {\npublic:\n    int a;\n    void f();\n};\n";
+
+    void writeTrees(const TestSupport::TempDirectory& tree) {
+        tree.write("before/same.h", unchanged);
+        tree.write("before/gone.h", "class Gone {\n    int x;\n};\n");
+        tree.write("before/api.h", apiBefore);
+        tree.write("after/same.h", unchanged);
+        tree.write("after/fresh.h", "class Fresh {\n    int y;\n};\n");
+        tree.write("after/api.h", apiAfter);
+    }
+
+    const DiffEntry* findEntry(const ResultDiffReport& report, DiffKind kind, DiffEntity entity, const std::string& name) {
+        for (const auto& entry : report.entries) {
+            if (entry.kind == kind && entry.entity == entity && entry.name == name) return &entry;
+        }
+        return nullptr;
+    }
+
+    bool hasEntry(const ResultDiffReport& report, DiffKind kind, DiffEntity entity, const std::string& name,
+                  bool bBreaking) {
+        const DiffEntry* entry = findEntry(report, kind, entity, name);
+        return entry != nullptr && entry->bBreaking == bBreaking;
+    }
+
+    void testEntries() {
+        TestSupport::section("Entries");
+        TestSupport::TempDirectory tree("diff");
+        writeTrees(tree);
+        SourceExplorer beforeExplorer, afterExplorer;
+        const SourceExplorerResult& before = beforeExplorer.explore(tree.path("before"), SourceExplorerOptions());
+        const SourceExplorerResult& after = afterExplorer.explore(tree.path("after"), SourceExplorerOptions());
+
+        ResultDiffOptions options;
+        options.beforeRoot = tree.path("before");
+        options.afterRoot = tree.path("after");
+        ResultDiffReport report = ResultDiff::compare(before, after, options);
+        check(report.success && report.filesCompared == 2, "files are matched by relative path");
+
+        check(hasEntry(report, DiffKind::Removed, DiffEntity::File, "gone.h", true) &&
+              hasEntry(report, DiffKind::Added, DiffEntity::File, "fresh.h", false), "added and removed files");
+        check(hasEntry(report, DiffKind::Removed, DiffEntity::Class, "Removed", true) &&
+              hasEntry(report, DiffKind::Added, DiffEntity::Class, "Added", false), "added and removed classes");
+
+        const DiffEntry* width = findEntry(report, DiffKind::Changed, DiffEntity::Member, "width");
+        check(width != nullptr && width->bBreaking && width->scope == "Widget" && width->file == "api.h" &&
+              width->before.find("int width") != std::string::npos && width->after.find("long width") != std::string::npos,
+              "a member type change is breaking, with both declarations");
+        check(hasEntry(report, DiffKind::Changed, DiffEntity::Member, "height", false),
+              "a default value change is not breaking");
+        check(hasEntry(report, DiffKind::Added, DiffEntity::Member, "depth", true) &&
+              hasEntry(report, DiffKind::Added, DiffEntity::Member, "extra", false),
+              "added data members break the layout, static ones do not");
+        check(!findEntry(report, DiffKind::Changed, DiffEntity::Member, "count"), "unchanged members are not reported");
+
+        check(hasEntry(report, DiffKind::Removed, DiffEntity::Method, "resize(int, int)", true) &&
+              hasEntry(report, DiffKind::Added, DiffEntity::Method, "resize(int)", false),
+              "methods are matched by signature");
+        check(hasEntry(report, DiffKind::Added, DiffEntity::Method, "paint()", true) &&
+              hasEntry(report, DiffKind::Added, DiffEntity::Method, "helper()", false),
+              "added virtual methods are breaking, others are not");
+        check(!findEntry(report, DiffKind::Changed, DiffEntity::Method, "area() const") &&
+              !findEntry(report, DiffKind::Changed, DiffEntity::Method, "draw(int)"), "unchanged methods are not reported");
+
+        size_t added = 0, removed = 0, changed = 0, breaking = 0;
+        bool bOrdered = true;
+        for (size_t i = 0; i < report.entries.size(); ++i) {
+            const DiffEntry& entry = report.entries[i];
+            added += entry.kind == DiffKind::Added;
+            removed += entry.kind == DiffKind::Removed;
+            changed += entry.kind == DiffKind::Changed;
+            breaking += entry.bBreaking;
+            bOrdered = bOrdered && (i == 0 || report.entries[i - 1].file <= entry.file);
+            bOrdered = bOrdered && entry.file != "same.h";
+        }
+        check(report.added == added && report.removed == removed && report.changed == changed &&
+              report.breaking == breaking && report.entries.size() == 12, "counters match the entries");
+        check(bOrdered, "entries are sorted by file and unchanged files have none");
+
+        std::ostringstream out;
+        check(ResultDiff::writeJson(report, out), "report writes as JSON");
+        nlohmann::json document = nlohmann::json::parse(out.str());
+        check(document["entries"].size() == report.entries.size() && document["added"] == report.added &&
+              document["entries"][0]["kind"].is_string() && document["entries"][0]["entity"].is_string(),
+              "JSON report holds every entry");
+
+        ResultDiffReport same = ResultDiff::compare(before, before);
+        check(same.success && same.entries.empty() && same.filesCompared == before.analyses.size(),
+              "a result compared with itself has no entries");
+
+        ResultDiffReport reversed = ResultDiff::compare(after, before, ResultDiffOptions());
+        check(reversed.success && reversed.filesCompared == 0 &&
+              reversed.added == before.analyses.size() && reversed.removed == after.analyses.size(),
+              "without roots, files of different trees do not match");
+
+        SourceExplorerResult failed;
+        failed.errorMessage = "walk failed";
+        ResultDiffReport rejected = ResultDiff::compare(before, failed);
+        check(!rejected.success && rejected.errorMessage.find("walk failed") != std::string::npos,
+              "an unsuccessful result is rejected");
+    }
+
+    // A result of one file holding the given enums, built by hand so the values are set
+    SourceExplorerResult enumResult(const std::vector<EnumInfo>& enums) {
+        auto parsed = std::make_shared<ParseResult>();
+        parsed->success = true;
+        parsed->enums = enums;
+        SourceExplorerResult result;
+        result.success = true;
+        result.analyses.emplace_back();
+        result.analyses.back().path = "enums.h";
+        result.analyses.back().success = true;
+        result.analyses.back().parseResult = parsed;
+        return result;
+    }
+
+    EnumInfo makeEnum(const std::string& name, const std::vector<std::string>& names) {
+        EnumInfo info;
+        info.name = name;
+        for (size_t i = 0; i < names.size(); ++i) info.values.emplace_back(names[i], std::to_string(i));
+        return info;
+    }
+
+    void testEnums() {
+        TestSupport::section("Enums");
+        SourceExplorerResult before = enumResult({makeEnum("Color", {"Red", "Green"}), makeEnum("Mode", {"First", "Second"}),
+                                                  makeEnum("Gone", {"A"})});
+        EnumInfo scoped = makeEnum("Mode", {"First", "Second"});
+        scoped.isClass = true;
+        SourceExplorerResult after = enumResult({makeEnum("Color", {"Red", "Green", "Blue"}), scoped,
+                                                 makeEnum("Fresh", {"B"})});
+        ResultDiffReport report = ResultDiff::compare(before, after);
+        check(report.success && hasEntry(report, DiffKind::Changed, DiffEntity::Enum, "Color", false),
+              "appended enum values are compatible");
+        check(hasEntry(report, DiffKind::Changed, DiffEntity::Enum, "Mode", true), "an enum becoming scoped is breaking");
+        check(hasEntry(report, DiffKind::Removed, DiffEntity::Enum, "Gone", true) &&
+              hasEntry(report, DiffKind::Added, DiffEntity::Enum, "Fresh", false) && report.entries.size() == 4,
+              "added and removed enums");
+
+        SourceExplorerResult reordered = enumResult({makeEnum("Color", {"Green", "Red"}), makeEnum("Mode", {"First", "Second"}),
+                                                     makeEnum("Gone", {"A"})});
+        ResultDiffReport moved = ResultDiff::compare(before, reordered);
+        check(moved.entries.size() == 1 && hasEntry(moved, DiffKind::Changed, DiffEntity::Enum, "Color", true),
+              "reordered enum values are breaking");
+    }
+
+    void testFingerprintSkip() {
+        TestSupport::section("Fingerprint skip");
+        TestSupport::TempDirectory tree("diff_cache");
+        writeTrees(tree);
+        AnalysisCache cache;
+        SourceExplorerOptions options;
+        options.cache = &cache;
+        options.bHashContents = true;
+
+        SourceExplorer first, second;
+        const SourceExplorerResult& before = first.explore(tree.path("before"), options);
+        const SourceExplorerResult& again = second.explore(tree.path("before"), options);
+        ResultDiffReport report = ResultDiff::compare(before, again);
+        check(report.success && report.entries.empty() && report.filesSkipped == report.filesCompared &&
+              report.filesCompared == before.analyses.size(), "files reused from the cache are skipped");
+
+        ResultDiffOptions full;
+        full.bSkipByFingerprint = false;
+        ResultDiffReport compared = ResultDiff::compare(before, again, full);
+        check(compared.success && compared.entries.empty() && compared.filesSkipped == 0,
+              "with the skip off they are compared, with the same outcome");
+
+        tree.write("before/api.h", apiAfter);
+        SourceExplorer third;
+        const SourceExplorerResult& edited = third.explore(tree.path("before"), options);
+        ResultDiffReport changed = ResultDiff::compare(before, edited);
+        check(changed.success && changed.filesSkipped == changed.filesCompared - 1 &&
+              findEntry(changed, DiffKind::Changed, DiffEntity::Member, "width") != nullptr,
+              "an edited file is compared even with a cache");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "ResultDiff checks" << std::endl;
+    testEntries();
+    testEnums();
+    testFingerprintSkip();
+    return TestSupport::finish();
+}
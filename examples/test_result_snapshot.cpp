@@ -0,0 +1,196 @@
+// Behavioural checks of ResultSnapshot (run from the repository root by "make test")
+#include "../include/ResultSnapshot.h"
+#include "TestSupport.h"
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    void testExplorerSnapshot() {
+        TestSupport::section("SourceExplorer snapshots");
+        TestSupport::TempDirectory tree("snapshot");
+        tree.write("a.h", "#include <vector>\n"
+                          "template <typename T>\n"
+                          "class Box : public Base {\n"
+                          "public:\n"
+                          "    static const int limit = 4;\n"
+                          "    virtual T get(const T& fallback, int* count) const = 0;\n"
+                          "};\n"
+                          "enum class Mode { On = 1, Off };\n");
+        tree.write("b/c.h", "struct Point {\n    double x;\n    double y;\n};\n");
+        tree.write("b/d.h", "this is not a header at all {{{\n");
+
+        SourceExplorer explorer;
+        explorer.explore(tree.path(), SourceExplorerOptions());
+        std::string expected = explorer.exportToJson();
+
+        ResultSnapshot snapshot;
+        snapshot.build(explorer.getLastResult());
+        check(snapshot.kind() == SnapshotKind::SourceExplorer && snapshot.files().size() == 3, "result is snapshotted");
+        check(snapshot.exportToJson() == expected, "built snapshot exports the explorer's JSON");
+
+        std::string file = tree.path("result.snap");
+        check(snapshot.save(file), "snapshot saves");
+        ResultSnapshot loaded;
+        check(loaded.load(file) && loaded.exportToJson() == expected && loaded.exportToJson(false) == explorer.exportToJson(false),
+              "loaded snapshot exports the explorer's JSON");
+
+        SourceExplorerResult restored;
+        check(loaded.toResult(restored) && restored.analyses.size() == 3 &&
+              restored.filesProcessed == explorer.getLastResult().filesProcessed, "toResult() restores the analyses");
+        std::shared_ptr<const ParseResult> parse = loaded.toParseResult(0);
+        check(parse != nullptr && parse->classes.size() == 1 && parse->classes[0].isTemplate &&
+              parse->classes[0].methods.size() == 1 && parse->classes[0].methods[0].parameters.size() == 2 &&
+              parse->enums.size() == 1, "toParseResult() restores one file");
+
+        std::string jsonFile = tree.path("result.json");
+        explorer.exportToJsonFile(jsonFile);
+        ResultSnapshot imported;
+        check(imported.importJson(jsonFile) && imported.exportToJson() == expected, "importJson() reads an export back");
+
+        PUMLClassDiagramResult wrongKind;
+        check(!loaded.toResult(wrongKind), "toResult() of another kind fails");
+    }
+
+    void testNamespaceSnapshot() {
+        TestSupport::section("Namespaces");
+        TestSupport::TempDirectory tree("snapshot_namespaces");
+        tree.write("ns.h", "namespace outer {\n"
+                           "    class First {\n"
+                           "        int x;\n"
+                           "    };\n"
+                           "    namespace inner {\n"
+                           "        struct Deep {\n"
+                           "            int y;\n"
+                           "        };\n"
+                           "    }\n"
+                           "    namespace {\n"
+                           "        class Hidden {\n"
+                           "            int z;\n"
+                           "        };\n"
+                           "    }\n"
+                           "    class Second {\n"
+                           "        int w;\n"
+                           "    };\n"
+                           "}\n"
+                           "namespace other {\n"
+                           "    class Third {\n"
+                           "        int v;\n"
+                           "    };\n"
+                           "}\n");
+        tree.write("plain.h", "class Plain {\n    int u;\n};\n");
+
+        SourceExplorer explorer;
+        explorer.explore(tree.path(), SourceExplorerOptions());
+        std::string expected = explorer.exportToJson();
+
+        ResultSnapshot snapshot;
+        snapshot.build(explorer.getLastResult());
+        std::string file = tree.path("ns.snap");
+        ResultSnapshot loaded;
+        check(snapshot.save(file) && loaded.load(file) && loaded.namespaces().size() == 4, "namespaces are stored");
+        check(loaded.exportToJson() == expected && loaded.exportToJson(false) == explorer.exportToJson(false),
+              "loaded snapshot exports the namespaces of the explorer's JSON");
+
+        SourceExplorerResult restored;
+        ResultSnapshot rebuilt;
+        check(loaded.toResult(restored), "toResult() succeeds");
+        rebuilt.build(restored);
+        check(rebuilt.exportToJson() == expected, "toResult() keeps the namespace tree");
+
+        std::shared_ptr<const ParseResult> parse;
+        for (size_t i = 0; i < loaded.files().size(); ++i) {
+            if (loaded.str(loaded.files()[i].filename) == "ns.h") parse = loaded.toParseResult(i);
+        }
+        bool bTree = parse != nullptr && parse->namespaces.size() == 2;
+        if (bTree) {
+            const NamespaceInfo& outer = parse->namespaces[0];
+            bTree = outer.name == "outer" && outer.classes.size() == 2 && outer.classes[1].fullName == "outer::Second" &&
+                    outer.classes[1].members.size() == 1 && outer.nestedNamespaces.size() == 2 &&
+                    outer.nestedNamespaces[0].name == "inner" && outer.nestedNamespaces[0].classes.size() == 1 &&
+                    outer.nestedNamespaces[1].name.empty() && parse->namespaces[1].name == "other";
+        }
+        check(bTree, "toParseResult() rebuilds nested and anonymous namespaces with their classes");
+    }
+
+    void testDiagramSnapshots() {
+        TestSupport::section("Diagram snapshots");
+        TestSupport::TempDirectory dir("snapshot_diagrams");
+
+        PUMLClassParser classParser;
+        PUMLClassDiagramResult classes = classParser.parseFile("examples/sample_class_diagram.puml");
+        ResultSnapshot classSnapshot;
+        classSnapshot.build(classes);
+        check(classSnapshot.save(dir.path("classes.snap")), "class diagram snapshot saves");
+        ResultSnapshot loadedClasses;
+        PUMLClassDiagramResult restoredClasses;
+        check(loadedClasses.load(dir.path("classes.snap")) && loadedClasses.kind() == SnapshotKind::ClassDiagram &&
+              loadedClasses.toResult(restoredClasses), "class diagram snapshot loads");
+
+        bool bSameClasses = restoredClasses.classes.size() == classes.classes.size();
+        for (size_t i = 0; bSameClasses && i < classes.classes.size(); ++i) {
+            const UMLClass& a = classes.classes[i];
+            const UMLClass& b = restoredClasses.classes[i];
+            bSameClasses = a.name == b.name && a.isAbstract == b.isAbstract && a.isInterface == b.isInterface &&
+                           a.attributes.size() == b.attributes.size() && a.methods.size() == b.methods.size();
+            for (size_t m = 0; bSameClasses && m < a.methods.size(); ++m) {
+                bSameClasses = a.methods[m].name == b.methods[m].name && a.methods[m].returnType == b.methods[m].returnType &&
+                               a.methods[m].parameters.size() == b.methods[m].parameters.size();
+            }
+        }
+        check(bSameClasses && restoredClasses.title == classes.title &&
+              restoredClasses.relationships.size() == classes.relationships.size() &&
+              restoredClasses.notes == classes.notes, "class diagram round trip");
+
+        PUMLEntityParser entityParser;
+        PUMLEntityDiagramResult entities = entityParser.parseFile("examples/sample_entity_diagram.puml");
+        ResultSnapshot entitySnapshot;
+        entitySnapshot.build(entities);
+        check(entitySnapshot.save(dir.path("entities.snap")), "entity diagram snapshot saves");
+        ResultSnapshot loadedEntities;
+        PUMLEntityDiagramResult restoredEntities;
+        check(loadedEntities.load(dir.path("entities.snap")) && loadedEntities.toResult(restoredEntities),
+              "entity diagram snapshot loads");
+        bool bSameFields = restoredEntities.entities.size() == entities.entities.size();
+        for (size_t i = 0; bSameFields && i < entities.entities.size(); ++i) {
+            const Entity& a = entities.entities[i];
+            const Entity& b = restoredEntities.entities[i];
+            bSameFields = a.name == b.name && a.fields.size() == b.fields.size();
+            for (size_t f = 0; bSameFields && f < a.fields.size(); ++f) {
+                bSameFields = a.fields[f].name == b.fields[f].name && a.fields[f].type == b.fields[f].type &&
+                              a.fields[f].isPrimaryKey == b.fields[f].isPrimaryKey &&
+                              a.fields[f].constraints == b.fields[f].constraints;
+            }
+        }
+        check(bSameFields && restoredEntities.relationships.size() == entities.relationships.size(),
+              "entity diagram round trip");
+    }
+
+    void testRejectedFiles() {
+        TestSupport::section("Rejected files");
+        TestSupport::TempDirectory dir("snapshot_rejected");
+        ResultSnapshot snapshot;
+        check(!snapshot.load(dir.write("garbage.snap", "definitely not a snapshot")) && !snapshot.getErrorMessage().empty(),
+              "a file that is not a snapshot is rejected");
+
+        PUMLEntityParser parser;
+        ResultSnapshot valid;
+        valid.build(parser.parseFile("examples/sample_entity_diagram.puml"));
+        valid.save(dir.path("valid.snap"));
+        std::string bytes = TestSupport::readFile(dir.path("valid.snap"));
+        check(!snapshot.load(dir.write("truncated.snap", bytes.substr(0, bytes.size() / 2))),
+              "a truncated snapshot is rejected");
+        check(snapshot.kind() == SnapshotKind::None, "a failed load leaves the snapshot empty");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "ResultSnapshot checks" << std::endl;
+    testExplorerSnapshot();
+    testNamespaceSnapshot();
+    testDiagramSnapshots();
+    testRejectedFiles();
+    return TestSupport::finish();
+}
@@ -0,0 +1,267 @@
+// Behavioural checks of SourceExplorer (run from the repository root by "make test")
+#include "../include/SourceExplorer.h"
+#include "../include/JsonWriter.h"
+#include "../include/third_party/json.hpp"
+#include "TestSupport.h"
+#include <sstream>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    SourceExplorerOptions optionsWithThreads(unsigned int threadCount) {
+        SourceExplorerOptions options;
+        options.threadCount = threadCount;
+        return options;
+    }
+
+    SourceExplorerOptions pipelineOptions(unsigned int threadCount, unsigned int ioThreads, size_t readQueueDepth,
+                                          size_t outputQueueDepth) {
+        SourceExplorerOptions options = optionsWithThreads(threadCount);
+        options.pipeline.bEnabled = true;
+        options.pipeline.ioThreads = ioThreads;
+        options.pipeline.readQueueDepth = readQueueDepth;
+        options.pipeline.outputQueueDepth = outputQueueDepth;
+        return options;
+    }
+
+    std::string exploreToString(const std::string& basePath, const SourceExplorerOptions& options) {
+        SourceExplorer explorer;
+        explorer.explore(basePath, options);
+        return explorer.exportToJson();
+    }
+
+    // The headers of include/ and examples/, copied a few times into nested directories
+    void writeTree(const TestSupport::TempDirectory& tree) {
+        const char* sources[] = {"examples/sample_header.h", "include/SimpleHeaderParser.h",
+                                 "include/SourceExplorer.h", "include/PUMLEntityParser.h"};
+        for (int copy = 0; copy < 6; ++copy) {
+            std::string dir = "copy" + std::to_string(copy) + (copy % 2 ? "/nested/" : "/");
+            for (const char* source : sources) {
+                std::string name = std::filesystem::path(source).filename().string();
+                tree.write(dir + name, TestSupport::readFile(source));
+            }
+        }
+    }
+
+    void testThreadedExplore() {
+        TestSupport::section("Threaded exploration");
+        TestSupport::TempDirectory tree("explore");
+        writeTree(tree);
+
+        SourceExplorer serial;
+        const SourceExplorerResult& serialResult = serial.explore(tree.path(), optionsWithThreads(1));
+        check(serialResult.success && serialResult.filesProcessed == 24, "serial exploration parses all 24 headers");
+
+        std::string serialJson = serial.exportToJson();
+        for (unsigned int threads : {2u, 4u, 7u}) {
+            check(exploreToString(tree.path(), optionsWithThreads(threads)) == serialJson,
+                  std::to_string(threads) + " threads give the same export as one thread");
+        }
+
+        SourceExplorer threaded;
+        const SourceExplorerResult& threadedResult = threaded.explore(tree.path(), optionsWithThreads(4));
+        bool bSorted = true;
+        for (size_t i = 1; i < threadedResult.analyses.size(); ++i) {
+            bSorted = bSorted && threadedResult.analyses[i - 1].path < threadedResult.analyses[i].path;
+        }
+        check(bSorted, "threaded analyses are sorted by path");
+    }
+
+    void testJsonExport() {
+        TestSupport::section("JSON export");
+        TestSupport::TempDirectory tree("json");
+        writeTree(tree);
+        tree.write("odd/quotes\"and\\slashes.h", "// \xC3\xA9t\xC3\xA9 \t\n"
+                                                  "class Escaped {\npublic:\n    const char* text = \"a\\tb\";\n};\n");
+
+        SourceExplorer explorer;
+        explorer.explore(tree.path(), SourceExplorerOptions());
+        std::string pretty = explorer.exportToJson();
+        std::string compact = explorer.exportToJson(false);
+
+        std::ostringstream streamed;
+        check(explorer.exportToJson(streamed) && streamed.str() == pretty, "stream export equals the string export");
+        std::string fileName = tree.path("export.json");
+        check(explorer.exportToJsonFile(fileName) && TestSupport::readFile(fileName) == pretty,
+              "file export equals the string export");
+
+        std::ostringstream explored;
+        SourceExplorer streaming;
+        streaming.exploreToJson(tree.path(), explored, SourceExplorerOptions());
+        check(explored.str() == pretty, "exploreToJson() equals explore() then exportToJson()");
+
+        // The streamed writer must lay documents out exactly as nlohmann::json::dump did
+        nlohmann::json document = nlohmann::json::parse(pretty);
+        check(document.dump(2) == pretty, "pretty export is laid out as nlohmann::json::dump(2)");
+        check(document.dump() == compact, "compact export is laid out as nlohmann::json::dump()");
+        check(document["files"].size() == 25 && document["filesProcessed"] == 25, "every file is exported");
+    }
+
+    void testInvalidUtf8() {
+        TestSupport::section("Invalid UTF-8");
+        std::string written;
+        {
+            JsonWriter writer(written, false);
+            writer.value(std::string("ok \xC3\xA9 \xF0\x9F\x98\x80 latin \xE9 cut \xE2\x82 stray \x80\xFF surrogate \xED\xA0\x80"));
+        }
+        check(written == "\"ok \xC3\xA9 \xF0\x9F\x98\x80 latin \\ufffd cut \\ufffd stray \\ufffd\\ufffd surrogate "
+                         "\\ufffd\\ufffd\\ufffd\"", "valid sequences are kept, each invalid one becomes \\ufffd");
+
+        TestSupport::TempDirectory tree("utf8");
+        tree.write("latin1.h", "class Latin {\npublic:\n    const char* name = \"caf\xE9\";\n};\n");
+        SourceExplorer explorer;
+        explorer.explore(tree.path(), SourceExplorerOptions());
+        std::string exported = explorer.exportToJson();
+        bool bParsed = true;
+        try {
+            nlohmann::json::parse(exported);
+        } catch (const std::exception&) {
+            bParsed = false;
+        }
+        check(bParsed && exported.find("caf\\ufffd") != std::string::npos, "a Latin-1 literal is exported as valid JSON");
+    }
+
+    void testVisitor() {
+        TestSupport::section("Visitor exploration");
+        TestSupport::TempDirectory tree("visitor");
+        writeTree(tree);
+
+        SourceExplorer collecting;
+        const SourceExplorerResult& collected = collecting.explore(tree.path(), optionsWithThreads(3));
+
+        std::vector<std::string> visitedPaths;
+        bool bSameResults = true;
+        size_t index = 0;
+        SourceExplorer visiting;
+        const SourceExplorerResult& visited = visiting.explore(tree.path(), optionsWithThreads(3),
+            [&](SourceFileAnalysis& analysis) {
+                visitedPaths.push_back(analysis.path);
+                bSameResults = bSameResults && index < collected.analyses.size() &&
+                               analysis.parseResult->classes.size() == collected.analyses[index].parseResult->classes.size();
+                index++;
+                return true;
+            });
+        std::vector<std::string> collectedPaths;
+        for (const auto& analysis : collected.analyses) collectedPaths.push_back(analysis.path);
+        check(visitedPaths == collectedPaths && bSameResults, "visitor sees the collected analyses, in path order");
+        check(visited.analyses.empty() && visited.filesProcessed == collected.filesProcessed,
+              "visitor result only carries the counters");
+
+        size_t calls = 0;
+        visiting.explore(tree.path(), optionsWithThreads(3), [&](SourceFileAnalysis&) { return ++calls < 3; });
+        check(calls == 3, "returning false stops the exploration");
+    }
+
+    void testPipeline() {
+        TestSupport::section("Pipelined exploration");
+        TestSupport::TempDirectory tree("pipeline");
+        writeTree(tree);
+        std::string expected = exploreToString(tree.path(), optionsWithThreads(1));
+
+        check(exploreToString(tree.path(), pipelineOptions(4, 0, 0, 0)) == expected, "default queues give the serial export");
+        check(exploreToString(tree.path(), pipelineOptions(1, 1, 1, 1)) == expected, "queues of one file");
+        check(exploreToString(tree.path(), pipelineOptions(3, 5, 2, 3)) == expected, "more readers than queue room");
+        check(exploreToString(tree.path(), pipelineOptions(2, 64, 64, 64)) == expected, "queues longer than the tree");
+
+        std::ostringstream streamed;
+        SourceExplorer streaming;
+        streaming.exploreToJson(tree.path(), streamed, pipelineOptions(4, 2, 3, 4));
+        check(streamed.str() == expected, "exploreToJson() through the pipeline");
+
+        AnalysisCache cache;
+        SourceExplorerOptions cached = pipelineOptions(3, 2, 2, 4);
+        cached.cache = &cache;
+        SourceExplorer first;
+        first.explore(tree.path(), cached);
+        tree.write("copy0/SourceExplorer.h", "class Edited {\n    int x;\n};\n");
+        SourceExplorer second;
+        const SourceExplorerResult& again = second.explore(tree.path(), cached);
+        check(again.filesProcessed == 24 && again.filesFromCache == 23 &&
+              second.exportToJson() == exploreToString(tree.path(), optionsWithThreads(1)),
+              "cached files skip the read and the edited one is parsed");
+
+        size_t calls = 0;
+        SourceExplorer stopping;
+        const SourceExplorerResult& stopped = stopping.explore(tree.path(), pipelineOptions(2, 4, 2, 2),
+            [&](SourceFileAnalysis&) { return ++calls < 5; });
+        check(calls == 5 && stopped.filesProcessed == 5, "returning false stops the pipeline");
+
+        SourceExplorer empty;
+        TestSupport::TempDirectory nothing("pipeline_empty");
+        const SourceExplorerResult& none = empty.explore(nothing.path(), pipelineOptions(2, 0, 0, 0));
+        check(none.success && none.analyses.empty(), "an empty tree");
+    }
+
+    void testJsonImport() {
+        TestSupport::section("JSON import");
+        TestSupport::TempDirectory tree("import");
+        writeTree(tree);
+        tree.write("odd/quotes\"and\\slashes.h", "// \xC3\xA9t\xC3\xA9 \t\n"
+                                                  "class Escaped {\npublic:\n    const char* text = \"a\\tb\";\n};\n");
+
+        SourceExplorer explorer;
+        const SourceExplorerResult& explored = explorer.explore(tree.path(), SourceExplorerOptions());
+        std::string pretty = explorer.exportToJson();
+        std::string prettyFile = tree.path("pretty.json");
+        std::string compactFile = tree.path("compact.json");
+        explorer.exportToJsonFile(prettyFile);
+        explorer.exportToJsonFile(compactFile, false);
+
+        SourceExplorer importer;
+        const SourceExplorerResult& imported = importer.importFromJsonFile(prettyFile);
+        check(imported.success && imported.analyses.size() == explored.analyses.size() &&
+              imported.filesProcessed == explored.filesProcessed && imported.filesWithErrors == explored.filesWithErrors,
+              "import restores the analyses and counters");
+        bool bParsed = true;
+        for (const auto& analysis : imported.analyses) bParsed = bParsed && analysis.parseResult != nullptr;
+        check(bParsed, "imported analyses carry a parse result");
+        check(importer.exportToJson() == pretty, "imported result exports as the original");
+        importer.importFromJsonFile(compactFile);
+        check(importer.exportToJson() == pretty, "compact export imports the same");
+
+        std::string streamedFile = tree.path("streamed.json");
+        {
+            std::ofstream out(streamedFile, std::ios::binary);
+            SourceExplorer streaming;
+            streaming.exploreToJson(tree.path(), out, SourceExplorerOptions());
+        }
+        importer.importFromJsonFile(streamedFile);
+        check(importer.exportToJson() == pretty, "exploreToJson() output imports the same");
+
+        std::vector<std::string> visitedPaths;
+        const SourceExplorerResult& visited = importer.importFromJsonFile(prettyFile, [&](SourceFileAnalysis& analysis) {
+            visitedPaths.push_back(analysis.path);
+            return true;
+        });
+        std::vector<std::string> exploredPaths;
+        for (const auto& analysis : explored.analyses) exploredPaths.push_back(analysis.path);
+        check(visited.success && visitedPaths == exploredPaths && visited.analyses.empty() &&
+              visited.filesProcessed == explored.filesProcessed, "visitor import sees every analysis, in file order");
+        size_t calls = 0;
+        importer.importFromJsonFile(prettyFile, [&](SourceFileAnalysis&) { return ++calls < 2; });
+        check(calls == 2, "returning false stops the import");
+
+        std::string truncatedFile = tree.write("truncated.json", pretty.substr(0, pretty.size() / 2));
+        const SourceExplorerResult& truncated = importer.importFromJsonFile(truncatedFile);
+        check(!truncated.success && !truncated.errorMessage.empty() && truncated.analyses.empty(),
+              "a truncated file is rejected with an empty result");
+        std::string wrongFile = tree.write("wrong.json", "[1, 2, 3]");
+        check(!importer.importFromJsonFile(wrongFile).success, "a document that is not an export is rejected");
+        check(!importer.importFromJsonFile(tree.path("missing.json")).success &&
+              !importer.getLastResult().errorMessage.empty(), "a missing file is an error");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "SourceExplorer checks" << std::endl;
+    testThreadedExplore();
+    testJsonExport();
+    testInvalidUtf8();
+    testVisitor();
+    testPipeline();
+    testJsonImport();
+    return TestSupport::finish();
+}
@@ -0,0 +1,188 @@
+// Behavioural checks of SourceServer (run from the repository root by "make test")
+#include "../include/SourceServer.h"
+#include "../include/third_party/json.hpp"
+#include "TestSupport.h"
+#include <thread>
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    nlohmann::json request(SourceServer& server, const std::string& line) {
+        return nlohmann::json::parse(server.handleRequest(line));
+    }
+
+    void testRequests() {
+        TestSupport::section("Requests");
+        TestSupport::TempDirectory tree("server");
+        tree.write("shapes.h", "#include <vector>\n"
+                               "class Shape {\n"
+                               "public:\n"
+                               "    virtual double area() const = 0;\n"
+                               "};\n"
+                               "class Circle : public Shape {\n"
+                               "public:\n"
+                               "    double area() const;\n"
+                               "};\n");
+
+        SourceServer server;
+        SourceServerOptions options;
+        options.endpoint = "-";
+        options.bPUML = false;
+        check(server.start(tree.path(), options), "server starts without a listener");
+
+        nlohmann::json status = request(server, "status");
+        check(status["ok"] == true && status["result"]["files"] == 1 && status["result"]["classes"] == 2,
+              "status counts the model");
+        check(status["result"]["internedStrings"] > 0 && status["result"]["internedBytes"] > 0,
+              "status reports the size of the global interner");
+        nlohmann::json circle = request(server, "class Circle");
+        check(circle["result"].size() == 1 && circle["result"][0]["bases"][0] == "Shape", "class request");
+        check(request(server, "derived Shape")["result"].size() == 1, "derived request");
+        check(request(server, "method area")["result"].size() == 2, "method request");
+        check(request(server, "includers vector")["result"].size() == 1, "includers request");
+        nlohmann::json unknown = request(server, "bogus");
+        check(unknown["ok"] == false && !unknown["error"].get<std::string>().empty(), "unknown requests are errors");
+
+        uint64_t generation = server.getStatus().generation;
+        tree.write("square.h", "class Square : public Shape {\n"
+                               "public:\n"
+                               "    double area() const;\n"
+                               "};\n");
+        server.refresh();
+        check(server.getStatus().generation > generation && request(server, "derived Shape")["result"].size() == 2,
+              "refresh() picks up a new header");
+
+        // Refreshes from several clients are all answered by the updater thread
+        std::vector<std::thread> clients;
+        for (int t = 0; t < 4; ++t) {
+            clients.emplace_back([&server, &tree, t]() {
+                tree.write("extra" + std::to_string(t) + ".h", "class Extra" + std::to_string(t) + " : public Shape {\n};\n");
+                server.refresh();
+                request(server, "refresh");
+            });
+        }
+        for (auto& client : clients) client.join();
+        check(server.getStatus().files == 6 && request(server, "derived Shape")["result"].size() == 6,
+              "concurrent refreshes see every new header");
+
+        server.stop();
+        check(!server.getStatus().running, "server stops");
+        generation = server.getStatus().generation;
+        server.refresh();
+        check(server.getStatus().generation == generation, "refresh() does nothing once stopped");
+    }
+
+    void testEndpoint() {
+        TestSupport::section("Endpoint");
+        TestSupport::TempDirectory tree("server_endpoint");
+        tree.write("a.h", "class A {\n    int x;\n};\n");
+        std::string endpoint = tree.path("server.sock");
+
+        SourceServerOptions options;
+        options.endpoint = endpoint;
+        options.bPUML = false;
+        SourceServer server;
+#ifndef _WIN32
+        // The socket must be private whatever the umask of the process
+        mode_t previousMask = ::umask(0);
+        bool bStarted = server.start(tree.path(), options);
+        ::umask(previousMask);
+        check(bStarted, "server listens on a socket");
+        struct stat info;
+        check(::stat(endpoint.c_str(), &info) == 0 && (info.st_mode & 0777) == 0600,
+              "socket file is only accessible to its owner");
+#else
+        check(server.start(tree.path(), options), "server listens on a pipe");
+#endif
+
+        std::string response;
+        check(SourceServer::query(endpoint, "class A", response) &&
+              nlohmann::json::parse(response)["result"].size() == 1, "query() reaches the server");
+
+        SourceServer second;
+        check(!second.start(tree.path(), options) && !second.getErrorMessage().empty(),
+              "a second server cannot take a live endpoint");
+
+        std::thread waiter([&server]() { server.wait(); });
+        check(SourceServer::query(endpoint, "shutdown", response), "shutdown request is answered");
+        waiter.join();
+        check(!server.getStatus().running && !SourceServer::query(endpoint, "status", response),
+              "server is gone after shutdown");
+#ifndef _WIN32
+        check(!std::filesystem::exists(endpoint), "socket file is removed");
+        tree.write("not_a_socket", "plain file");
+        options.endpoint = tree.path("not_a_socket");
+        SourceServer blocked;
+        check(!blocked.start(tree.path(), options), "an endpoint that is not a socket is refused");
+        check(blocked.getStatus().files == 0 && request(blocked, "status")["ok"] == false,
+              "a failed start leaves no model behind");
+
+        std::filesystem::create_directory(tree.path("shared"));
+        ::chmod(tree.path("shared").c_str(), 0777);
+        options.endpoint = tree.path("shared/server.sock");
+        check(!blocked.start(tree.path(), options) && !std::filesystem::exists(options.endpoint),
+              "a socket directory others may write to is refused");
+
+        options.endpoint = tree.path("private/server.sock");
+        check(blocked.start(tree.path(), options) && ::stat(tree.path("private").c_str(), &info) == 0 &&
+              (info.st_mode & 0777) == 0700, "a missing socket directory is created private");
+        blocked.stop();
+
+        std::filesystem::path defaultEndpoint = SourceServer::defaultEndpoint(tree.path());
+        check(defaultEndpoint.parent_path().filename() == "ufmtooling-" + std::to_string(::getuid()),
+              "the default socket is in a per-user directory");
+#endif
+    }
+
+    void testTruncatedFiles() {
+        TestSupport::section("Truncated files");
+        TestSupport::TempDirectory tree("server_truncate");
+        std::string big;
+        for (int i = 0; i < 20000; ++i) {
+            big += "class Big" + std::to_string(i) + " {\npublic:\n    int value() const;\n};\n";
+        }
+        std::string path = tree.write("big.h", big);
+
+        SourceServerOptions options;
+        options.endpoint = "-";
+        options.bPUML = false;
+        options.debounceMs = 0;
+        SourceServer server;
+        check(server.start(tree.path(), options), "server starts on a large header");
+
+        // Rewrite the header in place while the server reparses it: each rewrite truncates
+        // the file first, so reparses run into files shorter than they were at open time.
+        // A mapping would fault there and kill the process.
+        std::thread writer([&]() {
+            for (int round = 0; round < 40; ++round) {
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                out << (round % 2 == 0 ? big.substr(0, big.size() / 3) : big);
+            }
+        });
+        for (int round = 0; round < 20; ++round) {
+            server.refresh();
+        }
+        writer.join();
+
+        server.refresh();
+        nlohmann::json status = request(server, "status");
+        check(status["ok"] == true && status["result"]["classes"] == 20000, "the server survives truncated files");
+        server.stop();
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "SourceServer checks" << std::endl;
+    testRequests();
+    testEndpoint();
+    testTruncatedFiles();
+    return TestSupport::finish();
+}
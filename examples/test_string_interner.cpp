@@ -0,0 +1,170 @@
+// Behavioural checks of StringInterner and InternedString (run from the repository root by "make test")
+#include "../include/StringInterner.h"
+#include "../include/SimpleHeaderParser.h"
+#include "../include/PUMLEntityParser.h"
+#include "TestSupport.h"
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    void testInterner() {
+        TestSupport::section("Interner");
+        StringInterner interner;
+        Symbol intId = interner.intern("int");
+        Symbol stringId = interner.intern("const std::string&");
+        check(intId != 0 && stringId != 0 && intId != stringId, "distinct strings get distinct non-zero ids");
+        check(interner.intern(std::string("int")) == intId && interner.intern("const std::string&") == stringId,
+              "interning again returns the same id");
+        check(interner.intern("") == 0 && interner.view(0).empty(), "the empty string is id 0");
+        check(interner.view(intId) == "int" && interner.view(stringId) == "const std::string&", "view() gives the text back");
+        check(interner.find("int") == intId && interner.find("double") == 0 && interner.size() == 2,
+              "find() looks up without storing");
+        check(interner.view(1000).empty() && interner.view(uint32_t(-1)).empty(), "unknown ids view as empty");
+        check(interner.size() == 2 && interner.storedBytes() == 3 + 18, "size() and storedBytes() count distinct strings");
+
+        // Enough strings to fill several id blocks
+        std::vector<Symbol> ids;
+        for (int i = 0; i < 5000; ++i) ids.push_back(interner.intern("type" + std::to_string(i)));
+        bool bAllFound = true;
+        for (int i = 0; i < 5000; ++i) {
+            bAllFound = bAllFound && interner.view(ids[i]) == "type" + std::to_string(i) &&
+                        interner.intern("type" + std::to_string(i)) == ids[i];
+        }
+        check(bAllFound && interner.size() == 5002, "ids stay valid across id blocks");
+
+        // The thread cache must not hand out entries of another interner
+        StringInterner other;
+        Symbol otherId = other.intern("double");
+        check(otherId == 1 && other.view(otherId) == "double" && interner.find("double") == 0,
+              "interners do not share strings");
+        {
+            StringInterner shortLived;
+            shortLived.intern("int");
+        }
+        StringInterner fresh;
+        check(fresh.intern("int") == 1 && fresh.size() == 1 && fresh.view(1) == "int",
+              "a destroyed interner leaves nothing behind in the thread cache");
+    }
+
+    void testThreads() {
+        TestSupport::section("Threads");
+        StringInterner interner;
+        const int threadCount = 8;
+        const int stringCount = 2000;
+        std::vector<std::vector<Symbol>> ids(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                // Each thread walks the strings in its own order
+                for (int i = 0; i < stringCount; ++i) {
+                    int index = (i * 7 + t * 131) % stringCount;
+                    ids[t].push_back(interner.intern("name" + std::to_string(index)));
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        bool bSame = true;
+        std::set<Symbol> distinct;
+        for (int t = 0; t < threadCount; ++t) {
+            for (int i = 0; i < stringCount; ++i) {
+                int index = (i * 7 + t * 131) % stringCount;
+                bSame = bSame && ids[t][i] == interner.find("name" + std::to_string(index)) &&
+                        interner.view(ids[t][i]) == "name" + std::to_string(index);
+                distinct.insert(ids[t][i]);
+            }
+        }
+        check(bSame, "every thread gets the same id for the same text");
+        check(distinct.size() == size_t(stringCount) && interner.size() == size_t(stringCount) &&
+              *distinct.begin() == 1 && *distinct.rbegin() == Symbol(stringCount),
+              "each string is stored once, under dense ids");
+    }
+
+    void testInternedString() {
+        TestSupport::section("InternedString");
+        InternedString empty;
+        InternedString a = std::string("unsigned long");
+        InternedString b("unsigned long");
+        InternedString c = std::string_view("long");
+        check(empty.empty() && empty.id() == 0 && empty.str().empty() && empty == "", "default is the empty string");
+        check(a == b && a.id() == b.id() && a.c_str() == b.c_str(), "equal text shares one copy");
+        check(a != c && a.id() == StringInterner::global().find("unsigned long"), "ids are those of the global interner");
+        check(a == "unsigned long" && a == std::string("unsigned long") && a != "long" && a.size() == 13 &&
+              a.view() == "unsigned long", "text comparisons and accessors");
+        const std::string& text = a;
+        check(&text == &a.str() && std::string(a.begin(), a.end()) == "unsigned long", "reads as a const std::string");
+        c = "unsigned long";
+        check(c == a, "assigning text interns it");
+        check(c < InternedString("z") && InternedString("a") < c, "text order");
+        std::unordered_set<InternedString> set = {a, b, c, InternedString("long")};
+        check(set.size() == 2, "hashes by id");
+        std::ostringstream out;
+        out << a;
+        check(out.str() == "unsigned long", "prints its text");
+    }
+
+    void testParserResults() {
+        TestSupport::section("Parser results");
+        const std::string content =
+            "class First {\n"
+            "public:\n"
+            "    int count;\n"
+            "    const std::string& name(int index) const;\n"
+            "};\n"
+            "class Second {\n"
+            "public:\n"
+            "    int total;\n"
+            "    void rename(const std::string& name);\n"
+            "};\n";
+        SimpleHeaderParser parser;
+        ParseResult first = parser.parseContent(content, "first.h");
+        ParseResult second = parser.parseContent(content, "second.h");
+        bool bShaped = first.classes.size() == 2 && second.classes.size() == 2 &&
+                       first.classes[0].members.size() == 1 && first.classes[1].members.size() == 1 &&
+                       first.classes[0].methods.size() == 1 && first.classes[1].methods.size() == 1 &&
+                       !first.classes[1].methods[0].parameters.empty();
+        check(bShaped, "header parses");
+        if (bShaped) {
+            const MemberInfo& count = first.classes[0].members[0];
+            const MemberInfo& total = first.classes[1].members[0];
+            check(count.type == "int" && count.type == total.type && count.type.c_str() == total.type.c_str(),
+                  "member types of one parse share one copy");
+            check(count.type == second.classes[0].members[0].type, "and so do those of separate parses");
+            const MethodInfo& name = first.classes[0].methods[0];
+            const ParameterInfo& param = first.classes[1].methods[0].parameters[0];
+            check(name.returnType == param.type && name.returnType.id() == StringInterner::global().find(param.type.view()),
+                  "return and parameter types are interned in the global interner");
+        }
+
+        PUMLEntityParser entityParser;
+        PUMLEntityDiagramResult diagram = entityParser.parseFile("examples/sample_entity_diagram.puml");
+        bool bIntFields = diagram.success;
+        size_t intFields = 0;
+        const EntityField* firstInt = nullptr;
+        for (const auto& entity : diagram.entities) {
+            for (const auto& field : entity.fields) {
+                if (field.type != "int") continue;
+                if (!firstInt) firstInt = &field;
+                bIntFields = bIntFields && field.type == firstInt->type;
+                intFields++;
+            }
+        }
+        check(bIntFields && intFields > 1, "entity field types are interned");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "StringInterner checks" << std::endl;
+    testInterner();
+    testThreads();
+    testInternedString();
+    testParserResults();
+    return TestSupport::finish();
+}
@@ -0,0 +1,101 @@
+// Behavioural checks of SymbolIndex (run from the repository root by "make test")
+#include "../include/SymbolIndex.h"
+#include "TestSupport.h"
+#include <algorithm>
+
+using namespace UFMTooling;
+using TestSupport::check;
+
+namespace {
+
+    std::vector<std::string> names(const std::vector<SymbolClass>& classes) {
+        std::vector<std::string> found;
+        for (const auto& symbol : classes) found.emplace_back(symbol.name);
+        return found;
+    }
+
+    void writeTree(const TestSupport::TempDirectory& tree) {
+        tree.write("base.h",
+                   "#include <string>\n"
+                   "class Base {\n"
+                   "public:\n"
+                   "    virtual void draw();\n"
+                   "    int drawCount() const;\n"
+                   "};\n");
+        tree.write("shapes.h",
+                   "#include \"base.h\"\n"
+                   "namespace geo {\n"
+                   "    class Mid : public Base {\n"
+                   "    public:\n"
+                   "        void draw();\n"
+                   "    };\n"
+                   "    class Leaf : public Mid {\n"
+                   "    public:\n"
+                   "        static Leaf make();\n"
+                   "    };\n"
+                   "}\n"
+                   "struct Plain {\n"
+                   "    int x;\n"
+                   "};\n");
+    }
+
+    // The same queries on a built and on a loaded index must agree
+    void checkQueries(const SymbolIndex& index, const std::string& label) {
+        check(index.fileCount() == 2 && index.classCount() == 4 && index.methodCount() == 4,
+              label + ": counts of files, classes and methods");
+        check(names(index.findClasses("Leaf")) == std::vector<std::string>{"Leaf"} &&
+              names(index.findClasses("geo::Leaf")) == std::vector<std::string>{"Leaf"},
+              label + ": classes by name and full name");
+        check(names(index.derivedClasses("Base")) == std::vector<std::string>{"Mid"}, label + ": direct derived classes");
+        std::vector<std::string> transitive = names(index.derivedClasses("Base", true));
+        check(transitive.size() == 2 && std::find(transitive.begin(), transitive.end(), "Leaf") != transitive.end(),
+              label + ": transitive derived classes");
+
+        std::vector<SymbolMethod> draws = index.findMethods("draw");
+        check(draws.size() == 2 && index.filesDeclaringMethod("draw").size() == 2, label + ": methods across files");
+        std::vector<SymbolMethod> make = index.findMethods("make");
+        check(make.size() == 1 && make[0].isStatic && make[0].className == "Leaf", label + ": method details");
+
+        std::vector<std::string_view> includers = index.filesIncluding("base.h");
+        check(includers.size() == 1 && includers[0].find("shapes.h") != std::string_view::npos,
+              label + ": files including a header");
+        check(index.includesOf(index.filePath(0)).size() == 1, label + ": includes of a file");
+
+        check(names(index.classesWithPrefix("")) == std::vector<std::string>({"Base", "Leaf", "Mid", "Plain"}),
+              label + ": prefix query sorted by name");
+        check(index.methodsWithPrefix("draw").size() == 3 && index.methodsWithPrefix("draw", 1).size() == 1,
+              label + ": method prefixes with a limit");
+        check(index.findClasses("Missing").empty() && index.derivedClasses("Plain").empty(),
+              label + ": unknown names give empty lists");
+    }
+
+    void testIndex() {
+        TestSupport::section("Symbol index");
+        TestSupport::TempDirectory tree("symbols");
+        writeTree(tree);
+        SourceExplorer explorer;
+        const SourceExplorerResult& result = explorer.explore(tree.path(), SourceExplorerOptions());
+
+        SymbolIndex built;
+        built.build(result);
+        checkQueries(built, "built");
+
+        std::string indexFile = tree.path("symbols.idx");
+        check(built.save(indexFile), "index saves");
+        SymbolIndex loaded;
+        check(loaded.load(indexFile), "index loads");
+        checkQueries(loaded, "loaded");
+
+        tree.write("garbage.idx", "not an index");
+        SymbolIndex broken;
+        check(!broken.load(tree.path("garbage.idx")) && !broken.getErrorMessage().empty() && broken.classCount() == 0,
+              "a file that is not an index is rejected");
+    }
+
+} // namespace
+
+int main() {
+    std::cout << "SymbolIndex checks" << std::endl;
+    testIndex();
+    return TestSupport::finish();
+}
@@ -0,0 +1,80 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include "SimpleHeaderParser.h"
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+
+namespace UFMTooling {
+
+    // Identity of a file's contents at the time it was analyzed
+    struct FileFingerprint {
+        long long lastWriteTime;    // Last write time, in filesystem clock ticks
+        uint64_t size;              // File size in bytes
+        uint64_t contentHash;       // Hash of the contents (0 when not computed)
+        uint64_t optionsHash;       // AnalysisCache::hashOptions() of the options it was parsed with
+
+        FileFingerprint() : lastWriteTime(0), size(0), contentHash(0), optionsHash(0) {}
+    };
+
+    // Persistent cache of header parse results, keyed by path.
+    // An entry is reused while the file's mtime and size (or, when hashing is
+    // enabled, its content hash) still match the fingerprint it was stored with, and
+    // while it was parsed with the same preprocessor options.
+    // find() and store() may be called from several threads at once.
+    class AnalysisCache {
+    public:
+        AnalysisCache();
+        ~AnalysisCache();
+
+        // Look up the entry for path: fingerprint receives the stored fingerprint and,
+        // if result is not null, the cached result (shared, not copied)
+        bool find(const std::string& path, FileFingerprint& fingerprint,
+                  std::shared_ptr<const ParseResult>* result = nullptr) const;
+
+        // Add or replace the entry for path; the result is shared with the caller
+        void store(const std::string& path, const FileFingerprint& fingerprint, std::shared_ptr<const ParseResult> result);
+
+        // Add or replace the entry for path with a copy of result
+        void store(const std::string& path, const FileFingerprint& fingerprint, const ParseResult& result);
+
+        // Remove the entry for path
+        bool erase(const std::string& path);
+
+        // Remove entries whose file no longer exists; returns the number removed
+        size_t pruneMissing();
+
+        // Remove all entries
+        void clear();
+
+        // Number of cached files
+        size_t size() const;
+
+        // Load entries from a cache file written by save() (replaces current entries)
+        bool load(const std::string& filePath);
+
+        // Write all entries to a cache file
+        bool save(const std::string& filePath) const;
+
+        // Compute the fingerprint of a file on disk (mtime and size, plus the content hash if requested);
+        // optionsHash is left as it is. bCopy hashes a copy of the file instead of a mapping (MappedFile).
+        static bool fingerprintFile(const std::string& path, bool bHashContents, FileFingerprint& fingerprint,
+                                    bool bCopy = false);
+
+        // 64-bit FNV-1a hash of a buffer
+        static uint64_t hashContent(std::string_view content);
+
+        // Hash of the preprocessor options that can change a parse result: 0 when every
+        // branch is kept (bSkipDisabledBlocks off, the default)
+        static uint64_t hashOptions(const PreprocessorOptions& options);
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // ANALYSIS_CACHE_H
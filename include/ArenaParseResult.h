@@ -0,0 +1,155 @@
+#ifndef ARENA_PARSE_RESULT_H
+#define ARENA_PARSE_RESULT_H
+
+#include "SimpleHeaderParser.h"
+#include "MappedFile.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace UFMTooling {
+
+    // Arena counterparts of the SimpleHeaderParser structures. Strings are views,
+    // either into the parsed source or into the arena; vectors allocate from the arena.
+
+    struct ArenaMemberInfo {
+        std::string_view name;
+        std::string_view type;
+        AccessSpecifier access;
+        bool isStatic;
+        bool isConst;
+        std::string_view defaultValue;
+
+        ArenaMemberInfo() : access(AccessSpecifier::Private), isStatic(false), isConst(false) {}
+    };
+
+    struct ArenaParameterInfo {
+        std::string_view name;
+        std::string_view type;
+        std::string_view defaultValue;
+        bool isConst;
+        bool isReference;
+        bool isPointer;
+
+        ArenaParameterInfo() : isConst(false), isReference(false), isPointer(false) {}
+    };
+
+    struct ArenaMethodInfo {
+        std::string_view name;
+        std::string_view returnType;
+        AccessSpecifier access;
+        std::pmr::vector<ArenaParameterInfo> parameters;
+        bool isStatic;
+        bool isConst;
+        bool isVirtual;
+        bool isPureVirtual;
+        bool isConstructor;
+        bool isDestructor;
+        bool isOperator;
+
+        explicit ArenaMethodInfo(std::pmr::memory_resource* resource)
+            : access(AccessSpecifier::Private), parameters(resource), isStatic(false), isConst(false),
+              isVirtual(false), isPureVirtual(false), isConstructor(false),
+              isDestructor(false), isOperator(false) {}
+    };
+
+    struct ArenaBaseClassInfo {
+        std::string_view name;
+        AccessSpecifier access;
+
+        ArenaBaseClassInfo() : access(AccessSpecifier::Public) {}
+    };
+
+    struct ArenaClassInfo {
+        std::string_view name;
+        std::string_view fullName; // Including namespace
+        std::pmr::vector<ArenaBaseClassInfo> baseClasses;
+        std::pmr::vector<ArenaMemberInfo> members;
+        std::pmr::vector<ArenaMethodInfo> methods;
+        std::pmr::vector<std::string_view> friendClasses;
+        bool isStruct;
+        bool isTemplate;
+        std::pmr::vector<std::string_view> templateParameters;
+
+        explicit ArenaClassInfo(std::pmr::memory_resource* resource)
+            : baseClasses(resource), members(resource), methods(resource), friendClasses(resource),
+              isStruct(false), isTemplate(false), templateParameters(resource) {}
+    };
+
+    struct ArenaNamespaceInfo {
+        std::string_view name;
+        std::pmr::vector<ArenaClassInfo> classes;
+        std::pmr::vector<ArenaNamespaceInfo> nestedNamespaces;
+
+        explicit ArenaNamespaceInfo(std::pmr::memory_resource* resource)
+            : classes(resource), nestedNamespaces(resource) {}
+    };
+
+    struct ArenaEnumInfo {
+        std::string_view name;
+        std::pmr::vector<std::pair<std::string_view, std::string_view>> values; // name, value
+        bool isClass; // enum class vs enum
+
+        explicit ArenaEnumInfo(std::pmr::memory_resource* resource) : values(resource), isClass(false) {}
+    };
+
+    // Result of SimpleHeaderParser::parseFileArena()/parseContentArena().
+    // Every node and string of one file lives in a monotonic buffer owned by the result
+    // and is released at once when the result is destroyed; strings point straight into
+    // the source text (kept alive by the result) wherever possible.
+    class ArenaParseResult {
+        // Declared first so it outlives the containers that allocate from it
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> ownedArena;
+        std::pmr::memory_resource* arena;
+
+    public:
+        // Allocate from an owned monotonic buffer on top of upstream (null = new/delete)
+        explicit ArenaParseResult(std::pmr::memory_resource* upstream = nullptr);
+
+        // Allocate from resource, which must outlive the result (not owned)
+        struct BorrowedResource {};
+        ArenaParseResult(std::pmr::memory_resource* resource, BorrowedResource);
+
+        ArenaParseResult(const ArenaParseResult&) = delete;
+        ArenaParseResult& operator=(const ArenaParseResult&) = delete;
+
+        std::pmr::vector<ArenaClassInfo> classes;
+        std::pmr::vector<ArenaNamespaceInfo> namespaces;
+        std::pmr::vector<ArenaEnumInfo> enums;
+        std::pmr::vector<std::string_view> includes;
+        std::string_view fileName;
+        bool success;
+        std::string errorMessage;
+
+        // Resource every node of this result is allocated from
+        std::pmr::memory_resource* resource() const { return arena; }
+
+        // Copy a string into the arena and return a view of the copy
+        std::string_view store(std::string_view str);
+
+        // The parsed text; views in the result point into it
+        std::string_view source() const { return sourceText; }
+
+        // Keep a mapped file alive as the source text
+        void adoptSource(MappedFile&& file);
+
+        // Copy text into the arena and use it as the source text
+        void copySource(std::string_view text);
+
+        // Use text as the source text without copying (caller keeps it alive)
+        void borrowSource(std::string_view text) { sourceText = text; }
+
+        // Deep copy into the regular, self-contained result structures
+        ParseResult toParseResult() const;
+
+    private:
+        MappedFile mappedSource;
+        std::string_view sourceText;
+    };
+
+} // namespace UFMTooling
+
+#endif // ARENA_PARSE_RESULT_H
@@ -0,0 +1,73 @@
+#ifndef DIRECTORY_WATCHER_H
+#define DIRECTORY_WATCHER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace UFMTooling {
+
+    // Kind of a reported change
+    enum class DirectoryChangeKind {
+        Modified,       // Contents or attributes of the entry changed
+        Created,        // Entry created, or moved into a watched directory
+        Removed,        // Entry deleted, or moved out of a watched directory
+        Overflow        // Events were lost; everything may have changed
+    };
+
+    // One change seen by a DirectoryWatcher
+    struct DirectoryChange {
+        std::string path;           // Watched directory joined with the entry name (empty for Overflow)
+        DirectoryChangeKind kind;
+        bool isDirectory;           // The entry is (or was) a directory
+
+        DirectoryChange() : kind(DirectoryChangeKind::Modified), isDirectory(false) {}
+    };
+
+    // Reports changes to the entries of a set of directories, using inotify on Linux
+    // and ReadDirectoryChangesW on Windows. Elsewhere there is no native backend:
+    // isNative() is false and wait() only times out, so callers fall back to polling.
+    // The caller lists the directories itself (usually the directories of a
+    // FileSystemExplorer walk), so pruned directories are never watched. Directories
+    // created inside a watched directory are watched at once, until the next watch().
+    class DirectoryWatcher {
+    public:
+        DirectoryWatcher();
+        ~DirectoryWatcher();
+
+        // Watch exactly these directories under basePath (which should be among them);
+        // directories watched before and not listed any more are dropped. False if a
+        // directory could not be watched (e.g. the inotify watch limit was reached).
+        bool watch(const std::string& basePath, const std::vector<std::string>& directories);
+
+        // Stop watching everything (and reset interrupt())
+        void clear();
+
+        // Wait up to timeoutMs (-1 = no limit) for changes and append them to changes.
+        // Returns false after interrupt() or on an error, true otherwise (also on timeout).
+        bool wait(std::vector<DirectoryChange>& changes, int timeoutMs);
+
+        // Make wait() return false, in another thread now and in later calls, until clear()
+        void interrupt();
+
+        // Make a wait() in another thread (or the next call) return true at once,
+        // possibly without changes
+        void wake();
+
+        // False when there is no native backend
+        bool isNative() const;
+
+        // "inotify", "ReadDirectoryChangesW" or "polling"
+        static const char* backendName();
+
+        // Reason for the last watch()/wait() failure
+        const std::string& getErrorMessage() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // DIRECTORY_WATCHER_H
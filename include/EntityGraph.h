@@ -0,0 +1,109 @@
+#ifndef ENTITY_GRAPH_H
+#define ENTITY_GRAPH_H
+
+#include "PUMLEntityParser.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace UFMTooling {
+
+    // Shortest chain of relationships joining two entities
+    struct EntityJoinPath {
+        std::vector<uint32_t> entities;         // From the first entity to the last, both included
+        std::vector<uint32_t> relationships;    // Index in the diagram's relationships joining
+                                                // entities[i] and entities[i + 1]
+
+        bool empty() const { return entities.empty(); }
+    };
+
+    // Relationship graph of an entity diagram. Entities are nodes with dense ids (their
+    // position in the diagram); relationships are resolved by entity name or alias once,
+    // at build(), and stored as compressed adjacency arrays:
+    // - references: the foreign key direction, from the entity holding the key (the "many"
+    //   side, or the target of a one-to-one) to the entity it references, as exportToDDL()
+    //   derives them; many-to-many relationships have no direction and are left out
+    // - links: every relationship in both directions, for components and join paths
+    // Node lists are returned sorted by node id.
+    class EntityGraph {
+    public:
+        static const uint32_t npos = static_cast<uint32_t>(-1);
+
+        EntityGraph();
+        ~EntityGraph();
+
+        EntityGraph(EntityGraph&& other) noexcept;
+        EntityGraph& operator=(EntityGraph&& other) noexcept;
+
+        // Resolve the relationships of a diagram (replaces the current contents)
+        void build(const PUMLEntityDiagramResult& result);
+        void build(const std::vector<Entity>& entities, const std::vector<EntityRelationship>& relationships);
+
+        // Remove everything
+        void clear();
+
+        size_t nodeCount() const;
+
+        // Distinct (entity, referenced entity) pairs
+        size_t referenceCount() const;
+
+        // Distinct pairs of related entities
+        size_t linkCount() const;
+
+        // Name of a node's entity
+        std::string_view name(uint32_t node) const;
+
+        // Node of an entity name or alias, or npos
+        uint32_t find(std::string_view nameOrAlias) const;
+
+        // Entities a node references, and the entities referencing it
+        std::vector<uint32_t> references(uint32_t node) const;
+        std::vector<uint32_t> referencedBy(uint32_t node) const;
+
+        // Entities related to a node in any direction (many-to-many included)
+        std::vector<uint32_t> neighbors(uint32_t node) const;
+
+        // Every entity a node depends on, directly or not (what must exist before it)
+        std::vector<uint32_t> transitiveReferences(uint32_t node) const;
+
+        // Every entity depending on a node, directly or not (what a change to it affects)
+        std::vector<uint32_t> dependents(uint32_t node) const;
+
+        // All nodes, referenced entities before the ones referencing them (creation order
+        // for DDL); ties go to the lower node id. Cycles are broken by placing the lowest
+        // node left first: its references within the cycle must be added afterwards.
+        std::vector<uint32_t> creationOrder() const;
+
+        // True if creationOrder() satisfies every reference: no cycle spans more than one
+        // entity (an entity referencing itself can still be created in one statement)
+        bool isOrderable() const;
+
+        // Foreign key loops: groups of entities that all reach each other over references
+        // (or an entity referencing itself), each sorted
+        std::vector<std::vector<uint32_t>> cycles() const;
+
+        // Connected components over links, by their lowest node; entities without any
+        // relationship are components of their own
+        std::vector<std::vector<uint32_t>> components() const;
+
+        // Position of a node's component in components()
+        uint32_t componentOf(uint32_t node) const;
+
+        // Fewest relationships joining two entities, over links in any direction; empty if
+        // they are not connected. Neighbors are explored in id order, so ties are settled
+        // the same way on every call.
+        EntityJoinPath joinPath(uint32_t from, uint32_t to) const;
+
+        // Relationships naming an entity that is not in the diagram, in diagram order
+        const std::vector<uint32_t>& unresolved() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // ENTITY_GRAPH_H
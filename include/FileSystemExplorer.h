@@ -26,14 +26,39 @@ namespace UFMTooling {
         FileSystemExplorerResult() : success(false) {}
     };
 
+    // Options controlling a single exploration run.
+    // Globs: '*' and '?' match within one path component, '**' across components,
+    // [abc] / [a-z] / [!abc] match one character of a set. A pattern without '/' is
+    // matched against the entry name, one with '/' against the path relative to the
+    // base path, with '/' separators.
+    struct FileSystemExplorerOptions {
+        bool bRecursive;                            // Explore subdirectories
+        std::vector<std::string> extensions;        // Only record files with one of these extensions (empty = all)
+        std::vector<std::string> includePatterns;   // Only record files matching one of these globs (empty = all)
+        std::vector<std::string> excludePatterns;   // Skip matching files; matching directories are not descended into
+        bool bPruneIgnoredDirectories;              // Also skip the directories in ignoredDirectoryPatterns()
+        bool bIncludeDirectories;                   // Record directory entries
+        bool bFileSizes;                            // Fill FileSystemEntry::size (costs a stat per recorded file)
+        unsigned int threadCount;                   // Walker threads (0 = UFM_TOOLING_THREADS or hardware concurrency, 1 = serial)
+
+        FileSystemExplorerOptions() : bRecursive(true), bPruneIgnoredDirectories(false), bIncludeDirectories(true),
+                                      bFileSizes(true), threadCount(1) {}
+    };
+
     // Class for exploring file system structure
     class FileSystemExplorer {
     public:
         FileSystemExplorer();
         ~FileSystemExplorer();
 
-        // Explore a directory with optional recursive scan
-        FileSystemExplorerResult explore(const std::string& basePath, bool bRecursive = true);
+        // Explore a directory with optional recursive scan.
+        // The returned reference is getLastResult(), valid until the next exploration.
+        const FileSystemExplorerResult& explore(const std::string& basePath, bool bRecursive = true);
+
+        // Explore with filters applied during the walk: excluded directories are never
+        // opened and only matching files are recorded. Entries come in the same order
+        // as a serial walk, whatever the thread count.
+        const FileSystemExplorerResult& explore(const std::string& basePath, const FileSystemExplorerOptions& options);
 
         // Get all files with specific extension
         std::vector<FileSystemEntry> getFilesByExtension(const std::string& extension) const;
@@ -44,9 +69,20 @@ namespace UFMTooling {
         // Get all files (non-directories)
         std::vector<FileSystemEntry> getFiles() const;
 
+        // Same selections without copying: pointers into getLastResult().entries,
+        // valid until the next exploration
+        std::vector<const FileSystemEntry*> viewFilesByExtension(const std::string& extension) const;
+        std::vector<const FileSystemEntry*> viewDirectories() const;
+        std::vector<const FileSystemEntry*> viewFiles() const;
+
         // Get the last exploration result
         const FileSystemExplorerResult& getLastResult() const;
 
+        // Directory globs pruned by bPruneIgnoredDirectories: version control and tool
+        // metadata and dependency folders. Build directories vary by project; add them to
+        // excludePatterns.
+        static const std::vector<std::string>& ignoredDirectoryPatterns();
+
     private:
         class Impl;
         std::unique_ptr<Impl> pImpl;
@@ -0,0 +1,106 @@
+#ifndef INCLUDE_GRAPH_H
+#define INCLUDE_GRAPH_H
+
+#include "SourceExplorer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace UFMTooling {
+
+    // How IncludeGraph::build() resolves include targets
+    struct IncludeGraphOptions {
+        std::vector<std::string> includePaths;  // Searched in order after the including file's directory
+        bool bSearchFileSystem;     // Also look for targets on disk; headers found outside the result
+                                    // become nodes without includes of their own
+        bool bMatchBySuffix;        // Last resort: the only analyzed file whose path ends with /target
+
+        IncludeGraphOptions() : bSearchFileSystem(true), bMatchBySuffix(true) {}
+    };
+
+    // An include target that resolved to no file
+    struct UnresolvedInclude {
+        uint32_t file;              // Including node
+        std::string target;         // As written between the quotes or brackets
+    };
+
+    // A header and how much of the graph depends on it
+    struct IncludeFanIn {
+        uint32_t node;
+        std::string_view path;
+        uint32_t includers;         // Files including it directly
+        uint32_t dependents;        // Files including it directly or not (what rebuilds when it changes)
+
+        IncludeFanIn() : node(0), includers(0), dependents(0) {}
+    };
+
+    // Include graph of a SourceExplorerResult. Every analyzed header is a node, in the
+    // analyses' order, followed by the headers found only on disk. Edges are resolved
+    // once and stored as two compressed adjacency arrays (includes and includers), so
+    // transitive queries are a walk over flat arrays with a bitset of visited nodes.
+    // Node lists are returned sorted by node id; a node never lists itself.
+    class IncludeGraph {
+    public:
+        static const uint32_t npos = static_cast<uint32_t>(-1);
+
+        IncludeGraph();
+        ~IncludeGraph();
+
+        IncludeGraph(IncludeGraph&& other) noexcept;
+        IncludeGraph& operator=(IncludeGraph&& other) noexcept;
+
+        // Resolve the includes of every analysis of result (replaces the current contents)
+        void build(const SourceExplorerResult& result, const IncludeGraphOptions& options = IncludeGraphOptions());
+
+        // Remove everything
+        void clear();
+
+        size_t nodeCount() const;
+        size_t edgeCount() const;
+
+        // Normalized path of a node ('/' separators, no "." or ".." components)
+        std::string_view path(uint32_t node) const;
+
+        // False for headers found on disk but not analyzed
+        bool isAnalyzed(uint32_t node) const;
+
+        // Node of a path (normalized like the nodes), or npos
+        uint32_t find(std::string_view filePath) const;
+
+        // Direct edges: the headers a node includes, and the files including it
+        std::vector<uint32_t> includes(uint32_t node) const;
+        std::vector<uint32_t> includers(uint32_t node) const;
+
+        // Everything a node includes, directly or not
+        std::vector<uint32_t> transitiveIncludes(uint32_t node) const;
+
+        // Everything that includes a node, directly or not: what rebuilds when it changes
+        std::vector<uint32_t> dependents(uint32_t node) const;
+
+        // Files that rebuild when any of changed changes (the changed nodes themselves excluded)
+        std::vector<uint32_t> dependents(const std::vector<uint32_t>& changed) const;
+
+        // True if from includes to, directly or not
+        bool reaches(uint32_t from, uint32_t to) const;
+
+        // Include cycles: groups of nodes that all reach each other (strongly connected
+        // components of more than one node, or a node including itself), each sorted
+        std::vector<std::vector<uint32_t>> cycles() const;
+
+        // The count headers included directly by the most files (ties: lower node id), with
+        // their dependents counted
+        std::vector<IncludeFanIn> heaviestFanIn(size_t count) const;
+
+        // Targets that resolved to no node, in the analyses' order
+        const std::vector<UnresolvedInclude>& unresolved() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // INCLUDE_GRAPH_H
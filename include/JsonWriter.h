@@ -0,0 +1,75 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <memory>
+#include <type_traits>
+
+namespace UFMTooling {
+
+    // Streaming JSON writer: values go straight into an output buffer, no DOM is built.
+    // Pretty output (2-space indent) and compact output match nlohmann::json::dump(2)
+    // and dump() byte for byte when object keys are written in sorted order. Strings are
+    // expected in UTF-8; each invalid sequence is written as \ufffd.
+    class JsonWriter {
+    public:
+        // Write to a stream; the internal buffer is flushed whenever it fills up
+        explicit JsonWriter(std::ostream& out, bool bPretty = true);
+
+        // Append to a string
+        explicit JsonWriter(std::string& out, bool bPretty = true);
+
+        // Flushes any buffered output
+        ~JsonWriter();
+
+        void beginObject();
+        void endObject();
+        void beginArray();
+        void endArray();
+
+        // Object key; must be followed by exactly one value, object or array
+        void key(std::string_view name);
+
+        void value(std::string_view str);
+        void value(const char* str);
+        void value(const std::string& str);
+        void value(bool b);
+        void value(double number);      // Shortest round-trip digits in nlohmann's notation; NaN/inf as null
+        void null();
+
+        template <typename T>
+        typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+        value(T number) {
+            if (std::is_signed<T>::value) {
+                valueSigned(static_cast<long long>(number));
+            } else {
+                valueUnsigned(static_cast<unsigned long long>(number));
+            }
+        }
+
+        // key(name) followed by value(v)
+        template <typename T>
+        void member(std::string_view name, const T& v) {
+            key(name);
+            value(v);
+        }
+
+        // Push buffered output to the stream
+        void flush();
+
+        // False if writing to the stream failed
+        bool good() const;
+
+    private:
+        void valueSigned(long long number);
+        void valueUnsigned(unsigned long long number);
+
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // JSON_WRITER_H
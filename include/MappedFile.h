@@ -0,0 +1,56 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace UFMTooling {
+
+    // Read-only view over the contents of a file.
+    // The file is memory-mapped (mmap on POSIX, CreateFileMapping on Win32);
+    // if mapping is not possible the contents are read into an owned buffer instead.
+    // A mapping sees later writes to the file, and on POSIX reading past the end of a file
+    // truncated while mapped raises SIGBUS: open files that other processes may be
+    // rewriting (a server watching a tree being edited) with bCopy.
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Open and map a file, releasing any previously mapped one.
+        // bCopy reads the contents into an owned buffer instead of mapping them.
+        bool open(const std::string& filePath, bool bCopy = false);
+
+        // Release the mapping
+        void close();
+
+        // True if a file is currently open (empty files are open with size 0)
+        bool isOpen() const;
+
+        // True if the contents are backed by a memory mapping rather than a copy
+        bool isMapped() const;
+
+        // Contents of the file; valid until close() or destruction
+        std::string_view view() const;
+        const char* data() const;
+        size_t size() const;
+
+        // Fault the whole mapping in on the calling thread, so that reading view() later does
+        // not wait on the disk or the network (nothing to do for contents read into a buffer)
+        void prefetch() const;
+
+        // Reason for the last open() failure
+        const std::string& getErrorMessage() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // MAPPED_FILE_H
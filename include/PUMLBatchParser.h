@@ -0,0 +1,101 @@
+#ifndef PUML_BATCH_PARSER_H
+#define PUML_BATCH_PARSER_H
+
+#include "PUMLClassParser.h"
+#include "PUMLEntityParser.h"
+#include "FileSystemExplorer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace UFMTooling {
+
+    // Kind of diagram a .puml file holds
+    enum class PUMLDiagramType {
+        Unknown,
+        Class,
+        Entity
+    };
+
+    // Result of parsing one .puml file
+    struct PUMLFileAnalysis {
+        std::string path;
+        std::string filename;
+        PUMLDiagramType type;
+        PUMLClassDiagramResult classDiagram;    // Filled when type is Class
+        PUMLEntityDiagramResult entityDiagram;  // Filled when type is Entity
+        std::vector<std::string> warnings;      // Parser warnings for this file
+        bool success;
+        std::string errorMessage;
+
+        PUMLFileAnalysis() : type(PUMLDiagramType::Unknown), success(false) {}
+    };
+
+    // Result of a batch run
+    struct PUMLBatchResult {
+        std::vector<PUMLFileAnalysis> analyses; // In input order (sorted by path for explore())
+        PUMLClassDiagramResult classModel;      // All class diagrams merged (with bMerge)
+        PUMLEntityDiagramResult entityModel;    // All entity diagrams merged (with bMerge)
+        bool success;
+        std::string errorMessage;
+        int filesProcessed;
+        int filesWithErrors;
+        int classDiagrams;
+        int entityDiagrams;
+
+        PUMLBatchResult() : success(false), filesProcessed(0), filesWithErrors(0), classDiagrams(0), entityDiagrams(0) {}
+    };
+
+    // Options controlling a batch run
+    struct PUMLBatchOptions {
+        bool bRecursive;            // explore(): descend into subdirectories
+        unsigned int threadCount;   // Parser threads (0 = UFM_TOOLING_THREADS or hardware concurrency)
+        bool bMerge;                // Also build classModel and entityModel
+        FileSystemExplorerOptions walk; // explore(): globs, pruning, walker threads
+                                    // (bRecursive, extensions, directories and sizes are set by the parser)
+        bool bCopyFiles;            // Read the files into memory instead of mapping them (see MappedFile)
+
+        PUMLBatchOptions() : bRecursive(true), threadCount(0), bMerge(false), bCopyFiles(false) {}
+    };
+
+    // Parses many .puml files at once. Each file is mapped, its diagram type detected,
+    // and it is parsed by a worker thread with its own PUMLClassParser and
+    // PUMLEntityParser, taking files from a shared queue. Errors are reported per file;
+    // a file that fails does not stop the run.
+    class PUMLBatchParser {
+    public:
+        PUMLBatchParser();
+        ~PUMLBatchParser();
+
+        // Parse the given files. The returned reference is getLastResult(), valid until
+        // the next run.
+        const PUMLBatchResult& parseFiles(const std::vector<std::string>& filePaths,
+                                          const PUMLBatchOptions& options = PUMLBatchOptions());
+
+        // Parse every .puml file under basePath
+        const PUMLBatchResult& explore(const std::string& basePath,
+                                       const PUMLBatchOptions& options = PUMLBatchOptions());
+
+        // Get the last batch result
+        const PUMLBatchResult& getLastResult() const;
+
+        // Diagram type of PlantUML content: entity/table declarations and crow's foot
+        // arrows make an entity diagram, class/interface/enum declarations and UML
+        // arrows a class diagram. Unknown if there are neither.
+        static PUMLDiagramType detectDiagramType(std::string_view content);
+
+        // Merge diagrams into one model. Classes (entities) with the same name are
+        // merged, members keep their first declaration; repeated relationships and
+        // notes are kept once.
+        static PUMLClassDiagramResult mergeClassDiagrams(const std::vector<const PUMLClassDiagramResult*>& diagrams);
+        static PUMLEntityDiagramResult mergeEntityDiagrams(const std::vector<const PUMLEntityDiagramResult*>& diagrams);
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // PUML_BATCH_PARSER_H
@@ -1,10 +1,13 @@
 #ifndef PUML_CLASS_PARSER_H
 #define PUML_CLASS_PARSER_H
 
+#include "StringInterner.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
+#include <iosfwd>
 
 namespace UFMTooling {
 
@@ -24,13 +27,14 @@ namespace UFMTooling {
         Composition,        // *--
         Inheritance,        // --|>
         Realization,        // ..|>
-        DirectedAssociation // -->
+        DirectedAssociation, // -->
+        Nesting             // +-- (inner class)
     };
 
     // Represents a UML attribute
     struct UMLAttribute {
         std::string name;
-        std::string type;
+        InternedString type;
         UMLVisibility visibility;
         bool isStatic;
         std::string defaultValue;
@@ -42,7 +46,7 @@ namespace UFMTooling {
     // Represents a UML method parameter
     struct UMLParameter {
         std::string name;
-        std::string type;
+        InternedString type;
         std::string direction; // in, out, inout
         std::string defaultValue;
 
@@ -52,7 +56,7 @@ namespace UFMTooling {
     // Represents a UML method
     struct UMLMethod {
         std::string name;
-        std::string returnType;
+        InternedString returnType;
         UMLVisibility visibility;
         std::vector<UMLParameter> parameters;
         bool isStatic;
@@ -110,7 +114,7 @@ namespace UFMTooling {
         PUMLClassDiagramResult parseFile(const std::string& filePath);
 
         // Parse PlantUML content from string
-        PUMLClassDiagramResult parseContent(const std::string& content);
+        PUMLClassDiagramResult parseContent(std::string_view content);
 
         // Get all classes found
         const std::vector<UMLClass>& getClasses() const;
@@ -121,9 +125,11 @@ namespace UFMTooling {
         // Find a class by name
         const UMLClass* findClass(const std::string& className) const;
 
-        // Export to different formats
-        std::string exportToJson() const;
-        std::string exportToXML() const;
+        // Export the complete model of the last parse (JSON: 2-space indented or compact)
+        std::string exportToJson(bool bPretty = true) const;
+        bool exportToJson(std::ostream& out, bool bPretty = true) const;
+        std::string exportToXML(bool bPretty = true) const;
+        bool exportToXML(std::ostream& out, bool bPretty = true) const;
 
         // Get parsing warnings
         const std::vector<std::string>& getWarnings() const;
@@ -1,10 +1,14 @@
 #ifndef PUML_ENTITY_PARSER_H
 #define PUML_ENTITY_PARSER_H
 
+#include "StringInterner.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
+#include <iosfwd>
 
 namespace UFMTooling {
 
@@ -20,7 +24,7 @@ namespace UFMTooling {
     // Represents a field in an entity
     struct EntityField {
         std::string name;
-        std::string type;
+        InternedString type;
         std::vector<EntityFieldType> constraints;
         std::string defaultValue;
         std::string comment;
@@ -91,6 +95,35 @@ namespace UFMTooling {
         PUMLEntityDiagramResult() : success(false) {}
     };
 
+    // SQL dialects of exportToDDL()
+    enum class SQLDialect {
+        Generic,        // Unquoted names, types as written in the diagram
+        PostgreSQL,
+        MySQL,
+        SQLServer,
+        SQLite
+    };
+
+    // Options of exportToDDL()
+    struct DDLOptions {
+        SQLDialect dialect;
+        bool bForeignKeys;          // FOREIGN KEY constraints from the relationships
+        bool bIndexes;              // An index on the columns of each foreign key
+        unsigned int threadCount;   // Table generation threads (0 = UFM_TOOLING_THREADS or hardware concurrency)
+
+        DDLOptions() : dialect(SQLDialect::Generic), bForeignKeys(true), bIndexes(true), threadCount(1) {}
+    };
+
+    // Statements of one table: its CREATE TABLE and CREATE INDEX statements, or the
+    // ALTER TABLE adding foreign keys that could not be declared inline (cycles)
+    struct DDLStatement {
+        std::string table;          // Entity name
+        std::string sql;
+    };
+
+    // Receives the statements in execution order; return false to stop
+    using DDLStatementSink = std::function<bool(const DDLStatement& statement)>;
+
     // PUML Entity/ER Diagram Parser
     class PUMLEntityParser {
     public:
@@ -101,7 +134,7 @@ namespace UFMTooling {
         PUMLEntityDiagramResult parseFile(const std::string& filePath);
 
         // Parse PlantUML entity diagram content from string
-        PUMLEntityDiagramResult parseContent(const std::string& content);
+        PUMLEntityDiagramResult parseContent(std::string_view content);
 
         // Get all entities found
         const std::vector<Entity>& getEntities() const;
@@ -112,10 +145,25 @@ namespace UFMTooling {
         // Find an entity by name
         const Entity* findEntity(const std::string& entityName) const;
 
-        // Export to different formats
-        std::string exportToJson() const;
-        std::string exportToXML() const;
-        std::string exportToDDL(const std::string& dialect = "SQL") const; // Generate SQL DDL
+        // Export the complete model of the last parse (JSON: 2-space indented or compact)
+        std::string exportToJson(bool bPretty = true) const;
+        bool exportToJson(std::ostream& out, bool bPretty = true) const;
+        std::string exportToXML(bool bPretty = true) const;
+        bool exportToXML(std::ostream& out, bool bPretty = true) const;
+
+        // Generate SQL DDL. Tables come in dependency order (referenced tables first), each
+        // followed by the indexes of its foreign keys. The dialect is a name accepted by
+        // dialectFromString(); unknown names give generic SQL.
+        std::string exportToDDL(const std::string& dialect = "SQL") const;
+        std::string exportToDDL(const DDLOptions& options) const;
+
+        // Write the DDL to out, or hand it over one table at a time
+        bool exportToDDL(std::ostream& out, const DDLOptions& options) const;
+        bool exportToDDL(const DDLOptions& options, const DDLStatementSink& sink) const;
+
+        // "SQL", "PostgreSQL" ("postgres"), "MySQL" ("mariadb"), "SQLServer" ("mssql"),
+        // "SQLite"; case-insensitive. False for other names.
+        static bool dialectFromString(const std::string& name, SQLDialect& dialect);
 
         // Get parsing warnings
         const std::vector<std::string>& getWarnings() const;
@@ -125,6 +173,49 @@ namespace UFMTooling {
         std::unique_ptr<Impl> pImpl;
     };
 
+    // Callbacks of PUMLEntityStreamParser; any of them may be left empty.
+    // Entities and relationships may be moved from.
+    struct PUMLEntityCallbacks {
+        std::function<void(Entity& entity)> onEntity;                       // Entity with all its fields
+        std::function<void(EntityRelationship& relationship)> onRelationship;
+        std::function<void(const std::string& key, const std::string& text)> onNote;
+        std::function<void(const std::string& title)> onTitle;
+    };
+
+    // Push parser for entity diagrams too large to hold in memory. Content is fed in
+    // chunks of any size (a line, an entity block or "{" may be split anywhere), and
+    // each entity is handed to onEntity once its block is closed. Only the entity
+    // being declared and the start of an incomplete line are kept, so memory is
+    // bounded by the largest entity rather than by the file. Callbacks report
+    // exactly what parseContent() would return for the same content.
+    class PUMLEntityStreamParser {
+    public:
+        explicit PUMLEntityStreamParser(PUMLEntityCallbacks callbacks);
+        ~PUMLEntityStreamParser();
+
+        // Parse the next chunk. Returns false once parsing has failed (see getErrorMessage()).
+        bool feed(std::string_view chunk);
+
+        // End of input: parse a last line without '\n' and hand over an entity left open
+        bool finish();
+
+        // feed() a stream in chunks of chunkSize bytes until its end, then finish()
+        bool parseStream(std::istream& in, size_t chunkSize = 1 << 16);
+
+        // Forget all state, to parse another diagram with the same callbacks
+        void reset();
+
+        // Complete lines parsed so far
+        size_t getLineCount() const;
+
+        // Reason for the failure, with the line it happened at
+        const std::string& getErrorMessage() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
 } // namespace UFMTooling
 
 #endif // PUML_ENTITY_PARSER_H
@@ -0,0 +1,122 @@
+#ifndef PARSE_STATS_H
+#define PARSE_STATS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace UFMTooling {
+
+    // Stages of a header exploration that ParseStats times
+    enum class ParseStage {
+        Walk,           // Directory walk (FileSystemExplorer)
+        Read,           // Opening and mapping a file
+        Tokenize,       // Lexing and preprocessing (comments, continuations, conditionals, includes)
+        ParseClasses,
+        ParseEnums,
+        Export          // JSON export of the results
+    };
+
+    constexpr size_t parseStageCount = 6;
+
+    // Name of a stage in the exports ("walk", "read", "tokenize", ...)
+    const char* parseStageName(ParseStage stage);
+
+    // Wall time spent in one stage, over all files and threads
+    struct ParseStageStats {
+        uint64_t count;             // Times the stage ran
+        double totalMs;
+        double maxMs;
+
+        ParseStageStats() : count(0), totalMs(0.0), maxMs(0.0) {}
+    };
+
+    // What parsing one file cost
+    struct FileParseStats {
+        std::string path;
+        bool success;
+        uint64_t bytes;
+        size_t lines;
+        size_t classes;
+        size_t methods;
+        size_t enums;
+        uint64_t allocations;       // Allocations from the parser's arena (parseFile/parseContent only)
+        uint64_t allocatedBytes;
+        double startMs;             // Since the collector started (ParseStats::now())
+        double totalMs;
+        double stageMs[parseStageCount]; // Indexed by ParseStage; Walk and Export stay 0
+        unsigned int thread;        // Small id of the parsing thread, in order of first appearance
+
+        FileParseStats() : success(false), bytes(0), lines(0), classes(0), methods(0), enums(0), allocations(0),
+                           allocatedBytes(0), startMs(0.0), totalMs(0.0), stageMs(), thread(0) {}
+
+        double& stage(ParseStage s) { return stageMs[static_cast<size_t>(s)]; }
+        double stage(ParseStage s) const { return stageMs[static_cast<size_t>(s)]; }
+    };
+
+    // Options of a ParseStats collector
+    struct ParseStatsOptions {
+        size_t slowestFiles;        // Files kept in getSlowestFiles()
+        bool bRecordFiles;          // Keep every file in getFiles() (and in the trace); else only the slowest
+
+        ParseStatsOptions() : slowestFiles(20), bRecordFiles(true) {}
+    };
+
+    // Optional instrumentation of explorations: per-stage wall times, per-file sizes and
+    // counts, the slowest files and arena allocations, exportable as JSON or as a Chrome
+    // trace (chrome://tracing, Perfetto). Pass one to SourceExplorerOptions::stats or
+    // SimpleHeaderParser::setStats(); without a collector the parser and the explorer
+    // only test a null pointer, no clock is read.
+    //
+    // Thread-safe: the workers of an exploration record into the same collector.
+    class ParseStats {
+    public:
+        explicit ParseStats(const ParseStatsOptions& options = ParseStatsOptions());
+        ~ParseStats();
+
+        // Forget everything recorded and restart the clock (not while an exploration records)
+        void reset();
+
+        // Milliseconds since the collector was created or reset
+        double now() const;
+
+        // Record a stage that is not tied to one file (walk, export); startMs from now()
+        void recordStage(ParseStage stage, double startMs, double endMs, const std::string& detail = "");
+
+        // Record a parsed file; its stage times are added to the stage totals
+        void recordFile(FileParseStats file);
+
+        ParseStageStats getStage(ParseStage stage) const;
+
+        // Sums over all recorded files (path empty, stage times summed, startMs 0)
+        FileParseStats getTotals() const;
+
+        size_t getFileCount() const;
+
+        // Recorded files in recording order (empty without bRecordFiles)
+        std::vector<FileParseStats> getFiles() const;
+
+        // The slowest files by totalMs, slowest first
+        std::vector<FileParseStats> getSlowestFiles() const;
+
+        // Stages, totals, slowest files and (with bRecordFiles) every file
+        std::string exportToJson(bool bPretty = true) const;
+        bool exportToJson(std::ostream& out, bool bPretty = true) const;
+        bool exportToJsonFile(const std::string& filePath, bool bPretty = true) const;
+
+        // Chrome trace event format: one complete event per stage run, per file and thread
+        std::string exportToChromeTrace() const;
+        bool exportToChromeTrace(std::ostream& out) const;
+        bool exportToChromeTraceFile(const std::string& filePath) const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // PARSE_STATS_H
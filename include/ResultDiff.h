@@ -0,0 +1,92 @@
+#ifndef RESULT_DIFF_H
+#define RESULT_DIFF_H
+
+#include "SourceExplorer.h"
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+namespace UFMTooling {
+
+    enum class DiffKind {
+        Added,
+        Removed,
+        Changed
+    };
+
+    // What a DiffEntry is about
+    enum class DiffEntity {
+        File,
+        Class,
+        Method,
+        Member,
+        Enum
+    };
+
+    // Names used in the JSON output ("added", "class", ...)
+    const char* diffKindName(DiffKind kind);
+    const char* diffEntityName(DiffEntity entity);
+
+    // One added, removed or changed declaration
+    struct DiffEntry {
+        DiffKind kind;
+        DiffEntity entity;
+        std::string file;           // Path relative to its result's root (the after side unless removed)
+        std::string scope;          // Full name of the class, for methods and members
+        std::string name;           // Key it was matched by: path, class full name, enum or member
+                                    // name, or method signature (name, parameter types, const)
+        std::string before;         // Declaration before the change (empty if added)
+        std::string after;          // Declaration after the change (empty if removed)
+        bool bBreaking;             // Likely to break binary compatibility: anything removed or changed
+                                    // except default values and appended enum values, and data members
+                                    // or virtual methods added to an existing class
+
+        DiffEntry() : kind(DiffKind::Changed), entity(DiffEntity::File), bBreaking(false) {}
+    };
+
+    struct ResultDiffOptions {
+        std::string beforeRoot;     // Prefix removed from the paths of the before result (e.g. its checkout)
+        std::string afterRoot;      // Same for the after result; files are matched by the remaining path
+        bool bSkipByFingerprint;    // Skip files whose parse result is shared by both sides (the cache
+                                    // reused it) or whose content hashes match, without comparing them
+
+        ResultDiffOptions() : bSkipByFingerprint(true) {}
+    };
+
+    // Outcome of ResultDiff::compare()
+    struct ResultDiffReport {
+        std::vector<DiffEntry> entries; // By file path, then in declaration order: removed entries first,
+                                        // then the added and changed ones; a class's own entry before
+                                        // those of its members and methods
+        size_t filesCompared;       // Files present on both sides
+        size_t filesSkipped;        // Of those, skipped as unchanged by their fingerprint
+        size_t added;
+        size_t removed;
+        size_t changed;
+        size_t breaking;            // Entries with bBreaking set
+        bool success;
+        std::string errorMessage;
+
+        ResultDiffReport() : filesCompared(0), filesSkipped(0), added(0), removed(0), changed(0), breaking(0),
+                             success(false) {}
+    };
+
+    // Structural diff of two SourceExplorerResults: files are matched by relative path,
+    // classes by full name, methods by signature, members and enums by name. Declarations
+    // are paired by position while both sides agree and by a hash of their key otherwise,
+    // so the cost stays linear in the number of declarations; paired ones are compared
+    // field by field (type strings by their interned id), and text is only built for
+    // what is reported. Files the cache shows to be unchanged are not compared at all.
+    class ResultDiff {
+    public:
+        static ResultDiffReport compare(const SourceExplorerResult& before, const SourceExplorerResult& after,
+                                        const ResultDiffOptions& options = ResultDiffOptions());
+
+        // Write a report as JSON (2-space indented, or compact)
+        static bool writeJson(const ResultDiffReport& report, std::ostream& out, bool bPretty = true);
+    };
+
+} // namespace UFMTooling
+
+#endif // RESULT_DIFF_H
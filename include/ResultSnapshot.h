@@ -0,0 +1,337 @@
+#ifndef RESULT_SNAPSHOT_H
+#define RESULT_SNAPSHOT_H
+
+#include "SourceExplorer.h"
+#include "PUMLClassParser.h"
+#include "PUMLEntityParser.h"
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <memory>
+#include <cstdint>
+
+namespace UFMTooling {
+
+    // Records of the binary snapshot format. Every string is a StringRef into one string
+    // table, every list a Range of rows in another table; records hold no pointers, so
+    // a mapped file is used as it is.
+    namespace Snapshot {
+
+        struct StringRef {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        struct Range {
+            uint32_t begin;
+            uint32_t count;
+        };
+
+        // Flags of the records below
+        enum : uint32_t {
+            Success = 1u << 0,
+            FromCache = 1u << 1,
+            IsStruct = 1u << 0,
+            IsTemplate = 1u << 1,
+            IsStatic = 1u << 0,
+            IsConst = 1u << 1,
+            IsVirtual = 1u << 2,
+            IsPureVirtual = 1u << 3,
+            IsConstructor = 1u << 4,
+            IsDestructor = 1u << 5,
+            IsOperator = 1u << 6,
+            IsReference = 1u << 2,
+            IsPointer = 1u << 3,
+            IsClass = 1u << 0,
+            IsAbstract = 1u << 1,
+            IsInterface = 1u << 2,
+            IsPrimaryKey = 1u << 0,
+            IsForeignKey = 1u << 1,
+            IsUnique = 1u << 2,
+            IsNotNull = 1u << 3,
+            IsIdentifying = 1u << 0
+        };
+
+        // Top-level fields of the stored result (one row)
+        struct Summary {
+            StringRef title;            // Diagrams only
+            StringRef errorMessage;
+            uint32_t flags;             // Success
+            int32_t filesProcessed;
+            int32_t filesWithErrors;
+            int32_t filesFromCache;
+        };
+
+        // SourceExplorerResult
+        struct File {
+            StringRef path;
+            StringRef filename;
+            StringRef errorMessage;
+            StringRef parseFileName;
+            StringRef parseErrorMessage;
+            uint32_t flags;             // Success, FromCache (analysis)
+            uint32_t parseFlags;        // Success (parse result)
+            Range classes;
+            Range enums;
+            Range includes;             // Names
+            Range namespaces;           // Rows of the file's namespaces, in pre-order
+            int64_t lastWriteTime;
+            uint64_t size;
+            uint64_t contentHash;
+            uint64_t optionsHash;
+        };
+
+        // Namespace of a file; a nested namespace follows its parent, after any earlier sibling's subtree
+        struct Namespace {
+            StringRef name;             // Empty for an anonymous namespace
+            uint32_t parent;            // Row of the enclosing namespace, or NoParent
+            Range classes;              // Full names of the classes declared directly in it (Names)
+        };
+
+        const uint32_t NoParent = 0xFFFFFFFFu;
+
+        struct Class {
+            StringRef name;
+            StringRef fullName;
+            uint32_t flags;             // IsStruct, IsTemplate
+            Range baseClasses;
+            Range members;
+            Range methods;
+            Range friendClasses;        // Names
+            Range templateParameters;   // Names
+        };
+
+        struct BaseClass {
+            StringRef name;
+            uint32_t access;            // AccessSpecifier
+        };
+
+        struct Member {
+            StringRef name;
+            StringRef type;
+            StringRef defaultValue;
+            uint32_t access;
+            uint32_t flags;             // IsStatic, IsConst
+        };
+
+        struct Method {
+            StringRef name;
+            StringRef returnType;
+            uint32_t access;
+            uint32_t flags;             // IsStatic .. IsOperator
+            Range parameters;
+        };
+
+        struct Parameter {
+            StringRef name;
+            StringRef type;
+            StringRef defaultValue;
+            uint32_t flags;             // IsConst, IsReference, IsPointer
+        };
+
+        struct Enum {
+            StringRef name;
+            uint32_t flags;             // IsClass
+            Range values;
+        };
+
+        struct EnumValue {
+            StringRef name;
+            StringRef value;
+        };
+
+        // PUMLClassDiagramResult
+        struct UMLClassRecord {
+            StringRef name;
+            StringRef stereotype;
+            StringRef package;
+            StringRef note;
+            uint32_t flags;             // IsAbstract, IsInterface
+            Range attributes;
+            Range methods;
+        };
+
+        struct UMLAttributeRecord {
+            StringRef name;
+            StringRef type;
+            StringRef defaultValue;
+            StringRef stereotype;
+            uint32_t visibility;        // UMLVisibility
+            uint32_t flags;             // IsStatic
+        };
+
+        struct UMLMethodRecord {
+            StringRef name;
+            StringRef returnType;
+            StringRef stereotype;
+            uint32_t visibility;
+            uint32_t flags;             // IsStatic, IsAbstract
+            Range parameters;
+        };
+
+        struct UMLParameterRecord {
+            StringRef name;
+            StringRef type;
+            StringRef direction;
+            StringRef defaultValue;
+        };
+
+        struct UMLRelationshipRecord {
+            StringRef fromClass;
+            StringRef toClass;
+            StringRef label;
+            StringRef fromCardinality;
+            StringRef toCardinality;
+            uint32_t type;              // UMLRelationship
+        };
+
+        // Diagram notes, sorted by key
+        struct Note {
+            StringRef key;
+            StringRef text;
+        };
+
+        // PUMLEntityDiagramResult
+        struct EntityRecord {
+            StringRef name;
+            StringRef alias;
+            StringRef schema;
+            StringRef comment;
+            StringRef stereotype;
+            Range fields;
+        };
+
+        struct EntityFieldRecord {
+            StringRef name;
+            StringRef type;
+            StringRef defaultValue;
+            StringRef comment;
+            uint32_t flags;             // IsPrimaryKey .. IsNotNull
+            Range constraints;          // Values (EntityFieldType)
+        };
+
+        struct EntityRelationshipRecord {
+            StringRef fromEntity;
+            StringRef toEntity;
+            StringRef label;
+            uint32_t fromCardinality;   // Cardinality
+            uint32_t toCardinality;
+            uint32_t type;              // EntityRelationType
+            uint32_t flags;             // IsIdentifying
+            Range fromFields;           // Names
+            Range toFields;             // Names
+        };
+
+        // Read-only rows of one table
+        template <typename T>
+        class Table {
+        public:
+            Table() : rows(nullptr), count(0) {}
+            Table(const T* data, size_t size) : rows(data), count(size) {}
+
+            size_t size() const { return count; }
+            bool empty() const { return count == 0; }
+            const T& operator[](size_t i) const { return rows[i]; }
+            const T* begin() const { return rows; }
+            const T* end() const { return rows + count; }
+
+            // Rows of a Range stored in a record (validated on load)
+            Table slice(Range range) const { return Table(rows + range.begin, range.count); }
+
+        private:
+            const T* rows;
+            size_t count;
+        };
+
+    } // namespace Snapshot
+
+    // What a snapshot holds
+    enum class SnapshotKind {
+        None,
+        SourceExplorer,
+        ClassDiagram,
+        EntityDiagram
+    };
+
+    // Versioned binary snapshot of a SourceExplorerResult or a PUML diagram result.
+    // The snapshot is one flat buffer: fixed-size records in tables, plus a string table.
+    // load() maps a saved file and validates every offset once; the tables are then read
+    // in place, without building any std::string. The to*() calls materialize the usual
+    // structs when they are needed, and exportToJson() writes the SourceExplorer JSON.
+    class ResultSnapshot {
+    public:
+        ResultSnapshot();
+        ~ResultSnapshot();
+
+        ResultSnapshot(ResultSnapshot&& other) noexcept;
+        ResultSnapshot& operator=(ResultSnapshot&& other) noexcept;
+
+        // Snapshot a result (replaces the current contents)
+        void build(const SourceExplorerResult& result);
+        void build(const PUMLClassDiagramResult& result);
+        void build(const PUMLEntityDiagramResult& result);
+
+        // Read a file written by SourceExplorer::exportToJsonFile() into this snapshot
+        bool importJson(const std::string& jsonFilePath);
+
+        void clear();
+
+        // Write the snapshot to a file (atomically, via a temporary file)
+        bool save(const std::string& filePath) const;
+
+        // Map a snapshot file (replaces the current contents)
+        bool load(const std::string& filePath);
+
+        // Reason for the last failed call
+        const std::string& getErrorMessage() const;
+
+        SnapshotKind kind() const;
+
+        // Text of a StringRef of this snapshot
+        std::string_view str(Snapshot::StringRef ref) const;
+
+        const Snapshot::Summary& summary() const;
+
+        // Tables; records refer to each other's rows with Ranges (see Table::slice)
+        Snapshot::Table<Snapshot::StringRef> names() const;
+        Snapshot::Table<uint32_t> values() const;
+        Snapshot::Table<Snapshot::File> files() const;
+        Snapshot::Table<Snapshot::Class> classes() const;
+        Snapshot::Table<Snapshot::BaseClass> baseClasses() const;
+        Snapshot::Table<Snapshot::Member> members() const;
+        Snapshot::Table<Snapshot::Method> methods() const;
+        Snapshot::Table<Snapshot::Parameter> parameters() const;
+        Snapshot::Table<Snapshot::Enum> enums() const;
+        Snapshot::Table<Snapshot::EnumValue> enumValues() const;
+        Snapshot::Table<Snapshot::Namespace> namespaces() const;
+        Snapshot::Table<Snapshot::UMLClassRecord> umlClasses() const;
+        Snapshot::Table<Snapshot::UMLAttributeRecord> umlAttributes() const;
+        Snapshot::Table<Snapshot::UMLMethodRecord> umlMethods() const;
+        Snapshot::Table<Snapshot::UMLParameterRecord> umlParameters() const;
+        Snapshot::Table<Snapshot::UMLRelationshipRecord> umlRelationships() const;
+        Snapshot::Table<Snapshot::Note> notes() const;
+        Snapshot::Table<Snapshot::EntityRecord> entities() const;
+        Snapshot::Table<Snapshot::EntityFieldRecord> entityFields() const;
+        Snapshot::Table<Snapshot::EntityRelationshipRecord> entityRelationships() const;
+
+        // Materialize the stored result; false if the snapshot holds another kind
+        bool toResult(SourceExplorerResult& result) const;
+        bool toResult(PUMLClassDiagramResult& result) const;
+        bool toResult(PUMLEntityDiagramResult& result) const;
+
+        // Materialize the parse result of one file of a SourceExplorer snapshot
+        std::shared_ptr<const ParseResult> toParseResult(size_t file) const;
+
+        // Same JSON as SourceExplorer::exportToJson() of the stored result, written one
+        // file at a time (SourceExplorer snapshots only)
+        bool exportToJson(std::ostream& out, bool bPretty = true) const;
+        std::string exportToJson(bool bPretty = true) const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // RESULT_SNAPSHOT_H
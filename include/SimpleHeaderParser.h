@@ -1,13 +1,19 @@
 #ifndef SIMPLE_HEADER_PARSER_H
 #define SIMPLE_HEADER_PARSER_H
 
+#include "StringInterner.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
+#include <memory_resource>
 
 namespace UFMTooling {
 
+    class ArenaParseResult;
+    class ParseStats;
+
     // Enum for access specifiers
     enum class AccessSpecifier {
         Public,
@@ -19,7 +25,7 @@ namespace UFMTooling {
     // Represents a member variable in a class
     struct MemberInfo {
         std::string name;
-        std::string type;
+        InternedString type;
         AccessSpecifier access;
         bool isStatic;
         bool isConst;
@@ -31,7 +37,7 @@ namespace UFMTooling {
     // Represents a parameter in a method
     struct ParameterInfo {
         std::string name;
-        std::string type;
+        InternedString type;
         std::string defaultValue;
         bool isConst;
         bool isReference;
@@ -43,7 +49,7 @@ namespace UFMTooling {
     // Represents a method/function in a class
     struct MethodInfo {
         std::string name;
-        std::string returnType;
+        InternedString returnType;
         AccessSpecifier access;
         std::vector<ParameterInfo> parameters;
         bool isStatic;
@@ -84,8 +90,8 @@ namespace UFMTooling {
 
     // Represents a namespace
     struct NamespaceInfo {
-        std::string name;
-        std::vector<ClassInfo> classes;
+        std::string name;                       // Empty for an anonymous namespace
+        std::vector<ClassInfo> classes;         // Copies of the classes declared directly in it
         std::vector<NamespaceInfo> nestedNamespaces;
     };
 
@@ -111,6 +117,41 @@ namespace UFMTooling {
         ParseResult() : success(false) {}
     };
 
+    // What SimpleHeaderParser extracts. Each level has its own compiled declaration pass,
+    // so lighter levels skip their work without testing for it on every line.
+    enum class ParseDetail {
+        Full,           // Classes with members and methods, namespaces, enums and includes
+        NoMethods,      // The same without methods (nor their parameter lists)
+        Types,          // Classes (names, bases, template parameters), namespaces, enums and includes
+        IncludesOnly    // Includes only, from a structure-only pass that builds no tokens
+    };
+
+    // How SimpleHeaderParser treats preprocessor conditionals. By default the code of
+    // every branch is kept; conditions it cannot decide (anything beyond an integer or
+    // defined(NAME), optionally negated) keep it even with bSkipDisabledBlocks.
+    struct PreprocessorOptions {
+        bool bSkipDisabledBlocks;   // Drop the code of #if 0 / #elif 0 blocks and of the branches
+                                    // after one known to be taken
+        bool bEvaluateDefines;      // Also decide #ifdef, #ifndef and defined(NAME) from defines,
+                                    // kept up to date by the #define and #undef lines of the file
+        std::vector<std::string> defines; // Macros defined before the file starts
+
+        PreprocessorOptions() : bSkipDisabledBlocks(false), bEvaluateDefines(false) {}
+    };
+
+    // Splitting of very large headers across threads. A prescan finds the lines that end a
+    // declaration at namespace scope; the chunks between them are parsed on several threads
+    // and merged back in source order, into the same result as a serial parse. A chunk that
+    // does not end in the state the next one starts from (a declaration the prescan could
+    // not follow) makes the whole file parse serially.
+    struct ParallelParseOptions {
+        unsigned int threadCount;   // Threads per file (1 = serial; 0 = UFM_TOOLING_THREADS or hardware concurrency)
+        size_t minFileBytes;        // Smaller files are parsed serially
+        size_t minChunkBytes;       // Smallest chunk handed to a thread
+
+        ParallelParseOptions() : threadCount(1), minFileBytes(4 << 20), minChunkBytes(256 << 10) {}
+    };
+
     // Main parser class
     class SimpleHeaderParser {
     public:
@@ -123,6 +164,22 @@ namespace UFMTooling {
         // Parse header content from string
         ParseResult parseContent(const std::string& content, const std::string& fileName = "");
 
+        // Same as parseFile()/parseContent(), but the result is shared with the parser
+        // instead of copied out; it stays valid after the next parse
+        std::shared_ptr<const ParseResult> parseFileShared(const std::string& filePath);
+        std::shared_ptr<const ParseResult> parseContentShared(std::string_view content, const std::string& fileName = "");
+
+        // Parse into an arena-backed result: all nodes and strings of the file share one
+        // monotonic buffer (on top of upstream, null = new/delete) freed with the result.
+        // Does not change getLastResult() or the getters below.
+        std::shared_ptr<const ArenaParseResult> parseFileArena(const std::string& filePath,
+                                                               std::pmr::memory_resource* upstream = nullptr);
+        std::shared_ptr<const ArenaParseResult> parseContentArena(std::string_view content, const std::string& fileName = "",
+                                                                  std::pmr::memory_resource* upstream = nullptr);
+
+        // Result of the last parse (never null)
+        std::shared_ptr<const ParseResult> getLastResult() const;
+
         // Get all classes found
         const std::vector<ClassInfo>& getClasses() const;
 
@@ -138,6 +195,25 @@ namespace UFMTooling {
         // Get parsing errors/warnings
         const std::vector<std::string>& getWarnings() const;
 
+        // Record the stage times and counts of every following parse into stats
+        // (not owned; null, the default, records nothing)
+        void setStats(ParseStats* stats);
+
+        // Conditional handling of every following parse
+        void setPreprocessorOptions(const PreprocessorOptions& options);
+
+        // What every following parse extracts (ParseDetail::Full by default)
+        void setParseDetail(ParseDetail detail);
+
+        // Parse large files of the following parseFile()/parseContent() calls (and their
+        // shared variants) on several threads; arena parses stay serial
+        void setParallelOptions(const ParallelParseOptions& options);
+
+        // Read the files of the following parseFile() calls (and their shared and arena
+        // variants) into memory instead of mapping them, for files that may be truncated
+        // while they are parsed (see MappedFile)
+        void setCopyFiles(bool bCopy);
+
     private:
         class Impl;
         std::unique_ptr<Impl> pImpl;
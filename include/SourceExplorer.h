@@ -2,24 +2,30 @@
 #define SOURCE_EXPLORER_H
 
 #include "SimpleHeaderParser.h"
+#include "AnalysisCache.h"
+#include "FileSystemExplorer.h"
+#include "PUMLBatchParser.h"
+#include "ParseStats.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <ostream>
+#include <functional>
 
 namespace UFMTooling {
 
-    // Forward declarations
-    struct FileSystemEntry;
-
     // Represents the result of analyzing a single header file
     struct SourceFileAnalysis {
         std::string path;           // Full path to the file
         std::string filename;       // Name of the file
-        ParseResult parseResult;    // Result from SimpleHeaderParser
+        std::shared_ptr<const ParseResult> parseResult; // Result from SimpleHeaderParser, shared
+                                    // with the cache (never null in results from explore())
         bool success;
         std::string errorMessage;
+        FileFingerprint fingerprint; // File identity (filled when a cache is used)
+        bool fromCache;             // True if parseResult was reused from the cache
         
-        SourceFileAnalysis() : success(false) {}
+        SourceFileAnalysis() : success(false), fromCache(false) {}
     };
 
     // Result of source code exploration
@@ -29,28 +35,120 @@ namespace UFMTooling {
         std::string errorMessage;
         int filesProcessed;
         int filesWithErrors;
+        int filesFromCache;         // Files whose result was reused from the cache
         
-        SourceExplorerResult() : success(false), filesProcessed(0), filesWithErrors(0) {}
+        SourceExplorerResult() : success(false), filesProcessed(0), filesWithErrors(0), filesFromCache(0) {}
     };
 
+    // Pipelined exploration, for file systems where opening and reading a file is slow
+    // (network shares): I/O threads check the cache, open and read headers ahead of the
+    // parser threads, which parse from memory and feed the visitor (or JSON writer) in path
+    // order. Each stage waits while the queue in front of the next one is full.
+    struct ReadPipelineOptions {
+        bool bEnabled;
+        unsigned int ioThreads;     // Files being read at the same time (0 = 4 per parser thread)
+        size_t readQueueDepth;      // Files read or being read but not yet claimed by a parser (0 = 2 per I/O thread)
+        size_t outputQueueDepth;    // Files between the readers and the visitor, parsed or not: bounds
+                                    // the memory of the pipeline (0 = readQueueDepth + 4 per parser thread)
+
+        ReadPipelineOptions() : bEnabled(false), ioThreads(0), readQueueDepth(0), outputQueueDepth(0) {}
+    };
+
+    // Options controlling a single exploration run
+    struct SourceExplorerOptions {
+        bool bRecursive;            // Explore subdirectories
+        unsigned int threadCount;   // Parser threads (0 = UFM_TOOLING_THREADS or hardware concurrency)
+        AnalysisCache* cache;       // Reuse unchanged results and record new ones (not owned, may be null)
+        bool bHashContents;         // Also match cache entries by content hash when mtime changed
+        FileSystemExplorerOptions walk; // Directory walk: globs, pruning, walker threads
+                                    // (bRecursive, extensions, directories and sizes are set by the explorer)
+        PreprocessorOptions preprocessor; // Conditional blocks (SimpleHeaderParser::setPreprocessorOptions);
+                                    // cached results are only reused under the options they were parsed with
+        ParallelParseOptions parallel; // Huge headers split across threads (SimpleHeaderParser::setParallelOptions),
+                                    // on top of the threadCount parsers
+        ParseDetail detail;         // What the parsers extract (SimpleHeaderParser::setParseDetail); lighter
+                                    // results reuse full cached ones but are not recorded in the cache
+        ReadPipelineOptions pipeline; // Read headers ahead of the parsers on I/O threads (off by default)
+        bool bCopyFiles;            // Read headers into memory instead of mapping them (SimpleHeaderParser::setCopyFiles),
+                                    // when they may be truncated during the exploration
+        ParseStats* stats;          // Record stage times and per-file counts (not owned, null = off); the
+                                    // export functions record into the stats of the last exploration
+
+        SourceExplorerOptions() : bRecursive(true), threadCount(0), cache(nullptr), bHashContents(false),
+                                  detail(ParseDetail::Full), bCopyFiles(false), stats(nullptr) {}
+    };
+
+    // Called for each analyzed header, in path order, on the thread that called explore().
+    // The analysis may be moved from. Return false to stop the exploration early.
+    using SourceFileVisitor = std::function<bool(SourceFileAnalysis& analysis)>;
+
     // Class for exploring source code and analyzing header files
     class SourceExplorer {
     public:
         SourceExplorer();
         ~SourceExplorer();
 
-        // Explore a directory and analyze all .h files
-        SourceExplorerResult explore(const std::string& basePath, bool bRecursive = true);
+        // Explore a directory and analyze all .h files.
+        // The returned reference is getLastResult(), valid until the next exploration.
+        const SourceExplorerResult& explore(const std::string& basePath, bool bRecursive = true);
+
+        // Explore a directory with explicit options (thread count, recursion).
+        // Analyses are always returned sorted by path, whatever the thread count.
+        // An exception thrown on a parser thread stops the exploration and is rethrown
+        // here once every thread has finished.
+        const SourceExplorerResult& explore(const std::string& basePath, const SourceExplorerOptions& options);
 
-        // Export the last exploration result to JSON
-        std::string exportToJson() const;
+        // Explore a directory and hand each analysis to visitor as soon as it is ready,
+        // instead of collecting them. Only a few analyses are alive at any time, so
+        // memory use does not grow with the size of the tree. The returned result (and
+        // getLastResult()) only carries the counters, its analyses vector is empty.
+        const SourceExplorerResult& explore(const std::string& basePath, const SourceExplorerOptions& options,
+                                            const SourceFileVisitor& visitor);
 
-        // Export the last exploration result to a JSON file
-        bool exportToJsonFile(const std::string& filePath) const;
+        // Explore a directory and stream the JSON export of each analysis to out as soon
+        // as it is ready, without keeping the analyses in memory. The output is the same
+        // as explore() followed by exportToJson(); the returned result (and getLastResult())
+        // only carries the counters, its analyses vector is empty.
+        const SourceExplorerResult& exploreToJson(const std::string& basePath, std::ostream& out,
+                                                  const SourceExplorerOptions& options = SourceExplorerOptions(),
+                                                  bool bPretty = true);
+
+        // Export the last exploration result to JSON (2-space indented, or compact)
+        std::string exportToJson(bool bPretty = true) const;
+
+        // Stream the last exploration result as JSON to out
+        bool exportToJson(std::ostream& out, bool bPretty = true) const;
+
+        // Export the last exploration result to a JSON file, streamed without building
+        // the whole document in memory
+        bool exportToJsonFile(const std::string& filePath, bool bPretty = true) const;
+
+        // Load a result written by exportToJsonFile() (or exploreToJson()) back into
+        // getLastResult(), e.g. to compare with a new scan. The file is mapped and read
+        // with a pull parser straight into the result, without a JSON DOM. On failure the
+        // result is empty, with success false and errorMessage set.
+        const SourceExplorerResult& importFromJsonFile(const std::string& filePath);
+
+        // Same, handing each analysis to visitor as soon as it is read instead of
+        // collecting them, so memory use does not grow with the size of the file
+        const SourceExplorerResult& importFromJsonFile(const std::string& filePath, const SourceFileVisitor& visitor);
 
         // Get the last exploration result
         const SourceExplorerResult& getLastResult() const;
 
+        // Set parser up as the explorations do for options (preprocessor, parallel
+        // parsing, detail level, stats), e.g. to reparse single files the same way
+        static void configureParser(SimpleHeaderParser& parser, const SourceExplorerOptions& options);
+
+        // Parse every .puml file under basePath, class and entity diagrams alike, on a
+        // worker pool (see PUMLBatchParser). The returned reference is getLastPUMLResult(),
+        // valid until the next PUML exploration.
+        const PUMLBatchResult& explorePUML(const std::string& basePath,
+                                           const PUMLBatchOptions& options = PUMLBatchOptions());
+
+        // Get the last PUML exploration result
+        const PUMLBatchResult& getLastPUMLResult() const;
+
     private:
         class Impl;
         std::unique_ptr<Impl> pImpl;
@@ -0,0 +1,103 @@
+#ifndef SOURCE_SERVER_H
+#define SOURCE_SERVER_H
+
+#include "SourceExplorer.h"
+#include "PUMLBatchParser.h"
+#include <string>
+#include <memory>
+#include <cstdint>
+
+namespace UFMTooling {
+
+    // Options of a SourceServer
+    struct SourceServerOptions {
+        std::string endpoint;           // Socket path (POSIX) or pipe name (Windows); empty = defaultEndpoint(),
+                                        // "-" = no listener, requests only through handleRequest().
+                                        // The socket directory must belong to the user and be writable
+                                        // by nobody else; it is created (0700) if missing.
+        SourceExplorerOptions explore;  // Header exploration (the cache is the server's own, explore.cache is ignored;
+                                        // files are always read as copies, explore.bCopyFiles and puml.bCopyFiles are set)
+        bool bPUML;                     // Also keep the .puml diagrams under the base path parsed
+        PUMLBatchOptions puml;
+        std::string cacheFile;          // AnalysisCache loaded at start() and saved at stop() (empty = none)
+        unsigned int debounceMs;        // After a change, wait this long for more before updating
+        unsigned int pollIntervalMs;    // Rescan interval when the platform has no native watcher
+
+        SourceServerOptions() : bPUML(true), debounceMs(50), pollIntervalMs(2000) {}
+    };
+
+    // State of a SourceServer
+    struct SourceServerStatus {
+        bool running;
+        std::string basePath;
+        std::string endpoint;
+        std::string watcher;            // DirectoryWatcher::backendName(), or "polling" after a watch failure
+        uint64_t generation;            // Incremented by every model update
+        uint64_t requests;              // Requests answered so far
+        size_t files;                   // Headers analyzed
+        size_t filesWithErrors;
+        size_t classes;
+        size_t methods;
+        size_t pumlFiles;
+        double lastUpdateMs;            // Duration of the last model update
+        size_t internedStrings;         // Size of StringInterner::global(), which never shrinks
+        size_t internedBytes;
+        std::string errorMessage;       // Last watcher or update problem (the server keeps running)
+
+        SourceServerStatus() : running(false), generation(0), requests(0), files(0), filesWithErrors(0), classes(0),
+                               methods(0), pumlFiles(0), lastUpdateMs(0.0), internedStrings(0), internedBytes(0) {}
+    };
+
+    // Long-lived analysis service: explores a tree once, keeps the header analyses,
+    // their SymbolIndex and the PUML diagrams in memory, and updates them as files
+    // change (DirectoryWatcher; a modified header is reparsed on its own, new or removed
+    // directories trigger a rescan through the server's AnalysisCache). Clients send
+    // one-line requests to the endpoint and get one line of compact JSON back per
+    // request; several requests may share a connection. Queries run on a snapshot of
+    // the model, so they never wait for an update in progress.
+    //
+    // Requests: status, files, class <name>, derived <name>, method <name>,
+    // includers <name>, puml, export, refresh, shutdown.
+    class SourceServer {
+    public:
+        SourceServer();
+        ~SourceServer();
+
+        // Explore basePath, start watching it and start listening. False (with
+        // getErrorMessage()) if the exploration or the endpoint failed.
+        bool start(const std::string& basePath, const SourceServerOptions& options = SourceServerOptions());
+
+        // Stop listening and watching, and save the cache file
+        void stop();
+
+        // Block until a shutdown request or stop() from another thread, then stop()
+        void wait();
+
+        // Answer one request line, exactly as the endpoint would
+        std::string handleRequest(const std::string& request);
+
+        // Update the model now instead of waiting for the watcher. The update runs on the
+        // server's updater thread; returns once it is published. No effect unless running.
+        void refresh();
+
+        SourceServerStatus getStatus() const;
+
+        const std::string& getErrorMessage() const;
+
+        // Endpoint of the server for basePath, named after a hash of the absolute path: a
+        // socket in a private (0700) per-user directory of the temporary directory, or a
+        // named pipe
+        static std::string defaultEndpoint(const std::string& basePath);
+
+        // Client side: send one request to a server and receive its response line.
+        // False if no server is listening on endpoint.
+        static bool query(const std::string& endpoint, const std::string& request, std::string& response);
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // SOURCE_SERVER_H
@@ -0,0 +1,131 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <ostream>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace UFMTooling {
+
+    // Id of an interned string; 0 is the empty string
+    using Symbol = uint32_t;
+
+    // Thread-safe table of unique strings. Every distinct string is stored once, under a
+    // dense id; interning the same text again returns the same id and the same storage.
+    // Stored strings never move and are only freed with the interner, so views and
+    // InternedStrings stay valid as long as it exists.
+    //
+    // Interning locks one of several shards chosen by the hash; each thread also keeps a
+    // small cache of the strings it interned last, so the common ones (int, bool,
+    // const std::string&) take no lock. view() takes no lock.
+    class StringInterner {
+    public:
+        // Storage of one string (reached through InternedString)
+        struct Entry {
+            std::string text;
+            Symbol id;
+
+            Entry() : id(0) {}
+        };
+
+        StringInterner();
+        ~StringInterner();
+
+        StringInterner(const StringInterner&) = delete;
+        StringInterner& operator=(const StringInterner&) = delete;
+
+        // The interner used by InternedString and therefore by every parser result. It is
+        // never destroyed and never shrinks: it holds the vocabulary of type strings seen
+        // by the process, which is small next to the results themselves. Its size is
+        // bounded by the distinct spellings, not by the number of parses: parsing a file
+        // again adds nothing unless an edit brought a new spelling, so a long-lived
+        // SourceServer grows only with the edits it sees (its status reports the size).
+        static StringInterner& global();
+
+        // Id of text, storing it the first time
+        Symbol intern(std::string_view text);
+
+        // Storage of text, storing it the first time (nullptr for the empty string)
+        const Entry* internEntry(std::string_view text);
+
+        // Id of text if already interned, else 0
+        Symbol find(std::string_view text) const;
+
+        // Text of an id (empty for 0 and for ids this interner did not hand out)
+        std::string_view view(Symbol id) const;
+
+        // Distinct non-empty strings stored
+        size_t size() const;
+
+        // Characters stored, without the per-string overhead
+        size_t storedBytes() const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+    // A string held by the global interner: one pointer, copied without allocating and
+    // compared with another InternedString in O(1). Reads like a const std::string;
+    // assigning text interns it.
+    class InternedString {
+    public:
+        InternedString() : entry(nullptr) {}
+        InternedString(std::string_view text) : entry(StringInterner::global().internEntry(text)) {}
+        InternedString(const std::string& text) : InternedString(std::string_view(text)) {}
+        InternedString(const char* text) : InternedString(std::string_view(text)) {}
+
+        InternedString& operator=(std::string_view text) { return *this = InternedString(text); }
+        InternedString& operator=(const std::string& text) { return *this = InternedString(text); }
+        InternedString& operator=(const char* text) { return *this = InternedString(text); }
+
+        const std::string& str() const { return entry ? entry->text : emptyString(); }
+        operator const std::string&() const { return str(); }
+        std::string_view view() const { return str(); }
+        const char* c_str() const { return str().c_str(); }
+        const char* data() const { return str().data(); }
+        size_t size() const { return str().size(); }
+        size_t length() const { return size(); }
+        bool empty() const { return entry == nullptr; }
+        std::string::const_iterator begin() const { return str().begin(); }
+        std::string::const_iterator end() const { return str().end(); }
+
+        // Id in StringInterner::global()
+        Symbol id() const { return entry ? entry->id : 0; }
+
+        friend bool operator==(const InternedString& a, const InternedString& b) { return a.entry == b.entry; }
+        friend bool operator!=(const InternedString& a, const InternedString& b) { return a.entry != b.entry; }
+        friend bool operator==(const InternedString& a, std::string_view b) { return a.view() == b; }
+        friend bool operator!=(const InternedString& a, std::string_view b) { return a.view() != b; }
+        friend bool operator==(const InternedString& a, const std::string& b) { return a.str() == b; }
+        friend bool operator!=(const InternedString& a, const std::string& b) { return a.str() != b; }
+        friend bool operator==(const InternedString& a, const char* b) { return a.view() == b; }
+        friend bool operator!=(const InternedString& a, const char* b) { return a.view() != b; }
+
+        // Text order, for sorting
+        friend bool operator<(const InternedString& a, const InternedString& b) { return a.view() < b.view(); }
+
+        friend std::ostream& operator<<(std::ostream& out, const InternedString& str) { return out << str.str(); }
+
+    private:
+        static const std::string& emptyString();
+
+        const StringInterner::Entry* entry;
+    };
+
+} // namespace UFMTooling
+
+namespace std {
+    template <>
+    struct hash<UFMTooling::InternedString> {
+        size_t operator()(const UFMTooling::InternedString& str) const noexcept {
+            return std::hash<UFMTooling::Symbol>()(str.id());
+        }
+    };
+}
+
+#endif // STRING_INTERNER_H
@@ -0,0 +1,105 @@
+#ifndef SYMBOL_INDEX_H
+#define SYMBOL_INDEX_H
+
+#include "SourceExplorer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace UFMTooling {
+
+    // A class in a SymbolIndex. Views stay valid while the index is alive and unchanged.
+    struct SymbolClass {
+        uint32_t id;                // Position in the index (0 .. classCount() - 1)
+        std::string_view name;
+        std::string_view fullName;
+        std::string_view file;      // Path of the declaring header
+        bool isStruct;
+        bool isTemplate;
+
+        SymbolClass() : id(0), isStruct(false), isTemplate(false) {}
+    };
+
+    // A method in a SymbolIndex, with the class that declares it
+    struct SymbolMethod {
+        uint32_t classId;
+        std::string_view name;
+        std::string_view className;
+        std::string_view file;
+        AccessSpecifier access;
+        bool isStatic;
+        bool isConst;
+        bool isVirtual;
+
+        SymbolMethod() : classId(0), access(AccessSpecifier::Private), isStatic(false), isConst(false), isVirtual(false) {}
+    };
+
+    // Cross-file index of the classes, bases, methods and includes of a SourceExplorerResult.
+    // Stored as flat arrays over one interned string table, with sorted permutations
+    // for name and prefix queries. save() writes the arrays as they are; load() maps the
+    // file and queries run directly on the mapping, without rebuilding anything.
+    class SymbolIndex {
+    public:
+        SymbolIndex();
+        ~SymbolIndex();
+
+        SymbolIndex(SymbolIndex&& other) noexcept;
+        SymbolIndex& operator=(SymbolIndex&& other) noexcept;
+
+        // Index every analysis of result (replaces the current contents)
+        void build(const SourceExplorerResult& result);
+
+        // Remove everything
+        void clear();
+
+        // Write the index to a file; load() maps it back
+        bool save(const std::string& filePath) const;
+
+        // Map an index file written by save() (replaces the current contents)
+        bool load(const std::string& filePath);
+
+        // Reason for the last save()/load() failure
+        const std::string& getErrorMessage() const;
+
+        size_t fileCount() const;
+        size_t classCount() const;
+        size_t methodCount() const;
+
+        // Path of an indexed file (0 .. fileCount() - 1), in the analyses' order
+        std::string_view filePath(uint32_t file) const;
+
+        SymbolClass classAt(uint32_t id) const;
+
+        // Classes declared with this name or full name
+        std::vector<SymbolClass> findClasses(std::string_view name) const;
+
+        // Base class names of a class, as written in its declaration
+        std::vector<std::string_view> baseClasses(uint32_t id) const;
+
+        // Classes listing baseName as a base; with bTransitive also their derived classes
+        std::vector<SymbolClass> derivedClasses(std::string_view baseName, bool bTransitive = false) const;
+
+        // Methods with this name, in any class
+        std::vector<SymbolMethod> findMethods(std::string_view name) const;
+
+        // Headers declaring a method with this name (each listed once)
+        std::vector<std::string_view> filesDeclaringMethod(std::string_view name) const;
+
+        // Include edges: what a file includes, and which files include a name
+        std::vector<std::string_view> includesOf(std::string_view filePath) const;
+        std::vector<std::string_view> filesIncluding(std::string_view includeName) const;
+
+        // Classes and methods whose name starts with prefix, sorted by name (limit 0 = all)
+        std::vector<SymbolClass> classesWithPrefix(std::string_view prefix, size_t limit = 0) const;
+        std::vector<SymbolMethod> methodsWithPrefix(std::string_view prefix, size_t limit = 0) const;
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // SYMBOL_INDEX_H
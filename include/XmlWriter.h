@@ -0,0 +1,71 @@
+#ifndef XML_WRITER_H
+#define XML_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <memory>
+#include <type_traits>
+
+namespace UFMTooling {
+
+    // Streaming XML writer, the XML counterpart of JsonWriter: markup goes straight into
+    // an output buffer. Attribute values and text are escaped through a byte table;
+    // control characters XML 1.0 cannot represent are dropped. Pretty output indents
+    // nested elements by 2 spaces; elements without children are self-closed.
+    class XmlWriter {
+    public:
+        // Write to a stream; the internal buffer is flushed whenever it fills up
+        explicit XmlWriter(std::ostream& out, bool bPretty = true);
+
+        // Append to a string
+        explicit XmlWriter(std::string& out, bool bPretty = true);
+
+        // Closes open elements and flushes any buffered output
+        ~XmlWriter();
+
+        // <?xml version="1.0" encoding="UTF-8"?>
+        void declaration();
+
+        void beginElement(std::string_view name);
+        void endElement();
+
+        // Attribute of the element just begun; only valid before its children or text
+        void attribute(std::string_view name, std::string_view value);
+        void attribute(std::string_view name, const char* value);
+        void attribute(std::string_view name, const std::string& value);
+        void attribute(std::string_view name, bool value);
+
+        template <typename T>
+        typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+        attribute(std::string_view name, T number) {
+            if (std::is_signed<T>::value) {
+                attributeSigned(name, static_cast<long long>(number));
+            } else {
+                attributeUnsigned(name, static_cast<unsigned long long>(number));
+            }
+        }
+
+        // Character data inside the current element (keeps the element on one line)
+        void text(std::string_view str);
+
+        // <name>str</name>
+        void textElement(std::string_view name, std::string_view str);
+
+        // Push buffered output to the stream
+        void flush();
+
+        // False if writing to the stream failed
+        bool good() const;
+
+    private:
+        void attributeSigned(std::string_view name, long long number);
+        void attributeUnsigned(std::string_view name, unsigned long long number);
+
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // XML_WRITER_H
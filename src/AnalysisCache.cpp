@@ -0,0 +1,287 @@
+#include "../include/AnalysisCache.h"
+#include "../include/MappedFile.h"
+#include "../include/JsonWriter.h"
+#include "ParseResultJson.h"
+#include "JsonReader.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace UFMTooling {
+
+    namespace {
+        // Bumped whenever the cache layout or the parser output changes
+        const int CacheFormatVersion = 3;     // 2: preprocessor options hash
+                                              // 3: qualified fullNames, nested classes, namespaces
+    }
+
+    class AnalysisCache::Impl {
+    public:
+        struct Entry {
+            FileFingerprint fingerprint;
+            std::shared_ptr<const ParseResult> result;
+        };
+
+        std::unordered_map<std::string, Entry> entries;
+        mutable std::shared_mutex mutex;
+
+        bool loadFromFile(const std::string& filePath) {
+            MappedFile file;
+            if (!file.open(filePath)) {
+                return false;
+            }
+
+            // The version is the last key: entries are read first and dropped on a mismatch
+            JsonReader reader(file.view());
+            std::unordered_map<std::string, Entry> loaded;
+            long long version = 0;
+            if (!reader.beginObject()) {
+                return false;
+            }
+            std::string_view key;
+            while (reader.nextKey(key)) {
+                if (key == "version") {
+                    reader.readInteger(version);
+                    continue;
+                }
+                if (key != "entries") {
+                    reader.skipValue();
+                    continue;
+                }
+                if (!reader.beginArray()) continue;
+                while (reader.nextElement()) {
+                    std::string path;
+                    Entry entry;
+                    long long mtime = 0;
+                    uint64_t size = 0;
+                    uint64_t hash = 0;
+                    uint64_t optionsHash = 0;
+                    bool bComplete = true;
+                    auto result = std::make_shared<ParseResult>();
+                    std::string_view entryKey;
+                    if (!reader.beginObject()) continue;
+                    while (reader.nextKey(entryKey)) {
+                        if (entryKey == "path") {
+                            std::string_view value;
+                            bComplete &= reader.readString(value);
+                            path.assign(value.data(), value.size());
+                        } else if (entryKey == "mtime") {
+                            bComplete &= reader.readInteger(mtime);
+                        } else if (entryKey == "size") {
+                            bComplete &= reader.readUnsigned(size);
+                        } else if (entryKey == "hash") {
+                            bComplete &= reader.readUnsigned(hash);
+                        } else if (entryKey == "options") {
+                            bComplete &= reader.readUnsigned(optionsHash);
+                        } else if (entryKey == "result") {
+                            if (!reader.beginObject()) continue;
+                            std::string_view resultKey;
+                            while (reader.nextKey(resultKey)) {
+                                if (!JsonModel::readParseResultMember(resultKey, reader, *result)) reader.skipValue();
+                            }
+                        } else {
+                            reader.skipValue();
+                        }
+                    }
+                    if (!bComplete || path.empty()) {
+                        return false;   // Not a cache file: start from an empty cache
+                    }
+                    JsonModel::resolveNamespaces(*result);
+                    result->fileName = path;
+                    result->success = true;
+                    entry.fingerprint.lastWriteTime = mtime;
+                    entry.fingerprint.size = size;
+                    entry.fingerprint.contentHash = hash;
+                    entry.fingerprint.optionsHash = optionsHash;
+                    entry.result = std::move(result);
+                    loaded[path] = std::move(entry);
+                }
+            }
+            if (!reader.finish() || version != CacheFormatVersion) {
+                return false;   // Damaged or stale format: start from an empty cache
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            entries.swap(loaded);
+            return true;
+        }
+
+        bool saveToFile(const std::string& filePath) const {
+            try {
+                // Write to a temporary file first so a crash never leaves a truncated cache
+                std::string tempPath = filePath + ".tmp";
+                {
+                    std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+                    if (!outFile.is_open()) {
+                        return false;
+                    }
+
+                    std::shared_lock<std::shared_mutex> lock(mutex);
+                    JsonWriter writer(outFile, false);
+                    writer.beginObject();
+                    writer.key("entries");
+                    writer.beginArray();
+                    for (const auto& item : entries) {
+                        writer.beginObject();
+                        writer.member("hash", item.second.fingerprint.contentHash);
+                        writer.member("mtime", item.second.fingerprint.lastWriteTime);
+                        writer.member("options", item.second.fingerprint.optionsHash);
+                        writer.member("path", item.first);
+                        writer.key("result");
+                        writer.beginObject();
+                        JsonModel::writeParseResult(*item.second.result, writer);
+                        writer.endObject();
+                        writer.member("size", item.second.fingerprint.size);
+                        writer.endObject();
+                    }
+                    writer.endArray();
+                    writer.member("version", CacheFormatVersion);
+                    writer.endObject();
+                    writer.flush();
+                    if (!writer.good()) {
+                        return false;
+                    }
+                }
+
+                std::error_code ec;
+                fs::rename(tempPath, filePath, ec);
+                if (ec) {
+                    fs::remove(tempPath, ec);
+                    return false;
+                }
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    };
+
+    // AnalysisCache implementation
+    AnalysisCache::AnalysisCache() : pImpl(new Impl()) {}
+
+    AnalysisCache::~AnalysisCache() = default;
+
+    bool AnalysisCache::find(const std::string& path, FileFingerprint& fingerprint,
+                             std::shared_ptr<const ParseResult>* result) const {
+        std::shared_lock<std::shared_mutex> lock(pImpl->mutex);
+        auto it = pImpl->entries.find(path);
+        if (it == pImpl->entries.end()) {
+            return false;
+        }
+        fingerprint = it->second.fingerprint;
+        if (result != nullptr) {
+            *result = it->second.result;
+        }
+        return true;
+    }
+
+    void AnalysisCache::store(const std::string& path, const FileFingerprint& fingerprint,
+                              std::shared_ptr<const ParseResult> result) {
+        std::unique_lock<std::shared_mutex> lock(pImpl->mutex);
+        Impl::Entry& entry = pImpl->entries[path];
+        entry.fingerprint = fingerprint;
+        entry.result = std::move(result);
+    }
+
+    void AnalysisCache::store(const std::string& path, const FileFingerprint& fingerprint, const ParseResult& result) {
+        store(path, fingerprint, std::make_shared<const ParseResult>(result));
+    }
+
+    bool AnalysisCache::erase(const std::string& path) {
+        std::unique_lock<std::shared_mutex> lock(pImpl->mutex);
+        return pImpl->entries.erase(path) > 0;
+    }
+
+    size_t AnalysisCache::pruneMissing() {
+        std::unique_lock<std::shared_mutex> lock(pImpl->mutex);
+        size_t removed = 0;
+        for (auto it = pImpl->entries.begin(); it != pImpl->entries.end();) {
+            std::error_code ec;
+            if (!fs::exists(it->first, ec)) {
+                it = pImpl->entries.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+        return removed;
+    }
+
+    void AnalysisCache::clear() {
+        std::unique_lock<std::shared_mutex> lock(pImpl->mutex);
+        pImpl->entries.clear();
+    }
+
+    size_t AnalysisCache::size() const {
+        std::shared_lock<std::shared_mutex> lock(pImpl->mutex);
+        return pImpl->entries.size();
+    }
+
+    bool AnalysisCache::load(const std::string& filePath) {
+        return pImpl->loadFromFile(filePath);
+    }
+
+    bool AnalysisCache::save(const std::string& filePath) const {
+        return pImpl->saveToFile(filePath);
+    }
+
+    bool AnalysisCache::fingerprintFile(const std::string& path, bool bHashContents, FileFingerprint& fingerprint,
+                                        bool bCopy) {
+        std::error_code ec;
+        auto writeTime = fs::last_write_time(path, ec);
+        if (ec) {
+            return false;
+        }
+        auto fileSize = fs::file_size(path, ec);
+        if (ec) {
+            return false;
+        }
+
+        fingerprint.lastWriteTime = static_cast<long long>(writeTime.time_since_epoch().count());
+        fingerprint.size = static_cast<uint64_t>(fileSize);
+        fingerprint.contentHash = 0;
+
+        if (bHashContents) {
+            MappedFile file;
+            if (!file.open(path, bCopy)) {
+                return false;
+            }
+            fingerprint.contentHash = hashContent(file.view());
+        }
+        return true;
+    }
+
+    uint64_t AnalysisCache::hashContent(std::string_view content) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : content) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        // Reserve 0 for "not computed"
+        return hash == 0 ? 1 : hash;
+    }
+
+    uint64_t AnalysisCache::hashOptions(const PreprocessorOptions& options) {
+        if (!options.bSkipDisabledBlocks) {
+            return 0;   // The other options only matter when conditional blocks are skipped
+        }
+        std::string key = options.bEvaluateDefines ? "skip,evaluate" : "skip";
+        if (options.bEvaluateDefines) {
+            // Initial defines form a set: their order does not change the parse
+            std::vector<std::string> defines = options.defines;
+            std::sort(defines.begin(), defines.end());
+            defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+            for (const auto& define : defines) {
+                key += '\0';
+                key += define;
+            }
+        }
+        return hashContent(key);
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,153 @@
+#include "../include/ArenaParseResult.h"
+#include <cstring>
+
+namespace UFMTooling {
+
+    namespace {
+        // First chunk of an owned arena; later chunks grow geometrically
+        const size_t InitialArenaBytes = 16 * 1024;
+
+        std::vector<std::string> toStrings(const std::pmr::vector<std::string_view>& views) {
+            std::vector<std::string> strings;
+            strings.reserve(views.size());
+            for (std::string_view view : views) {
+                strings.emplace_back(view);
+            }
+            return strings;
+        }
+
+        ClassInfo toClassInfo(const ArenaClassInfo& source) {
+            ClassInfo cls;
+            cls.name = std::string(source.name);
+            cls.fullName = std::string(source.fullName);
+            cls.isStruct = source.isStruct;
+            cls.isTemplate = source.isTemplate;
+
+            cls.baseClasses.reserve(source.baseClasses.size());
+            for (const auto& sourceBase : source.baseClasses) {
+                BaseClassInfo base;
+                base.name = std::string(sourceBase.name);
+                base.access = sourceBase.access;
+                cls.baseClasses.push_back(std::move(base));
+            }
+
+            cls.members.reserve(source.members.size());
+            for (const auto& sourceMember : source.members) {
+                MemberInfo member;
+                member.name = std::string(sourceMember.name);
+                member.type = sourceMember.type;
+                member.access = sourceMember.access;
+                member.isStatic = sourceMember.isStatic;
+                member.isConst = sourceMember.isConst;
+                member.defaultValue = std::string(sourceMember.defaultValue);
+                cls.members.push_back(std::move(member));
+            }
+
+            cls.methods.reserve(source.methods.size());
+            for (const auto& sourceMethod : source.methods) {
+                MethodInfo method;
+                method.name = std::string(sourceMethod.name);
+                method.returnType = sourceMethod.returnType;
+                method.access = sourceMethod.access;
+                method.isStatic = sourceMethod.isStatic;
+                method.isConst = sourceMethod.isConst;
+                method.isVirtual = sourceMethod.isVirtual;
+                method.isPureVirtual = sourceMethod.isPureVirtual;
+                method.isConstructor = sourceMethod.isConstructor;
+                method.isDestructor = sourceMethod.isDestructor;
+                method.isOperator = sourceMethod.isOperator;
+
+                method.parameters.reserve(sourceMethod.parameters.size());
+                for (const auto& sourceParam : sourceMethod.parameters) {
+                    ParameterInfo param;
+                    param.name = std::string(sourceParam.name);
+                    param.type = sourceParam.type;
+                    param.defaultValue = std::string(sourceParam.defaultValue);
+                    param.isConst = sourceParam.isConst;
+                    param.isReference = sourceParam.isReference;
+                    param.isPointer = sourceParam.isPointer;
+                    method.parameters.push_back(std::move(param));
+                }
+                cls.methods.push_back(std::move(method));
+            }
+
+            cls.friendClasses = toStrings(source.friendClasses);
+            cls.templateParameters = toStrings(source.templateParameters);
+            return cls;
+        }
+
+        NamespaceInfo toNamespaceInfo(const ArenaNamespaceInfo& source) {
+            NamespaceInfo ns;
+            ns.name = std::string(source.name);
+            ns.classes.reserve(source.classes.size());
+            for (const auto& cls : source.classes) {
+                ns.classes.push_back(toClassInfo(cls));
+            }
+            ns.nestedNamespaces.reserve(source.nestedNamespaces.size());
+            for (const auto& nested : source.nestedNamespaces) {
+                ns.nestedNamespaces.push_back(toNamespaceInfo(nested));
+            }
+            return ns;
+        }
+    }
+
+    ArenaParseResult::ArenaParseResult(std::pmr::memory_resource* upstream)
+        : ownedArena(new std::pmr::monotonic_buffer_resource(
+              InitialArenaBytes, upstream ? upstream : std::pmr::new_delete_resource())),
+          arena(ownedArena.get()),
+          classes(arena), namespaces(arena), enums(arena), includes(arena), success(false) {}
+
+    ArenaParseResult::ArenaParseResult(std::pmr::memory_resource* resource, BorrowedResource)
+        : arena(resource), classes(arena), namespaces(arena), enums(arena), includes(arena), success(false) {}
+
+    std::string_view ArenaParseResult::store(std::string_view str) {
+        if (str.empty()) {
+            return std::string_view();
+        }
+        char* copy = static_cast<char*>(arena->allocate(str.size(), 1));
+        std::memcpy(copy, str.data(), str.size());
+        return std::string_view(copy, str.size());
+    }
+
+    void ArenaParseResult::adoptSource(MappedFile&& file) {
+        mappedSource = std::move(file);
+        sourceText = mappedSource.view();
+    }
+
+    void ArenaParseResult::copySource(std::string_view text) {
+        sourceText = store(text);
+    }
+
+    ParseResult ArenaParseResult::toParseResult() const {
+        ParseResult result;
+        result.fileName = std::string(fileName);
+        result.success = success;
+        result.errorMessage = errorMessage;
+
+        result.classes.reserve(classes.size());
+        for (const auto& cls : classes) {
+            result.classes.push_back(toClassInfo(cls));
+        }
+
+        result.namespaces.reserve(namespaces.size());
+        for (const auto& ns : namespaces) {
+            result.namespaces.push_back(toNamespaceInfo(ns));
+        }
+
+        result.enums.reserve(enums.size());
+        for (const auto& sourceEnum : enums) {
+            EnumInfo enumInfo;
+            enumInfo.name = std::string(sourceEnum.name);
+            enumInfo.isClass = sourceEnum.isClass;
+            enumInfo.values.reserve(sourceEnum.values.size());
+            for (const auto& value : sourceEnum.values) {
+                enumInfo.values.emplace_back(std::string(value.first), std::string(value.second));
+            }
+            result.enums.push_back(std::move(enumInfo));
+        }
+
+        result.includes = toStrings(includes);
+        return result;
+    }
+
+} // namespace UFMTooling
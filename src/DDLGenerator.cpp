@@ -0,0 +1,503 @@
+#include "DDLGenerator.h"
+#include "WorkerThreads.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace UFMTooling {
+    namespace DDL {
+
+        namespace {
+            // Tables rendered by one worker claim
+            const size_t TablesPerClaim = 64;
+
+            std::string toLower(std::string_view str) {
+                std::string result(str);
+                std::transform(result.begin(), result.end(), result.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                return result;
+            }
+
+            std::string_view trimView(std::string_view str) {
+                size_t first = str.find_first_not_of(" \t\r\n");
+                if (first == std::string_view::npos) return std::string_view();
+                size_t last = str.find_last_not_of(" \t\r\n");
+                return str.substr(first, last - first + 1);
+            }
+
+            bool endsWith(std::string_view str, std::string_view suffix) {
+                return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+            }
+
+            bool isMany(Cardinality cardinality) {
+                return cardinality == Cardinality::ZeroOrMany || cardinality == Cardinality::OneOrMany;
+            }
+
+            // Portable type names mapped per dialect (PostgreSQL, MySQL, SQL Server, SQLite).
+            // '$' stands for the arguments as written, e.g. "(50)"; bare is used without them.
+            struct TypeRule {
+                const char* names;          // Space-separated, lower case
+                const char* target[4];
+                const char* bare[4];        // nullptr: target without '$'
+            };
+
+            const TypeRule typeRules[] = {
+                { "int integer int4", { "INTEGER", "INT", "INT", "INTEGER" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "bigint long int8", { "BIGINT", "BIGINT", "BIGINT", "INTEGER" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "smallint short int2", { "SMALLINT", "SMALLINT", "SMALLINT", "INTEGER" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "bool boolean", { "BOOLEAN", "BOOLEAN", "BIT", "INTEGER" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "varchar nvarchar string", { "VARCHAR$", "VARCHAR$", "NVARCHAR$", "TEXT" },
+                                             { "TEXT", "VARCHAR(255)", "NVARCHAR(MAX)", "TEXT" } },
+                { "char nchar", { "CHAR$", "CHAR$", "NCHAR$", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "text clob", { "TEXT", "TEXT", "NVARCHAR(MAX)", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "datetime timestamp", { "TIMESTAMP", "DATETIME", "DATETIME2", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "date", { "DATE", "DATE", "DATE", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "time", { "TIME", "TIME", "TIME", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "decimal numeric", { "NUMERIC$", "DECIMAL$", "DECIMAL$", "NUMERIC" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "float double real", { "DOUBLE PRECISION", "DOUBLE", "FLOAT", "REAL" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "uuid guid", { "UUID", "CHAR(36)", "UNIQUEIDENTIFIER", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "blob binary varbinary bytea", { "BYTEA", "BLOB", "VARBINARY(MAX)", "BLOB" }, { nullptr, nullptr, nullptr, nullptr } },
+                { "json jsonb", { "JSONB", "JSON", "NVARCHAR(MAX)", "TEXT" }, { nullptr, nullptr, nullptr, nullptr } }
+            };
+
+            bool hasName(const char* names, std::string_view name) {
+                std::string_view list(names);
+                size_t pos = 0;
+                while (pos <= list.size()) {
+                    size_t end = list.find(' ', pos);
+                    if (end == std::string_view::npos) end = list.size();
+                    if (list.substr(pos, end - pos) == name) return true;
+                    pos = end + 1;
+                }
+                return false;
+            }
+
+            // Everything that depends on the dialect
+            class Dialect {
+            public:
+                explicit Dialect(SQLDialect dialect) : dialect(dialect) {}
+
+                bool isGeneric() const { return dialect == SQLDialect::Generic; }
+
+                // SQLite checks foreign keys when rows are written, so tables may refer to
+                // tables created later; it also has no ALTER TABLE ADD CONSTRAINT
+                bool needsReferencedTables() const { return dialect != SQLDialect::SQLite; }
+
+                void quote(std::string_view name, std::string& out) const {
+                    char open = 0, close = 0;
+                    switch (dialect) {
+                        case SQLDialect::Generic: out.append(name); return;
+                        case SQLDialect::MySQL: open = close = '`'; break;
+                        case SQLDialect::SQLServer: open = '['; close = ']'; break;
+                        default: open = close = '"'; break;
+                    }
+                    out.push_back(open);
+                    for (char c : name) {
+                        out.push_back(c);
+                        if (c == close) out.push_back(c);
+                    }
+                    out.push_back(close);
+                }
+
+                void tableName(const Entity& entity, std::string& out) const {
+                    if (!entity.schema.empty() && dialect != SQLDialect::SQLite) {
+                        quote(entity.schema, out);
+                        out.push_back('.');
+                    }
+                    quote(entity.name, out);
+                }
+
+                void columnList(const std::vector<std::string>& columns, std::string& out) const {
+                    out.push_back('(');
+                    for (size_t i = 0; i < columns.size(); ++i) {
+                        if (i > 0) out.append(", ");
+                        quote(columns[i], out);
+                    }
+                    out.push_back(')');
+                }
+
+                void type(std::string_view written, std::string& out) const {
+                    written = trimView(written);
+                    if (isGeneric()) {
+                        out.append(written);
+                        return;
+                    }
+                    int column = dialect == SQLDialect::PostgreSQL ? 0 : dialect == SQLDialect::MySQL ? 1
+                               : dialect == SQLDialect::SQLServer ? 2 : 3;
+                    size_t paren = written.find('(');
+                    std::string base = toLower(trimView(written.substr(0, paren)));
+                    std::string_view args = paren == std::string_view::npos ? std::string_view() : written.substr(paren);
+
+                    if (base.empty()) base = "text";
+                    for (const TypeRule& rule : typeRules) {
+                        if (!hasName(rule.names, base)) continue;
+                        const char* target = args.empty() && rule.bare[column] ? rule.bare[column] : rule.target[column];
+                        for (const char* c = target; *c; ++c) {
+                            if (*c == '$') out.append(args);
+                            else out.push_back(*c);
+                        }
+                        return;
+                    }
+                    out.append(written);
+                }
+
+                const char* tableSuffix() const {
+                    return dialect == SQLDialect::MySQL ? " ENGINE=InnoDB" : "";
+                }
+
+                // ALTER TABLE t ADD CONSTRAINT a ..., ADD CONSTRAINT b ... (SQL Server: ADD once)
+                const char* alterPrefix() const {
+                    return dialect == SQLDialect::SQLServer ? " ADD" : "";
+                }
+                const char* alterClause() const {
+                    return dialect == SQLDialect::SQLServer ? "    CONSTRAINT " : "    ADD CONSTRAINT ";
+                }
+
+            private:
+                SQLDialect dialect;
+            };
+
+            struct ForeignKey {
+                size_t child;
+                size_t parent;
+                std::vector<std::string> childColumns;
+                std::vector<std::string> parentColumns;
+                std::string name;
+                bool bDeferred;
+            };
+
+            struct Index {
+                std::string name;
+                std::vector<std::string> columns;
+            };
+
+            // What gets written for one table
+            struct TablePlan {
+                std::vector<std::string> primaryKey;
+                std::vector<size_t> inlineKeys;     // Positions in keys
+                std::vector<size_t> deferredKeys;
+                std::vector<Index> indexes;
+                std::vector<std::string> notes;     // Relationships without a foreign key
+            };
+
+            std::vector<std::string> primaryKeyOf(const Entity& entity) {
+                std::vector<std::string> columns;
+                for (const auto& field : entity.fields) {
+                    if (field.isPrimaryKey) columns.push_back(field.name);
+                }
+                return columns;
+            }
+
+            // Child column referencing parentColumn: a foreign key field named like it
+            // (order_id, customer_order_id), else any field of that name
+            const EntityField* findReferencingField(const Entity& child, const Entity& parent, bool bSelf,
+                                                    const std::string& parentColumn) {
+                std::string prefixed = toLower(parent.name) + "_" + parentColumn;
+                std::string suffix = "_" + parentColumn;
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (const auto& field : child.fields) {
+                        if (bSelf && field.isPrimaryKey) continue;     // A key cannot reference itself
+                        if (pass == 0 && !field.isForeignKey) continue;
+                        if (field.name == parentColumn || field.name == prefixed ||
+                            (pass == 0 && endsWith(field.name, suffix))) {
+                            return &field;
+                        }
+                    }
+                }
+                return nullptr;
+            }
+
+            bool resolveColumns(const Entity& child, const Entity& parent, bool bSelf,
+                                const std::vector<std::string>& childFields, const std::vector<std::string>& parentFields,
+                                ForeignKey& key) {
+                key.parentColumns = parentFields.empty() ? primaryKeyOf(parent) : parentFields;
+                if (key.parentColumns.empty()) return false;
+
+                if (!childFields.empty()) {
+                    key.childColumns = childFields;
+                    return key.childColumns.size() == key.parentColumns.size();
+                }
+                for (const auto& parentColumn : key.parentColumns) {
+                    const EntityField* field = findReferencingField(child, parent, bSelf, parentColumn);
+                    if (field == nullptr) return false;
+                    key.childColumns.push_back(field->name);
+                }
+                return true;
+            }
+
+            std::string uniqueName(std::string name, std::set<std::string>& used) {
+                std::string candidate = name;
+                for (int suffix = 2; !used.insert(candidate).second; ++suffix) {
+                    candidate = name + "_" + std::to_string(suffix);
+                }
+                return candidate;
+            }
+
+            void writeForeignKeyBody(const ForeignKey& key, const std::vector<Entity>& entities, const Dialect& dialect,
+                                     std::string& out) {
+                dialect.quote(key.name, out);
+                out.append(" FOREIGN KEY ");
+                dialect.columnList(key.childColumns, out);
+                out.append(" REFERENCES ");
+                dialect.tableName(entities[key.parent], out);
+                out.push_back(' ');
+                dialect.columnList(key.parentColumns, out);
+            }
+
+            void renderTable(const Entity& entity, const TablePlan& plan, const std::vector<ForeignKey>& keys,
+                             const std::vector<Entity>& entities, const Dialect& dialect, std::string& out) {
+                for (const auto& note : plan.notes) {
+                    out.append("-- ").append(note).push_back('\n');
+                }
+
+                out.append("CREATE TABLE ");
+                dialect.tableName(entity, out);
+                out.append(" (\n");
+
+                bool bInlineKey = plan.primaryKey.size() == 1;
+                bool bFirst = true;
+                auto nextLine = [&out, &bFirst]() {
+                    if (!bFirst) out.append(",\n");
+                    bFirst = false;
+                    out.append("    ");
+                };
+
+                for (const auto& field : entity.fields) {
+                    nextLine();
+                    dialect.quote(field.name, out);
+                    out.push_back(' ');
+                    dialect.type(field.type.view(), out);
+                    if (!field.defaultValue.empty()) {
+                        out.append(" DEFAULT ").append(field.defaultValue);
+                    }
+                    if (field.isPrimaryKey && bInlineKey) {
+                        out.append(" PRIMARY KEY");
+                    }
+                    if ((field.isNotNull || field.isPrimaryKey) && !(field.isPrimaryKey && bInlineKey)) {
+                        out.append(" NOT NULL");
+                    }
+                    if (field.isUnique && !field.isPrimaryKey) {
+                        out.append(" UNIQUE");
+                    }
+                }
+
+                if (plan.primaryKey.size() > 1) {
+                    nextLine();
+                    out.append("PRIMARY KEY ");
+                    dialect.columnList(plan.primaryKey, out);
+                }
+
+                for (size_t k : plan.inlineKeys) {
+                    nextLine();
+                    out.append("CONSTRAINT ");
+                    writeForeignKeyBody(keys[k], entities, dialect, out);
+                }
+
+                out.append("\n)").append(dialect.tableSuffix()).append(";\n");
+
+                for (const auto& index : plan.indexes) {
+                    out.append("CREATE INDEX ");
+                    dialect.quote(index.name, out);
+                    out.append(" ON ");
+                    dialect.tableName(entity, out);
+                    out.push_back(' ');
+                    dialect.columnList(index.columns, out);
+                    out.append(";\n");
+                }
+                out.push_back('\n');
+            }
+
+            // Foreign keys the table could not declare inline, in one ALTER TABLE
+            void renderDeferred(const Entity& entity, const TablePlan& plan, const std::vector<ForeignKey>& keys,
+                                const std::vector<Entity>& entities, const Dialect& dialect, std::string& out) {
+                out.append("ALTER TABLE ");
+                dialect.tableName(entity, out);
+                out.append(dialect.alterPrefix()).push_back('\n');
+                for (size_t i = 0; i < plan.deferredKeys.size(); ++i) {
+                    if (i > 0) out.append(",\n");
+                    out.append(dialect.alterClause());
+                    writeForeignKeyBody(keys[plan.deferredKeys[i]], entities, dialect, out);
+                }
+                out.append(";\n\n");
+            }
+
+            // Kahn's algorithm over child -> parent edges; ties and cycles are broken by
+            // diagram order, so the output is deterministic
+            std::vector<size_t> dependencyOrder(size_t tableCount, const std::vector<ForeignKey>& keys) {
+                std::vector<size_t> pending(tableCount, 0);
+                std::vector<std::vector<size_t>> dependents(tableCount);
+                for (const auto& key : keys) {
+                    if (key.child == key.parent) continue;
+                    pending[key.child]++;
+                    dependents[key.parent].push_back(key.child);
+                }
+
+                std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+                for (size_t i = 0; i < tableCount; ++i) {
+                    if (pending[i] == 0) ready.push(i);
+                }
+
+                std::vector<size_t> order;
+                order.reserve(tableCount);
+                std::vector<bool> placed(tableCount, false);
+                size_t nextUnplaced = 0;
+                while (order.size() < tableCount) {
+                    size_t table;
+                    if (!ready.empty()) {
+                        table = ready.top();
+                        ready.pop();
+                        if (placed[table]) continue;
+                    } else {
+                        // Only cycles remain: place the first table left
+                        while (placed[nextUnplaced]) nextUnplaced++;
+                        table = nextUnplaced;
+                    }
+                    placed[table] = true;
+                    order.push_back(table);
+                    for (size_t dependent : dependents[table]) {
+                        if (!placed[dependent] && pending[dependent] > 0 && --pending[dependent] == 0) {
+                            ready.push(dependent);
+                        }
+                    }
+                }
+                return order;
+            }
+        }
+
+        bool generate(const std::vector<Entity>& entities, const std::vector<EntityRelationship>& relationships,
+                      const DDLOptions& options, const DDLStatementSink& sink) {
+            Dialect dialect(options.dialect);
+            std::vector<TablePlan> plans(entities.size());
+            for (size_t i = 0; i < entities.size(); ++i) {
+                plans[i].primaryKey = primaryKeyOf(entities[i]);
+            }
+
+            // Foreign keys: the "many" side references the "one" side; one-to-one
+            // relationships are held by the target entity
+            std::vector<ForeignKey> keys;
+            if (options.bForeignKeys) {
+                std::unordered_map<std::string_view, size_t> positions;
+                for (size_t i = 0; i < entities.size(); ++i) {
+                    positions.emplace(entities[i].name, i);
+                    if (!entities[i].alias.empty()) positions.emplace(entities[i].alias, i);
+                }
+
+                std::set<std::string> usedNames;
+                std::set<std::tuple<size_t, size_t, std::vector<std::string>>> seen;
+                for (const auto& rel : relationships) {
+                    auto from = positions.find(rel.fromEntity);
+                    auto to = positions.find(rel.toEntity);
+                    if (from == positions.end() || to == positions.end()) continue;
+
+                    bool fromMany = isMany(rel.fromCardinality);
+                    bool toMany = isMany(rel.toCardinality);
+                    if (fromMany && toMany) {
+                        plans[from->second].notes.push_back("Many-to-many relationship " + rel.fromEntity + " - " +
+                                                            rel.toEntity + " needs a join table");
+                        continue;
+                    }
+                    bool bChildIsFrom = fromMany;
+                    ForeignKey key;
+                    key.child = bChildIsFrom ? from->second : to->second;
+                    key.parent = bChildIsFrom ? to->second : from->second;
+                    key.bDeferred = false;
+                    const Entity& child = entities[key.child];
+                    const Entity& parent = entities[key.parent];
+
+                    if (!resolveColumns(child, parent, key.child == key.parent, bChildIsFrom ? rel.fromFields : rel.toFields,
+                                        bChildIsFrom ? rel.toFields : rel.fromFields, key)) {
+                        plans[key.child].notes.push_back("No foreign key for " + child.name + " -> " + parent.name +
+                                                         ": no matching column");
+                        continue;
+                    }
+                    if (!seen.emplace(key.child, key.parent, key.childColumns).second) continue;
+
+                    key.name = uniqueName("fk_" + child.name + "_" + parent.name, usedNames);
+                    keys.push_back(std::move(key));
+                }
+            }
+
+            std::vector<size_t> order = dependencyOrder(entities.size(), keys);
+            std::vector<size_t> position(entities.size());
+            for (size_t i = 0; i < order.size(); ++i) {
+                position[order[i]] = i;
+            }
+
+            std::set<std::string> usedIndexNames;
+            for (size_t k = 0; k < keys.size(); ++k) {
+                ForeignKey& key = keys[k];
+                TablePlan& plan = plans[key.child];
+                key.bDeferred = dialect.needsReferencedTables() && position[key.parent] > position[key.child];
+                (key.bDeferred ? plan.deferredKeys : plan.inlineKeys).push_back(k);
+
+                // Index the referencing columns unless a key or unique constraint already does
+                if (!options.bIndexes || key.childColumns == plan.primaryKey) continue;
+                if (key.childColumns.size() == 1) {
+                    const Entity& child = entities[key.child];
+                    auto field = std::find_if(child.fields.begin(), child.fields.end(),
+                                              [&key](const EntityField& f) { return f.name == key.childColumns[0]; });
+                    if (field != child.fields.end() && field->isUnique) continue;
+                }
+                auto same = [&key](const Index& index) { return index.columns == key.childColumns; };
+                if (std::any_of(plan.indexes.begin(), plan.indexes.end(), same)) continue;
+
+                std::string name = "idx_" + entities[key.child].name;
+                for (const auto& column : key.childColumns) {
+                    name += "_" + column;
+                }
+                plan.indexes.push_back(Index{ uniqueName(name, usedIndexNames), key.childColumns });
+            }
+
+            // Render every table into its own buffer; large schemas are split across workers
+            std::vector<std::string> buffers(entities.size());
+            auto renderRange = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    renderTable(entities[i], plans[i], keys, entities, dialect, buffers[i]);
+                }
+            };
+            size_t claims = (entities.size() + TablesPerClaim - 1) / TablesPerClaim;
+            unsigned int threadCount = resolveThreadCount(options.threadCount, claims);
+            if (threadCount <= 1) {
+                renderRange(0, entities.size());
+            } else {
+                std::atomic<size_t> nextClaim(0);
+                std::vector<std::thread> workers;
+                workers.reserve(threadCount);
+                for (unsigned int t = 0; t < threadCount; ++t) {
+                    workers.emplace_back([&]() {
+                        for (size_t claim = nextClaim++; claim < claims; claim = nextClaim++) {
+                            size_t begin = claim * TablesPerClaim;
+                            renderRange(begin, std::min(begin + TablesPerClaim, entities.size()));
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+            }
+
+            DDLStatement statement;
+            for (size_t table : order) {
+                statement.table = entities[table].name;
+                statement.sql = std::move(buffers[table]);
+                if (!sink(statement)) return false;
+            }
+            for (size_t table : order) {
+                if (plans[table].deferredKeys.empty()) continue;
+                statement.table = entities[table].name;
+                statement.sql.clear();
+                renderDeferred(entities[table], plans[table], keys, entities, dialect, statement.sql);
+                if (!sink(statement)) return false;
+            }
+            return true;
+        }
+
+    } // namespace DDL
+} // namespace UFMTooling
@@ -0,0 +1,22 @@
+#ifndef DDL_GENERATOR_H
+#define DDL_GENERATOR_H
+
+// Internal helper: SQL DDL for an entity diagram, behind PUMLEntityParser::exportToDDL().
+// Foreign keys are derived from the relationships, tables are ordered so referenced
+// tables come first, and the statements of each table are rendered into their own
+// buffer (in parallel for large schemas) before being handed out in order.
+
+#include "../include/PUMLEntityParser.h"
+#include <vector>
+
+namespace UFMTooling {
+    namespace DDL {
+
+        // Hand the statements of the schema to sink in execution order; false if sink stopped
+        bool generate(const std::vector<Entity>& entities, const std::vector<EntityRelationship>& relationships,
+                      const DDLOptions& options, const DDLStatementSink& sink);
+
+    } // namespace DDL
+} // namespace UFMTooling
+
+#endif // DDL_GENERATOR_H
@@ -0,0 +1,366 @@
+#include "DiagramExport.h"
+
+namespace UFMTooling {
+    namespace DiagramExport {
+
+        namespace {
+            void writeNotesJson(const std::map<std::string, std::string>& notes, JsonWriter& writer) {
+                // std::map iterates in key order, as nlohmann sorts object keys
+                writer.beginObject();
+                for (const auto& note : notes) {
+                    writer.member(note.first, note.second);
+                }
+                writer.endObject();
+            }
+
+            void writeStringsJson(const std::vector<std::string>& strings, JsonWriter& writer) {
+                writer.beginArray();
+                for (const auto& str : strings) {
+                    writer.value(str);
+                }
+                writer.endArray();
+            }
+
+            void writeNotesXml(const std::map<std::string, std::string>& notes, XmlWriter& writer) {
+                for (const auto& note : notes) {
+                    writer.beginElement("Note");
+                    writer.attribute("key", note.first);
+                    writer.text(note.second);
+                    writer.endElement();
+                }
+            }
+
+            // Attribute only when the string is not empty
+            void optionalAttribute(XmlWriter& writer, std::string_view name, const std::string& value) {
+                if (!value.empty()) {
+                    writer.attribute(name, value);
+                }
+            }
+        }
+
+        const char* visibilityToString(UMLVisibility visibility) {
+            switch (visibility) {
+                case UMLVisibility::Public: return "public";
+                case UMLVisibility::Private: return "private";
+                case UMLVisibility::Protected: return "protected";
+                case UMLVisibility::Package: return "package";
+                default: return "unknown";
+            }
+        }
+
+        const char* relationshipToString(UMLRelationship type) {
+            switch (type) {
+                case UMLRelationship::Association: return "association";
+                case UMLRelationship::Dependency: return "dependency";
+                case UMLRelationship::Aggregation: return "aggregation";
+                case UMLRelationship::Composition: return "composition";
+                case UMLRelationship::Inheritance: return "inheritance";
+                case UMLRelationship::Realization: return "realization";
+                case UMLRelationship::DirectedAssociation: return "directedAssociation";
+                case UMLRelationship::Nesting: return "nesting";
+                default: return "unknown";
+            }
+        }
+
+        const char* cardinalityToString(Cardinality cardinality) {
+            switch (cardinality) {
+                case Cardinality::ZeroOrOne: return "zeroOrOne";
+                case Cardinality::ExactlyOne: return "exactlyOne";
+                case Cardinality::ZeroOrMany: return "zeroOrMany";
+                case Cardinality::OneOrMany: return "oneOrMany";
+                default: return "unknown";
+            }
+        }
+
+        const char* entityRelationTypeToString(EntityRelationType type) {
+            switch (type) {
+                case EntityRelationType::OneToOne: return "oneToOne";
+                case EntityRelationType::OneToMany: return "oneToMany";
+                case EntityRelationType::ManyToOne: return "manyToOne";
+                case EntityRelationType::ManyToMany: return "manyToMany";
+                default: return "unknown";
+            }
+        }
+
+        const char* fieldTypeToString(EntityFieldType type) {
+            switch (type) {
+                case EntityFieldType::PrimaryKey: return "primaryKey";
+                case EntityFieldType::ForeignKey: return "foreignKey";
+                case EntityFieldType::Unique: return "unique";
+                case EntityFieldType::NotNull: return "notNull";
+                case EntityFieldType::Regular: return "regular";
+                default: return "unknown";
+            }
+        }
+
+        void writeJson(const ClassDiagramView& diagram, JsonWriter& writer) {
+            writer.beginObject();
+
+            writer.key("classes");
+            writer.beginArray();
+            for (const auto& cls : diagram.classes) {
+                writer.beginObject();
+
+                writer.key("attributes");
+                writer.beginArray();
+                for (const auto& attribute : cls.attributes) {
+                    writer.beginObject();
+                    writer.member("defaultValue", attribute.defaultValue);
+                    writer.member("isStatic", attribute.isStatic);
+                    writer.member("name", attribute.name);
+                    writer.member("stereotype", attribute.stereotype);
+                    writer.member("type", attribute.type);
+                    writer.member("visibility", visibilityToString(attribute.visibility));
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.member("isAbstract", cls.isAbstract);
+                writer.member("isInterface", cls.isInterface);
+
+                writer.key("methods");
+                writer.beginArray();
+                for (const auto& method : cls.methods) {
+                    writer.beginObject();
+                    writer.member("isAbstract", method.isAbstract);
+                    writer.member("isStatic", method.isStatic);
+                    writer.member("name", method.name);
+
+                    writer.key("parameters");
+                    writer.beginArray();
+                    for (const auto& param : method.parameters) {
+                        writer.beginObject();
+                        writer.member("defaultValue", param.defaultValue);
+                        writer.member("direction", param.direction);
+                        writer.member("name", param.name);
+                        writer.member("type", param.type);
+                        writer.endObject();
+                    }
+                    writer.endArray();
+
+                    writer.member("returnType", method.returnType);
+                    writer.member("stereotype", method.stereotype);
+                    writer.member("visibility", visibilityToString(method.visibility));
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.member("name", cls.name);
+                writer.member("note", cls.note);
+                writer.member("package", cls.package);
+                writer.member("stereotype", cls.stereotype);
+                writer.endObject();
+            }
+            writer.endArray();
+
+            writer.key("notes");
+            writeNotesJson(diagram.notes, writer);
+
+            writer.key("relationships");
+            writer.beginArray();
+            for (const auto& rel : diagram.relationships) {
+                writer.beginObject();
+                writer.member("fromCardinality", rel.fromCardinality);
+                writer.member("fromClass", rel.fromClass);
+                writer.member("label", rel.label);
+                writer.member("toCardinality", rel.toCardinality);
+                writer.member("toClass", rel.toClass);
+                writer.member("type", relationshipToString(rel.type));
+                writer.endObject();
+            }
+            writer.endArray();
+
+            writer.member("title", diagram.title);
+            writer.endObject();
+        }
+
+        void writeJson(const EntityDiagramView& diagram, JsonWriter& writer) {
+            writer.beginObject();
+
+            writer.key("entities");
+            writer.beginArray();
+            for (const auto& entity : diagram.entities) {
+                writer.beginObject();
+                writer.member("alias", entity.alias);
+                writer.member("comment", entity.comment);
+
+                writer.key("fields");
+                writer.beginArray();
+                for (const auto& field : entity.fields) {
+                    writer.beginObject();
+                    writer.member("comment", field.comment);
+
+                    writer.key("constraints");
+                    writer.beginArray();
+                    for (EntityFieldType constraint : field.constraints) {
+                        writer.value(fieldTypeToString(constraint));
+                    }
+                    writer.endArray();
+
+                    writer.member("defaultValue", field.defaultValue);
+                    writer.member("isForeignKey", field.isForeignKey);
+                    writer.member("isNotNull", field.isNotNull);
+                    writer.member("isPrimaryKey", field.isPrimaryKey);
+                    writer.member("isUnique", field.isUnique);
+                    writer.member("name", field.name);
+                    writer.member("type", field.type);
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.member("name", entity.name);
+                writer.member("schema", entity.schema);
+                writer.member("stereotype", entity.stereotype);
+                writer.endObject();
+            }
+            writer.endArray();
+
+            writer.key("notes");
+            writeNotesJson(diagram.notes, writer);
+
+            writer.key("relationships");
+            writer.beginArray();
+            for (const auto& rel : diagram.relationships) {
+                writer.beginObject();
+                writer.member("fromCardinality", cardinalityToString(rel.fromCardinality));
+                writer.member("fromEntity", rel.fromEntity);
+                writer.key("fromFields");
+                writeStringsJson(rel.fromFields, writer);
+                writer.member("isIdentifying", rel.isIdentifying);
+                writer.member("label", rel.label);
+                writer.member("toCardinality", cardinalityToString(rel.toCardinality));
+                writer.member("toEntity", rel.toEntity);
+                writer.key("toFields");
+                writeStringsJson(rel.toFields, writer);
+                writer.member("type", entityRelationTypeToString(rel.type));
+                writer.endObject();
+            }
+            writer.endArray();
+
+            writer.member("title", diagram.title);
+            writer.endObject();
+        }
+
+        void writeXml(const ClassDiagramView& diagram, XmlWriter& writer) {
+            writer.declaration();
+            writer.beginElement("ClassDiagram");
+            if (!diagram.title.empty()) {
+                writer.attribute("title", diagram.title);
+            }
+
+            for (const auto& cls : diagram.classes) {
+                writer.beginElement("Class");
+                writer.attribute("name", cls.name);
+                writer.attribute("isAbstract", cls.isAbstract);
+                writer.attribute("isInterface", cls.isInterface);
+                optionalAttribute(writer, "stereotype", cls.stereotype);
+                optionalAttribute(writer, "package", cls.package);
+                optionalAttribute(writer, "note", cls.note);
+
+                for (const auto& attribute : cls.attributes) {
+                    writer.beginElement("Attribute");
+                    writer.attribute("name", attribute.name);
+                    writer.attribute("type", attribute.type);
+                    writer.attribute("visibility", visibilityToString(attribute.visibility));
+                    writer.attribute("isStatic", attribute.isStatic);
+                    optionalAttribute(writer, "defaultValue", attribute.defaultValue);
+                    optionalAttribute(writer, "stereotype", attribute.stereotype);
+                    writer.endElement();
+                }
+
+                for (const auto& method : cls.methods) {
+                    writer.beginElement("Method");
+                    writer.attribute("name", method.name);
+                    writer.attribute("returnType", method.returnType);
+                    writer.attribute("visibility", visibilityToString(method.visibility));
+                    writer.attribute("isStatic", method.isStatic);
+                    writer.attribute("isAbstract", method.isAbstract);
+                    optionalAttribute(writer, "stereotype", method.stereotype);
+                    for (const auto& param : method.parameters) {
+                        writer.beginElement("Parameter");
+                        writer.attribute("name", param.name);
+                        writer.attribute("type", param.type);
+                        writer.attribute("direction", param.direction);
+                        optionalAttribute(writer, "defaultValue", param.defaultValue);
+                        writer.endElement();
+                    }
+                    writer.endElement();
+                }
+
+                writer.endElement();
+            }
+
+            for (const auto& rel : diagram.relationships) {
+                writer.beginElement("Relationship");
+                writer.attribute("from", rel.fromClass);
+                writer.attribute("to", rel.toClass);
+                writer.attribute("type", relationshipToString(rel.type));
+                optionalAttribute(writer, "label", rel.label);
+                optionalAttribute(writer, "fromCardinality", rel.fromCardinality);
+                optionalAttribute(writer, "toCardinality", rel.toCardinality);
+                writer.endElement();
+            }
+
+            writeNotesXml(diagram.notes, writer);
+            writer.endElement();
+        }
+
+        void writeXml(const EntityDiagramView& diagram, XmlWriter& writer) {
+            writer.declaration();
+            writer.beginElement("EntityDiagram");
+            if (!diagram.title.empty()) {
+                writer.attribute("title", diagram.title);
+            }
+
+            for (const auto& entity : diagram.entities) {
+                writer.beginElement("Entity");
+                writer.attribute("name", entity.name);
+                optionalAttribute(writer, "alias", entity.alias);
+                optionalAttribute(writer, "schema", entity.schema);
+                optionalAttribute(writer, "comment", entity.comment);
+                optionalAttribute(writer, "stereotype", entity.stereotype);
+
+                for (const auto& field : entity.fields) {
+                    writer.beginElement("Field");
+                    writer.attribute("name", field.name);
+                    writer.attribute("type", field.type);
+                    writer.attribute("isPrimaryKey", field.isPrimaryKey);
+                    writer.attribute("isForeignKey", field.isForeignKey);
+                    writer.attribute("isUnique", field.isUnique);
+                    writer.attribute("isNotNull", field.isNotNull);
+                    optionalAttribute(writer, "defaultValue", field.defaultValue);
+                    optionalAttribute(writer, "comment", field.comment);
+                    writer.endElement();
+                }
+
+                writer.endElement();
+            }
+
+            for (const auto& rel : diagram.relationships) {
+                writer.beginElement("Relationship");
+                writer.attribute("from", rel.fromEntity);
+                writer.attribute("to", rel.toEntity);
+                writer.attribute("fromCardinality", cardinalityToString(rel.fromCardinality));
+                writer.attribute("toCardinality", cardinalityToString(rel.toCardinality));
+                writer.attribute("type", entityRelationTypeToString(rel.type));
+                writer.attribute("isIdentifying", rel.isIdentifying);
+                optionalAttribute(writer, "label", rel.label);
+                for (const auto& field : rel.fromFields) {
+                    writer.beginElement("FromField");
+                    writer.attribute("name", field);
+                    writer.endElement();
+                }
+                for (const auto& field : rel.toFields) {
+                    writer.beginElement("ToField");
+                    writer.attribute("name", field);
+                    writer.endElement();
+                }
+                writer.endElement();
+            }
+
+            writeNotesXml(diagram.notes, writer);
+            writer.endElement();
+        }
+
+    } // namespace DiagramExport
+} // namespace UFMTooling
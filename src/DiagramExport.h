@@ -0,0 +1,55 @@
+#ifndef DIAGRAM_EXPORT_H
+#define DIAGRAM_EXPORT_H
+
+// Internal helpers: complete JSON and XML exports of the PUML diagram models, shared
+// by the parsers' exportToJson()/exportToXML() and the batch parser.
+// JSON objects are written with their keys in sorted order, like the SourceExplorer
+// export, so the output equals nlohmann::json::dump() of the same document.
+
+#include "../include/PUMLClassParser.h"
+#include "../include/PUMLEntityParser.h"
+#include "../include/JsonWriter.h"
+#include "../include/XmlWriter.h"
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace UFMTooling {
+    namespace DiagramExport {
+
+        // Enumerators as exported (lower camel case, like the access specifiers)
+        const char* visibilityToString(UMLVisibility visibility);
+        const char* relationshipToString(UMLRelationship type);
+        const char* cardinalityToString(Cardinality cardinality);
+        const char* entityRelationTypeToString(EntityRelationType type);
+        const char* fieldTypeToString(EntityFieldType type);
+
+        // The parts of a diagram a parser holds after parse()
+        struct ClassDiagramView {
+            std::string_view title;
+            const std::vector<UMLClass>& classes;
+            const std::vector<UMLClassRelationship>& relationships;
+            const std::map<std::string, std::string>& notes;
+        };
+
+        struct EntityDiagramView {
+            std::string_view title;
+            const std::vector<Entity>& entities;
+            const std::vector<EntityRelationship>& relationships;
+            const std::map<std::string, std::string>& notes;
+        };
+
+        // One JSON object: classes / entities, notes, relationships, title
+        void writeJson(const ClassDiagramView& diagram, JsonWriter& writer);
+        void writeJson(const EntityDiagramView& diagram, JsonWriter& writer);
+
+        // <ClassDiagram> / <EntityDiagram> root element, after the XML declaration.
+        // Empty optional strings are left out.
+        void writeXml(const ClassDiagramView& diagram, XmlWriter& writer);
+        void writeXml(const EntityDiagramView& diagram, XmlWriter& writer);
+
+    } // namespace DiagramExport
+} // namespace UFMTooling
+
+#endif // DIAGRAM_EXPORT_H
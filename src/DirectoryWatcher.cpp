@@ -0,0 +1,468 @@
+#include "../include/DirectoryWatcher.h"
+#include <atomic>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sys/inotify.h>
+    #include <sys/eventfd.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+    #include <cstdint>
+#else
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace UFMTooling {
+
+#if defined(__linux__)
+
+    class DirectoryWatcher::Impl {
+    public:
+        // Everything that changes the entries of a directory, plus the directory itself going away
+        static const uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM |
+                                          IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+        int fd;
+        int wakeFd;
+        std::atomic<bool> interrupted;
+        std::unordered_map<int, std::string> directoriesByWatch;
+        std::unordered_map<std::string, int> watchesByDirectory;
+        alignas(struct inotify_event) char buffer[64 * 1024];
+        std::string errorMessage;
+
+        Impl() : fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+                 interrupted(false) {
+            if (fd < 0 || wakeFd < 0) {
+                errorMessage = std::string("Could not initialize inotify: ") + std::strerror(errno);
+            }
+        }
+
+        ~Impl() {
+            if (fd >= 0) ::close(fd);
+            if (wakeFd >= 0) ::close(wakeFd);
+        }
+
+        bool addWatch(const std::string& directory) {
+            int wd = inotify_add_watch(fd, directory.c_str(), WatchMask);
+            if (wd < 0) {
+                errorMessage = "Could not watch " + directory + ": " + std::strerror(errno);
+                return false;
+            }
+            directoriesByWatch[wd] = directory;
+            watchesByDirectory[directory] = wd;
+            return true;
+        }
+
+        bool watch(const std::vector<std::string>& directories) {
+            if (fd < 0) return false;
+            std::unordered_set<std::string> wanted(directories.begin(), directories.end());
+            for (auto it = watchesByDirectory.begin(); it != watchesByDirectory.end();) {
+                if (wanted.count(it->first) == 0) {
+                    inotify_rm_watch(fd, it->second);
+                    directoriesByWatch.erase(it->second);
+                    it = watchesByDirectory.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            bool bAll = true;
+            for (const auto& directory : directories) {
+                if (watchesByDirectory.count(directory) == 0 && !addWatch(directory)) {
+                    bAll = false;
+                }
+            }
+            return bAll;
+        }
+
+        void clear() {
+            for (const auto& entry : directoriesByWatch) {
+                inotify_rm_watch(fd, entry.first);
+            }
+            directoriesByWatch.clear();
+            watchesByDirectory.clear();
+            uint64_t count;
+            while (wakeFd >= 0 && ::read(wakeFd, &count, sizeof(count)) > 0) {}
+            interrupted = false;
+        }
+
+        void report(const struct inotify_event& event, std::vector<DirectoryChange>& changes) {
+            DirectoryChange change;
+            if (event.mask & IN_Q_OVERFLOW) {
+                change.kind = DirectoryChangeKind::Overflow;
+                changes.push_back(std::move(change));
+                return;
+            }
+
+            auto it = directoriesByWatch.find(event.wd);
+            if (it == directoriesByWatch.end()) return;
+            if (event.mask & IN_IGNORED) {
+                // Removed by the kernel after the directory went away
+                watchesByDirectory.erase(it->second);
+                directoriesByWatch.erase(it);
+                return;
+            }
+
+            if (event.len > 0) {
+                change.path = (fs::path(it->second) / event.name).string();
+                change.isDirectory = (event.mask & IN_ISDIR) != 0;
+            } else {
+                change.path = it->second;
+                change.isDirectory = true;
+            }
+            if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+                change.kind = DirectoryChangeKind::Created;
+                if (change.isDirectory) {
+                    addWatch(change.path);
+                }
+            } else if (event.mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                change.kind = DirectoryChangeKind::Removed;
+            } else {
+                change.kind = DirectoryChangeKind::Modified;
+            }
+            changes.push_back(std::move(change));
+        }
+
+        bool wait(std::vector<DirectoryChange>& changes, int timeoutMs) {
+            if (interrupted) return false;
+            if (fd < 0) return false;
+
+            pollfd fds[2] = { { fd, POLLIN, 0 }, { wakeFd, POLLIN, 0 } };
+            int ready = ::poll(fds, 2, timeoutMs < 0 ? -1 : timeoutMs);
+            if (interrupted) return false;
+            if (ready < 0) {
+                if (errno == EINTR) return true;
+                errorMessage = std::string("Waiting for changes failed: ") + std::strerror(errno);
+                return false;
+            }
+            if (fds[1].revents & POLLIN) {
+                uint64_t count;
+                while (::read(wakeFd, &count, sizeof(count)) > 0) {}     // Consume the wake()
+                if (interrupted) return false;
+            }
+
+            // Drain everything queued, so one wait() reports a whole burst
+            for (;;) {
+                ssize_t length = ::read(fd, buffer, sizeof(buffer));
+                if (length <= 0) break;
+                for (char* p = buffer; p < buffer + length;) {
+                    const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+                    report(*event, changes);
+                    p += sizeof(struct inotify_event) + event->len;
+                }
+            }
+            return true;
+        }
+
+        void interrupt() {
+            interrupted = true;
+            wake();
+        }
+
+        void wake() {
+            uint64_t one = 1;
+            if (wakeFd >= 0 && ::write(wakeFd, &one, sizeof(one)) < 0) {
+                // The counter is already set; a pending wake-up is enough
+            }
+        }
+
+        bool isNative() const { return fd >= 0; }
+    };
+
+    const char* DirectoryWatcher::backendName() {
+        return "inotify";
+    }
+
+#elif defined(_WIN32)
+
+    class DirectoryWatcher::Impl {
+    public:
+        HANDLE directory;
+        HANDLE readEvent;
+        HANDLE wakeEvent;
+        OVERLAPPED overlapped;
+        bool pending;                           // A ReadDirectoryChangesW call is outstanding
+        std::atomic<bool> interrupted;
+        std::string root;
+        std::unordered_set<std::string> directories;
+        std::vector<DWORD> buffer;              // DWORD-aligned, as ReadDirectoryChangesW needs
+        std::string errorMessage;
+
+        Impl() : directory(INVALID_HANDLE_VALUE), readEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)),
+                 wakeEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)), overlapped(), pending(false),
+                 interrupted(false), buffer(16 * 1024) {}
+
+        ~Impl() {
+            closeDirectory();
+            if (readEvent) CloseHandle(readEvent);
+            if (wakeEvent) CloseHandle(wakeEvent);
+        }
+
+        void fail(const std::string& what) {
+            errorMessage = what + " (error " + std::to_string(GetLastError()) + ")";
+        }
+
+        void closeDirectory() {
+            if (directory == INVALID_HANDLE_VALUE) return;
+            if (pending) {
+                CancelIoEx(directory, &overlapped);
+                DWORD bytes = 0;
+                GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+                pending = false;
+            }
+            CloseHandle(directory);
+            directory = INVALID_HANDLE_VALUE;
+            root.clear();
+        }
+
+        // One recursive read on the root covers every directory; events outside the
+        // listed directories are dropped in wait()
+        bool issue() {
+            ZeroMemory(&overlapped, sizeof(overlapped));
+            overlapped.hEvent = readEvent;
+            ResetEvent(readEvent);
+            DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                           FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+            if (!ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+                                       TRUE, filter, nullptr, &overlapped, nullptr)) {
+                fail("Could not watch " + root);
+                return false;
+            }
+            pending = true;
+            return true;
+        }
+
+        bool watch(const std::string& basePath, const std::vector<std::string>& list) {
+            directories = std::unordered_set<std::string>(list.begin(), list.end());
+            if (directory != INVALID_HANDLE_VALUE && root == basePath) {
+                return true;
+            }
+
+            closeDirectory();
+            std::wstring widePath = fs::u8path(basePath).wstring();
+            directory = CreateFileW(widePath.c_str(), FILE_LIST_DIRECTORY,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+            if (directory == INVALID_HANDLE_VALUE) {
+                fail("Could not open " + basePath);
+                return false;
+            }
+            root = basePath;
+            return issue();
+        }
+
+        void clear() {
+            closeDirectory();
+            directories.clear();
+            ResetEvent(wakeEvent);
+            interrupted = false;
+        }
+
+        void report(const FILE_NOTIFY_INFORMATION& info, std::vector<DirectoryChange>& changes) {
+            std::wstring name(info.FileName, info.FileNameLength / sizeof(WCHAR));
+            fs::path full = fs::path(root) / fs::path(name);
+
+            DirectoryChange change;
+            change.path = full.string();
+            if (directories.count(full.parent_path().string()) == 0) return;
+
+            std::error_code error;
+            switch (info.Action) {
+                case FILE_ACTION_ADDED:
+                case FILE_ACTION_RENAMED_NEW_NAME:
+                    change.kind = DirectoryChangeKind::Created;
+                    change.isDirectory = fs::is_directory(full, error);
+                    if (change.isDirectory) {
+                        directories.insert(change.path);
+                    }
+                    break;
+                case FILE_ACTION_REMOVED:
+                case FILE_ACTION_RENAMED_OLD_NAME:
+                    change.kind = DirectoryChangeKind::Removed;
+                    change.isDirectory = directories.count(change.path) > 0;
+                    break;
+                default:
+                    change.kind = DirectoryChangeKind::Modified;
+                    change.isDirectory = fs::is_directory(full, error);
+                    break;
+            }
+            changes.push_back(std::move(change));
+        }
+
+        bool wait(std::vector<DirectoryChange>& changes, int timeoutMs) {
+            if (interrupted) return false;
+            DWORD timeout = timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs);
+            if (directory == INVALID_HANDLE_VALUE) {
+                if (WaitForSingleObject(wakeEvent, timeout) == WAIT_OBJECT_0 && !interrupted) {
+                    ResetEvent(wakeEvent);
+                }
+                return !interrupted;
+            }
+            if (!pending && !issue()) return false;
+
+            HANDLE handles[2] = { readEvent, wakeEvent };
+            DWORD status = WaitForMultipleObjects(2, handles, FALSE, timeout);
+            if (interrupted) return false;
+            if (status == WAIT_TIMEOUT) return true;
+            if (status == WAIT_OBJECT_0 + 1) {
+                ResetEvent(wakeEvent);      // Consume the wake(); interrupt() sets interrupted first
+                return !interrupted;
+            }
+            if (status != WAIT_OBJECT_0) {
+                fail("Waiting for changes failed");
+                return false;
+            }
+
+            DWORD bytes = 0;
+            pending = false;
+            BOOL bRead = GetOverlappedResult(directory, &overlapped, &bytes, FALSE);
+            if (!bRead && GetLastError() != ERROR_NOTIFY_ENUM_DIR) {
+                fail("Reading changes failed");
+                return false;
+            }
+            if (!bRead || bytes == 0) {
+                // More changes than the buffer holds
+                DirectoryChange change;
+                change.kind = DirectoryChangeKind::Overflow;
+                changes.push_back(std::move(change));
+            } else {
+                const char* p = reinterpret_cast<const char*>(buffer.data());
+                for (;;) {
+                    const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p);
+                    report(*info, changes);
+                    if (info->NextEntryOffset == 0) break;
+                    p += info->NextEntryOffset;
+                }
+            }
+            return issue();
+        }
+
+        void interrupt() {
+            interrupted = true;
+            SetEvent(wakeEvent);
+        }
+
+        void wake() {
+            SetEvent(wakeEvent);
+        }
+
+        bool isNative() const { return readEvent != nullptr; }
+    };
+
+    const char* DirectoryWatcher::backendName() {
+        return "ReadDirectoryChangesW";
+    }
+
+#else
+
+    // No native backend: wait() only sleeps, callers rescan on their own
+    class DirectoryWatcher::Impl {
+    public:
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::atomic<bool> interrupted;
+        bool woken;                 // Guarded by mutex
+        std::string errorMessage;
+
+        Impl() : interrupted(false), woken(false) {}
+
+        bool watch(const std::string&, const std::vector<std::string>&) { return true; }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            interrupted = false;
+            woken = false;
+        }
+
+        bool wait(std::vector<DirectoryChange>&, int timeoutMs) {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto isWoken = [this]() { return interrupted.load() || woken; };
+            if (timeoutMs < 0) {
+                wakeUp.wait(lock, isWoken);
+            } else {
+                wakeUp.wait_for(lock, std::chrono::milliseconds(timeoutMs), isWoken);
+            }
+            woken = false;
+            return !interrupted;
+        }
+
+        void interrupt() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                interrupted = true;
+            }
+            wakeUp.notify_all();
+        }
+
+        void wake() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                woken = true;
+            }
+            wakeUp.notify_all();
+        }
+
+        bool isNative() const { return false; }
+    };
+
+    const char* DirectoryWatcher::backendName() {
+        return "polling";
+    }
+
+#endif
+
+    // DirectoryWatcher implementation
+    DirectoryWatcher::DirectoryWatcher() : pImpl(new Impl()) {}
+
+    DirectoryWatcher::~DirectoryWatcher() = default;
+
+    bool DirectoryWatcher::watch(const std::string& basePath, const std::vector<std::string>& directories) {
+#if defined(__linux__)
+        (void)basePath;
+        return pImpl->watch(directories);
+#else
+        return pImpl->watch(basePath, directories);
+#endif
+    }
+
+    void DirectoryWatcher::clear() {
+        pImpl->clear();
+    }
+
+    bool DirectoryWatcher::wait(std::vector<DirectoryChange>& changes, int timeoutMs) {
+        return pImpl->wait(changes, timeoutMs);
+    }
+
+    void DirectoryWatcher::interrupt() {
+        pImpl->interrupt();
+    }
+
+    void DirectoryWatcher::wake() {
+        pImpl->wake();
+    }
+
+    bool DirectoryWatcher::isNative() const {
+        return pImpl->isNative();
+    }
+
+    const std::string& DirectoryWatcher::getErrorMessage() const {
+        return pImpl->errorMessage;
+    }
+
+} // namespace UFMTooling
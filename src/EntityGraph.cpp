@@ -0,0 +1,302 @@
+#include "../include/EntityGraph.h"
+#include "GraphAdjacency.h"
+#include <deque>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace UFMTooling {
+
+    namespace {
+        bool isMany(Cardinality cardinality) {
+            return cardinality == Cardinality::ZeroOrMany || cardinality == Cardinality::OneOrMany;
+        }
+
+        std::vector<uint32_t> edgesOf(const Graph::Adjacency& graph, uint32_t node) {
+            return std::vector<uint32_t>(graph.targets.begin() + graph.begin[node],
+                                         graph.targets.begin() + graph.begin[node + 1]);
+        }
+    }
+
+    class EntityGraph::Impl {
+    public:
+        std::deque<std::string> names;          // A deque keeps the views of nodeByName valid
+        std::deque<std::string> aliases;
+        std::unordered_map<std::string_view, uint32_t> nodeByName;
+
+        // Labels are relationship indices (the lowest one when several join the same pair)
+        Graph::Adjacency referenceEdges;        // Entity -> entities it references
+        Graph::Adjacency referrerEdges;         // Entity -> entities referencing it
+        Graph::Adjacency linkEdges;             // Both directions, every relationship
+
+        std::vector<uint32_t> componentIds;
+        uint32_t componentCount = 0;
+        std::vector<uint32_t> unresolvedRelationships;
+
+        void clear() {
+            names.clear();
+            aliases.clear();
+            nodeByName.clear();
+            referenceEdges.clear();
+            referrerEdges.clear();
+            linkEdges.clear();
+            componentIds.clear();
+            componentCount = 0;
+            unresolvedRelationships.clear();
+        }
+
+        uint32_t find(std::string_view name) const {
+            auto it = nodeByName.find(name);
+            return it != nodeByName.end() ? it->second : npos;
+        }
+
+        void build(const std::vector<Entity>& entities, const std::vector<EntityRelationship>& relationships) {
+            clear();
+
+            // The first entity of a name or alias wins, as in exportToDDL()
+            nodeByName.reserve(entities.size() * 2);
+            for (size_t i = 0; i < entities.size(); ++i) {
+                names.push_back(entities[i].name);
+                nodeByName.emplace(names.back(), static_cast<uint32_t>(i));
+                if (!entities[i].alias.empty()) {
+                    aliases.push_back(entities[i].alias);
+                    nodeByName.emplace(aliases.back(), static_cast<uint32_t>(i));
+                }
+            }
+
+            std::vector<Graph::Edge> references;
+            std::vector<Graph::Edge> links;
+            references.reserve(relationships.size());
+            links.reserve(relationships.size() * 2);
+            for (size_t r = 0; r < relationships.size(); ++r) {
+                const EntityRelationship& rel = relationships[r];
+                uint32_t label = static_cast<uint32_t>(r);
+                uint32_t from = find(rel.fromEntity);
+                uint32_t to = find(rel.toEntity);
+                if (from == npos || to == npos) {
+                    unresolvedRelationships.push_back(label);
+                    continue;
+                }
+
+                if (from != to) {
+                    links.push_back(Graph::Edge{from, to, label});
+                    links.push_back(Graph::Edge{to, from, label});
+                }
+                // The "many" side holds the foreign key; one-to-one keys are held by the target
+                bool fromMany = isMany(rel.fromCardinality);
+                bool toMany = isMany(rel.toCardinality);
+                if (fromMany && toMany) continue;
+                references.push_back(fromMany ? Graph::Edge{from, to, label} : Graph::Edge{to, from, label});
+            }
+
+            size_t nodes = names.size();
+            Graph::sortUnique(references);
+            Graph::sortUnique(links);
+            referenceEdges.build(nodes, references, false, true);
+            referrerEdges.build(nodes, references, true, true);
+            linkEdges.build(nodes, links, false, true);
+            labelComponents();
+        }
+
+        // Breadth-first over links from each node not labelled yet; roots come in id order,
+        // so components are numbered by their lowest node
+        void labelComponents() {
+            size_t nodes = names.size();
+            componentIds.assign(nodes, npos);
+            componentCount = 0;
+            std::vector<uint32_t> queue;
+            for (uint32_t root = 0; root < nodes; ++root) {
+                if (componentIds[root] != npos) continue;
+                uint32_t component = componentCount++;
+                componentIds[root] = component;
+                queue.assign(1, root);
+                for (size_t head = 0; head < queue.size(); ++head) {
+                    uint32_t node = queue[head];
+                    for (uint32_t e = linkEdges.begin[node]; e < linkEdges.begin[node + 1]; ++e) {
+                        uint32_t target = linkEdges.targets[e];
+                        if (componentIds[target] != npos) continue;
+                        componentIds[target] = component;
+                        queue.push_back(target);
+                    }
+                }
+            }
+        }
+
+        // Kahn's algorithm over references, lowest ready node first; when only cycles are
+        // left, the lowest unplaced node goes next. Self-references do not hold a node back.
+        std::vector<uint32_t> creationOrder(bool* pbComplete) const {
+            size_t nodes = names.size();
+            std::vector<uint32_t> pending(nodes, 0);
+            for (uint32_t node = 0; node < nodes; ++node) {
+                pending[node] = referenceEdges.degree(node) - (referenceEdges.hasEdge(node, node) ? 1 : 0);
+            }
+
+            std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+            for (uint32_t node = 0; node < nodes; ++node) {
+                if (pending[node] == 0) ready.push(node);
+            }
+
+            std::vector<uint32_t> order;
+            order.reserve(nodes);
+            std::vector<bool> placed(nodes, false);
+            uint32_t nextUnplaced = 0;
+            bool bComplete = true;
+            while (order.size() < nodes) {
+                uint32_t node;
+                if (!ready.empty()) {
+                    node = ready.top();
+                    ready.pop();
+                    if (placed[node]) continue;
+                } else {
+                    while (placed[nextUnplaced]) nextUnplaced++;
+                    node = nextUnplaced;
+                    bComplete = false;
+                }
+                placed[node] = true;
+                order.push_back(node);
+                for (uint32_t e = referrerEdges.begin[node]; e < referrerEdges.begin[node + 1]; ++e) {
+                    uint32_t referrer = referrerEdges.targets[e];
+                    if (referrer != node && !placed[referrer] && pending[referrer] > 0 && --pending[referrer] == 0) {
+                        ready.push(referrer);
+                    }
+                }
+            }
+            if (pbComplete != nullptr) *pbComplete = bComplete;
+            return order;
+        }
+
+        EntityJoinPath joinPath(uint32_t from, uint32_t to) const {
+            EntityJoinPath path;
+            size_t nodes = names.size();
+            if (from >= nodes || to >= nodes || componentIds[from] != componentIds[to]) {
+                return path;
+            }
+
+            // Breadth-first from 'from', neighbors in id order, until 'to' is reached
+            std::vector<uint32_t> parentEdge(nodes, npos);  // Position in linkEdges of the edge that reached a node
+            std::vector<uint64_t> visited((nodes + 63) / 64, 0);
+            visited[from / 64] |= uint64_t(1) << (from % 64);
+            std::vector<uint32_t> queue(1, from);
+            std::vector<uint32_t> parents(nodes, npos);
+            for (size_t head = 0; head < queue.size() && !(visited[to / 64] & (uint64_t(1) << (to % 64))); ++head) {
+                uint32_t node = queue[head];
+                for (uint32_t e = linkEdges.begin[node]; e < linkEdges.begin[node + 1]; ++e) {
+                    uint32_t target = linkEdges.targets[e];
+                    uint64_t bit = uint64_t(1) << (target % 64);
+                    if (visited[target / 64] & bit) continue;
+                    visited[target / 64] |= bit;
+                    parents[target] = node;
+                    parentEdge[target] = e;
+                    if (target == to) break;
+                    queue.push_back(target);
+                }
+            }
+
+            for (uint32_t node = to; node != from; node = parents[node]) {
+                path.entities.push_back(node);
+                path.relationships.push_back(linkEdges.labels[parentEdge[node]]);
+            }
+            path.entities.push_back(from);
+            std::reverse(path.entities.begin(), path.entities.end());
+            std::reverse(path.relationships.begin(), path.relationships.end());
+            return path;
+        }
+    };
+
+    const uint32_t EntityGraph::npos;
+
+    EntityGraph::EntityGraph() : pImpl(new Impl()) {}
+
+    EntityGraph::~EntityGraph() = default;
+
+    EntityGraph::EntityGraph(EntityGraph&& other) noexcept = default;
+
+    EntityGraph& EntityGraph::operator=(EntityGraph&& other) noexcept = default;
+
+    void EntityGraph::build(const PUMLEntityDiagramResult& result) {
+        pImpl->build(result.entities, result.relationships);
+    }
+
+    void EntityGraph::build(const std::vector<Entity>& entities, const std::vector<EntityRelationship>& relationships) {
+        pImpl->build(entities, relationships);
+    }
+
+    void EntityGraph::clear() {
+        pImpl->clear();
+    }
+
+    size_t EntityGraph::nodeCount() const {
+        return pImpl->names.size();
+    }
+
+    size_t EntityGraph::referenceCount() const {
+        return pImpl->referenceEdges.targets.size();
+    }
+
+    size_t EntityGraph::linkCount() const {
+        return pImpl->linkEdges.targets.size() / 2;
+    }
+
+    std::string_view EntityGraph::name(uint32_t node) const {
+        return pImpl->names[node];
+    }
+
+    uint32_t EntityGraph::find(std::string_view nameOrAlias) const {
+        return pImpl->find(nameOrAlias);
+    }
+
+    std::vector<uint32_t> EntityGraph::references(uint32_t node) const {
+        return edgesOf(pImpl->referenceEdges, node);
+    }
+
+    std::vector<uint32_t> EntityGraph::referencedBy(uint32_t node) const {
+        return edgesOf(pImpl->referrerEdges, node);
+    }
+
+    std::vector<uint32_t> EntityGraph::neighbors(uint32_t node) const {
+        return edgesOf(pImpl->linkEdges, node);
+    }
+
+    std::vector<uint32_t> EntityGraph::transitiveReferences(uint32_t node) const {
+        return Graph::reach(pImpl->referenceEdges, std::vector<uint32_t>(1, node));
+    }
+
+    std::vector<uint32_t> EntityGraph::dependents(uint32_t node) const {
+        return Graph::reach(pImpl->referrerEdges, std::vector<uint32_t>(1, node));
+    }
+
+    std::vector<uint32_t> EntityGraph::creationOrder() const {
+        return pImpl->creationOrder(nullptr);
+    }
+
+    bool EntityGraph::isOrderable() const {
+        bool bComplete = true;
+        pImpl->creationOrder(&bComplete);
+        return bComplete;
+    }
+
+    std::vector<std::vector<uint32_t>> EntityGraph::cycles() const {
+        return Graph::cycles(pImpl->referenceEdges);
+    }
+
+    std::vector<std::vector<uint32_t>> EntityGraph::components() const {
+        std::vector<std::vector<uint32_t>> found(pImpl->componentCount);
+        for (uint32_t node = 0; node < pImpl->componentIds.size(); ++node) {
+            found[pImpl->componentIds[node]].push_back(node);
+        }
+        return found;
+    }
+
+    uint32_t EntityGraph::componentOf(uint32_t node) const {
+        return node < pImpl->componentIds.size() ? pImpl->componentIds[node] : npos;
+    }
+
+    EntityJoinPath EntityGraph::joinPath(uint32_t from, uint32_t to) const {
+        return pImpl->joinPath(from, to);
+    }
+
+    const std::vector<uint32_t>& EntityGraph::unresolved() const {
+        return pImpl->unresolvedRelationships;
+    }
+
+} // namespace UFMTooling
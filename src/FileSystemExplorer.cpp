@@ -1,17 +1,354 @@
 #include "../include/FileSystemExplorer.h"
+#include "WorkerThreads.h"
 #include <filesystem>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <thread>
 
 namespace fs = std::filesystem;
 
 namespace UFMTooling {
 
+    namespace {
+        // Normalize an extension filter to start with a dot
+        std::string normalizeExtension(const std::string& extension) {
+            if (!extension.empty() && extension[0] != '.') {
+                return "." + extension;
+            }
+            return extension;
+        }
+
+        // Same rule as fs::path::extension() on the file name, without building a path:
+        // the part from the last dot, unless that dot starts the name
+        bool hasExtension(const std::string& name, const std::string& ext) {
+            size_t dot = name.rfind('.');
+            if (dot == std::string::npos || dot == 0 || name == "..") {
+                return ext.empty();
+            }
+            return name.size() - dot == ext.size() && name.compare(dot, std::string::npos, ext) == 0;
+        }
+
+        // Match one character against the set starting at pattern[pos] == '['; pos is moved
+        // past the closing ']'. Returns false with pos unchanged if the set is not closed.
+        bool matchSet(std::string_view pattern, size_t& pos, char c, bool& bMatched) {
+            size_t i = pos + 1;
+            bool bNegate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+            if (bNegate) ++i;
+
+            bool bFound = false;
+            size_t first = i;
+            for (; i < pattern.size() && (pattern[i] != ']' || i == first); ++i) {
+                if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+                    bFound = bFound || (pattern[i] <= c && c <= pattern[i + 2]);
+                    i += 2;
+                } else {
+                    bFound = bFound || pattern[i] == c;
+                }
+            }
+            if (i >= pattern.size()) {
+                return false;
+            }
+
+            pos = i;
+            bMatched = bFound != bNegate && c != '/';
+            return true;
+        }
+
+        bool globMatch(std::string_view pattern, std::string_view text) {
+            size_t p = 0;
+            size_t t = 0;
+            while (p < pattern.size()) {
+                char c = pattern[p];
+                if (c == '*') {
+                    bool bDeep = p + 1 < pattern.size() && pattern[p + 1] == '*';
+                    std::string_view rest = pattern.substr(p + (bDeep ? 2 : 1));
+
+                    // "**/" also matches no directory at all
+                    if (bDeep && !rest.empty() && rest[0] == '/' && globMatch(rest.substr(1), text.substr(t))) {
+                        return true;
+                    }
+                    for (size_t k = t; ; ++k) {
+                        if (globMatch(rest, text.substr(k))) return true;
+                        if (k >= text.size() || (!bDeep && text[k] == '/')) return false;
+                    }
+                }
+
+                if (t >= text.size()) return false;
+
+                bool bMatched = false;
+                if (c == '?') {
+                    bMatched = text[t] != '/';
+                } else if (c != '[' || !matchSet(pattern, p, text[t], bMatched)) {
+                    bMatched = c == text[t];
+                }
+                if (!bMatched) return false;
+                ++p;
+                ++t;
+            }
+            return t == text.size();
+        }
+
+        // Globs split by what they are matched against
+        struct PatternSet {
+            std::vector<std::string> namePatterns;
+            std::vector<std::string> pathPatterns;
+
+            void add(const std::string& pattern) {
+                (pattern.find('/') == std::string::npos ? namePatterns : pathPatterns).push_back(pattern);
+            }
+
+            bool empty() const { return namePatterns.empty() && pathPatterns.empty(); }
+
+            bool matches(const std::string& name, const std::string& relativePath) const {
+                for (const auto& pattern : namePatterns) {
+                    if (globMatch(pattern, name)) return true;
+                }
+                for (const auto& pattern : pathPatterns) {
+                    if (globMatch(pattern, relativePath)) return true;
+                }
+                return false;
+            }
+        };
+
+        // Walk-time decisions for one exploration
+        class EntryFilter {
+        public:
+            EntryFilter(const FileSystemExplorerOptions& options, const fs::path& base)
+                : options(options), baseLength(base.generic_string().size()) {
+                for (const auto& extension : options.extensions) {
+                    extensions.push_back(normalizeExtension(extension));
+                }
+                for (const auto& pattern : options.includePatterns) {
+                    includes.add(pattern);
+                }
+                for (const auto& pattern : options.excludePatterns) {
+                    excludes.add(pattern);
+                }
+                if (options.bPruneIgnoredDirectories) {
+                    for (const auto& pattern : FileSystemExplorer::ignoredDirectoryPatterns()) {
+                        ignoredDirectories.add(pattern);
+                    }
+                }
+                bNeedsRelativePath = !includes.pathPatterns.empty() || !excludes.pathPatterns.empty() ||
+                                     !ignoredDirectories.pathPatterns.empty();
+            }
+
+            // Record entry into entries if it passes the filters. Returns true for a
+            // directory that should be descended into.
+            bool visit(const fs::directory_entry& entry, std::vector<FileSystemEntry>& entries) const {
+                std::string name = entry.path().filename().string();
+                bool bDirectory = entry.is_directory();
+
+                // Cheap name checks first, so non-matching files cost no path building or stat
+                if (!bDirectory && !extensions.empty() &&
+                    std::none_of(extensions.begin(), extensions.end(),
+                                 [&name](const std::string& ext) { return hasExtension(name, ext); })) {
+                    return false;
+                }
+
+                std::string relativePath;
+                if (bNeedsRelativePath) {
+                    relativePath = entry.path().generic_string();
+                    size_t skip = std::min(baseLength, relativePath.size());
+                    if (skip < relativePath.size() && relativePath[skip] == '/') ++skip;
+                    relativePath.erase(0, skip);
+                }
+
+                if (excludes.matches(name, relativePath)) {
+                    return false;
+                }
+
+                FileSystemEntry fsEntry;
+                if (bDirectory) {
+                    if (ignoredDirectories.matches(name, relativePath)) {
+                        return false;
+                    }
+                    if (!options.bIncludeDirectories) {
+                        return true;
+                    }
+                } else {
+                    if (!includes.empty() && !includes.matches(name, relativePath)) {
+                        return false;
+                    }
+                    if (options.bFileSizes && entry.is_regular_file()) {
+                        fsEntry.size = entry.file_size();
+                    }
+                }
+
+                fsEntry.path = entry.path().string();
+                fsEntry.name = std::move(name);
+                fsEntry.isDirectory = bDirectory;
+                entries.push_back(std::move(fsEntry));
+                return bDirectory;
+            }
+
+        private:
+            const FileSystemExplorerOptions& options;
+            size_t baseLength;
+            bool bNeedsRelativePath;
+            std::vector<std::string> extensions;
+            PatternSet includes;
+            PatternSet excludes;
+            PatternSet ignoredDirectories;
+        };
+
+        // A directory listed by the parallel walker. Entries are kept in listing order;
+        // each child is the subtree to splice in after the first 'position' entries.
+        struct DirectoryNode {
+            fs::path path;
+            std::vector<FileSystemEntry> entries;
+            std::vector<std::pair<size_t, std::unique_ptr<DirectoryNode>>> children;
+
+            explicit DirectoryNode(fs::path directory) : path(std::move(directory)) {}
+
+            // Pre-order, the order recursive_directory_iterator produces
+            void flatten(std::vector<FileSystemEntry>& out) {
+                size_t next = 0;
+                for (auto& child : children) {
+                    for (; next < child.first; ++next) {
+                        out.push_back(std::move(entries[next]));
+                    }
+                    child.second->flatten(out);
+                }
+                for (; next < entries.size(); ++next) {
+                    out.push_back(std::move(entries[next]));
+                }
+            }
+        };
+
+        // Lists directories on several threads. Each worker takes new directories from
+        // the back of its own queue and, when that is empty, steals from the front of
+        // the others', so wide trees spread across all threads.
+        class ParallelWalker {
+        public:
+            ParallelWalker(const EntryFilter& filter, unsigned int threadCount)
+                : filter(filter), queues(threadCount), pending(0), queued(0) {}
+
+            void walk(DirectoryNode& root) {
+                // The base directory is listed on the calling thread so that errors
+                // opening it are reported like in the serial walk
+                fs::directory_iterator it(root.path, fs::directory_options::skip_permission_denied);
+                list(root, it, 0);
+
+                std::vector<std::thread> workers;
+                for (size_t i = 1; i < queues.size(); ++i) {
+                    workers.emplace_back([this, i]() { work(i); });
+                }
+                work(0);
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+            }
+
+        private:
+            struct Queue {
+                std::mutex mutex;
+                std::deque<DirectoryNode*> directories;
+            };
+
+            const EntryFilter& filter;
+            std::deque<Queue> queues;
+            std::atomic<size_t> pending;    // Directories queued or being listed
+            std::atomic<size_t> queued;     // Directories waiting in a queue
+            std::mutex idleMutex;
+            std::condition_variable idle;
+
+            void list(DirectoryNode& node, fs::directory_iterator& it, size_t worker) {
+                std::error_code ec;
+                for (; it != fs::directory_iterator(); it.increment(ec)) {
+                    try {
+                        if (filter.visit(*it, node.entries) && !it->is_symlink()) {
+                            node.children.emplace_back(node.entries.size(), new DirectoryNode(it->path()));
+                            push(worker, node.children.back().second.get());
+                        }
+                    } catch (const std::exception&) {
+                        // Skip entries that cause errors (permission denied, etc.)
+                    }
+                    if (ec) break;
+                }
+            }
+
+            void push(size_t worker, DirectoryNode* node) {
+                pending++;
+                {
+                    std::lock_guard<std::mutex> lock(queues[worker].mutex);
+                    queues[worker].directories.push_back(node);
+                }
+                queued++;
+                notify(false);
+            }
+
+            void notify(bool bAll) {
+                { std::lock_guard<std::mutex> lock(idleMutex); }
+                if (bAll) {
+                    idle.notify_all();
+                } else {
+                    idle.notify_one();
+                }
+            }
+
+            DirectoryNode* take(size_t worker) {
+                {
+                    Queue& own = queues[worker];
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (!own.directories.empty()) {
+                        DirectoryNode* node = own.directories.back();
+                        own.directories.pop_back();
+                        return node;
+                    }
+                }
+                for (size_t offset = 1; offset < queues.size(); ++offset) {
+                    Queue& victim = queues[(worker + offset) % queues.size()];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.directories.empty()) {
+                        DirectoryNode* node = victim.directories.front();
+                        victim.directories.pop_front();
+                        return node;
+                    }
+                }
+                return nullptr;
+            }
+
+            void work(size_t worker) {
+                while (true) {
+                    DirectoryNode* node = take(worker);
+                    if (!node) {
+                        std::unique_lock<std::mutex> lock(idleMutex);
+                        idle.wait(lock, [this]() { return queued > 0 || pending == 0; });
+                        if (pending == 0) return;
+                        continue;
+                    }
+                    queued--;
+
+                    // Subdirectories that cannot be opened are skipped
+                    std::error_code ec;
+                    fs::directory_iterator it(node->path, fs::directory_options::skip_permission_denied, ec);
+                    if (!ec) {
+                        list(*node, it, worker);
+                    }
+
+                    if (--pending == 0) {
+                        notify(true);
+                    }
+                }
+            }
+        };
+    }
+
     class FileSystemExplorer::Impl {
     public:
         FileSystemExplorerResult lastResult;
 
-        FileSystemExplorerResult exploreDirectory(const std::string& basePath, bool bRecursive) {
-            FileSystemExplorerResult result;
+        // Entries are built in place in lastResult, which explore() hands out by reference
+        const FileSystemExplorerResult& exploreDirectory(const std::string& basePath,
+                                                         const FileSystemExplorerOptions& options) {
+            FileSystemExplorerResult& result = lastResult;
+            result = FileSystemExplorerResult();
             
             try {
                 fs::path base(basePath);
@@ -29,43 +366,29 @@ namespace UFMTooling {
                 }
                 
                 // Iterate through the directory
-                if (bRecursive) {
-                    for (const auto& entry : fs::recursive_directory_iterator(base, fs::directory_options::skip_permission_denied)) {
+                EntryFilter filter(options, base);
+                unsigned int threadCount = resolveThreadCount(options.threadCount, std::numeric_limits<size_t>::max());
+                if (options.bRecursive && threadCount > 1) {
+                    DirectoryNode root(base);
+                    ParallelWalker(filter, threadCount).walk(root);
+                    root.flatten(result.entries);
+                } else if (options.bRecursive) {
+                    fs::recursive_directory_iterator it(base, fs::directory_options::skip_permission_denied);
+                    for (; it != fs::recursive_directory_iterator(); ++it) {
                         try {
-                            FileSystemEntry fsEntry;
-                            fsEntry.path = entry.path().string();
-                            fsEntry.name = entry.path().filename().string();
-                            fsEntry.isDirectory = entry.is_directory();
-                            
-                            if (!fsEntry.isDirectory && entry.is_regular_file()) {
-                                fsEntry.size = entry.file_size();
-                            } else {
-                                fsEntry.size = 0;
+                            if (!filter.visit(*it, result.entries)) {
+                                it.disable_recursion_pending();
                             }
-                            
-                            result.entries.push_back(fsEntry);
-                        } catch (const std::exception& e) {
-                            // Skip entries that cause errors (permission denied, etc.)
-                            continue;
+                        } catch (const std::exception&) {
+                            // Skip entries that cause errors (permission denied, etc.), and what is below them
+                            it.disable_recursion_pending();
                         }
                     }
                 } else {
                     for (const auto& entry : fs::directory_iterator(base, fs::directory_options::skip_permission_denied)) {
                         try {
-                            FileSystemEntry fsEntry;
-                            fsEntry.path = entry.path().string();
-                            fsEntry.name = entry.path().filename().string();
-                            fsEntry.isDirectory = entry.is_directory();
-                            
-                            if (!fsEntry.isDirectory && entry.is_regular_file()) {
-                                fsEntry.size = entry.file_size();
-                            } else {
-                                fsEntry.size = 0;
-                            }
-                            
-                            result.entries.push_back(fsEntry);
-                        } catch (const std::exception& e) {
-                            // Skip entries that cause errors (permission denied, etc.)
+                            filter.visit(entry, result.entries);
+                        } catch (const std::exception&) {
                             continue;
                         }
                     }
@@ -76,49 +399,42 @@ namespace UFMTooling {
                 result.errorMessage = std::string("Error exploring directory: ") + e.what();
             }
             
-            lastResult = result;
             return result;
         }
 
-        std::vector<FileSystemEntry> filterByExtension(const std::string& extension) const {
-            std::vector<FileSystemEntry> filtered;
-            std::string ext = extension;
-            
-            // Ensure extension starts with a dot
-            if (!ext.empty() && ext[0] != '.') {
-                ext = "." + ext;
-            }
-            
+        template <typename Predicate>
+        std::vector<const FileSystemEntry*> select(Predicate matches) const {
+            std::vector<const FileSystemEntry*> selected;
             for (const auto& entry : lastResult.entries) {
-                if (!entry.isDirectory) {
-                    fs::path p(entry.path);
-                    if (p.extension().string() == ext) {
-                        filtered.push_back(entry);
-                    }
+                if (matches(entry)) {
+                    selected.push_back(&entry);
                 }
             }
-            
-            return filtered;
+            return selected;
         }
 
-        std::vector<FileSystemEntry> getDirectories() const {
-            std::vector<FileSystemEntry> directories;
-            for (const auto& entry : lastResult.entries) {
-                if (entry.isDirectory) {
-                    directories.push_back(entry);
-                }
-            }
-            return directories;
+        std::vector<const FileSystemEntry*> selectByExtension(const std::string& extension) const {
+            std::string ext = normalizeExtension(extension);
+            return select([&ext](const FileSystemEntry& entry) {
+                return !entry.isDirectory && hasExtension(entry.name, ext);
+            });
         }
 
-        std::vector<FileSystemEntry> getFiles() const {
-            std::vector<FileSystemEntry> files;
-            for (const auto& entry : lastResult.entries) {
-                if (!entry.isDirectory) {
-                    files.push_back(entry);
-                }
+        std::vector<const FileSystemEntry*> selectDirectories() const {
+            return select([](const FileSystemEntry& entry) { return entry.isDirectory; });
+        }
+
+        std::vector<const FileSystemEntry*> selectFiles() const {
+            return select([](const FileSystemEntry& entry) { return !entry.isDirectory; });
+        }
+
+        static std::vector<FileSystemEntry> copyEntries(const std::vector<const FileSystemEntry*>& view) {
+            std::vector<FileSystemEntry> entries;
+            entries.reserve(view.size());
+            for (const FileSystemEntry* entry : view) {
+                entries.push_back(*entry);
             }
-            return files;
+            return entries;
         }
     };
 
@@ -127,24 +443,50 @@ namespace UFMTooling {
 
     FileSystemExplorer::~FileSystemExplorer() = default;
 
-    FileSystemExplorerResult FileSystemExplorer::explore(const std::string& basePath, bool bRecursive) {
-        return pImpl->exploreDirectory(basePath, bRecursive);
+    const FileSystemExplorerResult& FileSystemExplorer::explore(const std::string& basePath, bool bRecursive) {
+        FileSystemExplorerOptions options;
+        options.bRecursive = bRecursive;
+        return pImpl->exploreDirectory(basePath, options);
+    }
+
+    const FileSystemExplorerResult& FileSystemExplorer::explore(const std::string& basePath,
+                                                                const FileSystemExplorerOptions& options) {
+        return pImpl->exploreDirectory(basePath, options);
     }
 
     std::vector<FileSystemEntry> FileSystemExplorer::getFilesByExtension(const std::string& extension) const {
-        return pImpl->filterByExtension(extension);
+        return Impl::copyEntries(pImpl->selectByExtension(extension));
     }
 
     std::vector<FileSystemEntry> FileSystemExplorer::getDirectories() const {
-        return pImpl->getDirectories();
+        return Impl::copyEntries(pImpl->selectDirectories());
     }
 
     std::vector<FileSystemEntry> FileSystemExplorer::getFiles() const {
-        return pImpl->getFiles();
+        return Impl::copyEntries(pImpl->selectFiles());
+    }
+
+    std::vector<const FileSystemEntry*> FileSystemExplorer::viewFilesByExtension(const std::string& extension) const {
+        return pImpl->selectByExtension(extension);
+    }
+
+    std::vector<const FileSystemEntry*> FileSystemExplorer::viewDirectories() const {
+        return pImpl->selectDirectories();
+    }
+
+    std::vector<const FileSystemEntry*> FileSystemExplorer::viewFiles() const {
+        return pImpl->selectFiles();
     }
 
     const FileSystemExplorerResult& FileSystemExplorer::getLastResult() const {
         return pImpl->lastResult;
     }
 
+    const std::vector<std::string>& FileSystemExplorer::ignoredDirectoryPatterns() {
+        static const std::vector<std::string> patterns = {
+            ".git", ".hg", ".svn", ".vs", ".idea", ".vscode", "node_modules", "__pycache__"
+        };
+        return patterns;
+    }
+
 } // namespace UFMTooling
@@ -0,0 +1,214 @@
+#ifndef GRAPH_ADJACENCY_H
+#define GRAPH_ADJACENCY_H
+
+// Internal helper: graphs over dense node ids stored as compressed adjacency arrays,
+// with the traversals shared by IncludeGraph and EntityGraph. Traversals are
+// iterative (chains can be deep) and mark visited nodes in bitsets.
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace UFMTooling {
+    namespace Graph {
+
+        const uint32_t npos = static_cast<uint32_t>(-1);
+
+        // Index of the lowest set bit of a non-zero word
+        inline unsigned lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+        }
+
+        // An edge and what it stands for (e.g. the relationship it was built from)
+        struct Edge {
+            uint32_t from;
+            uint32_t to;
+            uint32_t label;
+
+            friend bool operator<(const Edge& a, const Edge& b) {
+                return a.from != b.from ? a.from < b.from : (a.to != b.to ? a.to < b.to : a.label < b.label);
+            }
+        };
+
+        // Sort edges and keep one per (from, to) pair, the one with the lowest label
+        inline void sortUnique(std::vector<Edge>& edges) {
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end(),
+                                    [](const Edge& a, const Edge& b) { return a.from == b.from && a.to == b.to; }),
+                        edges.end());
+        }
+
+        // The edges of node v are targets[begin[v] .. begin[v + 1]), sorted, with their
+        // labels (if kept) at the same positions
+        struct Adjacency {
+            std::vector<uint32_t> begin;
+            std::vector<uint32_t> targets;
+            std::vector<uint32_t> labels;
+
+            Adjacency() : begin(1, 0) {}
+
+            void clear() {
+                begin.assign(1, 0);
+                targets.clear();
+                labels.clear();
+            }
+
+            size_t nodeCount() const { return begin.size() - 1; }
+            uint32_t degree(uint32_t node) const { return begin[node + 1] - begin[node]; }
+
+            bool hasEdge(uint32_t from, uint32_t to) const {
+                return std::binary_search(targets.begin() + begin[from], targets.begin() + begin[from + 1], to);
+            }
+
+            // From edges sorted by sortUnique(); bReverse stores each edge at its target
+            // (pointing back to its source) instead
+            void build(size_t nodes, const std::vector<Edge>& edges, bool bReverse, bool bLabels) {
+                begin.assign(nodes + 1, 0);
+                targets.resize(edges.size());
+                labels.resize(bLabels ? edges.size() : 0);
+                for (const auto& edge : edges) {
+                    begin[(bReverse ? edge.to : edge.from) + 1]++;
+                }
+                for (size_t v = 0; v < nodes; ++v) {
+                    begin[v + 1] += begin[v];
+                }
+                // Edges are sorted by source, so the reverse lists come out sorted as well
+                std::vector<uint32_t> next(begin.begin(), begin.end() - 1);
+                for (const auto& edge : edges) {
+                    uint32_t slot = next[bReverse ? edge.to : edge.from]++;
+                    targets[slot] = bReverse ? edge.from : edge.to;
+                    if (bLabels) labels[slot] = edge.label;
+                }
+            }
+        };
+
+        // Nodes reachable from seeds, in id order, without the seeds
+        inline std::vector<uint32_t> reach(const Adjacency& graph, const std::vector<uint32_t>& seeds) {
+            size_t nodes = graph.nodeCount();
+            std::vector<uint64_t> visited((nodes + 63) / 64, 0);
+            std::vector<uint32_t> stack;
+            for (uint32_t seed : seeds) {
+                if (seed >= nodes) continue;
+                stack.push_back(seed);
+                visited[seed / 64] |= uint64_t(1) << (seed % 64);
+            }
+            while (!stack.empty()) {
+                uint32_t node = stack.back();
+                stack.pop_back();
+                for (uint32_t e = graph.begin[node]; e < graph.begin[node + 1]; ++e) {
+                    uint32_t target = graph.targets[e];
+                    uint64_t bit = uint64_t(1) << (target % 64);
+                    if (visited[target / 64] & bit) continue;
+                    visited[target / 64] |= bit;
+                    stack.push_back(target);
+                }
+            }
+            for (uint32_t seed : seeds) {
+                if (seed < nodes) visited[seed / 64] &= ~(uint64_t(1) << (seed % 64));
+            }
+
+            std::vector<uint32_t> found;
+            for (size_t w = 0; w < visited.size(); ++w) {
+                for (uint64_t word = visited[w]; word != 0; word &= word - 1) {
+                    found.push_back(static_cast<uint32_t>(w * 64 + lowestBit(word)));
+                }
+            }
+            return found;
+        }
+
+        // True if to can be reached from from over at least one edge
+        inline bool reaches(const Adjacency& graph, uint32_t from, uint32_t to) {
+            size_t nodes = graph.nodeCount();
+            if (from >= nodes || to >= nodes) return false;
+            std::vector<uint64_t> visited((nodes + 63) / 64, 0);
+            std::vector<uint32_t> stack(1, from);
+            while (!stack.empty()) {
+                uint32_t node = stack.back();
+                stack.pop_back();
+                for (uint32_t e = graph.begin[node]; e < graph.begin[node + 1]; ++e) {
+                    uint32_t target = graph.targets[e];
+                    if (target == to) return true;
+                    uint64_t bit = uint64_t(1) << (target % 64);
+                    if (visited[target / 64] & bit) continue;
+                    visited[target / 64] |= bit;
+                    stack.push_back(target);
+                }
+            }
+            return false;
+        }
+
+        // Cycles: strongly connected components of more than one node, or a node with an
+        // edge to itself (Tarjan's algorithm), each sorted, sorted by their first node
+        inline std::vector<std::vector<uint32_t>> cycles(const Adjacency& graph) {
+            size_t nodes = graph.nodeCount();
+            std::vector<uint32_t> index(nodes, npos);
+            std::vector<uint32_t> low(nodes, 0);
+            std::vector<bool> onStack(nodes, false);
+            std::vector<uint32_t> component;
+            std::vector<std::pair<uint32_t, uint32_t>> calls;  // Node, next edge
+            std::vector<std::vector<uint32_t>> found;
+            uint32_t counter = 0;
+
+            for (uint32_t root = 0; root < nodes; ++root) {
+                if (index[root] != npos) continue;
+                calls.emplace_back(root, graph.begin[root]);
+                index[root] = low[root] = counter++;
+                component.push_back(root);
+                onStack[root] = true;
+
+                while (!calls.empty()) {
+                    uint32_t node = calls.back().first;
+                    uint32_t& edge = calls.back().second;
+                    if (edge < graph.begin[node + 1]) {
+                        uint32_t target = graph.targets[edge++];
+                        if (index[target] == npos) {
+                            index[target] = low[target] = counter++;
+                            component.push_back(target);
+                            onStack[target] = true;
+                            calls.emplace_back(target, graph.begin[target]);
+                        } else if (onStack[target]) {
+                            low[node] = std::min(low[node], index[target]);
+                        }
+                        continue;
+                    }
+
+                    calls.pop_back();
+                    if (!calls.empty()) {
+                        uint32_t parent = calls.back().first;
+                        low[parent] = std::min(low[parent], low[node]);
+                    }
+                    if (low[node] != index[node]) continue;
+
+                    std::vector<uint32_t> scc;
+                    uint32_t member;
+                    do {
+                        member = component.back();
+                        component.pop_back();
+                        onStack[member] = false;
+                        scc.push_back(member);
+                    } while (member != node);
+                    if (scc.size() > 1 || graph.hasEdge(node, node)) {
+                        std::sort(scc.begin(), scc.end());
+                        found.push_back(std::move(scc));
+                    }
+                }
+            }
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+    } // namespace Graph
+} // namespace UFMTooling
+
+#endif // GRAPH_ADJACENCY_H
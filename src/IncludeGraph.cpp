@@ -0,0 +1,309 @@
+#include "../include/IncludeGraph.h"
+#include "GraphAdjacency.h"
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace UFMTooling {
+
+    namespace {
+        namespace fs = std::filesystem;
+
+        bool isSeparator(char c) {
+            return c == '/' || c == '\\';
+        }
+
+        bool isAbsolute(std::string_view path) {
+            return (!path.empty() && isSeparator(path[0])) || (path.size() > 1 && path[1] == ':');
+        }
+
+        // Append the components of path to the normalized path out, resolving "." and ".."
+        // lexically ('\' is read as '/'); a ".." with nothing left to remove is kept
+        void appendNormalized(std::string& out, std::string_view path) {
+            size_t pos = 0;
+            while (pos < path.size()) {
+                size_t end = pos;
+                while (end < path.size() && !isSeparator(path[end])) ++end;
+                std::string_view component = path.substr(pos, end - pos);
+                pos = end + 1;
+
+                if (component.empty() || component == ".") continue;
+                if (component == "..") {
+                    size_t slash = out.rfind('/');
+                    std::string_view last = slash == std::string::npos ? std::string_view(out)
+                                                                       : std::string_view(out).substr(slash + 1);
+                    if (out == "/") continue;           // Nothing above the root
+                    if (!out.empty() && last != "..") {
+                        out.resize(slash == std::string::npos ? 0 : (slash == 0 ? 1 : slash));
+                        continue;
+                    }
+                }
+                if (!out.empty() && out.back() != '/') out.push_back('/');
+                out.append(component.data(), component.size());
+            }
+        }
+
+        std::string normalized(std::string_view path) {
+            std::string out = !path.empty() && isSeparator(path[0]) ? "/" : "";
+            appendNormalized(out, path);
+            return out;
+        }
+
+        // target relative to the directory dir (normalized), unless target is absolute
+        std::string joined(std::string_view dir, std::string_view target) {
+            if (isAbsolute(target)) return normalized(target);
+            std::string out(dir);
+            appendNormalized(out, target);
+            return out;
+        }
+
+        std::string_view parentDirectory(std::string_view path) {
+            size_t slash = path.rfind('/');
+            if (slash == std::string_view::npos) return std::string_view();
+            return path.substr(0, slash == 0 ? 1 : slash);
+        }
+
+        std::string_view fileName(std::string_view path) {
+            size_t slash = path.rfind('/');
+            return slash == std::string_view::npos ? path : path.substr(slash + 1);
+        }
+    }
+
+    class IncludeGraph::Impl {
+    public:
+        std::deque<std::string> paths;          // Node paths; a deque keeps the views of nodeByPath valid
+        std::unordered_map<std::string_view, uint32_t> nodeByPath;
+        size_t analyzedCount = 0;               // Nodes [0, analyzedCount) are analyses
+
+        Graph::Adjacency includeEdges;          // Headers each node includes
+        Graph::Adjacency includerEdges;         // Files including each node
+
+        std::vector<UnresolvedInclude> unresolvedIncludes;
+
+        void clear() {
+            paths.clear();
+            nodeByPath.clear();
+            analyzedCount = 0;
+            includeEdges.clear();
+            includerEdges.clear();
+            unresolvedIncludes.clear();
+        }
+
+        uint32_t find(std::string_view path) const {
+            auto it = nodeByPath.find(path);
+            return it != nodeByPath.end() ? it->second : npos;
+        }
+
+        uint32_t addNode(std::string path) {
+            uint32_t node = static_cast<uint32_t>(paths.size());
+            paths.push_back(std::move(path));
+            nodeByPath.emplace(paths.back(), node);
+            return node;
+        }
+
+        void build(const SourceExplorerResult& result, const IncludeGraphOptions& options) {
+            clear();
+
+            std::vector<uint32_t> analysisNodes;
+            analysisNodes.reserve(result.analyses.size());
+            nodeByPath.reserve(result.analyses.size());
+            for (const auto& analysis : result.analyses) {
+                std::string path = normalized(analysis.path);
+                uint32_t node = find(path);
+                analysisNodes.push_back(node != npos ? node : addNode(std::move(path)));
+            }
+            analyzedCount = paths.size();
+
+            // Analyzed files by file name, for suffix matching
+            std::unordered_map<std::string_view, std::vector<uint32_t>> byFileName;
+            if (options.bMatchBySuffix) {
+                for (uint32_t node = 0; node < analyzedCount; ++node) {
+                    byFileName[fileName(paths[node])].push_back(node);
+                }
+            }
+            std::vector<std::string> includePaths;
+            for (const auto& includePath : options.includePaths) {
+                includePaths.push_back(normalized(includePath));
+            }
+
+            // Node of a candidate path: analyzed, already found on disk, or found now. Failed
+            // disk probes are remembered, every includer in a directory tries the same candidates
+            std::unordered_set<std::string> missing;
+            auto lookup = [&](std::string candidate) -> uint32_t {
+                uint32_t node = find(candidate);
+                if (node != npos || !options.bSearchFileSystem) return node;
+                if (missing.count(candidate)) return npos;
+                std::error_code error;
+                if (!fs::is_regular_file(fs::path(candidate), error)) {
+                    missing.insert(std::move(candidate));
+                    return npos;
+                }
+                return addNode(std::move(candidate));
+            };
+
+            // Targets not found next to their includer resolve the same way from every
+            // directory: searched once, cached by target
+            std::unordered_map<std::string, uint32_t> global;
+            std::string key;
+            auto resolveGlobal = [&](std::string_view target) -> uint32_t {
+                key.assign(target.data(), target.size());
+                auto cached = global.find(key);
+                if (cached != global.end()) return cached->second;
+
+                uint32_t node = npos;
+                for (size_t i = 0; i < includePaths.size() && node == npos; ++i) {
+                    node = lookup(joined(includePaths[i], target));
+                }
+                if (node == npos && options.bMatchBySuffix) {
+                    // Leading ".." components say nothing about where the file is
+                    std::string suffix = normalized(target);
+                    while (suffix.compare(0, 3, "../") == 0) suffix.erase(0, 3);
+                    auto named = byFileName.find(fileName(suffix));
+                    if (named != byFileName.end()) {
+                        for (uint32_t candidate : named->second) {
+                            std::string_view path = paths[candidate];
+                            bool bMatches = path == suffix ||
+                                            (path.size() > suffix.size() && path[path.size() - suffix.size() - 1] == '/' &&
+                                             path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0);
+                            if (!bMatches) continue;
+                            if (node != npos) {
+                                node = npos;        // Ambiguous
+                                break;
+                            }
+                            node = candidate;
+                        }
+                    }
+                }
+                global.emplace(key, node);
+                return node;
+            };
+            auto resolve = [&](std::string_view dir, std::string_view target) -> uint32_t {
+                uint32_t node = lookup(joined(dir, target));
+                return node != npos ? node : resolveGlobal(target);
+            };
+
+            std::vector<Graph::Edge> edges;
+            for (size_t i = 0; i < result.analyses.size(); ++i) {
+                const auto& parsed = result.analyses[i].parseResult;
+                if (!parsed) continue;
+                uint32_t from = analysisNodes[i];
+                std::string dir(parentDirectory(paths[from]));
+                for (const auto& target : parsed->includes) {
+                    uint32_t to = resolve(dir, target);
+                    if (to == npos) {
+                        unresolvedIncludes.push_back(UnresolvedInclude{from, target});
+                    } else {
+                        edges.push_back(Graph::Edge{from, to, 0});
+                    }
+                }
+            }
+
+            Graph::sortUnique(edges);
+            includeEdges.build(paths.size(), edges, false, false);
+            includerEdges.build(paths.size(), edges, true, false);
+        }
+    };
+
+    const uint32_t IncludeGraph::npos;
+
+    IncludeGraph::IncludeGraph() : pImpl(new Impl()) {
+        pImpl->clear();
+    }
+
+    IncludeGraph::~IncludeGraph() = default;
+
+    IncludeGraph::IncludeGraph(IncludeGraph&& other) noexcept = default;
+
+    IncludeGraph& IncludeGraph::operator=(IncludeGraph&& other) noexcept = default;
+
+    void IncludeGraph::build(const SourceExplorerResult& result, const IncludeGraphOptions& options) {
+        pImpl->build(result, options);
+    }
+
+    void IncludeGraph::clear() {
+        pImpl->clear();
+    }
+
+    size_t IncludeGraph::nodeCount() const {
+        return pImpl->paths.size();
+    }
+
+    size_t IncludeGraph::edgeCount() const {
+        return pImpl->includeEdges.targets.size();
+    }
+
+    std::string_view IncludeGraph::path(uint32_t node) const {
+        return pImpl->paths[node];
+    }
+
+    bool IncludeGraph::isAnalyzed(uint32_t node) const {
+        return node < pImpl->analyzedCount;
+    }
+
+    uint32_t IncludeGraph::find(std::string_view filePath) const {
+        return pImpl->find(normalized(filePath));
+    }
+
+    std::vector<uint32_t> IncludeGraph::includes(uint32_t node) const {
+        const Graph::Adjacency& edges = pImpl->includeEdges;
+        return std::vector<uint32_t>(edges.targets.begin() + edges.begin[node], edges.targets.begin() + edges.begin[node + 1]);
+    }
+
+    std::vector<uint32_t> IncludeGraph::includers(uint32_t node) const {
+        const Graph::Adjacency& edges = pImpl->includerEdges;
+        return std::vector<uint32_t>(edges.targets.begin() + edges.begin[node], edges.targets.begin() + edges.begin[node + 1]);
+    }
+
+    std::vector<uint32_t> IncludeGraph::transitiveIncludes(uint32_t node) const {
+        return Graph::reach(pImpl->includeEdges, std::vector<uint32_t>(1, node));
+    }
+
+    std::vector<uint32_t> IncludeGraph::dependents(uint32_t node) const {
+        return Graph::reach(pImpl->includerEdges, std::vector<uint32_t>(1, node));
+    }
+
+    std::vector<uint32_t> IncludeGraph::dependents(const std::vector<uint32_t>& changed) const {
+        return Graph::reach(pImpl->includerEdges, changed);
+    }
+
+    bool IncludeGraph::reaches(uint32_t from, uint32_t to) const {
+        return Graph::reaches(pImpl->includeEdges, from, to);
+    }
+
+    std::vector<std::vector<uint32_t>> IncludeGraph::cycles() const {
+        return Graph::cycles(pImpl->includeEdges);
+    }
+
+    std::vector<IncludeFanIn> IncludeGraph::heaviestFanIn(size_t count) const {
+        std::vector<uint32_t> nodes;
+        for (uint32_t node = 0; node < pImpl->paths.size(); ++node) {
+            if (pImpl->includerEdges.degree(node) > 0) nodes.push_back(node);
+        }
+        auto heavier = [&](uint32_t a, uint32_t b) {
+            uint32_t da = pImpl->includerEdges.degree(a);
+            uint32_t db = pImpl->includerEdges.degree(b);
+            return da != db ? da > db : a < b;
+        };
+        count = std::min(count, nodes.size());
+        std::partial_sort(nodes.begin(), nodes.begin() + count, nodes.end(), heavier);
+
+        std::vector<IncludeFanIn> heaviest;
+        heaviest.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            IncludeFanIn fanIn;
+            fanIn.node = nodes[i];
+            fanIn.path = pImpl->paths[nodes[i]];
+            fanIn.includers = pImpl->includerEdges.degree(nodes[i]);
+            fanIn.dependents = static_cast<uint32_t>(dependents(nodes[i]).size());
+            heaviest.push_back(fanIn);
+        }
+        return heaviest;
+    }
+
+    const std::vector<UnresolvedInclude>& IncludeGraph::unresolved() const {
+        return pImpl->unresolvedIncludes;
+    }
+
+} // namespace UFMTooling
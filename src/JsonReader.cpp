@@ -0,0 +1,342 @@
+#include "JsonReader.h"
+
+namespace UFMTooling {
+
+    namespace {
+        // Deeper documents are rejected instead of risking the callers' recursion
+        const size_t MaxDepth = 512;
+
+        int hexDigit(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        void appendUtf8(std::string& out, uint32_t codePoint) {
+            if (codePoint < 0x80) {
+                out.push_back(static_cast<char>(codePoint));
+            } else if (codePoint < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            } else if (codePoint < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+        }
+    }
+
+    JsonReader::JsonReader(std::string_view json)
+        : text(json), pos(0), depth(0), bFirst(true), bFailed(false) {
+        // A UTF-8 byte order mark is allowed, as nlohmann does
+        if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) pos = 3;
+    }
+
+    void JsonReader::skipWhitespace() {
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+            ++pos;
+        }
+    }
+
+    bool JsonReader::fail(const char* what) {
+        if (!bFailed) {
+            bFailed = true;
+            errorMessage = std::string(what) + " at offset " + std::to_string(pos);
+        }
+        return false;
+    }
+
+    JsonReader::Kind JsonReader::peek() {
+        if (bFailed) return Kind::Invalid;
+        skipWhitespace();
+        if (pos >= text.size()) return Kind::End;
+        switch (text[pos]) {
+            case '{': return Kind::Object;
+            case '[': return Kind::Array;
+            case '"': return Kind::String;
+            case 't': case 'f': return Kind::Boolean;
+            case 'n': return Kind::Null;
+            case '-': return Kind::Number;
+            default:
+                return text[pos] >= '0' && text[pos] <= '9' ? Kind::Number : Kind::Invalid;
+        }
+    }
+
+    bool JsonReader::beginObject() {
+        if (peek() != Kind::Object) {
+            skipValue();
+            return false;
+        }
+        if (++depth > MaxDepth) return fail("Nesting too deep");
+        ++pos;
+        bFirst = true;
+        return true;
+    }
+
+    bool JsonReader::nextKey(std::string_view& key) {
+        if (bFailed) return false;
+        skipWhitespace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            --depth;
+            bFirst = false;         // The enclosing container holds at least this object
+            return false;
+        }
+        if (!bFirst) {
+            if (pos >= text.size() || text[pos] != ',') return fail("Expected ',' or '}'");
+            ++pos;
+            skipWhitespace();
+        }
+        bFirst = false;
+        if (pos >= text.size() || text[pos] != '"') return fail("Expected an object key");
+        if (!parseString(key)) return false;
+        skipWhitespace();
+        if (pos >= text.size() || text[pos] != ':') return fail("Expected ':'");
+        ++pos;
+        return true;
+    }
+
+    bool JsonReader::beginArray() {
+        if (peek() != Kind::Array) {
+            skipValue();
+            return false;
+        }
+        if (++depth > MaxDepth) return fail("Nesting too deep");
+        ++pos;
+        bFirst = true;
+        return true;
+    }
+
+    bool JsonReader::nextElement() {
+        if (bFailed) return false;
+        skipWhitespace();
+        if (pos < text.size() && text[pos] == ']') {
+            ++pos;
+            --depth;
+            bFirst = false;
+            return false;
+        }
+        if (!bFirst) {
+            if (pos >= text.size() || text[pos] != ',') return fail("Expected ',' or ']'");
+            ++pos;
+        }
+        bFirst = false;
+        return true;
+    }
+
+    // At the opening quote
+    bool JsonReader::parseString(std::string_view& value) {
+        size_t start = ++pos;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                value = text.substr(start, pos - start);
+                ++pos;
+                return true;
+            }
+            if (c == '\\') break;
+            if (static_cast<unsigned char>(c) < 0x20) return fail("Control character in string");
+            ++pos;
+        }
+        if (pos >= text.size()) return fail("Unterminated string");
+
+        // Escapes: unescape into the scratch buffer
+        scratch.assign(text.data() + start, pos - start);
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '"') {
+                value = scratch;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) return fail("Control character in string");
+            if (c != '\\') {
+                scratch.push_back(c);
+                continue;
+            }
+            if (pos >= text.size()) break;
+            char escape = text[pos++];
+            switch (escape) {
+                case '"': scratch.push_back('"'); break;
+                case '\\': scratch.push_back('\\'); break;
+                case '/': scratch.push_back('/'); break;
+                case 'b': scratch.push_back('\b'); break;
+                case 'f': scratch.push_back('\f'); break;
+                case 'n': scratch.push_back('\n'); break;
+                case 'r': scratch.push_back('\r'); break;
+                case 't': scratch.push_back('\t'); break;
+                case 'u': {
+                    auto readHex = [&](uint32_t& unit) {
+                        if (text.size() - pos < 4) return false;
+                        unit = 0;
+                        for (int i = 0; i < 4; ++i) {
+                            int digit = hexDigit(text[pos + i]);
+                            if (digit < 0) return false;
+                            unit = unit * 16 + static_cast<uint32_t>(digit);
+                        }
+                        pos += 4;
+                        return true;
+                    };
+                    uint32_t unit;
+                    if (!readHex(unit)) return fail("Invalid \\u escape");
+                    if (unit >= 0xD800 && unit < 0xDC00) {
+                        uint32_t low;
+                        if (text.compare(pos, 2, "\\u") != 0) return fail("Unpaired surrogate");
+                        pos += 2;
+                        if (!readHex(low) || low < 0xDC00 || low > 0xDFFF) return fail("Unpaired surrogate");
+                        unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+                        return fail("Unpaired surrogate");
+                    }
+                    appendUtf8(scratch, unit);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape");
+            }
+        }
+        return fail("Unterminated string");
+    }
+
+    // True for an integer, false for a number with a fraction or exponent (or an error)
+    bool JsonReader::skipNumber() {
+        if (pos < text.size() && text[pos] == '-') ++pos;
+        size_t digits = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+        if (pos == digits) return fail("Invalid number");
+        bool bInteger = true;
+        if (pos < text.size() && text[pos] == '.') {
+            bInteger = false;
+            size_t fraction = ++pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+            if (pos == fraction) return fail("Invalid number");
+        }
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            bInteger = false;
+            ++pos;
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) ++pos;
+            size_t exponent = pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+            if (pos == exponent) return fail("Invalid number");
+        }
+        return bInteger;
+    }
+
+    bool JsonReader::expectLiteral(std::string_view literal) {
+        if (text.compare(pos, literal.size(), literal) != 0) return fail("Invalid literal");
+        pos += literal.size();
+        return true;
+    }
+
+    bool JsonReader::readString(std::string_view& value) {
+        if (peek() != Kind::String) {
+            skipValue();
+            return false;
+        }
+        return parseString(value);
+    }
+
+    bool JsonReader::readBool(bool& value) {
+        if (peek() != Kind::Boolean) {
+            skipValue();
+            return false;
+        }
+        value = text[pos] == 't';
+        return expectLiteral(value ? "true" : "false");
+    }
+
+    bool JsonReader::readInteger(long long& value) {
+        if (peek() != Kind::Number) {
+            skipValue();
+            return false;
+        }
+        size_t start = pos;
+        if (!skipNumber()) return false;
+        bool bNegative = text[start] == '-';
+        uint64_t limit = bNegative ? uint64_t(INT64_MAX) + 1 : uint64_t(INT64_MAX);
+        uint64_t magnitude = 0;
+        for (size_t i = start + (bNegative ? 1 : 0); i < pos; ++i) {
+            unsigned digit = static_cast<unsigned>(text[i] - '0');
+            if (magnitude > (limit - digit) / 10) return false;     // Out of range
+            magnitude = magnitude * 10 + digit;
+        }
+        value = bNegative ? static_cast<long long>(0 - magnitude) : static_cast<long long>(magnitude);
+        return true;
+    }
+
+    bool JsonReader::readUnsigned(uint64_t& value) {
+        if (peek() != Kind::Number) {
+            skipValue();
+            return false;
+        }
+        size_t start = pos;
+        if (!skipNumber() || text[start] == '-') return false;
+        uint64_t number = 0;
+        for (size_t i = start; i < pos; ++i) {
+            unsigned digit = static_cast<unsigned>(text[i] - '0');
+            if (number > (UINT64_MAX - digit) / 10) return false;
+            number = number * 10 + digit;
+        }
+        value = number;
+        return true;
+    }
+
+    void JsonReader::skipValue() {
+        switch (peek()) {
+            case Kind::String: {
+                std::string_view ignored;
+                parseString(ignored);
+                return;
+            }
+            case Kind::Number:
+                skipNumber();
+                return;
+            case Kind::Boolean:
+                expectLiteral(text[pos] == 't' ? "true" : "false");
+                return;
+            case Kind::Null:
+                expectLiteral("null");
+                return;
+            case Kind::Object:
+            case Kind::Array:
+                break;
+            case Kind::End:
+                fail("Unexpected end of document");
+                return;
+            default:
+                fail("Unexpected character");
+                return;
+        }
+
+        // A whole container: only brackets and strings matter, without recursion
+        size_t level = 0;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                std::string_view ignored;
+                if (!parseString(ignored)) return;
+                continue;
+            }
+            ++pos;
+            if (c == '{' || c == '[') {
+                ++level;
+            } else if (c == '}' || c == ']') {
+                if (--level == 0) return;
+            }
+        }
+        fail("Unexpected end of document");
+    }
+
+    bool JsonReader::finish() {
+        if (bFailed) return false;
+        return peek() == Kind::End || fail("Unexpected text after the document");
+    }
+
+} // namespace UFMTooling
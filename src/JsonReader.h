@@ -0,0 +1,71 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+// Internal helper: pull reader over JSON text held in memory (usually a mapped
+// file), used to load exports and cache files without building a DOM. Strings
+// without escapes are returned as views into the text; the caller walks the
+// document with beginObject()/nextKey() and beginArray()/nextElement(), reading or
+// skipping each value. The first syntax error stops the reader: every later call
+// returns false, and failed()/getErrorMessage() tell where it happened.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace UFMTooling {
+
+    class JsonReader {
+    public:
+        enum class Kind { Object, Array, String, Number, Boolean, Null, End, Invalid };
+
+        explicit JsonReader(std::string_view text);
+
+        // Kind of the next value, without consuming it (End after the document)
+        Kind peek();
+
+        // Enter an object: then call nextKey() until it returns false (the '}' is consumed
+        // then); each key must be followed by reading or skipping its value
+        bool beginObject();
+        bool nextKey(std::string_view& key);
+
+        // Enter an array: nextElement() is true while another value follows, and consumes
+        // the ']' when it returns false
+        bool beginArray();
+        bool nextElement();
+
+        // Read a value of the given kind. On another kind the value is skipped and false
+        // returned, so missing or mistyped fields read as defaults. A string view stays
+        // valid until the next read if the string had escapes, else as long as the text.
+        bool readString(std::string_view& value);
+        bool readBool(bool& value);
+        bool readInteger(long long& value);
+        bool readUnsigned(uint64_t& value);
+
+        // Skip the next value, nested or not
+        void skipValue();
+
+        // Check that nothing but whitespace follows the document (fails otherwise)
+        bool finish();
+
+        bool failed() const { return bFailed; }
+        const std::string& getErrorMessage() const { return errorMessage; }
+
+    private:
+        void skipWhitespace();
+        bool fail(const char* what);
+        bool parseString(std::string_view& value);
+        bool skipNumber();
+        bool expectLiteral(std::string_view literal);
+
+        std::string_view text;
+        size_t pos;
+        size_t depth;
+        bool bFirst;                // No element or key read yet in the innermost container
+        bool bFailed;
+        std::string scratch;        // Unescaped copy of the last string with escapes
+        std::string errorMessage;
+    };
+
+} // namespace UFMTooling
+
+#endif // JSON_READER_H
@@ -0,0 +1,308 @@
+#include "../include/JsonWriter.h"
+#include <charconv>
+#include <cmath>
+#include <vector>
+
+namespace UFMTooling {
+
+    namespace {
+        // Flush to the stream once this much output is buffered
+        const size_t FlushThreshold = 64 * 1024;
+
+        // Escape sequence for each byte: 0 = copy as is, 'u' = \u00XX, '8' = start of a
+        // UTF-8 sequence to validate, otherwise \<char>
+        struct EscapeTable {
+            char codes[256];
+
+            EscapeTable() {
+                for (int c = 0; c < 256; ++c) {
+                    codes[c] = c < 0x20 ? 'u' : (c >= 0x80 ? '8' : 0);
+                }
+                codes[static_cast<unsigned char>('"')] = '"';
+                codes[static_cast<unsigned char>('\\')] = '\\';
+                codes[static_cast<unsigned char>('\b')] = 'b';
+                codes[static_cast<unsigned char>('\f')] = 'f';
+                codes[static_cast<unsigned char>('\n')] = 'n';
+                codes[static_cast<unsigned char>('\r')] = 'r';
+                codes[static_cast<unsigned char>('\t')] = 't';
+            }
+        };
+
+        const EscapeTable escapeTable;
+
+        // Length of the well-formed UTF-8 sequence at str[i] (a byte >= 0x80), or 0. For 0,
+        // invalidLength is what one U+FFFD stands for: the bytes that could still have
+        // started a valid sequence, at least one (Unicode's "maximal subpart" practice)
+        size_t utf8Length(std::string_view str, size_t i, size_t& invalidLength) {
+            unsigned char lead = static_cast<unsigned char>(str[i]);
+            unsigned char low = 0x80;
+            unsigned char high = 0xBF;
+            size_t length;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                length = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                length = 3;
+                if (lead == 0xE0) low = 0xA0;           // Overlong
+                else if (lead == 0xED) high = 0x9F;     // Surrogates
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                length = 4;
+                if (lead == 0xF0) low = 0x90;           // Overlong
+                else if (lead == 0xF4) high = 0x8F;     // Past U+10FFFF
+            } else {
+                invalidLength = 1;
+                return 0;
+            }
+            for (size_t k = 1; k < length; ++k) {
+                unsigned char c = i + k < str.size() ? static_cast<unsigned char>(str[i + k]) : 0;
+                if (c < low || c > high) {
+                    invalidLength = k;
+                    return 0;
+                }
+                low = 0x80;
+                high = 0xBF;
+            }
+            return length;
+        }
+    }
+
+    class JsonWriter::Impl {
+    public:
+        std::ostream* stream;
+        std::string ownBuffer;
+        std::string& buffer;        // Stream mode: ownBuffer; string mode: the caller's string
+        bool pretty;
+        bool failed;
+        bool afterKey;              // A key was written and awaits its value
+
+        // One entry per open container: true while it has no children yet
+        std::vector<bool> firstChild;
+
+        Impl(std::ostream* out, std::string* target, bool bPretty)
+            : stream(out), buffer(target ? *target : ownBuffer), pretty(bPretty), failed(false), afterKey(false) {
+            if (stream) {
+                ownBuffer.reserve(FlushThreshold + 4096);
+            }
+        }
+
+        void newlineAndIndent(size_t depth) {
+            buffer.push_back('\n');
+            buffer.append(depth * 2, ' ');
+        }
+
+        // Separator and indentation before a value or key inside the current container
+        void beforeElement() {
+            if (afterKey) {
+                afterKey = false;
+                return;
+            }
+            if (firstChild.empty()) {
+                return;
+            }
+            if (!firstChild.back()) {
+                buffer.push_back(',');
+            }
+            firstChild.back() = false;
+            if (pretty) {
+                newlineAndIndent(firstChild.size());
+            }
+        }
+
+        void open(char bracket) {
+            beforeElement();
+            buffer.push_back(bracket);
+            firstChild.push_back(true);
+        }
+
+        void close(char bracket) {
+            bool empty = firstChild.empty() || firstChild.back();
+            if (!firstChild.empty()) {
+                firstChild.pop_back();
+            }
+            if (pretty && !empty) {
+                newlineAndIndent(firstChild.size());
+            }
+            buffer.push_back(bracket);
+            maybeFlush();
+        }
+
+        // Headers are not always UTF-8 (Latin-1 comments and literals end up in default
+        // values): each invalid sequence is written as \ufffd, so the output stays JSON
+        void writeString(std::string_view str) {
+            static const char hex[] = "0123456789abcdef";
+            buffer.push_back('"');
+            size_t runStart = 0;
+            for (size_t i = 0; i < str.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(str[i]);
+                char code = escapeTable.codes[c];
+                if (code == 0) continue;
+                if (code == '8') {
+                    size_t invalidLength = 0;
+                    size_t length = utf8Length(str, i, invalidLength);
+                    if (length != 0) {
+                        i += length - 1;
+                        continue;
+                    }
+                    buffer.append(str.data() + runStart, i - runStart);
+                    buffer.append("\\ufffd");
+                    i += invalidLength - 1;
+                    runStart = i + 1;
+                    continue;
+                }
+
+                buffer.append(str.data() + runStart, i - runStart);
+                buffer.push_back('\\');
+                if (code == 'u') {
+                    buffer.append("u00");
+                    buffer.push_back(hex[c >> 4]);
+                    buffer.push_back(hex[c & 0x0F]);
+                } else {
+                    buffer.push_back(code);
+                }
+                runStart = i + 1;
+            }
+            buffer.append(str.data() + runStart, str.size() - runStart);
+            buffer.push_back('"');
+        }
+
+        template <typename T>
+        void writeNumber(T number) {
+            char digits[32];
+            auto res = std::to_chars(digits, digits + sizeof(digits), number);
+            buffer.append(digits, static_cast<size_t>(res.ptr - digits));
+        }
+
+        // Shortest round-trip digits laid out like nlohmann: fixed notation for decimal
+        // exponents in (-4, 15], with ".0" on integral values, scientific otherwise
+        void writeDouble(double number) {
+            char sci[32];
+            auto res = std::to_chars(sci, sci + sizeof(sci), number, std::chars_format::scientific);
+            std::string_view text(sci, static_cast<size_t>(res.ptr - sci));
+
+            if (!text.empty() && text[0] == '-') {
+                buffer.push_back('-');
+                text.remove_prefix(1);
+            }
+            size_t ePos = text.find('e');
+            int exponent = 0;
+            std::from_chars(text.data() + ePos + (text[ePos + 1] == '+' ? 2 : 1), text.data() + text.size(), exponent);
+
+            std::string digits(1, text[0]);
+            if (ePos > 2) {
+                digits.append(text.substr(2, ePos - 2));
+            }
+            int k = static_cast<int>(digits.size());
+            int n = exponent + 1;
+
+            if (k <= n && n <= 15) {
+                buffer.append(digits).append(static_cast<size_t>(n - k), '0').append(".0");
+            } else if (0 < n && n <= 15) {
+                buffer.append(digits, 0, static_cast<size_t>(n)).append(".").append(digits, static_cast<size_t>(n));
+            } else if (-4 < n && n <= 0) {
+                buffer.append("0.").append(static_cast<size_t>(-n), '0').append(digits);
+            } else {
+                buffer.append(text);
+            }
+        }
+
+        void maybeFlush() {
+            if (stream && buffer.size() >= FlushThreshold) {
+                flush();
+            }
+        }
+
+        void flush() {
+            if (!stream || buffer.empty()) return;
+            stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            if (!*stream) {
+                failed = true;
+            }
+            buffer.clear();
+        }
+    };
+
+    // JsonWriter implementation
+    JsonWriter::JsonWriter(std::ostream& out, bool bPretty) : pImpl(new Impl(&out, nullptr, bPretty)) {}
+
+    JsonWriter::JsonWriter(std::string& out, bool bPretty) : pImpl(new Impl(nullptr, &out, bPretty)) {}
+
+    JsonWriter::~JsonWriter() {
+        pImpl->flush();
+    }
+
+    void JsonWriter::beginObject() {
+        pImpl->open('{');
+    }
+
+    void JsonWriter::endObject() {
+        pImpl->close('}');
+    }
+
+    void JsonWriter::beginArray() {
+        pImpl->open('[');
+    }
+
+    void JsonWriter::endArray() {
+        pImpl->close(']');
+    }
+
+    void JsonWriter::key(std::string_view name) {
+        pImpl->beforeElement();
+        pImpl->writeString(name);
+        pImpl->buffer.append(pImpl->pretty ? ": " : ":");
+        pImpl->afterKey = true;
+    }
+
+    void JsonWriter::value(std::string_view str) {
+        pImpl->beforeElement();
+        pImpl->writeString(str);
+    }
+
+    void JsonWriter::value(const char* str) {
+        value(std::string_view(str));
+    }
+
+    void JsonWriter::value(const std::string& str) {
+        value(std::string_view(str));
+    }
+
+    void JsonWriter::value(bool b) {
+        pImpl->beforeElement();
+        pImpl->buffer.append(b ? "true" : "false");
+    }
+
+    void JsonWriter::null() {
+        pImpl->beforeElement();
+        pImpl->buffer.append("null");
+    }
+
+    void JsonWriter::valueSigned(long long number) {
+        pImpl->beforeElement();
+        pImpl->writeNumber(number);
+    }
+
+    void JsonWriter::valueUnsigned(unsigned long long number) {
+        pImpl->beforeElement();
+        pImpl->writeNumber(number);
+    }
+
+    void JsonWriter::value(double number) {
+        if (!std::isfinite(number)) {
+            null();
+            return;
+        }
+        pImpl->beforeElement();
+        pImpl->writeDouble(number);
+    }
+
+    void JsonWriter::flush() {
+        pImpl->flush();
+        if (pImpl->stream) {
+            pImpl->stream->flush();
+        }
+    }
+
+    bool JsonWriter::good() const {
+        return !pImpl->failed && (!pImpl->stream || static_cast<bool>(*pImpl->stream));
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,80 @@
+#ifndef KEYWORD_TABLE_H
+#define KEYWORD_TABLE_H
+
+// Internal helper: fixed word -> value tables built at compile time. The table searches
+// for a multiplier that hashes every word of the set to its own slot (a perfect hash), so a
+// lookup costs one multiplication and at most one comparison, whatever the set size.
+// The hash only reads the length and the first, second and last characters; words
+// sharing all four cannot be told apart, and valid() is false for such a set.
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace UFMTooling {
+
+    template <typename Value>
+    struct KeywordEntry {
+        std::string_view text;
+        Value value{};
+    };
+
+    template <typename Value, size_t Count>
+    class KeywordTable {
+    public:
+        constexpr KeywordTable(const KeywordEntry<Value> (&entries)[Count], Value none)
+            : slots(), none(none), multiplier(0) {
+            for (uint32_t candidate = 1; candidate < 8192; candidate += 2) {
+                if (place(entries, candidate * 0x9E3779B1u)) {
+                    multiplier = candidate * 0x9E3779B1u;
+                    return;
+                }
+            }
+        }
+
+        // False if no perfect hash was found (check with static_assert)
+        constexpr bool valid() const { return multiplier != 0; }
+
+        // Value of word, or none
+        constexpr Value find(std::string_view word) const {
+            if (word.empty()) return none;
+            const KeywordEntry<Value>& slot = slots[slotOf(word, multiplier)];
+            return slot.text == word ? slot.value : none;
+        }
+
+    private:
+        static constexpr size_t Bits = Count <= 8 ? 4 : (Count <= 16 ? 5 : (Count <= 32 ? 6 : 7));
+        static constexpr size_t Size = size_t(1) << Bits;
+        static_assert(Count <= Size / 2, "KeywordTable holds up to 64 words");
+
+        KeywordEntry<Value> slots[Size];
+        Value none;
+        uint32_t multiplier;
+
+        static constexpr size_t slotOf(std::string_view word, uint32_t factor) {
+            uint32_t key = static_cast<uint32_t>(word.size()) |
+                           static_cast<uint32_t>(static_cast<unsigned char>(word[0])) << 8 |
+                           static_cast<uint32_t>(static_cast<unsigned char>(word[word.size() > 1 ? 1 : 0])) << 16 |
+                           static_cast<uint32_t>(static_cast<unsigned char>(word.back())) << 24;
+            return static_cast<uint32_t>(key * factor) >> (32 - Bits);
+        }
+
+        // Try one multiplier; on success the slots hold the entries
+        constexpr bool place(const KeywordEntry<Value> (&entries)[Count], uint32_t factor) {
+            for (auto& slot : slots) {
+                slot.text = std::string_view();
+                slot.value = none;
+            }
+            for (const auto& entry : entries) {
+                if (entry.text.empty()) return false;
+                auto& slot = slots[slotOf(entry.text, factor)];
+                if (!slot.text.empty()) return false;
+                slot = entry;
+            }
+            return true;
+        }
+    };
+
+} // namespace UFMTooling
+
+#endif // KEYWORD_TABLE_H
@@ -0,0 +1,591 @@
+#include "LocalSocket.h"
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <sddl.h>
+    #include <filesystem>
+    #include <vector>
+#else
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+    #include <string_view>
+#endif
+
+namespace UFMTooling {
+
+    namespace {
+        // Longest request or response line accepted
+        const size_t MaxLineLength = 1024 * 1024;
+    }
+
+#ifdef _WIN32
+
+    namespace {
+        std::wstring widen(const std::string& endpoint) {
+            return std::filesystem::u8path(endpoint).wstring();
+        }
+
+        // Wait for an overlapped operation; cancels it if cancelEvent is set first
+        bool waitForIo(HANDLE handle, OVERLAPPED& overlapped, HANDLE cancelEvent, DWORD& bytes) {
+            HANDLE handles[2] = { overlapped.hEvent, cancelEvent };
+            if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0) {
+                CancelIoEx(handle, &overlapped);
+                GetOverlappedResult(handle, &overlapped, &bytes, TRUE);
+                return false;
+            }
+            return GetOverlappedResult(handle, &overlapped, &bytes, FALSE) != 0;
+        }
+
+        // Security attributes that give the current user, and nobody else, access to a pipe
+        class OwnerOnlySecurity {
+        public:
+            SECURITY_ATTRIBUTES attributes;
+
+            OwnerOnlySecurity() : attributes(), descriptor(nullptr) {
+                HANDLE token = nullptr;
+                if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) return;
+                DWORD size = 0;
+                GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+                std::vector<BYTE> user(size);
+                LPWSTR sid = nullptr;
+                if (size > 0 && GetTokenInformation(token, TokenUser, user.data(), size, &size) &&
+                    ConvertSidToStringSidW(reinterpret_cast<TOKEN_USER*>(user.data())->User.Sid, &sid)) {
+                    // Protected DACL with a single entry: full access for the user
+                    std::wstring sddl = L"D:P(A;;GA;;;" + std::wstring(sid) + L")";
+                    LocalFree(sid);
+                    ConvertStringSecurityDescriptorToSecurityDescriptorW(sddl.c_str(), SDDL_REVISION_1, &descriptor,
+                                                                         nullptr);
+                }
+                CloseHandle(token);
+                attributes.nLength = sizeof(attributes);
+                attributes.lpSecurityDescriptor = descriptor;
+                attributes.bInheritHandle = FALSE;
+            }
+
+            ~OwnerOnlySecurity() {
+                if (descriptor) LocalFree(descriptor);
+            }
+
+            bool isValid() const { return descriptor != nullptr; }
+
+        private:
+            OwnerOnlySecurity(const OwnerOnlySecurity&) = delete;
+            OwnerOnlySecurity& operator=(const OwnerOnlySecurity&) = delete;
+
+            PSECURITY_DESCRIPTOR descriptor;
+        };
+    }
+
+    class LocalConnection::Impl {
+    public:
+        HANDLE handle;
+        HANDLE ioEvent;
+        HANDLE cancelEvent;
+        bool bServerSide;           // Pipe instance created by a LocalListener
+        std::string pending;        // Read but not yet returned
+
+        Impl() : handle(INVALID_HANDLE_VALUE), ioEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)),
+                 cancelEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)), bServerSide(false) {}
+
+        ~Impl() {
+            close();
+            if (ioEvent) CloseHandle(ioEvent);
+            if (cancelEvent) CloseHandle(cancelEvent);
+        }
+
+        void adopt(HANDLE pipe) {
+            close();
+            handle = pipe;
+            bServerSide = true;
+        }
+
+        bool connect(const std::string& endpoint) {
+            close();
+            std::wstring name = widen(endpoint);
+            for (int attempt = 0; attempt < 2; ++attempt) {
+                handle = CreateFileW(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                                     FILE_FLAG_OVERLAPPED, nullptr);
+                if (handle != INVALID_HANDLE_VALUE) return true;
+                if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeW(name.c_str(), 2000)) break;
+            }
+            return false;
+        }
+
+        long readSome(char* data, size_t size) {
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = ioEvent;
+            ResetEvent(ioEvent);
+            if (!ReadFile(handle, data, static_cast<DWORD>(size), nullptr, &overlapped)) {
+                DWORD error = GetLastError();
+                if (error == ERROR_BROKEN_PIPE) return 0;
+                if (error != ERROR_IO_PENDING) return -1;
+            }
+            DWORD bytes = 0;
+            if (!waitForIo(handle, overlapped, cancelEvent, bytes)) {
+                return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+            }
+            return static_cast<long>(bytes);
+        }
+
+        bool writeAll(std::string_view data) {
+            while (!data.empty()) {
+                OVERLAPPED overlapped = {};
+                overlapped.hEvent = ioEvent;
+                ResetEvent(ioEvent);
+                DWORD size = static_cast<DWORD>(std::min<size_t>(data.size(), 1 << 20));
+                if (!WriteFile(handle, data.data(), size, nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING) {
+                    return false;
+                }
+                DWORD bytes = 0;
+                if (!waitForIo(handle, overlapped, cancelEvent, bytes) || bytes == 0) return false;
+                data.remove_prefix(bytes);
+            }
+            return true;
+        }
+
+        void shutdown() {
+            SetEvent(cancelEvent);
+        }
+
+        void close() {
+            if (handle != INVALID_HANDLE_VALUE) {
+                if (bServerSide) {
+                    DisconnectNamedPipe(handle);
+                }
+                CloseHandle(handle);
+                handle = INVALID_HANDLE_VALUE;
+            }
+            bServerSide = false;
+            pending.clear();
+            ResetEvent(cancelEvent);
+        }
+
+        bool isOpen() const { return handle != INVALID_HANDLE_VALUE; }
+    };
+
+    class LocalListener::Impl {
+    public:
+        std::wstring name;
+        OwnerOnlySecurity security;
+        HANDLE nextPipe;            // Instance waiting for the next client
+        HANDLE connectEvent;
+        HANDLE wakeEvent;
+        std::atomic<bool> interrupted;
+
+        Impl() : nextPipe(INVALID_HANDLE_VALUE), connectEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)),
+                 wakeEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)), interrupted(false) {}
+
+        ~Impl() {
+            close();
+            if (connectEvent) CloseHandle(connectEvent);
+            if (wakeEvent) CloseHandle(wakeEvent);
+        }
+
+        HANDLE createInstance(bool bFirst) {
+            DWORD mode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT;
+#ifdef PIPE_REJECT_REMOTE_CLIENTS
+            mode |= PIPE_REJECT_REMOTE_CLIENTS;
+#endif
+            DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (bFirst ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+            return CreateNamedPipeW(name.c_str(), openMode, mode, PIPE_UNLIMITED_INSTANCES, 64 * 1024, 64 * 1024, 0,
+                                    &security.attributes);
+        }
+
+        bool listen(const std::string& endpoint, std::string& errorMessage) {
+            close();
+            if (!security.isValid()) {
+                errorMessage = "Could not build the access rights of pipe " + endpoint;
+                return false;
+            }
+            name = widen(endpoint);
+            nextPipe = createInstance(true);
+            if (nextPipe == INVALID_HANDLE_VALUE) {
+                errorMessage = GetLastError() == ERROR_ACCESS_DENIED ? "Endpoint already in use: " + endpoint
+                                                                      : "Could not create pipe: " + endpoint;
+                return false;
+            }
+            return true;
+        }
+
+        // The connected pipe instance, or INVALID_HANDLE_VALUE
+        HANDLE accept() {
+            while (!interrupted) {
+                if (nextPipe == INVALID_HANDLE_VALUE && (nextPipe = createInstance(false)) == INVALID_HANDLE_VALUE) {
+                    return INVALID_HANDLE_VALUE;
+                }
+
+                OVERLAPPED overlapped = {};
+                overlapped.hEvent = connectEvent;
+                ResetEvent(connectEvent);
+                bool bConnected = ConnectNamedPipe(nextPipe, &overlapped) != 0;
+                if (!bConnected) {
+                    DWORD error = GetLastError();
+                    if (error == ERROR_PIPE_CONNECTED) {
+                        bConnected = true;
+                    } else if (error == ERROR_IO_PENDING) {
+                        DWORD bytes = 0;
+                        bConnected = waitForIo(nextPipe, overlapped, wakeEvent, bytes);
+                    }
+                }
+                if (interrupted) return INVALID_HANDLE_VALUE;
+                if (bConnected) {
+                    HANDLE pipe = nextPipe;
+                    nextPipe = INVALID_HANDLE_VALUE;
+                    return pipe;
+                }
+
+                // The client went away before it was connected; offer a fresh instance
+                CloseHandle(nextPipe);
+                nextPipe = INVALID_HANDLE_VALUE;
+            }
+            return INVALID_HANDLE_VALUE;
+        }
+
+        void interrupt() {
+            interrupted = true;
+            SetEvent(wakeEvent);
+        }
+
+        void close() {
+            if (nextPipe != INVALID_HANDLE_VALUE) {
+                CloseHandle(nextPipe);
+                nextPipe = INVALID_HANDLE_VALUE;
+            }
+        }
+    };
+
+#else
+
+    namespace {
+        void setCloseOnExec(int fd) {
+            fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+        }
+
+        // A write to a closed peer must fail with EPIPE, not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+        const int SendFlags = MSG_NOSIGNAL;
+        void disableSigPipe(int) {}
+#else
+        const int SendFlags = 0;
+        void disableSigPipe(int fd) {
+    #ifdef SO_NOSIGPIPE
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    #endif
+        }
+#endif
+
+        bool fillAddress(const std::string& endpoint, sockaddr_un& address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (endpoint.empty() || endpoint.size() >= sizeof(address.sun_path)) return false;
+            std::memcpy(address.sun_path, endpoint.c_str(), endpoint.size() + 1);
+            return true;
+        }
+
+        // The directory of a socket must belong to the user and be writable by nobody else,
+        // so no other user can replace the socket file. A missing directory is created
+        // private (0700), e.g. the per-user directory of SourceServer::defaultEndpoint().
+        bool checkSocketDirectory(const std::string& endpoint, std::string& errorMessage) {
+            std::string_view path(endpoint);
+            size_t slash = path.find_last_of('/');
+            std::string directory = slash == std::string_view::npos ? std::string(".")
+                                  : slash == 0                       ? std::string("/")
+                                                                     : std::string(path.substr(0, slash));
+            if (::mkdir(directory.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+                errorMessage = "Could not create socket directory " + directory + ": " + std::strerror(errno);
+                return false;
+            }
+            struct stat info;
+            if (::lstat(directory.c_str(), &info) != 0) {
+                errorMessage = "Could not check socket directory " + directory + ": " + std::strerror(errno);
+                return false;
+            }
+            if (!S_ISDIR(info.st_mode) || info.st_uid != ::geteuid() || (info.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+                errorMessage = "Socket directory is not private to the user: " + directory;
+                return false;
+            }
+            return true;
+        }
+
+        int openSocket() {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0) {
+                setCloseOnExec(fd);
+                disableSigPipe(fd);
+            }
+            return fd;
+        }
+    }
+
+    class LocalConnection::Impl {
+    public:
+        int fd;
+        std::string pending;        // Read but not yet returned
+
+        Impl() : fd(-1) {}
+
+        ~Impl() {
+            close();
+        }
+
+        void adopt(int socket) {
+            close();
+            fd = socket;
+        }
+
+        bool connect(const std::string& endpoint) {
+            close();
+            sockaddr_un address;
+            if (!fillAddress(endpoint, address) || (fd = openSocket()) < 0) return false;
+            if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        long readSome(char* data, size_t size) {
+            for (;;) {
+                ssize_t bytes = ::recv(fd, data, size, 0);
+                if (bytes < 0 && errno == EINTR) continue;
+                return static_cast<long>(bytes);
+            }
+        }
+
+        bool writeAll(std::string_view data) {
+            while (!data.empty()) {
+                ssize_t bytes = ::send(fd, data.data(), data.size(), SendFlags);
+                if (bytes < 0 && errno == EINTR) continue;
+                if (bytes <= 0) return false;
+                data.remove_prefix(static_cast<size_t>(bytes));
+            }
+            return true;
+        }
+
+        void shutdown() {
+            if (fd >= 0) ::shutdown(fd, SHUT_RDWR);
+        }
+
+        void close() {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+            pending.clear();
+        }
+
+        bool isOpen() const { return fd >= 0; }
+    };
+
+    class LocalListener::Impl {
+    public:
+        int fd;
+        int wake[2];                // Self-pipe that interrupts accept()
+        std::string path;           // Socket file we created
+        std::atomic<bool> interrupted;
+
+        Impl() : fd(-1), wake{ -1, -1 }, interrupted(false) {}
+
+        ~Impl() {
+            close();
+        }
+
+        bool listen(const std::string& endpoint, std::string& errorMessage) {
+            close();
+            sockaddr_un address;
+            if (!fillAddress(endpoint, address)) {
+                errorMessage = "Invalid endpoint path (empty or too long): " + endpoint;
+                return false;
+            }
+            if (!checkSocketDirectory(endpoint, errorMessage)) {
+                return false;
+            }
+
+            // Replace a socket file only if nobody answers on it
+            struct stat info;
+            if (::lstat(endpoint.c_str(), &info) == 0) {
+                if (!S_ISSOCK(info.st_mode)) {
+                    errorMessage = "Endpoint exists and is not a socket: " + endpoint;
+                    return false;
+                }
+                LocalConnection probe;
+                if (probe.connect(endpoint)) {
+                    errorMessage = "Endpoint already in use: " + endpoint;
+                    return false;
+                }
+                ::unlink(endpoint.c_str());
+            }
+
+            // Nobody can connect before listen(), so restricting the socket file after bind()
+            // leaves no window, whatever the umask of the process
+            fd = openSocket();
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                errorMessage = "Could not bind " + endpoint + ": " + std::strerror(errno);
+                close();
+                return false;
+            }
+            path = endpoint;
+            if (::chmod(endpoint.c_str(), S_IRUSR | S_IWUSR) != 0) {   // Only the owner may connect
+                errorMessage = "Could not restrict access to " + endpoint + ": " + std::strerror(errno);
+                close();
+                return false;
+            }
+
+            if (::listen(fd, SOMAXCONN) != 0 || ::pipe(wake) != 0) {
+                errorMessage = "Could not listen on " + endpoint + ": " + std::strerror(errno);
+                close();
+                return false;
+            }
+            setCloseOnExec(wake[0]);
+            setCloseOnExec(wake[1]);
+            interrupted = false;
+            return true;
+        }
+
+        // The connected socket, or -1
+        int accept() {
+            while (!interrupted && fd >= 0) {
+                pollfd fds[2] = { { fd, POLLIN, 0 }, { wake[0], POLLIN, 0 } };
+                if (::poll(fds, 2, -1) < 0 && errno != EINTR) return -1;
+                if (interrupted) return -1;
+                if (!(fds[0].revents & POLLIN)) continue;
+
+                int client = ::accept(fd, nullptr, nullptr);
+                if (client < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN) continue;
+                    return -1;
+                }
+                setCloseOnExec(client);
+                disableSigPipe(client);
+                return client;
+            }
+            return -1;
+        }
+
+        void interrupt() {
+            interrupted = true;
+            if (wake[1] >= 0 && ::write(wake[1], "x", 1) < 0) {
+                // Pipe full: accept() is woken already
+            }
+        }
+
+        void close() {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+            for (int& end : wake) {
+                if (end >= 0) {
+                    ::close(end);
+                    end = -1;
+                }
+            }
+            if (!path.empty()) {
+                ::unlink(path.c_str());
+                path.clear();
+            }
+        }
+    };
+
+#endif
+
+    // LocalConnection implementation
+    LocalConnection::LocalConnection() : pImpl(new Impl()) {}
+
+    LocalConnection::~LocalConnection() = default;
+
+    bool LocalConnection::connect(const std::string& endpoint) {
+        return pImpl->connect(endpoint);
+    }
+
+    bool LocalConnection::readLine(std::string& line) {
+        std::string& pending = pImpl->pending;
+        size_t searchFrom = 0;
+        for (;;) {
+            size_t newline = pending.find('\n', searchFrom);
+            if (newline != std::string::npos) {
+                line.assign(pending, 0, newline);
+                pending.erase(0, newline + 1);
+                break;
+            }
+            if (pending.size() > MaxLineLength || !pImpl->isOpen()) return false;
+            searchFrom = pending.size();
+
+            char chunk[4096];
+            long bytes = pImpl->readSome(chunk, sizeof(chunk));
+            if (bytes <= 0) {
+                // A last line without '\n' still counts
+                if (bytes < 0 || pending.empty()) return false;
+                line.swap(pending);
+                pending.clear();
+                break;
+            }
+            pending.append(chunk, static_cast<size_t>(bytes));
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    bool LocalConnection::write(std::string_view data) {
+        return pImpl->isOpen() && pImpl->writeAll(data);
+    }
+
+    void LocalConnection::shutdown() {
+        pImpl->shutdown();
+    }
+
+    void LocalConnection::close() {
+        pImpl->close();
+    }
+
+    bool LocalConnection::isOpen() const {
+        return pImpl->isOpen();
+    }
+
+    // LocalListener implementation
+    LocalListener::LocalListener() : pImpl(new Impl()) {}
+
+    LocalListener::~LocalListener() = default;
+
+    bool LocalListener::listen(const std::string& endpoint, std::string& errorMessage) {
+        return pImpl->listen(endpoint, errorMessage);
+    }
+
+    bool LocalListener::accept(LocalConnection& connection) {
+#ifdef _WIN32
+        HANDLE client = pImpl->accept();
+        if (client == INVALID_HANDLE_VALUE) return false;
+#else
+        int client = pImpl->accept();
+        if (client < 0) return false;
+#endif
+        connection.pImpl->adopt(client);
+        return true;
+    }
+
+    void LocalListener::interrupt() {
+        pImpl->interrupt();
+    }
+
+    void LocalListener::close() {
+        pImpl->close();
+    }
+
+} // namespace UFMTooling
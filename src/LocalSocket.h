@@ -0,0 +1,73 @@
+#ifndef LOCAL_SOCKET_H
+#define LOCAL_SOCKET_H
+
+// Internal helper: the local stream endpoint SourceServer listens on. A Unix domain
+// socket at a filesystem path on POSIX systems, a named pipe (\\.\pipe\name) on
+// Windows. Both carry newline-terminated messages.
+
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace UFMTooling {
+
+    class LocalConnection {
+    public:
+        LocalConnection();
+        ~LocalConnection();
+
+        // Connect to a listening endpoint
+        bool connect(const std::string& endpoint);
+
+        // Next line, without the '\n' (and a trailing '\r'); false at the end of the
+        // stream, on an error, after shutdown(), or for lines over 1 MiB
+        bool readLine(std::string& line);
+
+        // Write all of data
+        bool write(std::string_view data);
+
+        // Make a readLine() blocked in another thread return false; the connection
+        // cannot be used afterwards
+        void shutdown();
+
+        void close();
+        bool isOpen() const;
+
+    private:
+        friend class LocalListener;
+        LocalConnection(const LocalConnection&) = delete;
+        LocalConnection& operator=(const LocalConnection&) = delete;
+
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+    class LocalListener {
+    public:
+        LocalListener();
+        ~LocalListener();
+
+        // Start listening. Fails if another process is already listening on the
+        // endpoint; a stale socket file left by a crashed server is replaced.
+        bool listen(const std::string& endpoint, std::string& errorMessage);
+
+        // Wait for the next client; false after interrupt() or on an error
+        bool accept(LocalConnection& connection);
+
+        // Make accept() return false, now and in later calls
+        void interrupt();
+
+        // Stop listening and remove the socket file
+        void close();
+
+    private:
+        LocalListener(const LocalListener&) = delete;
+        LocalListener& operator=(const LocalListener&) = delete;
+
+        class Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+} // namespace UFMTooling
+
+#endif // LOCAL_SOCKET_H
@@ -0,0 +1,230 @@
+#include "../include/MappedFile.h"
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <filesystem>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <cstring>
+    #include <cerrno>
+#endif
+
+namespace UFMTooling {
+
+    class MappedFile::Impl {
+    public:
+        const char* data;
+        size_t size;
+        bool open;
+        bool mapped;
+        std::string fallback;       // Owned copy when mapping is not possible
+        std::string errorMessage;
+
+        Impl() : data(nullptr), size(0), open(false), mapped(false) {}
+
+        ~Impl() {
+            release();
+        }
+
+        bool openFile(const std::string& filePath, bool bCopy) {
+            release();
+
+            if (!bCopy && mapFile(filePath)) {
+                open = true;
+                return true;
+            }
+
+            // Pipes, special files or exotic filesystems: read the contents instead
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file.is_open()) {
+                errorMessage = "Could not open file: " + filePath;
+                return false;
+            }
+
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            fallback = buffer.str();
+            data = fallback.data();
+            size = fallback.size();
+            open = true;
+            errorMessage.clear();
+            return true;
+        }
+
+        void release() {
+            if (mapped && data != nullptr) {
+                unmap();
+            }
+            data = nullptr;
+            size = 0;
+            open = false;
+            mapped = false;
+            fallback.clear();
+            fallback.shrink_to_fit();
+        }
+
+    private:
+#ifdef _WIN32
+        bool mapFile(const std::string& filePath) {
+            std::wstring widePath = std::filesystem::u8path(filePath).wstring();
+            HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                errorMessage = "Could not open file: " + filePath;
+                return false;
+            }
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize)) {
+                CloseHandle(file);
+                errorMessage = "Could not get size of file: " + filePath;
+                return false;
+            }
+
+            if (fileSize.QuadPart == 0) {
+                // Zero-length files cannot be mapped; let the caller read them instead
+                CloseHandle(file);
+                return false;
+            }
+
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (mapping == nullptr) {
+                errorMessage = "Could not map file: " + filePath;
+                return false;
+            }
+
+            void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);   // The view keeps the mapping alive
+            if (view == nullptr) {
+                errorMessage = "Could not map file: " + filePath;
+                return false;
+            }
+
+            data = static_cast<const char*>(view);
+            size = static_cast<size_t>(fileSize.QuadPart);
+            mapped = true;
+            return true;
+        }
+
+        void unmap() {
+            UnmapViewOfFile(data);
+        }
+#else
+        bool mapFile(const std::string& filePath) {
+            int fd = ::open(filePath.c_str(), O_RDONLY);
+            if (fd < 0) {
+                errorMessage = "Could not open file: " + filePath + " (" + std::strerror(errno) + ")";
+                return false;
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                ::close(fd);
+                errorMessage = "Not a regular file: " + filePath;
+                return false;
+            }
+
+            if (st.st_size == 0) {
+                // Zero-length (or size-less, e.g. /proc) files cannot be mapped; let the caller read them instead
+                ::close(fd);
+                return false;
+            }
+
+            void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);    // The mapping stays valid after the descriptor is closed
+            if (view == MAP_FAILED) {
+                errorMessage = "Could not map file: " + filePath + " (" + std::strerror(errno) + ")";
+                return false;
+            }
+
+            madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char*>(view);
+            size = static_cast<size_t>(st.st_size);
+            mapped = true;
+            return true;
+        }
+
+        void unmap() {
+            munmap(const_cast<char*>(data), size);
+        }
+#endif
+    };
+
+    // MappedFile implementation
+    MappedFile::MappedFile() : pImpl(new Impl()) {}
+
+    MappedFile::~MappedFile() = default;
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept = default;
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept = default;
+
+    bool MappedFile::open(const std::string& filePath, bool bCopy) {
+        if (!pImpl) {
+            pImpl.reset(new Impl());    // Reopening a moved-from instance
+        }
+        return pImpl->openFile(filePath, bCopy);
+    }
+
+    void MappedFile::close() {
+        if (pImpl) {
+            pImpl->release();
+        }
+    }
+
+    bool MappedFile::isOpen() const {
+        return pImpl && pImpl->open;
+    }
+
+    bool MappedFile::isMapped() const {
+        return pImpl && pImpl->mapped;
+    }
+
+    std::string_view MappedFile::view() const {
+        if (!isOpen()) return std::string_view();
+        return std::string_view(pImpl->data, pImpl->size);
+    }
+
+    const char* MappedFile::data() const {
+        return isOpen() ? pImpl->data : nullptr;
+    }
+
+    size_t MappedFile::size() const {
+        return isOpen() ? pImpl->size : 0;
+    }
+
+    void MappedFile::prefetch() const {
+        if (!isMapped()) {
+            return;
+        }
+#ifndef _WIN32
+        madvise(const_cast<char*>(pImpl->data), pImpl->size, MADV_WILLNEED);
+#endif
+        // Read one byte per page: the page faults, and the I/O behind them, happen here
+        const size_t pageSize = 4096;
+        unsigned char sum = 0;
+        for (size_t offset = 0; offset < pImpl->size; offset += pageSize) {
+            sum ^= static_cast<unsigned char>(pImpl->data[offset]);
+        }
+        volatile unsigned char sink = sum;
+        (void)sink;
+    }
+
+    const std::string& MappedFile::getErrorMessage() const {
+        static const std::string empty;
+        return pImpl ? pImpl->errorMessage : empty;
+    }
+
+} // namespace UFMTooling
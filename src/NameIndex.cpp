@@ -0,0 +1,93 @@
+#include "NameIndex.h"
+
+namespace UFMTooling {
+
+    namespace {
+        const size_t MinimumSlots = 16;
+    }
+
+    NameIndex::NameIndex() : count(0) {}
+
+    void NameIndex::clear() {
+        slots.clear();
+        count = 0;
+        ownedKeys.clear();
+    }
+
+    void NameIndex::reserve(size_t keyCount) {
+        size_t slotCount = MinimumSlots;
+        while (slotCount < keyCount * 2) {
+            slotCount *= 2;
+        }
+        if (slotCount > slots.size()) {
+            rehash(slotCount);
+        }
+    }
+
+    // FNV-1a
+    uint64_t NameIndex::hashKey(std::string_view key) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    void NameIndex::rehash(size_t slotCount) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(slotCount);
+        size_t mask = slotCount - 1;
+        for (const Slot& slot : old) {
+            if (!slot.used) continue;
+            size_t i = static_cast<size_t>(slot.hash) & mask;
+            while (slots[i].used) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+
+    void NameIndex::insert(std::string_view key, size_t position) {
+        if (key.empty()) return;
+        if ((count + 1) * 2 > slots.size()) {
+            rehash(slots.empty() ? MinimumSlots : slots.size() * 2);
+        }
+
+        uint64_t hash = hashKey(key);
+        size_t mask = slots.size() - 1;
+        size_t i = static_cast<size_t>(hash) & mask;
+        for (; slots[i].used; i = (i + 1) & mask) {
+            if (slots[i].hash == hash && slots[i].key == key) {
+                return;
+            }
+        }
+
+        slots[i].hash = hash;
+        slots[i].key = key;
+        slots[i].position = static_cast<uint32_t>(position);
+        slots[i].used = true;
+        count++;
+    }
+
+    void NameIndex::insertCopy(std::string key, size_t position) {
+        if (key.empty() || find(key) != npos) return;
+        ownedKeys.push_back(std::move(key));
+        insert(ownedKeys.back(), position);
+    }
+
+    size_t NameIndex::find(std::string_view key) const {
+        if (slots.empty() || key.empty()) return npos;
+
+        uint64_t hash = hashKey(key);
+        size_t mask = slots.size() - 1;
+        for (size_t i = static_cast<size_t>(hash) & mask; slots[i].used; i = (i + 1) & mask) {
+            if (slots[i].hash == hash && slots[i].key == key) {
+                return slots[i].position;
+            }
+        }
+        return npos;
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,58 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+// Internal helper: hash index from names to positions in a parser's result vector,
+// used by findClass()/findEntity(). Open addressing with linear probing.
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace UFMTooling {
+
+    class NameIndex {
+    public:
+        static const size_t npos = static_cast<size_t>(-1);
+
+        NameIndex();
+
+        void clear();
+
+        // Make room for keyCount keys without rehashing
+        void reserve(size_t keyCount);
+
+        // Map key to position unless the key is already present (the first insert wins).
+        // The key is not copied and must stay valid until clear(); empty keys are ignored.
+        void insert(std::string_view key, size_t position);
+
+        // Same, for a key built on the fly (a qualified name): the index keeps a copy
+        void insertCopy(std::string key, size_t position);
+
+        // Position stored for key, or npos
+        size_t find(std::string_view key) const;
+
+        size_t size() const { return count; }
+
+    private:
+        struct Slot {
+            uint64_t hash;
+            std::string_view key;
+            uint32_t position;
+            bool used;
+
+            Slot() : hash(0), position(0), used(false) {}
+        };
+
+        std::vector<Slot> slots;        // Power-of-two size, at most half full
+        size_t count;
+        std::deque<std::string> ownedKeys;
+
+        static uint64_t hashKey(std::string_view key);
+        void rehash(size_t slotCount);
+    };
+
+} // namespace UFMTooling
+
+#endif // NAME_INDEX_H
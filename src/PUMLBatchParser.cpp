@@ -0,0 +1,327 @@
+#include "../include/PUMLBatchParser.h"
+#include "../include/MappedFile.h"
+#include "WorkerThreads.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+
+namespace UFMTooling {
+
+    namespace {
+        std::string_view trimView(std::string_view str) {
+            size_t first = str.find_first_not_of(" \t\n\r");
+            if (first == std::string_view::npos) return std::string_view();
+            size_t last = str.find_last_not_of(" \t\n\r");
+            return str.substr(first, last - first + 1);
+        }
+
+        // First word of a line, up to a blank or an opening brace
+        std::string_view firstWord(std::string_view line) {
+            return line.substr(0, line.find_first_of(" \t{"));
+        }
+
+        // True if the line has a crow's foot end next to a -- or .. shaft (||--o{, }o..|| ...)
+        bool hasCrowsFoot(std::string_view line) {
+            static const std::string_view shafts[] = { "--", ".." };
+            static const std::string_view leftEnds[] = { "|o", "||", "}o", "}|" };
+            static const std::string_view rightEnds[] = { "o|", "||", "o{", "|{" };
+            for (std::string_view shaft : shafts) {
+                for (size_t pos = line.find(shaft); pos != std::string_view::npos; pos = line.find(shaft, pos + 1)) {
+                    for (std::string_view end : leftEnds) {
+                        if (pos >= end.size() && line.substr(pos - end.size(), end.size()) == end) return true;
+                    }
+                    for (std::string_view end : rightEnds) {
+                        if (line.substr(pos + shaft.size(), end.size()) == end) return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        bool hasUMLArrow(std::string_view line) {
+            static const std::string_view arrows[] = { "<|", "|>", "-->", "<--", "..>", "<..", "*--", "--*", "o--", "--o" };
+            for (std::string_view arrow : arrows) {
+                if (line.find(arrow) != std::string_view::npos) return true;
+            }
+            return false;
+        }
+
+        // Parse one file into its analysis slot; each worker passes its own parsers
+        void analyzeFile(const std::string& filePath, bool bCopy, PUMLClassParser& classParser,
+                         PUMLEntityParser& entityParser, PUMLFileAnalysis& analysis) {
+            analysis.path = filePath;
+            size_t slash = filePath.find_last_of("/\\");
+            analysis.filename = slash == std::string::npos ? filePath : filePath.substr(slash + 1);
+
+            try {
+                MappedFile file;
+                if (!file.open(filePath, bCopy)) {
+                    analysis.errorMessage = "Could not open file: " + filePath;
+                    return;
+                }
+
+                analysis.type = PUMLBatchParser::detectDiagramType(file.view());
+                switch (analysis.type) {
+                    case PUMLDiagramType::Class:
+                        analysis.classDiagram = classParser.parseContent(file.view());
+                        analysis.warnings = classParser.getWarnings();
+                        analysis.success = analysis.classDiagram.success;
+                        analysis.errorMessage = analysis.classDiagram.errorMessage;
+                        break;
+                    case PUMLDiagramType::Entity:
+                        analysis.entityDiagram = entityParser.parseContent(file.view());
+                        analysis.warnings = entityParser.getWarnings();
+                        analysis.success = analysis.entityDiagram.success;
+                        analysis.errorMessage = analysis.entityDiagram.errorMessage;
+                        break;
+                    case PUMLDiagramType::Unknown:
+                        analysis.errorMessage = "Not a class or entity diagram: " + filePath;
+                        break;
+                }
+            } catch (const std::exception& e) {
+                analysis.success = false;
+                analysis.errorMessage = std::string("Parsing error: ") + e.what();
+            }
+        }
+
+        // Add the members of source missing from target (same name; methods also same arity)
+        void mergeClass(UMLClass& target, const UMLClass& source) {
+            for (const auto& attribute : source.attributes) {
+                auto same = [&attribute](const UMLAttribute& a) { return a.name == attribute.name; };
+                if (std::none_of(target.attributes.begin(), target.attributes.end(), same)) {
+                    target.attributes.push_back(attribute);
+                }
+            }
+            for (const auto& method : source.methods) {
+                auto same = [&method](const UMLMethod& m) {
+                    return m.name == method.name && m.parameters.size() == method.parameters.size();
+                };
+                if (std::none_of(target.methods.begin(), target.methods.end(), same)) {
+                    target.methods.push_back(method);
+                }
+            }
+            if (target.stereotype.empty()) target.stereotype = source.stereotype;
+            if (target.package.empty()) target.package = source.package;
+            if (target.note.empty()) target.note = source.note;
+            target.isAbstract = target.isAbstract || source.isAbstract;
+            target.isInterface = target.isInterface || source.isInterface;
+        }
+
+        void mergeEntity(Entity& target, const Entity& source) {
+            for (const auto& field : source.fields) {
+                auto same = [&field](const EntityField& f) { return f.name == field.name; };
+                if (std::none_of(target.fields.begin(), target.fields.end(), same)) {
+                    target.fields.push_back(field);
+                }
+            }
+            if (target.alias.empty()) target.alias = source.alias;
+            if (target.schema.empty()) target.schema = source.schema;
+            if (target.comment.empty()) target.comment = source.comment;
+            if (target.stereotype.empty()) target.stereotype = source.stereotype;
+        }
+    }
+
+    class PUMLBatchParser::Impl {
+    public:
+        PUMLBatchResult lastResult;
+        FileSystemExplorer fsExplorer;
+
+        // Results are built in place in lastResult, which the public calls hand out by reference
+        const PUMLBatchResult& parseAll(const std::vector<std::string>& filePaths, const PUMLBatchOptions& options) {
+            PUMLBatchResult& result = lastResult;
+            result.analyses.clear();
+            result.analyses.resize(filePaths.size());
+
+            unsigned int threadCount = resolveThreadCount(options.threadCount, filePaths.size());
+            if (threadCount <= 1) {
+                PUMLClassParser classParser;
+                PUMLEntityParser entityParser;
+                for (size_t i = 0; i < filePaths.size(); ++i) {
+                    analyzeFile(filePaths[i], options.bCopyFiles, classParser, entityParser, result.analyses[i]);
+                }
+            } else {
+                // Workers claim the next file from a shared counter; every slot is written by
+                // exactly one worker, so the results need no locking
+                std::atomic<size_t> nextIndex(0);
+                std::vector<std::thread> workers;
+                workers.reserve(threadCount);
+                for (unsigned int t = 0; t < threadCount; ++t) {
+                    workers.emplace_back([&]() {
+                        PUMLClassParser classParser;
+                        PUMLEntityParser entityParser;
+                        for (size_t i = nextIndex++; i < filePaths.size(); i = nextIndex++) {
+                            analyzeFile(filePaths[i], options.bCopyFiles, classParser, entityParser, result.analyses[i]);
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+            }
+
+            for (const auto& analysis : result.analyses) {
+                result.filesProcessed++;
+                if (!analysis.success) result.filesWithErrors++;
+                if (analysis.type == PUMLDiagramType::Class) result.classDiagrams++;
+                if (analysis.type == PUMLDiagramType::Entity) result.entityDiagrams++;
+            }
+
+            if (options.bMerge) {
+                std::vector<const PUMLClassDiagramResult*> classDiagrams;
+                std::vector<const PUMLEntityDiagramResult*> entityDiagrams;
+                for (const auto& analysis : result.analyses) {
+                    if (!analysis.success) continue;
+                    if (analysis.type == PUMLDiagramType::Class) classDiagrams.push_back(&analysis.classDiagram);
+                    if (analysis.type == PUMLDiagramType::Entity) entityDiagrams.push_back(&analysis.entityDiagram);
+                }
+                result.classModel = mergeClassDiagrams(classDiagrams);
+                result.entityModel = mergeEntityDiagrams(entityDiagrams);
+            }
+
+            result.success = true;
+            return result;
+        }
+
+        const PUMLBatchResult& explore(const std::string& basePath, const PUMLBatchOptions& options) {
+            lastResult = PUMLBatchResult();
+
+            FileSystemExplorerOptions walk = options.walk;
+            walk.bRecursive = options.bRecursive;
+            walk.extensions.assign(1, ".puml");
+            walk.bIncludeDirectories = false;
+            walk.bFileSizes = false;
+
+            const FileSystemExplorerResult& fsResult = fsExplorer.explore(basePath, walk);
+            if (!fsResult.success) {
+                lastResult.errorMessage = fsResult.errorMessage;
+                return lastResult;
+            }
+
+            // Sorted by path, so the result does not depend on directory iteration order
+            std::vector<std::string> filePaths;
+            filePaths.reserve(fsResult.entries.size());
+            for (const auto& entry : fsResult.entries) {
+                filePaths.push_back(entry.path);
+            }
+            std::sort(filePaths.begin(), filePaths.end());
+            return parseAll(filePaths, options);
+        }
+    };
+
+    // PUMLBatchParser implementation
+    PUMLBatchParser::PUMLBatchParser() : pImpl(new Impl()) {}
+
+    PUMLBatchParser::~PUMLBatchParser() = default;
+
+    const PUMLBatchResult& PUMLBatchParser::parseFiles(const std::vector<std::string>& filePaths,
+                                                       const PUMLBatchOptions& options) {
+        pImpl->lastResult = PUMLBatchResult();
+        return pImpl->parseAll(filePaths, options);
+    }
+
+    const PUMLBatchResult& PUMLBatchParser::explore(const std::string& basePath, const PUMLBatchOptions& options) {
+        return pImpl->explore(basePath, options);
+    }
+
+    const PUMLBatchResult& PUMLBatchParser::getLastResult() const {
+        return pImpl->lastResult;
+    }
+
+    PUMLDiagramType PUMLBatchParser::detectDiagramType(std::string_view content) {
+        int classVotes = 0;
+        int entityVotes = 0;
+        bool inPlantUML = false;
+
+        size_t pos = 0;
+        while (pos < content.size()) {
+            size_t end = content.find('\n', pos);
+            if (end == std::string_view::npos) end = content.size();
+            std::string_view line = trimView(content.substr(pos, end - pos));
+            pos = end + 1;
+
+            if (line.empty() || line[0] == '\'') continue;
+            if (line.compare(0, 9, "@startuml") == 0) {
+                inPlantUML = true;
+                continue;
+            }
+            if (line.compare(0, 7, "@enduml") == 0) {
+                inPlantUML = false;
+                continue;
+            }
+            if (!inPlantUML) continue;
+
+            std::string_view word = firstWord(line);
+            if (word == "entity" || word == "table") {
+                entityVotes++;
+            } else if (word == "class" || word == "interface" || word == "abstract" || word == "enum") {
+                classVotes++;
+            } else if (hasCrowsFoot(line)) {
+                entityVotes++;
+            } else if (hasUMLArrow(line)) {
+                classVotes++;
+            }
+        }
+
+        if (entityVotes > classVotes) return PUMLDiagramType::Entity;
+        if (classVotes > 0) return PUMLDiagramType::Class;
+        return PUMLDiagramType::Unknown;
+    }
+
+    PUMLClassDiagramResult PUMLBatchParser::mergeClassDiagrams(const std::vector<const PUMLClassDiagramResult*>& diagrams) {
+        PUMLClassDiagramResult merged;
+        merged.success = true;
+
+        std::map<std::string, size_t> classPositions;
+        std::set<std::tuple<std::string, std::string, int, std::string, std::string, std::string>> seenRelationships;
+        for (const PUMLClassDiagramResult* diagram : diagrams) {
+            for (const auto& cls : diagram->classes) {
+                auto inserted = classPositions.emplace(cls.name, merged.classes.size());
+                if (inserted.second) {
+                    merged.classes.push_back(cls);
+                } else {
+                    mergeClass(merged.classes[inserted.first->second], cls);
+                }
+            }
+            for (const auto& rel : diagram->relationships) {
+                if (seenRelationships.emplace(rel.fromClass, rel.toClass, static_cast<int>(rel.type), rel.label,
+                                              rel.fromCardinality, rel.toCardinality).second) {
+                    merged.relationships.push_back(rel);
+                }
+            }
+            merged.notes.insert(diagram->notes.begin(), diagram->notes.end());
+        }
+        return merged;
+    }
+
+    PUMLEntityDiagramResult PUMLBatchParser::mergeEntityDiagrams(const std::vector<const PUMLEntityDiagramResult*>& diagrams) {
+        PUMLEntityDiagramResult merged;
+        merged.success = true;
+
+        std::map<std::string, size_t> entityPositions;
+        std::set<std::tuple<std::string, std::string, int, int, int, std::string>> seenRelationships;
+        for (const PUMLEntityDiagramResult* diagram : diagrams) {
+            for (const auto& entity : diagram->entities) {
+                auto inserted = entityPositions.emplace(entity.name, merged.entities.size());
+                if (inserted.second) {
+                    merged.entities.push_back(entity);
+                } else {
+                    mergeEntity(merged.entities[inserted.first->second], entity);
+                }
+            }
+            for (const auto& rel : diagram->relationships) {
+                if (seenRelationships.emplace(rel.fromEntity, rel.toEntity, static_cast<int>(rel.fromCardinality),
+                                              static_cast<int>(rel.toCardinality), static_cast<int>(rel.type),
+                                              rel.label).second) {
+                    merged.relationships.push_back(rel);
+                }
+            }
+            merged.notes.insert(diagram->notes.begin(), diagram->notes.end());
+        }
+        return merged;
+    }
+
+} // namespace UFMTooling
@@ -1,20 +1,47 @@
 #include "../include/PUMLClassParser.h"
-#include <fstream>
+#include "../include/MappedFile.h"
+#include "NameIndex.h"
+#include "DiagramExport.h"
+#include "KeywordTable.h"
 #include <sstream>
 #include <algorithm>
-#include <regex>
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <iterator>
 
 namespace UFMTooling {
 
     // Helper functions
     namespace {
-        std::string trim(const std::string& str) {
+        std::string_view trimView(std::string_view str) {
             size_t first = str.find_first_not_of(" \t\n\r");
-            if (first == std::string::npos) return "";
+            if (first == std::string_view::npos) return std::string_view();
             size_t last = str.find_last_not_of(" \t\n\r");
             return str.substr(first, last - first + 1);
         }
 
+        std::string trim(std::string_view str) {
+            return std::string(trimView(str));
+        }
+
+        // Next line of content starting at pos, without its '\n' (same splitting as std::getline)
+        bool nextLine(std::string_view content, size_t& pos, std::string_view& line) {
+            if (pos >= content.size()) return false;
+            size_t end = content.find('\n', pos);
+            if (end == std::string_view::npos) end = content.size();
+            line = content.substr(pos, end - pos);
+            pos = end + 1;
+            return true;
+        }
+
+        // Remove every occurrence of marker (e.g. "{static}") from str
+        void eraseAll(std::string& str, std::string_view marker) {
+            for (size_t pos = str.find(marker); pos != std::string::npos; pos = str.find(marker, pos)) {
+                str.erase(pos, marker.size());
+            }
+        }
+
         UMLVisibility parseVisibility(char symbol) {
             switch (symbol) {
                 case '+': return UMLVisibility::Public;
@@ -25,15 +52,232 @@ namespace UFMTooling {
             }
         }
 
-        UMLRelationship parseRelationship(const std::string& rel) {
-            std::string r = trim(rel);
-            if (r.find("--|>") != std::string::npos) return UMLRelationship::Inheritance;
-            if (r.find("..|>") != std::string::npos) return UMLRelationship::Realization;
-            if (r.find("*--") != std::string::npos) return UMLRelationship::Composition;
-            if (r.find("o--") != std::string::npos) return UMLRelationship::Aggregation;
-            if (r.find("-->") != std::string::npos) return UMLRelationship::DirectedAssociation;
-            if (r.find("..>") != std::string::npos) return UMLRelationship::Dependency;
-            return UMLRelationship::Association;
+        // Keywords a line is classified by; matched as whole words outside quotes.
+        // Declaration keywords must be followed by a blank ("{abstract}" is a modifier).
+        enum LineKeyword {
+            KeywordStartUml,
+            KeywordEndUml,
+            KeywordClass,
+            KeywordInterface,
+            KeywordAbstract,
+            KeywordNote,
+            KeywordCount
+        };
+
+        constexpr KeywordEntry<LineKeyword> keywordEntries[] = {
+            {"@startuml", KeywordStartUml},
+            {"@enduml", KeywordEndUml},
+            {"class", KeywordClass},
+            {"interface", KeywordInterface},
+            {"abstract", KeywordAbstract},
+            {"note", KeywordNote}
+        };
+
+        constexpr KeywordTable<LineKeyword, std::size(keywordEntries)> Keywords(keywordEntries, KeywordCount);
+        static_assert(Keywords.valid(), "line keywords need a perfect hash");
+
+        bool isDeclarationKeyword(LineKeyword keyword) {
+            return keyword == KeywordClass || keyword == KeywordInterface || keyword == KeywordAbstract;
+        }
+
+        // Character classes of the single-pass line scan, built once at compile time
+        enum : uint8_t {
+            CharIdentifier = 1 << 0,    // Letters, digits, '_'
+            CharKeyword = 1 << 1,       // First character of a keyword
+            CharShaft = 1 << 2,         // Arrow shaft: '-' or '.'
+            CharQuote = 1 << 3
+        };
+
+        constexpr std::array<uint8_t, 256> makeCharClasses() {
+            std::array<uint8_t, 256> table{};
+            for (int c = 'a'; c <= 'z'; ++c) table[c] |= CharIdentifier;
+            for (int c = 'A'; c <= 'Z'; ++c) table[c] |= CharIdentifier;
+            for (int c = '0'; c <= '9'; ++c) table[c] |= CharIdentifier;
+            table['_'] |= CharIdentifier;
+            for (const auto& keyword : keywordEntries) table[static_cast<unsigned char>(keyword.text[0])] |= CharKeyword;
+            table['-'] |= CharShaft;
+            table['.'] |= CharShaft;
+            table['"'] |= CharQuote;
+            return table;
+        }
+
+        constexpr std::array<uint8_t, 256> CharClasses = makeCharClasses();
+
+        bool isIdentifierChar(char c) {
+            return (CharClasses[static_cast<unsigned char>(c)] & CharIdentifier) != 0;
+        }
+
+        // Arrow heads, on either end of a shaft
+        enum class ArrowHead {
+            None,
+            Triangle,       // <| |> ^
+            Open,           // < >
+            Filled,         // * (composition)
+            Hollow,         // o (aggregation)
+            Plus,           // + (nesting)
+            Cross,          // x
+            Square,         // #
+            Crowfoot        // } {
+        };
+
+        struct Arrow {
+            size_t begin;   // First character, left head included
+            size_t end;     // One past the last character, right head included
+            ArrowHead left;
+            ArrowHead right;
+            bool bDotted;
+
+            Arrow() : begin(std::string_view::npos), end(0), left(ArrowHead::None), right(ArrowHead::None), bDotted(false) {}
+
+            bool found() const { return begin != std::string_view::npos; }
+        };
+
+        // Result of scanning a line once: where each keyword first appears, and the first arrow
+        struct LineScan {
+            size_t keywords[KeywordCount];
+            Arrow arrow;
+
+            LineScan() {
+                for (size_t& position : keywords) position = std::string_view::npos;
+            }
+
+            bool has(LineKeyword keyword) const { return keywords[keyword] != std::string_view::npos; }
+        };
+
+        // Letter heads (o, x) only count when separated from the class name
+        bool isHeadBoundary(std::string_view line, size_t pos) {
+            return pos >= line.size() || line[pos] == ' ' || line[pos] == '\t' || line[pos] == '"';
+        }
+
+        ArrowHead leftHead(std::string_view line, size_t& begin) {
+            if (begin >= 2 && line[begin - 2] == '<' && line[begin - 1] == '|') {
+                begin -= 2;
+                return ArrowHead::Triangle;
+            }
+            if (begin == 0) return ArrowHead::None;
+
+            ArrowHead head = ArrowHead::None;
+            switch (line[begin - 1]) {
+                case '<': head = ArrowHead::Open; break;
+                case '^': head = ArrowHead::Triangle; break;
+                case '*': head = ArrowHead::Filled; break;
+                case '+': head = ArrowHead::Plus; break;
+                case '#': head = ArrowHead::Square; break;
+                case '}': head = ArrowHead::Crowfoot; break;
+                case 'o': if (begin < 2 || isHeadBoundary(line, begin - 2)) head = ArrowHead::Hollow; break;
+                case 'x': if (begin < 2 || isHeadBoundary(line, begin - 2)) head = ArrowHead::Cross; break;
+                default: break;
+            }
+            if (head != ArrowHead::None) --begin;
+            return head;
+        }
+
+        ArrowHead rightHead(std::string_view line, size_t& end) {
+            if (end + 1 < line.size() && line[end] == '|' && line[end + 1] == '>') {
+                end += 2;
+                return ArrowHead::Triangle;
+            }
+            if (end >= line.size()) return ArrowHead::None;
+
+            ArrowHead head = ArrowHead::None;
+            switch (line[end]) {
+                case '>': head = ArrowHead::Open; break;
+                case '^': head = ArrowHead::Triangle; break;
+                case '*': head = ArrowHead::Filled; break;
+                case '+': head = ArrowHead::Plus; break;
+                case '#': head = ArrowHead::Square; break;
+                case '{': head = ArrowHead::Crowfoot; break;
+                case 'o': if (isHeadBoundary(line, end + 1)) head = ArrowHead::Hollow; break;
+                case 'x': if (isHeadBoundary(line, end + 1)) head = ArrowHead::Cross; break;
+                default: break;
+            }
+            if (head != ArrowHead::None) ++end;
+            return head;
+        }
+
+        // Length of a direction hint (up, down, left, right, u, d, l, r) or style ([#red])
+        // embedded in a shaft at pos, as in "-up->" or "-[#blue]-"
+        size_t shaftHint(std::string_view line, size_t pos) {
+            if (pos < line.size() && line[pos] == '[') {
+                size_t close = line.find(']', pos);
+                return close == std::string_view::npos ? 0 : close - pos + 1;
+            }
+            static const std::string_view hints[] = {"up", "down", "left", "right", "u", "d", "l", "r"};
+            for (std::string_view hint : hints) {
+                if (line.compare(pos, hint.size(), hint) == 0) return hint.size();
+            }
+            return 0;
+        }
+
+        // Arrow whose shaft starts at pos: at least two '-' or '.', with optional heads
+        bool matchArrow(std::string_view line, size_t pos, Arrow& arrow) {
+            char shaft = line[pos];
+            size_t end = pos;
+            size_t shaftLength = 0;
+            while (end < line.size()) {
+                if (line[end] == shaft) {
+                    ++end;
+                    ++shaftLength;
+                    continue;
+                }
+                size_t hint = shaftLength > 0 ? shaftHint(line, end) : 0;
+                if (hint == 0 || end + hint >= line.size() || line[end + hint] != shaft) break;
+                end += hint;
+            }
+            if (shaftLength < 2) return false;
+
+            size_t begin = pos;
+            arrow.left = leftHead(line, begin);
+            arrow.right = rightHead(line, end);
+            arrow.begin = begin;
+            arrow.end = end;
+            arrow.bDotted = shaft == '.';
+            return true;
+        }
+
+        // One pass over the line: keywords (whole words) and the first arrow, both outside quotes
+        LineScan scanLine(std::string_view line) {
+            LineScan scan;
+            bool bQuoted = false;
+            for (size_t i = 0; i < line.size(); ++i) {
+                uint8_t charClass = CharClasses[static_cast<unsigned char>(line[i])];
+                if ((charClass & (CharKeyword | CharShaft | CharQuote)) == 0) continue;
+
+                if (charClass & CharQuote) {
+                    bQuoted = !bQuoted;
+                } else if (bQuoted) {
+                    continue;
+                } else if ((charClass & CharKeyword) && (i == 0 || !isIdentifierChar(line[i - 1]))) {
+                    // The whole word at i ('@' only starts one), looked up once
+                    size_t end = i + 1;
+                    while (end < line.size() && isIdentifierChar(line[end])) ++end;
+                    LineKeyword keyword = Keywords.find(line.substr(i, end - i));
+                    if (keyword != KeywordCount &&
+                        (!isDeclarationKeyword(keyword) || (end < line.size() && (line[end] == ' ' || line[end] == '\t')))) {
+                        if (!scan.has(keyword)) scan.keywords[keyword] = i;
+                        i = end - 1;
+                    }
+                } else if ((charClass & CharShaft) && !scan.arrow.found() && matchArrow(line, i, scan.arrow)) {
+                    i = scan.arrow.end - 1;
+                }
+            }
+            return scan;
+        }
+
+        // str without surrounding double quotes
+        std::string_view unquote(std::string_view str) {
+            if (str.size() >= 2 && str.front() == '"' && str.back() == '"') return str.substr(1, str.size() - 2);
+            return str;
+        }
+
+        // Position of c in str outside double quotes
+        size_t findUnquoted(std::string_view str, char c) {
+            bool bQuoted = false;
+            for (size_t i = 0; i < str.size(); ++i) {
+                if (str[i] == '"') bQuoted = !bQuoted;
+                else if (str[i] == c && !bQuoted) return i;
+            }
+            return std::string_view::npos;
         }
     }
 
@@ -46,7 +290,12 @@ namespace UFMTooling {
         std::vector<std::string> warnings;
         std::string title;
 
-        PUMLClassDiagramResult parse(const std::string& content) {
+        // The model of the last parse, for the exports
+        DiagramExport::ClassDiagramView view() const {
+            return DiagramExport::ClassDiagramView{ title, classes, relationships, notes };
+        }
+
+        PUMLClassDiagramResult parse(std::string_view content) {
             PUMLClassDiagramResult result;
             result.success = true;
 
@@ -54,29 +303,34 @@ namespace UFMTooling {
             relationships.clear();
             notes.clear();
             warnings.clear();
+            title.clear();
 
             try {
-                std::istringstream stream(content);
-                std::string line;
+                size_t linePos = 0;
+                std::string_view rawLine;
                 bool inClass = false;
                 UMLClass currentClass;
                 bool inPlantUML = false;
 
-                while (std::getline(stream, line)) {
-                    line = trim(line);
+                // Lines are views into the content; nothing is copied per line
+                while (nextLine(content, linePos, rawLine)) {
+                    std::string_view line = trimView(rawLine);
                     
                     // Skip empty lines and comments
                     if (line.empty() || line[0] == '\'') continue;
 
+                    // Keywords and the first arrow, found in one pass over the line
+                    LineScan scan = scanLine(line);
+
                     // Check for PlantUML start/end
-                    if (line.find("@startuml") != std::string::npos) {
+                    if (scan.has(KeywordStartUml)) {
                         inPlantUML = true;
                         continue;
                     }
-                    if (line.find("@enduml") != std::string::npos) {
+                    if (scan.has(KeywordEndUml)) {
                         inPlantUML = false;
                         if (inClass) {
-                            classes.push_back(currentClass);
+                            classes.push_back(std::move(currentClass));
                             inClass = false;
                         }
                         continue;
@@ -85,62 +339,56 @@ namespace UFMTooling {
                     if (!inPlantUML) continue;
 
                     // Parse title
-                    if (line.find("title ") == 0) {
+                    if (line.compare(0, 6, "title ") == 0) {
                         title = line.substr(6);
                         result.title = title;
                         continue;
                     }
 
                     // Parse class declaration
-                    if (line.find("class ") != std::string::npos || 
-                        line.find("interface ") != std::string::npos ||
-                        line.find("abstract ") != std::string::npos) {
-                        
+                    if (scan.has(KeywordClass) || scan.has(KeywordInterface) || scan.has(KeywordAbstract)) {
                         if (inClass) {
-                            classes.push_back(currentClass);
+                            classes.push_back(std::move(currentClass));
                         }
 
                         currentClass = UMLClass();
                         inClass = true;
 
                         // Check for abstract or interface
-                        currentClass.isAbstract = line.find("abstract") != std::string::npos;
-                        currentClass.isInterface = line.find("interface") != std::string::npos;
-
-                        // Extract class name
-                        size_t classPos = line.find("class ");
-                        if (classPos == std::string::npos) {
-                            classPos = line.find("interface ");
-                        }
-                        
-                        if (classPos != std::string::npos) {
-                            std::string rest = line.substr(classPos);
-                            size_t nameStart = rest.find(" ") + 1;
-                            std::string nameStr = trim(rest.substr(nameStart));
-                            
-                            // Check for stereotype
-                            if (nameStr.find("<<") != std::string::npos) {
-                                size_t stereoStart = nameStr.find("<<");
-                                size_t stereoEnd = nameStr.find(">>", stereoStart);
-                                if (stereoEnd != std::string::npos && stereoEnd > stereoStart) {
-                                    currentClass.stereotype = nameStr.substr(stereoStart + 2, stereoEnd - stereoStart - 2);
-                                    nameStr = trim(nameStr.substr(0, stereoStart)) + trim(nameStr.substr(stereoEnd + 2));
-                                }
+                        currentClass.isAbstract = scan.has(KeywordAbstract);
+                        currentClass.isInterface = scan.has(KeywordInterface);
+
+                        // The name follows "class", else "interface", else a bare "abstract"
+                        size_t classPos = scan.keywords[KeywordClass];
+                        if (classPos == std::string_view::npos) classPos = scan.keywords[KeywordInterface];
+                        if (classPos == std::string_view::npos) classPos = scan.keywords[KeywordAbstract];
+
+                        std::string_view rest = line.substr(classPos);
+                        size_t nameStart = rest.find_first_of(" \t");
+                        std::string nameStr = nameStart == std::string_view::npos ? std::string() : trim(rest.substr(nameStart));
+
+                        // Check for stereotype
+                        if (nameStr.find("<<") != std::string::npos) {
+                            size_t stereoStart = nameStr.find("<<");
+                            size_t stereoEnd = nameStr.find(">>", stereoStart);
+                            if (stereoEnd != std::string::npos && stereoEnd > stereoStart) {
+                                currentClass.stereotype = nameStr.substr(stereoStart + 2, stereoEnd - stereoStart - 2);
+                                nameStr = trim(nameStr.substr(0, stereoStart)) + trim(nameStr.substr(stereoEnd + 2));
                             }
+                        }
 
-                            size_t nameEnd = nameStr.find_first_of(" {");
-                            if (nameEnd != std::string::npos) {
-                                currentClass.name = nameStr.substr(0, nameEnd);
-                            } else {
-                                currentClass.name = nameStr;
-                            }
+                        size_t nameEnd = nameStr.find_first_of(" {");
+                        if (nameEnd != std::string::npos) {
+                            currentClass.name = nameStr.substr(0, nameEnd);
+                        } else {
+                            currentClass.name = nameStr;
                         }
                         continue;
                     }
 
                     // End of class
                     if (line == "}" && inClass) {
-                        classes.push_back(currentClass);
+                        classes.push_back(std::move(currentClass));
                         inClass = false;
                         currentClass = UMLClass();
                         continue;
@@ -160,22 +408,19 @@ namespace UFMTooling {
                     }
 
                     // Parse relationships
-                    if (line.find("--") != std::string::npos || 
-                        line.find("..") != std::string::npos ||
-                        line.find("<|") != std::string::npos ||
-                        line.find("|>") != std::string::npos) {
-                        parseRelationshipLine(line);
+                    if (scan.arrow.found()) {
+                        parseRelationshipLine(line, scan.arrow);
                     }
 
                     // Parse notes
-                    if (line.find("note") != std::string::npos) {
+                    if (scan.has(KeywordNote)) {
                         parseNote(line);
                     }
                 }
 
                 // Save last class if needed
                 if (inClass) {
-                    classes.push_back(currentClass);
+                    classes.push_back(std::move(currentClass));
                 }
 
                 result.classes = classes;
@@ -187,11 +432,30 @@ namespace UFMTooling {
                 result.errorMessage = std::string("Parsing error: ") + e.what();
             }
 
+            indexClasses();
             return result;
         }
 
+        const UMLClass* findClass(std::string_view name) const {
+            size_t position = classIndex.find(name);
+            return position == NameIndex::npos ? nullptr : &classes[position];
+        }
+
     private:
-        void parseAttribute(const std::string& line, UMLClass& cls) {
+        NameIndex classIndex;       // Name and package-qualified name -> position in classes
+
+        void indexClasses() {
+            classIndex.clear();
+            classIndex.reserve(classes.size());
+            for (size_t i = 0; i < classes.size(); ++i) {
+                classIndex.insert(classes[i].name, i);
+                if (!classes[i].package.empty()) {
+                    classIndex.insertCopy(classes[i].package + "." + classes[i].name, i);
+                }
+            }
+        }
+
+        void parseAttribute(std::string_view line, UMLClass& cls) {
             UMLAttribute attr;
             
             // Parse visibility
@@ -204,7 +468,7 @@ namespace UFMTooling {
             // Check for static
             if (content.find("{static}") != std::string::npos) {
                 attr.isStatic = true;
-                content = std::regex_replace(content, std::regex("\\{static\\}"), "");
+                eraseAll(content, "{static}");
                 content = trim(content);
             }
 
@@ -229,7 +493,7 @@ namespace UFMTooling {
             cls.attributes.push_back(attr);
         }
 
-        void parseMethod(const std::string& line, UMLClass& cls) {
+        void parseMethod(std::string_view line, UMLClass& cls) {
             UMLMethod method;
             
             // Parse visibility
@@ -242,14 +506,14 @@ namespace UFMTooling {
             // Check for static
             if (content.find("{static}") != std::string::npos) {
                 method.isStatic = true;
-                content = std::regex_replace(content, std::regex("\\{static\\}"), "");
+                eraseAll(content, "{static}");
                 content = trim(content);
             }
 
             // Check for abstract
             if (content.find("{abstract}") != std::string::npos) {
                 method.isAbstract = true;
-                content = std::regex_replace(content, std::regex("\\{abstract\\}"), "");
+                eraseAll(content, "{abstract}");
                 content = trim(content);
             }
 
@@ -300,45 +564,82 @@ namespace UFMTooling {
             }
         }
 
-        void parseRelationshipLine(const std::string& line) {
+        void parseRelationshipLine(std::string_view line, const Arrow& arrow) {
             UMLClassRelationship rel;
-            
-            // Find relationship symbols
-            std::vector<std::pair<std::string, UMLRelationship>> patterns = {
-                {"--|>", UMLRelationship::Inheritance},
-                {"..|>", UMLRelationship::Realization},
-                {"*--", UMLRelationship::Composition},
-                {"o--", UMLRelationship::Aggregation},
-                {"-->", UMLRelationship::DirectedAssociation},
-                {"..>", UMLRelationship::Dependency},
-                {"--", UMLRelationship::Association}
+
+            // The strongest head decides the type. Relationships are stored in the
+            // orientation of their basic arrow: from = child for --|>, ..|> and -->,
+            // from = whole for *--, o-- and +--; arrows drawn the other way are swapped.
+            bool bHeadOnLeft = false;
+            auto hasHead = [&arrow, &bHeadOnLeft](ArrowHead head) {
+                if (arrow.right == head) return true;
+                if (arrow.left == head) bHeadOnLeft = true;
+                return arrow.left == head;
             };
+            bool bSwap = false;
+            if (hasHead(ArrowHead::Triangle)) {
+                rel.type = arrow.bDotted ? UMLRelationship::Realization : UMLRelationship::Inheritance;
+                bSwap = bHeadOnLeft;
+            } else if (hasHead(ArrowHead::Filled)) {
+                rel.type = UMLRelationship::Composition;
+                bSwap = !bHeadOnLeft;
+            } else if (hasHead(ArrowHead::Hollow)) {
+                rel.type = UMLRelationship::Aggregation;
+                bSwap = !bHeadOnLeft;
+            } else if (hasHead(ArrowHead::Plus)) {
+                rel.type = UMLRelationship::Nesting;
+                bSwap = !bHeadOnLeft;
+            } else if (hasHead(ArrowHead::Open)) {
+                rel.type = arrow.bDotted ? UMLRelationship::Dependency : UMLRelationship::DirectedAssociation;
+                bSwap = bHeadOnLeft;
+            } else {
+                rel.type = UMLRelationship::Association;    // Plain, x, # and crow's foot ends
+            }
 
-            for (const auto& pattern : patterns) {
-                size_t pos = line.find(pattern.first);
-                if (pos != std::string::npos) {
-                    rel.type = pattern.second;
-                    
-                    // Extract class names
-                    rel.fromClass = trim(line.substr(0, pos));
-                    std::string rest = trim(line.substr(pos + pattern.first.length()));
-                    
-                    // Extract label if present
-                    size_t labelPos = rest.find(":");
-                    if (labelPos != std::string::npos) {
-                        rel.toClass = trim(rest.substr(0, labelPos));
-                        rel.label = trim(rest.substr(labelPos + 1));
-                    } else {
-                        rel.toClass = rest;
-                    }
-                    
-                    relationships.push_back(rel);
-                    break;
+            std::string_view from = trimView(line.substr(0, arrow.begin));
+            std::string_view to = trimView(line.substr(arrow.end));
+
+            // Extract label if present
+            size_t labelPos = findUnquoted(to, ':');
+            if (labelPos != std::string_view::npos) {
+                rel.label = trim(to.substr(labelPos + 1));
+                to = trimView(to.substr(0, labelPos));
+            }
+
+            // Cardinalities are quoted next to the arrow: A "1" *-- "many" B. A quoted
+            // string with nothing beside it is a quoted class name instead.
+            if (from.size() >= 2 && from.back() == '"') {
+                size_t open = from.rfind('"', from.size() - 2);
+                if (open != std::string_view::npos && open > 0) {
+                    rel.fromCardinality = std::string(from.substr(open + 1, from.size() - open - 2));
+                    from = trimView(from.substr(0, open));
+                }
+            }
+            if (to.size() >= 2 && to.front() == '"') {
+                size_t close = to.find('"', 1);
+                if (close != std::string_view::npos && close + 1 < to.size()) {
+                    rel.toCardinality = std::string(to.substr(1, close - 1));
+                    to = trimView(to.substr(close + 1));
                 }
             }
+            from = unquote(from);
+            to = unquote(to);
+
+            if (from.empty() || to.empty()) {
+                warnings.push_back("Relationship without two classes: " + std::string(line));
+                return;
+            }
+
+            rel.fromClass = std::string(from);
+            rel.toClass = std::string(to);
+            if (bSwap) {
+                std::swap(rel.fromClass, rel.toClass);
+                std::swap(rel.fromCardinality, rel.toCardinality);
+            }
+            relationships.push_back(std::move(rel));
         }
 
-        void parseNote(const std::string& line) {
+        void parseNote(std::string_view line) {
             // Simple note parsing
             if (line.find("note") != std::string::npos) {
                 size_t ofPos = line.find(" of ");
@@ -356,20 +657,19 @@ namespace UFMTooling {
     PUMLClassParser::~PUMLClassParser() = default;
 
     PUMLClassDiagramResult PUMLClassParser::parseFile(const std::string& filePath) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
+        // Parse straight out of the mapped file; nothing is copied before scanning
+        MappedFile file;
+        if (!file.open(filePath)) {
             PUMLClassDiagramResult result;
             result.success = false;
             result.errorMessage = "Could not open file: " + filePath;
             return result;
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return parseContent(buffer.str());
+        return pImpl->parse(file.view());
     }
 
-    PUMLClassDiagramResult PUMLClassParser::parseContent(const std::string& content) {
+    PUMLClassDiagramResult PUMLClassParser::parseContent(std::string_view content) {
         return pImpl->parse(content);
     }
 
@@ -382,50 +682,35 @@ namespace UFMTooling {
     }
 
     const UMLClass* PUMLClassParser::findClass(const std::string& className) const {
-        for (const auto& cls : pImpl->classes) {
-            if (cls.name == className) {
-                return &cls;
-            }
-        }
-        return nullptr;
+        return pImpl->findClass(className);
     }
 
-    std::string PUMLClassParser::exportToJson() const {
-        // Basic JSON export
-        std::stringstream json;
-        json << "{\n";
-        json << "  \"classes\": [\n";
-        
-        for (size_t i = 0; i < pImpl->classes.size(); ++i) {
-            const auto& cls = pImpl->classes[i];
-            json << "    {\n";
-            json << "      \"name\": \"" << cls.name << "\",\n";
-            json << "      \"isAbstract\": " << (cls.isAbstract ? "true" : "false") << ",\n";
-            json << "      \"isInterface\": " << (cls.isInterface ? "true" : "false") << "\n";
-            json << "    }";
-            if (i < pImpl->classes.size() - 1) json << ",";
-            json << "\n";
-        }
-        
-        json << "  ]\n";
-        json << "}\n";
-        return json.str();
+    std::string PUMLClassParser::exportToJson(bool bPretty) const {
+        std::string output;
+        JsonWriter writer(output, bPretty);
+        DiagramExport::writeJson(pImpl->view(), writer);
+        return output;
     }
 
-    std::string PUMLClassParser::exportToXML() const {
-        // Basic XML export
-        std::stringstream xml;
-        xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-        xml << "<ClassDiagram>\n";
-        
-        for (const auto& cls : pImpl->classes) {
-            xml << "  <Class name=\"" << cls.name << "\" ";
-            xml << "isAbstract=\"" << (cls.isAbstract ? "true" : "false") << "\" ";
-            xml << "isInterface=\"" << (cls.isInterface ? "true" : "false") << "\" />\n";
-        }
-        
-        xml << "</ClassDiagram>\n";
-        return xml.str();
+    bool PUMLClassParser::exportToJson(std::ostream& out, bool bPretty) const {
+        JsonWriter writer(out, bPretty);
+        DiagramExport::writeJson(pImpl->view(), writer);
+        writer.flush();
+        return writer.good();
+    }
+
+    std::string PUMLClassParser::exportToXML(bool bPretty) const {
+        std::string output;
+        XmlWriter writer(output, bPretty);
+        DiagramExport::writeXml(pImpl->view(), writer);
+        return output;
+    }
+
+    bool PUMLClassParser::exportToXML(std::ostream& out, bool bPretty) const {
+        XmlWriter writer(out, bPretty);
+        DiagramExport::writeXml(pImpl->view(), writer);
+        writer.flush();
+        return writer.good();
     }
 
     const std::vector<std::string>& PUMLClassParser::getWarnings() const {
@@ -1,28 +1,133 @@
 #include "../include/PUMLEntityParser.h"
-#include <fstream>
+#include "../include/MappedFile.h"
+#include "NameIndex.h"
+#include "DiagramExport.h"
+#include "DDLGenerator.h"
+#include "KeywordTable.h"
 #include <sstream>
+#include <istream>
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <iterator>
 #include <regex>
+#include <string_view>
 
 namespace UFMTooling {
 
     // Helper functions
     namespace {
-        std::string trim(const std::string& str) {
+        std::string_view trimView(std::string_view str) {
             size_t first = str.find_first_not_of(" \t\n\r");
-            if (first == std::string::npos) return "";
+            if (first == std::string_view::npos) return std::string_view();
             size_t last = str.find_last_not_of(" \t\n\r");
             return str.substr(first, last - first + 1);
         }
 
+        std::string trim(std::string_view str) {
+            return std::string(trimView(str));
+        }
+
+        // Next line of content starting at pos, without its '\n' (same splitting as std::getline)
+        bool nextLine(std::string_view content, size_t& pos, std::string_view& line) {
+            if (pos >= content.size()) return false;
+            size_t end = content.find('\n', pos);
+            if (end == std::string_view::npos) end = content.size();
+            line = content.substr(pos, end - pos);
+            pos = end + 1;
+            return true;
+        }
+
+        // Crow's foot end as written on either side: |o / o|, ||, }o / o{, }| / |{
         Cardinality parseCardinality(const std::string& card) {
-            if (card.find("|o") != std::string::npos) return Cardinality::ZeroOrOne;
+            if (card.find("|o") != std::string::npos || card.find("o|") != std::string::npos) return Cardinality::ZeroOrOne;
             if (card.find("||") != std::string::npos) return Cardinality::ExactlyOne;
-            if (card.find("}o") != std::string::npos) return Cardinality::ZeroOrMany;
-            if (card.find("}|") != std::string::npos) return Cardinality::OneOrMany;
+            if (card.find("}o") != std::string::npos || card.find("o{") != std::string::npos) return Cardinality::ZeroOrMany;
+            if (card.find("}|") != std::string::npos || card.find("|{") != std::string::npos) return Cardinality::OneOrMany;
             return Cardinality::ExactlyOne;
         }
 
+        // Words a line is classified by, matched whole; entity and table must be followed by a space
+        enum class LineWord : uint8_t {
+            StartUml,
+            EndUml,
+            Entity,
+            Table,
+            Note,
+            Count
+        };
+
+        constexpr KeywordEntry<LineWord> lineWordEntries[] = {
+            {"@startuml", LineWord::StartUml},
+            {"@enduml", LineWord::EndUml},
+            {"entity", LineWord::Entity},
+            {"table", LineWord::Table},
+            {"note", LineWord::Note}
+        };
+
+        constexpr KeywordTable<LineWord, std::size(lineWordEntries)> lineWords(lineWordEntries, LineWord::Count);
+        static_assert(lineWords.valid(), "line words need a perfect hash");
+
+        // Character classes of the line scan, built once at compile time
+        enum : uint8_t {
+            CharIdentifier = 1 << 0,    // Letters, digits, '_'
+            CharWordStart = 1 << 1,     // Identifier characters and '@'
+            CharLink = 1 << 2           // Relationship marks: "--", "..", '|', '}'
+        };
+
+        constexpr std::array<uint8_t, 256> makeCharClasses() {
+            std::array<uint8_t, 256> table{};
+            for (int c = 'a'; c <= 'z'; ++c) table[c] |= CharIdentifier | CharWordStart;
+            for (int c = 'A'; c <= 'Z'; ++c) table[c] |= CharIdentifier | CharWordStart;
+            for (int c = '0'; c <= '9'; ++c) table[c] |= CharIdentifier | CharWordStart;
+            table['_'] |= CharIdentifier | CharWordStart;
+            table['@'] |= CharWordStart;
+            table['-'] |= CharLink;
+            table['.'] |= CharLink;
+            table['|'] |= CharLink;
+            table['}'] |= CharLink;
+            return table;
+        }
+
+        constexpr std::array<uint8_t, 256> CharClasses = makeCharClasses();
+
+        // Result of scanning a line once: where each word first appears, and whether the
+        // line has a relationship mark
+        struct LineScan {
+            size_t words[static_cast<size_t>(LineWord::Count)];
+            bool bLink;
+
+            LineScan() : bLink(false) {
+                for (size_t& position : words) position = std::string_view::npos;
+            }
+
+            size_t find(LineWord word) const { return words[static_cast<size_t>(word)]; }
+            bool has(LineWord word) const { return find(word) != std::string_view::npos; }
+        };
+
+        LineScan scanLine(std::string_view line) {
+            LineScan scan;
+            for (size_t i = 0; i < line.size(); ++i) {
+                uint8_t charClass = CharClasses[static_cast<unsigned char>(line[i])];
+                if (charClass & CharWordStart) {
+                    size_t end = i + 1;
+                    while (end < line.size() && (CharClasses[static_cast<unsigned char>(line[end])] & CharIdentifier)) ++end;
+                    LineWord word = lineWords.find(line.substr(i, end - i));
+                    bool bDeclaration = word == LineWord::Entity || word == LineWord::Table;
+                    if (word != LineWord::Count && !scan.has(word) &&
+                        (!bDeclaration || (end < line.size() && line[end] == ' '))) {
+                        scan.words[static_cast<size_t>(word)] = i;
+                    }
+                    i = end - 1;
+                } else if (charClass & CharLink) {
+                    char c = line[i];
+                    if (c == '|' || c == '}' || (i + 1 < line.size() && line[i + 1] == c)) scan.bLink = true;
+                }
+            }
+            return scan;
+        }
+
         EntityRelationType determineRelationType(Cardinality from, Cardinality to) {
             bool fromMany = (from == Cardinality::ZeroOrMany || from == Cardinality::OneOrMany);
             bool toMany = (to == Cardinality::ZeroOrMany || to == Cardinality::OneOrMany);
@@ -32,282 +137,412 @@ namespace UFMTooling {
             if (!fromMany && toMany) return EntityRelationType::OneToMany;
             return EntityRelationType::OneToOne;
         }
-    }
 
-    // Implementation class
-    class PUMLEntityParser::Impl {
-    public:
-        std::vector<Entity> entities;
-        std::vector<EntityRelationship> relationships;
-        std::map<std::string, std::string> notes;
-        std::vector<std::string> warnings;
-        std::string title;
+        // Line-by-line state machine behind parseContent() and PUMLEntityStreamParser.
+        // Completed entities, relationships and notes are handed to the callbacks as soon
+        // as they are known; only the entity being declared is held.
+        class EntityLineParser {
+        public:
+            explicit EntityLineParser(const PUMLEntityCallbacks& callbacks) : callbacks(callbacks) {
+                reset();
+            }
 
-        PUMLEntityDiagramResult parse(const std::string& content) {
-            PUMLEntityDiagramResult result;
-            result.success = true;
+            void reset() {
+                inPlantUML = false;
+                inEntity = false;
+                currentEntity = Entity();
+            }
 
-            entities.clear();
-            relationships.clear();
-            notes.clear();
-            warnings.clear();
+            // One line of content, without its '\n'
+            void parseLine(std::string_view rawLine) {
+                std::string_view line = trimView(rawLine);
 
-            try {
-                std::istringstream stream(content);
-                std::string line;
-                bool inEntity = false;
-                Entity currentEntity;
-                bool inPlantUML = false;
-
-                while (std::getline(stream, line)) {
-                    line = trim(line);
-                    
-                    // Skip empty lines and comments
-                    if (line.empty() || line[0] == '\'') continue;
+                // Skip empty lines and comments
+                if (line.empty() || line[0] == '\'') return;
 
-                    // Check for PlantUML start/end
-                    if (line.find("@startuml") != std::string::npos) {
-                        inPlantUML = true;
-                        continue;
-                    }
-                    if (line.find("@enduml") != std::string::npos) {
-                        inPlantUML = false;
-                        if (inEntity) {
-                            entities.push_back(currentEntity);
-                            inEntity = false;
-                        }
-                        continue;
-                    }
+                // Words and relationship marks, found in one pass over the line
+                LineScan scan = scanLine(line);
 
-                    if (!inPlantUML) continue;
+                // Check for PlantUML start/end
+                if (scan.has(LineWord::StartUml)) {
+                    inPlantUML = true;
+                    return;
+                }
+                if (scan.has(LineWord::EndUml)) {
+                    inPlantUML = false;
+                    finishEntity();
+                    return;
+                }
 
-                    // Parse title
-                    if (line.find("title ") == 0) {
-                        title = line.substr(6);
-                        result.title = title;
-                        continue;
-                    }
+                if (!inPlantUML) return;
 
-                    // Parse entity declaration
-                    if (line.find("entity ") != std::string::npos || 
-                        line.find("table ") != std::string::npos) {
-                        
-                        if (inEntity) {
-                            entities.push_back(currentEntity);
-                        }
+                // Parse title
+                if (line.compare(0, 6, "title ") == 0) {
+                    if (callbacks.onTitle) callbacks.onTitle(std::string(line.substr(6)));
+                    return;
+                }
 
-                        currentEntity = Entity();
-                        inEntity = true;
+                // Parse entity declaration
+                if (scan.has(LineWord::Entity) || scan.has(LineWord::Table)) {
+                    
+                    finishEntity();
+                    inEntity = true;
 
-                        // Extract entity name
-                        size_t entityPos = line.find("entity ");
-                        if (entityPos == std::string::npos) {
-                            entityPos = line.find("table ");
-                        }
+                    // Extract entity name
+                    size_t entityPos = scan.find(LineWord::Entity);
+                    if (entityPos == std::string::npos) {
+                        entityPos = scan.find(LineWord::Table);
+                    }
+                    
+                    if (entityPos != std::string::npos) {
+                        std::string_view rest = line.substr(entityPos);
+                        size_t nameStart = rest.find(" ") + 1;
+                        std::string nameStr = trim(rest.substr(nameStart));
                         
-                        if (entityPos != std::string::npos) {
-                            std::string rest = line.substr(entityPos);
-                            size_t nameStart = rest.find(" ") + 1;
-                            std::string nameStr = trim(rest.substr(nameStart));
-                            
-                            // Handle "Entity as Alias" syntax
-                            size_t asPos = nameStr.find(" as ");
-                            if (asPos != std::string::npos) {
-                                currentEntity.name = trim(nameStr.substr(0, asPos));
-                                std::string aliasStr = trim(nameStr.substr(asPos + 4));
-                                size_t aliasEnd = aliasStr.find_first_of(" {");
-                                if (aliasEnd != std::string::npos) {
-                                    currentEntity.alias = aliasStr.substr(0, aliasEnd);
-                                } else {
-                                    currentEntity.alias = aliasStr;
-                                }
+                        // Handle "Entity as Alias" syntax
+                        size_t asPos = nameStr.find(" as ");
+                        if (asPos != std::string::npos) {
+                            currentEntity.name = trim(nameStr.substr(0, asPos));
+                            std::string aliasStr = trim(nameStr.substr(asPos + 4));
+                            size_t aliasEnd = aliasStr.find_first_of(" {");
+                            if (aliasEnd != std::string::npos) {
+                                currentEntity.alias = aliasStr.substr(0, aliasEnd);
                             } else {
-                                size_t nameEnd = nameStr.find_first_of(" {");
-                                if (nameEnd != std::string::npos) {
-                                    currentEntity.name = nameStr.substr(0, nameEnd);
-                                } else {
-                                    currentEntity.name = nameStr;
-                                }
+                                currentEntity.alias = aliasStr;
+                            }
+                        } else {
+                            size_t nameEnd = nameStr.find_first_of(" {");
+                            if (nameEnd != std::string::npos) {
+                                currentEntity.name = nameStr.substr(0, nameEnd);
+                            } else {
+                                currentEntity.name = nameStr;
                             }
                         }
-                        continue;
-                    }
-
-                    // End of entity
-                    if (line == "}" && inEntity) {
-                        entities.push_back(currentEntity);
-                        inEntity = false;
-                        currentEntity = Entity();
-                        continue;
-                    }
-
-                    // Parse entity fields (inside entity)
-                    if (inEntity && line != "{") {
-                        parseField(line, currentEntity);
-                        continue;
                     }
+                    return;
+                }
 
-                    // Parse relationships
-                    if (line.find("--") != std::string::npos || 
-                        line.find("..") != std::string::npos ||
-                        line.find("|") != std::string::npos ||
-                        line.find("}") != std::string::npos) {
-                        parseRelationshipLine(line);
-                    }
+                // End of entity
+                if (line == "}" && inEntity) {
+                    finishEntity();
+                    return;
+                }
 
-                    // Parse notes
-                    if (line.find("note") != std::string::npos) {
-                        parseNote(line);
-                    }
+                // Parse entity fields (inside entity)
+                if (inEntity && line != "{") {
+                    parseField(line, currentEntity);
+                    return;
                 }
 
-                // Save last entity if needed
-                if (inEntity) {
-                    entities.push_back(currentEntity);
+                // Parse relationships
+                if (scan.bLink) {
+                    parseRelationshipLine(line);
                 }
 
-                result.entities = entities;
-                result.relationships = relationships;
-                result.notes = notes;
+                // Parse notes
+                if (scan.has(LineWord::Note)) {
+                    parseNote(line);
+                }
+            }
 
-            } catch (const std::exception& e) {
-                result.success = false;
-                result.errorMessage = std::string("Parsing error: ") + e.what();
+            // Hand over the entity still being declared, if any
+            void finishEntity() {
+                if (!inEntity) return;
+                inEntity = false;
+                Entity entity = std::move(currentEntity);
+                currentEntity = Entity();
+                if (callbacks.onEntity) callbacks.onEntity(entity);
             }
 
-            return result;
-        }
+            bool isInEntity() const { return inEntity; }
 
-    private:
-        void parseField(const std::string& line, Entity& entity) {
-            EntityField field;
-            std::string content = trim(line);
+        private:
+            const PUMLEntityCallbacks& callbacks;
+            bool inPlantUML;
+            bool inEntity;
+            Entity currentEntity;
 
-            // Skip separator lines
-            if (content == "--" || content.empty()) {
-                return;
-            }
+            void parseField(std::string_view line, Entity& entity) {
+                EntityField field;
+                std::string content = trim(line);
 
-            // Check for primary key marker (*)
-            if (content.find("*") == 0) {
-                field.isPrimaryKey = true;
-                content = trim(content.substr(1));
-            }
+                // Skip separator lines
+                if (content == "--" || content.empty()) {
+                    return;
+                }
 
-            // Check for foreign key marker (+)
-            if (content.find("+") == 0) {
-                field.isForeignKey = true;
-                content = trim(content.substr(1));
+                // Check for primary key marker (*)
+                if (content.find("*") == 0) {
+                    field.isPrimaryKey = true;
+                    content = trim(content.substr(1));
+                }
+
+                // Check for foreign key marker (+)
+                if (content.find("+") == 0) {
+                    field.isForeignKey = true;
+                    content = trim(content.substr(1));
+                }
+
+                // Check for unique marker (#)
+                if (content.find("#") == 0) {
+                    field.isUnique = true;
+                    content = trim(content.substr(1));
+                }
+
+                // Parse field name : type
+                size_t colonPos = content.find(":");
+                if (colonPos != std::string::npos) {
+                    field.name = trim(content.substr(0, colonPos));
+                    std::string typeStr = trim(content.substr(colonPos + 1));
+                    
+                    // Check for constraints in angle brackets
+                    size_t bracketPos = typeStr.find("<");
+                    if (bracketPos != std::string::npos) {
+                        field.type = trim(typeStr.substr(0, bracketPos));
+                        size_t closeBracket = typeStr.find(">", bracketPos);
+                        if (closeBracket != std::string::npos) {
+                            std::string constraints = typeStr.substr(bracketPos + 1, closeBracket - bracketPos - 1);
+                            parseConstraints(constraints, field);
+                        }
+                    } else {
+                        field.type = typeStr;
+                    }
+                } else {
+                    // Just field name
+                    field.name = content;
+                }
+
+                // Set constraint flags
+                if (field.isPrimaryKey) {
+                    field.constraints.push_back(EntityFieldType::PrimaryKey);
+                    field.isNotNull = true;
+                }
+                if (field.isForeignKey) {
+                    field.constraints.push_back(EntityFieldType::ForeignKey);
+                }
+                if (field.isUnique) {
+                    field.constraints.push_back(EntityFieldType::Unique);
+                }
+                if (field.isNotNull) {
+                    field.constraints.push_back(EntityFieldType::NotNull);
+                }
+
+                entity.fields.push_back(std::move(field));
             }
 
-            // Check for unique marker (#)
-            if (content.find("#") == 0) {
-                field.isUnique = true;
-                content = trim(content.substr(1));
+            void parseConstraints(const std::string& constraints, EntityField& field) {
+                std::istringstream stream(constraints);
+                std::string constraint;
+                while (std::getline(stream, constraint, ',')) {
+                    constraint = trim(constraint);
+                    if (constraint == "PK" || constraint == "pk") {
+                        field.isPrimaryKey = true;
+                    } else if (constraint == "FK" || constraint == "fk") {
+                        field.isForeignKey = true;
+                    } else if (constraint == "UK" || constraint == "unique") {
+                        field.isUnique = true;
+                    } else if (constraint == "NOT NULL" || constraint == "notnull") {
+                        field.isNotNull = true;
+                    }
+                }
             }
 
-            // Parse field name : type
-            size_t colonPos = content.find(":");
-            if (colonPos != std::string::npos) {
-                field.name = trim(content.substr(0, colonPos));
-                std::string typeStr = trim(content.substr(colonPos + 1));
+            void parseRelationshipLine(std::string_view line) {
+                EntityRelationship rel;
                 
-                // Check for constraints in angle brackets
-                size_t bracketPos = typeStr.find("<");
-                if (bracketPos != std::string::npos) {
-                    field.type = trim(typeStr.substr(0, bracketPos));
-                    size_t closeBracket = typeStr.find(">", bracketPos);
-                    if (closeBracket != std::string::npos) {
-                        std::string constraints = typeStr.substr(bracketPos + 1, closeBracket - bracketPos - 1);
-                        parseConstraints(constraints, field);
+                // Look for relationship patterns like: Entity1 ||--o{ Entity2
+                // Pattern: [Entity] [leftCard] -- [rightCard] [Entity]
+                
+                static const std::regex relRegex(R"((\w+)\s*(\|\||\|o|\}o|\}\|)\s*-+\s*(\|\||o\||o\{|\|\{|\|o|\}o|\}\|)\s*(\w+))");
+                static const std::regex simpleRegex(R"((\w+)\s*-+\s*(\w+))");
+                std::cmatch match;
+                
+                if (std::regex_search(line.data(), line.data() + line.size(), match, relRegex)) {
+                    rel.fromEntity = match[1].str();
+                    rel.fromCardinality = parseCardinality(match[2].str());
+                    rel.toCardinality = parseCardinality(match[3].str());
+                    rel.toEntity = match[4].str();
+                    rel.type = determineRelationType(rel.fromCardinality, rel.toCardinality);
+                    
+                    // Look for label
+                    size_t colonPos = line.find(":");
+                    if (colonPos != std::string::npos) {
+                        rel.label = trim(line.substr(colonPos + 1));
                     }
+                    
+                    if (callbacks.onRelationship) callbacks.onRelationship(rel);
                 } else {
-                    field.type = typeStr;
+                    // Try simpler pattern: Entity1 -- Entity2
+                    if (std::regex_search(line.data(), line.data() + line.size(), match, simpleRegex)) {
+                        rel.fromEntity = match[1].str();
+                        rel.toEntity = match[2].str();
+                        rel.type = EntityRelationType::OneToMany;
+                        if (callbacks.onRelationship) callbacks.onRelationship(rel);
+                    }
                 }
-            } else {
-                // Just field name
-                field.name = content;
             }
 
-            // Set constraint flags
-            if (field.isPrimaryKey) {
-                field.constraints.push_back(EntityFieldType::PrimaryKey);
-                field.isNotNull = true;
-            }
-            if (field.isForeignKey) {
-                field.constraints.push_back(EntityFieldType::ForeignKey);
-            }
-            if (field.isUnique) {
-                field.constraints.push_back(EntityFieldType::Unique);
-            }
-            if (field.isNotNull) {
-                field.constraints.push_back(EntityFieldType::NotNull);
+            void parseNote(std::string_view line) {
+                // Simple note parsing
+                if (line.find("note") != std::string::npos) {
+                    size_t ofPos = line.find(" of ");
+                    if (ofPos != std::string::npos) {
+                        std::string entityName = trim(line.substr(ofPos + 4));
+                        if (callbacks.onNote) callbacks.onNote(entityName, "Note"); // Simplified
+                    }
+                }
             }
+        };
+    }
+
+    // Implementation class
+    class PUMLEntityParser::Impl {
+    public:
+        std::vector<Entity> entities;
+        std::vector<EntityRelationship> relationships;
+        std::map<std::string, std::string> notes;
+        std::vector<std::string> warnings;
+        std::string title;
 
-            entity.fields.push_back(field);
+        // The model of the last parse, for the exports
+        DiagramExport::EntityDiagramView view() const {
+            return DiagramExport::EntityDiagramView{ title, entities, relationships, notes };
         }
 
-        void parseConstraints(const std::string& constraints, EntityField& field) {
-            std::istringstream stream(constraints);
-            std::string constraint;
-            while (std::getline(stream, constraint, ',')) {
-                constraint = trim(constraint);
-                if (constraint == "PK" || constraint == "pk") {
-                    field.isPrimaryKey = true;
-                } else if (constraint == "FK" || constraint == "fk") {
-                    field.isForeignKey = true;
-                } else if (constraint == "UK" || constraint == "unique") {
-                    field.isUnique = true;
-                } else if (constraint == "NOT NULL" || constraint == "notnull") {
-                    field.isNotNull = true;
+        PUMLEntityDiagramResult parse(std::string_view content) {
+            PUMLEntityDiagramResult result;
+            result.success = true;
+
+            entities.clear();
+            relationships.clear();
+            notes.clear();
+            warnings.clear();
+            title.clear();
+
+            PUMLEntityCallbacks callbacks;
+            callbacks.onEntity = [this](Entity& entity) { entities.push_back(std::move(entity)); };
+            callbacks.onRelationship = [this](EntityRelationship& rel) { relationships.push_back(std::move(rel)); };
+            callbacks.onNote = [this](const std::string& key, const std::string& text) { notes[key] = text; };
+            callbacks.onTitle = [this, &result](const std::string& text) {
+                title = text;
+                result.title = text;
+            };
+
+            try {
+                EntityLineParser lineParser(callbacks);
+                size_t linePos = 0;
+                std::string_view rawLine;
+
+                // Lines are views into the content; nothing is copied per line
+                while (nextLine(content, linePos, rawLine)) {
+                    lineParser.parseLine(rawLine);
                 }
+
+                // Save last entity if needed
+                lineParser.finishEntity();
+
+                result.entities = entities;
+                result.relationships = relationships;
+                result.notes = notes;
+
+            } catch (const std::exception& e) {
+                result.success = false;
+                result.errorMessage = std::string("Parsing error: ") + e.what();
             }
+
+            indexEntities();
+            return result;
         }
 
-        void parseRelationshipLine(const std::string& line) {
-            EntityRelationship rel;
-            
-            // Look for relationship patterns like: Entity1 ||--o{ Entity2
-            // Pattern: [Entity] [leftCard] -- [rightCard] [Entity]
-            
-            std::regex relRegex(R"((\w+)\s*(\|\||\|o|\}o|\}\|)\s*-+\s*(\|\||\|o|\}o|\}\|)\s*(\w+))");
-            std::smatch match;
-            
-            if (std::regex_search(line, match, relRegex)) {
-                rel.fromEntity = match[1].str();
-                rel.fromCardinality = parseCardinality(match[2].str());
-                rel.toCardinality = parseCardinality(match[3].str());
-                rel.toEntity = match[4].str();
-                rel.type = determineRelationType(rel.fromCardinality, rel.toCardinality);
-                
-                // Look for label
-                size_t colonPos = line.find(":");
-                if (colonPos != std::string::npos) {
-                    rel.label = trim(line.substr(colonPos + 1));
+        const Entity* findEntity(std::string_view name) const {
+            size_t position = entityIndex.find(name);
+            return position == NameIndex::npos ? nullptr : &entities[position];
+        }
+
+    private:
+        NameIndex entityIndex;      // Name, alias and schema-qualified name -> position in entities
+
+        void indexEntities() {
+            entityIndex.clear();
+            entityIndex.reserve(entities.size() * 2);
+            for (size_t i = 0; i < entities.size(); ++i) {
+                entityIndex.insert(entities[i].name, i);
+                entityIndex.insert(entities[i].alias, i);
+                if (!entities[i].schema.empty()) {
+                    entityIndex.insertCopy(entities[i].schema + "." + entities[i].name, i);
                 }
-                
-                relationships.push_back(rel);
-            } else {
-                // Try simpler pattern: Entity1 -- Entity2
-                std::regex simpleRegex(R"((\w+)\s*-+\s*(\w+))");
-                if (std::regex_search(line, match, simpleRegex)) {
-                    rel.fromEntity = match[1].str();
-                    rel.toEntity = match[2].str();
-                    rel.type = EntityRelationType::OneToMany;
-                    relationships.push_back(rel);
+            }
+        }
+    };
+
+    class PUMLEntityStreamParser::Impl {
+    public:
+        PUMLEntityCallbacks callbacks;
+        EntityLineParser lineParser;
+        std::string pending;        // Start of a line continued by the next chunk
+        std::string errorMessage;
+        size_t lineCount;
+        bool bFailed;
+
+        explicit Impl(PUMLEntityCallbacks callbacks)
+            : callbacks(std::move(callbacks)), lineParser(this->callbacks), lineCount(0), bFailed(false) {}
+
+        void reset() {
+            lineParser.reset();
+            pending.clear();
+            errorMessage.clear();
+            lineCount = 0;
+            bFailed = false;
+        }
+
+        bool fail(const std::exception& e) {
+            bFailed = true;
+            errorMessage = std::string("Parsing error at line ") + std::to_string(lineCount + 1) + ": " + e.what();
+            pending.clear();
+            return false;
+        }
+
+        bool feed(std::string_view chunk) {
+            if (bFailed) return false;
+            try {
+                size_t pos = 0;
+                while (pos < chunk.size()) {
+                    size_t end = chunk.find('\n', pos);
+                    if (end == std::string_view::npos) {
+                        // Incomplete line: keep it for the next chunk
+                        pending.append(chunk.data() + pos, chunk.size() - pos);
+                        break;
+                    }
+                    if (pending.empty()) {
+                        lineParser.parseLine(chunk.substr(pos, end - pos));
+                    } else {
+                        pending.append(chunk.data() + pos, end - pos);
+                        lineParser.parseLine(pending);
+                        pending.clear();
+                    }
+                    lineCount++;
+                    pos = end + 1;
                 }
+            } catch (const std::exception& e) {
+                return fail(e);
             }
+            return true;
         }
 
-        void parseNote(const std::string& line) {
-            // Simple note parsing
-            if (line.find("note") != std::string::npos) {
-                size_t ofPos = line.find(" of ");
-                if (ofPos != std::string::npos) {
-                    std::string entityName = trim(line.substr(ofPos + 4));
-                    notes[entityName] = "Note"; // Simplified
+        bool finish() {
+            if (bFailed) return false;
+            try {
+                // Last line without '\n', then an entity left open by missing "}" or @enduml
+                if (!pending.empty()) {
+                    lineParser.parseLine(pending);
+                    pending.clear();
+                    lineCount++;
                 }
+                lineParser.finishEntity();
+            } catch (const std::exception& e) {
+                return fail(e);
             }
+            return true;
         }
     };
 
@@ -317,20 +552,19 @@ namespace UFMTooling {
     PUMLEntityParser::~PUMLEntityParser() = default;
 
     PUMLEntityDiagramResult PUMLEntityParser::parseFile(const std::string& filePath) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
+        // Parse straight out of the mapped file; nothing is copied before scanning
+        MappedFile file;
+        if (!file.open(filePath)) {
             PUMLEntityDiagramResult result;
             result.success = false;
             result.errorMessage = "Could not open file: " + filePath;
             return result;
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return parseContent(buffer.str());
+        return pImpl->parse(file.view());
     }
 
-    PUMLEntityDiagramResult PUMLEntityParser::parseContent(const std::string& content) {
+    PUMLEntityDiagramResult PUMLEntityParser::parseContent(std::string_view content) {
         return pImpl->parse(content);
     }
 
@@ -343,104 +577,121 @@ namespace UFMTooling {
     }
 
     const Entity* PUMLEntityParser::findEntity(const std::string& entityName) const {
-        for (const auto& entity : pImpl->entities) {
-            if (entity.name == entityName || entity.alias == entityName) {
-                return &entity;
-            }
-        }
-        return nullptr;
+        return pImpl->findEntity(entityName);
     }
 
-    std::string PUMLEntityParser::exportToJson() const {
-        // Basic JSON export
-        std::stringstream json;
-        json << "{\n";
-        json << "  \"entities\": [\n";
-        
-        for (size_t i = 0; i < pImpl->entities.size(); ++i) {
-            const auto& entity = pImpl->entities[i];
-            json << "    {\n";
-            json << "      \"name\": \"" << entity.name << "\",\n";
-            json << "      \"fields\": [\n";
-            
-            for (size_t j = 0; j < entity.fields.size(); ++j) {
-                const auto& field = entity.fields[j];
-                json << "        {\n";
-                json << "          \"name\": \"" << field.name << "\",\n";
-                json << "          \"type\": \"" << field.type << "\",\n";
-                json << "          \"isPrimaryKey\": " << (field.isPrimaryKey ? "true" : "false") << "\n";
-                json << "        }";
-                if (j < entity.fields.size() - 1) json << ",";
-                json << "\n";
-            }
-            
-            json << "      ]\n";
-            json << "    }";
-            if (i < pImpl->entities.size() - 1) json << ",";
-            json << "\n";
-        }
-        
-        json << "  ]\n";
-        json << "}\n";
-        return json.str();
+    std::string PUMLEntityParser::exportToJson(bool bPretty) const {
+        std::string output;
+        JsonWriter writer(output, bPretty);
+        DiagramExport::writeJson(pImpl->view(), writer);
+        return output;
     }
 
-    std::string PUMLEntityParser::exportToXML() const {
-        // Basic XML export
-        std::stringstream xml;
-        xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-        xml << "<EntityDiagram>\n";
-        
-        for (const auto& entity : pImpl->entities) {
-            xml << "  <Entity name=\"" << entity.name << "\">\n";
-            for (const auto& field : entity.fields) {
-                xml << "    <Field name=\"" << field.name << "\" ";
-                xml << "type=\"" << field.type << "\" ";
-                xml << "isPrimaryKey=\"" << (field.isPrimaryKey ? "true" : "false") << "\" />\n";
-            }
-            xml << "  </Entity>\n";
-        }
-        
-        xml << "</EntityDiagram>\n";
-        return xml.str();
+    bool PUMLEntityParser::exportToJson(std::ostream& out, bool bPretty) const {
+        JsonWriter writer(out, bPretty);
+        DiagramExport::writeJson(pImpl->view(), writer);
+        writer.flush();
+        return writer.good();
+    }
+
+    std::string PUMLEntityParser::exportToXML(bool bPretty) const {
+        std::string output;
+        XmlWriter writer(output, bPretty);
+        DiagramExport::writeXml(pImpl->view(), writer);
+        return output;
+    }
+
+    bool PUMLEntityParser::exportToXML(std::ostream& out, bool bPretty) const {
+        XmlWriter writer(out, bPretty);
+        DiagramExport::writeXml(pImpl->view(), writer);
+        writer.flush();
+        return writer.good();
     }
 
     std::string PUMLEntityParser::exportToDDL(const std::string& dialect) const {
-        // Generate SQL DDL
-        (void)dialect; // Suppress unused parameter warning
-        std::stringstream ddl;
-        
-        for (const auto& entity : pImpl->entities) {
-            ddl << "CREATE TABLE " << entity.name << " (\n";
-            
-            for (size_t i = 0; i < entity.fields.size(); ++i) {
-                const auto& field = entity.fields[i];
-                ddl << "    " << field.name << " " << field.type;
-                
-                if (field.isPrimaryKey) {
-                    ddl << " PRIMARY KEY";
-                }
-                if (field.isNotNull && !field.isPrimaryKey) {
-                    ddl << " NOT NULL";
-                }
-                if (field.isUnique && !field.isPrimaryKey) {
-                    ddl << " UNIQUE";
-                }
-                
-                if (i < entity.fields.size() - 1) {
-                    ddl << ",";
-                }
-                ddl << "\n";
-            }
-            
-            ddl << ");\n\n";
-        }
-        
-        return ddl.str();
+        DDLOptions options;
+        dialectFromString(dialect, options.dialect);
+        return exportToDDL(options);
+    }
+
+    std::string PUMLEntityParser::exportToDDL(const DDLOptions& options) const {
+        std::string ddl;
+        exportToDDL(options, [&ddl](const DDLStatement& statement) {
+            ddl += statement.sql;
+            return true;
+        });
+        return ddl;
+    }
+
+    bool PUMLEntityParser::exportToDDL(std::ostream& out, const DDLOptions& options) const {
+        return exportToDDL(options, [&out](const DDLStatement& statement) {
+            out.write(statement.sql.data(), static_cast<std::streamsize>(statement.sql.size()));
+            return static_cast<bool>(out);
+        });
+    }
+
+    bool PUMLEntityParser::exportToDDL(const DDLOptions& options, const DDLStatementSink& sink) const {
+        return DDL::generate(pImpl->entities, pImpl->relationships, options, sink);
+    }
+
+    bool PUMLEntityParser::dialectFromString(const std::string& name, SQLDialect& dialect) {
+        std::string key = name;
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (key == "sql" || key == "generic" || key.empty()) dialect = SQLDialect::Generic;
+        else if (key == "postgresql" || key == "postgres") dialect = SQLDialect::PostgreSQL;
+        else if (key == "mysql" || key == "mariadb") dialect = SQLDialect::MySQL;
+        else if (key == "sqlserver" || key == "mssql") dialect = SQLDialect::SQLServer;
+        else if (key == "sqlite") dialect = SQLDialect::SQLite;
+        else return false;
+        return true;
     }
 
     const std::vector<std::string>& PUMLEntityParser::getWarnings() const {
         return pImpl->warnings;
     }
 
+    // PUMLEntityStreamParser implementation
+    PUMLEntityStreamParser::PUMLEntityStreamParser(PUMLEntityCallbacks callbacks)
+        : pImpl(new Impl(std::move(callbacks))) {}
+
+    PUMLEntityStreamParser::~PUMLEntityStreamParser() = default;
+
+    bool PUMLEntityStreamParser::feed(std::string_view chunk) {
+        return pImpl->feed(chunk);
+    }
+
+    bool PUMLEntityStreamParser::finish() {
+        return pImpl->finish();
+    }
+
+    bool PUMLEntityStreamParser::parseStream(std::istream& in, size_t chunkSize) {
+        std::vector<char> buffer(std::max<size_t>(chunkSize, 1));
+        while (in) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            std::streamsize bytes = in.gcount();
+            if (bytes > 0 && !feed(std::string_view(buffer.data(), static_cast<size_t>(bytes)))) {
+                return false;
+            }
+        }
+        if (in.bad()) {
+            pImpl->bFailed = true;
+            pImpl->errorMessage = "Read error after line " + std::to_string(pImpl->lineCount);
+            return false;
+        }
+        return finish();
+    }
+
+    void PUMLEntityStreamParser::reset() {
+        pImpl->reset();
+    }
+
+    size_t PUMLEntityStreamParser::getLineCount() const {
+        return pImpl->lineCount;
+    }
+
+    const std::string& PUMLEntityStreamParser::getErrorMessage() const {
+        return pImpl->errorMessage;
+    }
+
 } // namespace UFMTooling
@@ -0,0 +1,452 @@
+#include "ParseResultJson.h"
+#include "../include/MappedFile.h"
+#include "JsonReader.h"
+#include <climits>
+#include <unordered_map>
+
+namespace UFMTooling {
+    namespace JsonModel {
+
+        namespace {
+            // Read helpers tolerant of missing keys and mistyped values (older or
+            // hand-edited files): those read as defaults
+            void readInto(JsonReader& reader, std::string& out) {
+                std::string_view value;
+                if (reader.readString(value)) out.assign(value.data(), value.size());
+            }
+
+            void readInto(JsonReader& reader, InternedString& out) {
+                std::string_view value;
+                if (reader.readString(value)) out = value;
+            }
+
+            void readInto(JsonReader& reader, bool& out) {
+                reader.readBool(out);
+            }
+
+            void readInto(JsonReader& reader, AccessSpecifier& out) {
+                std::string_view value;
+                if (reader.readString(value)) out = accessSpecifierFromString(value);
+            }
+
+            void readInto(JsonReader& reader, int& out) {
+                long long value;
+                if (reader.readInteger(value) && value >= INT_MIN && value <= INT_MAX) out = static_cast<int>(value);
+            }
+
+            // Strings of an array; other values are skipped
+            void readStrings(JsonReader& reader, std::vector<std::string>& out) {
+                if (!reader.beginArray()) return;
+                while (reader.nextElement()) {
+                    std::string_view value;
+                    if (reader.readString(value)) out.emplace_back(value);
+                }
+            }
+
+            // An array of objects, each read by readMember(key, element) for every key
+            template <typename T, typename ReadMember>
+            void readObjects(JsonReader& reader, std::vector<T>& out, ReadMember readMember) {
+                if (!reader.beginArray()) return;
+                while (reader.nextElement()) {
+                    out.emplace_back();
+                    T& element = out.back();
+                    std::string_view key;
+                    if (!reader.beginObject()) continue;
+                    while (reader.nextKey(key)) {
+                        readMember(key, element);
+                    }
+                }
+            }
+
+            void readBaseClasses(JsonReader& reader, std::vector<BaseClassInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, BaseClassInfo& base) {
+                    if (key == "name") readInto(reader, base.name);
+                    else if (key == "access") readInto(reader, base.access);
+                    else reader.skipValue();
+                });
+            }
+
+            void readMembers(JsonReader& reader, std::vector<MemberInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, MemberInfo& member) {
+                    if (key == "name") readInto(reader, member.name);
+                    else if (key == "type") readInto(reader, member.type);
+                    else if (key == "access") readInto(reader, member.access);
+                    else if (key == "isStatic") readInto(reader, member.isStatic);
+                    else if (key == "isConst") readInto(reader, member.isConst);
+                    else if (key == "defaultValue") readInto(reader, member.defaultValue);
+                    else reader.skipValue();
+                });
+            }
+
+            void readParameters(JsonReader& reader, std::vector<ParameterInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, ParameterInfo& param) {
+                    if (key == "name") readInto(reader, param.name);
+                    else if (key == "type") readInto(reader, param.type);
+                    else if (key == "defaultValue") readInto(reader, param.defaultValue);
+                    else if (key == "isConst") readInto(reader, param.isConst);
+                    else if (key == "isReference") readInto(reader, param.isReference);
+                    else if (key == "isPointer") readInto(reader, param.isPointer);
+                    else reader.skipValue();
+                });
+            }
+
+            void readMethods(JsonReader& reader, std::vector<MethodInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, MethodInfo& method) {
+                    if (key == "name") readInto(reader, method.name);
+                    else if (key == "returnType") readInto(reader, method.returnType);
+                    else if (key == "access") readInto(reader, method.access);
+                    else if (key == "isStatic") readInto(reader, method.isStatic);
+                    else if (key == "isConst") readInto(reader, method.isConst);
+                    else if (key == "isVirtual") readInto(reader, method.isVirtual);
+                    else if (key == "isPureVirtual") readInto(reader, method.isPureVirtual);
+                    else if (key == "isConstructor") readInto(reader, method.isConstructor);
+                    else if (key == "isDestructor") readInto(reader, method.isDestructor);
+                    else if (key == "isOperator") readInto(reader, method.isOperator);
+                    else if (key == "parameters") readParameters(reader, method.parameters);
+                    else reader.skipValue();
+                });
+            }
+
+            void readClasses(JsonReader& reader, std::vector<ClassInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, ClassInfo& cls) {
+                    if (key == "name") readInto(reader, cls.name);
+                    else if (key == "fullName") readInto(reader, cls.fullName);
+                    else if (key == "isStruct") readInto(reader, cls.isStruct);
+                    else if (key == "isTemplate") readInto(reader, cls.isTemplate);
+                    else if (key == "baseClasses") readBaseClasses(reader, cls.baseClasses);
+                    else if (key == "members") readMembers(reader, cls.members);
+                    else if (key == "methods") readMethods(reader, cls.methods);
+                    else if (key == "templateParameters") readStrings(reader, cls.templateParameters);
+                    else if (key == "friendClasses") readStrings(reader, cls.friendClasses);
+                    else reader.skipValue();
+                });
+            }
+
+            void readEnums(JsonReader& reader, std::vector<EnumInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, EnumInfo& enumInfo) {
+                    if (key == "name") readInto(reader, enumInfo.name);
+                    else if (key == "isClass") readInto(reader, enumInfo.isClass);
+                    else if (key == "values") {
+                        readObjects(reader, enumInfo.values, [&](std::string_view valueKey, std::pair<std::string, std::string>& value) {
+                            if (valueKey == "name") readInto(reader, value.first);
+                            else if (valueKey == "value") readInto(reader, value.second);
+                            else reader.skipValue();
+                        });
+                    } else {
+                        reader.skipValue();
+                    }
+                });
+            }
+
+            // Namespace classes are stored by fullName: read as classes with only fullName
+            // set, replaced by copies of the file's classes in resolveNamespaces()
+            void readNamespaces(JsonReader& reader, std::vector<NamespaceInfo>& out) {
+                readObjects(reader, out, [&](std::string_view key, NamespaceInfo& ns) {
+                    if (key == "name") {
+                        readInto(reader, ns.name);
+                    } else if (key == "classes") {
+                        if (!reader.beginArray()) return;
+                        while (reader.nextElement()) {
+                            std::string_view fullName;
+                            if (!reader.readString(fullName)) continue;
+                            ns.classes.emplace_back();
+                            ns.classes.back().fullName.assign(fullName.data(), fullName.size());
+                        }
+                    } else if (key == "nestedNamespaces") {
+                        readNamespaces(reader, ns.nestedNamespaces);
+                    } else {
+                        reader.skipValue();
+                    }
+                });
+            }
+
+            void resolveNamespaces(std::vector<NamespaceInfo>& namespaces, const std::vector<ClassInfo>& classes,
+                                   const std::unordered_map<std::string_view, size_t>& classByFullName) {
+                for (auto& ns : namespaces) {
+                    std::vector<ClassInfo> resolved;
+                    for (const auto& placeholder : ns.classes) {
+                        auto found = classByFullName.find(placeholder.fullName);
+                        if (found != classByFullName.end()) resolved.push_back(classes[found->second]);
+                    }
+                    ns.classes.swap(resolved);
+                    resolveNamespaces(ns.nestedNamespaces, classes, classByFullName);
+                }
+            }
+        }
+
+        std::string accessSpecifierToString(AccessSpecifier access) {
+            switch (access) {
+                case AccessSpecifier::Public: return "public";
+                case AccessSpecifier::Protected: return "protected";
+                case AccessSpecifier::Private: return "private";
+                case AccessSpecifier::None: return "none";
+                default: return "unknown";
+            }
+        }
+
+        AccessSpecifier accessSpecifierFromString(std::string_view str) {
+            if (str == "public") return AccessSpecifier::Public;
+            if (str == "protected") return AccessSpecifier::Protected;
+            if (str == "private") return AccessSpecifier::Private;
+            return AccessSpecifier::None;
+        }
+
+        void writeClasses(const std::vector<ClassInfo>& classes, JsonWriter& writer) {
+            writer.beginArray();
+            for (const auto& cls : classes) {
+                writer.beginObject();
+
+                writer.key("baseClasses");
+                writer.beginArray();
+                for (const auto& base : cls.baseClasses) {
+                    writer.beginObject();
+                    writer.member("access", accessSpecifierToString(base.access));
+                    writer.member("name", base.name);
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.key("friendClasses");
+                writer.beginArray();
+                for (const auto& friendClass : cls.friendClasses) {
+                    writer.value(friendClass);
+                }
+                writer.endArray();
+
+                writer.member("fullName", cls.fullName);
+                writer.member("isStruct", cls.isStruct);
+                writer.member("isTemplate", cls.isTemplate);
+
+                writer.key("members");
+                writer.beginArray();
+                for (const auto& member : cls.members) {
+                    writer.beginObject();
+                    writer.member("access", accessSpecifierToString(member.access));
+                    writer.member("defaultValue", member.defaultValue);
+                    writer.member("isConst", member.isConst);
+                    writer.member("isStatic", member.isStatic);
+                    writer.member("name", member.name);
+                    writer.member("type", member.type);
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.key("methods");
+                writer.beginArray();
+                for (const auto& method : cls.methods) {
+                    writer.beginObject();
+                    writer.member("access", accessSpecifierToString(method.access));
+                    writer.member("isConst", method.isConst);
+                    writer.member("isConstructor", method.isConstructor);
+                    writer.member("isDestructor", method.isDestructor);
+                    writer.member("isOperator", method.isOperator);
+                    writer.member("isPureVirtual", method.isPureVirtual);
+                    writer.member("isStatic", method.isStatic);
+                    writer.member("isVirtual", method.isVirtual);
+                    writer.member("name", method.name);
+
+                    writer.key("parameters");
+                    writer.beginArray();
+                    for (const auto& param : method.parameters) {
+                        writer.beginObject();
+                        writer.member("defaultValue", param.defaultValue);
+                        writer.member("isConst", param.isConst);
+                        writer.member("isPointer", param.isPointer);
+                        writer.member("isReference", param.isReference);
+                        writer.member("name", param.name);
+                        writer.member("type", param.type);
+                        writer.endObject();
+                    }
+                    writer.endArray();
+
+                    writer.member("returnType", method.returnType);
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.member("name", cls.name);
+
+                writer.key("templateParameters");
+                writer.beginArray();
+                for (const auto& tparam : cls.templateParameters) {
+                    writer.value(tparam);
+                }
+                writer.endArray();
+
+                writer.endObject();
+            }
+            writer.endArray();
+        }
+
+        void writeEnums(const std::vector<EnumInfo>& enums, JsonWriter& writer) {
+            writer.beginArray();
+            for (const auto& enumInfo : enums) {
+                writer.beginObject();
+                writer.member("isClass", enumInfo.isClass);
+                writer.member("name", enumInfo.name);
+
+                writer.key("values");
+                writer.beginArray();
+                for (const auto& value : enumInfo.values) {
+                    writer.beginObject();
+                    writer.member("name", value.first);
+                    writer.member("value", value.second);
+                    writer.endObject();
+                }
+                writer.endArray();
+
+                writer.endObject();
+            }
+            writer.endArray();
+        }
+
+        void writeIncludes(const std::vector<std::string>& includes, JsonWriter& writer) {
+            writer.beginArray();
+            for (const auto& include : includes) {
+                writer.value(include);
+            }
+            writer.endArray();
+        }
+
+        void writeNamespaces(const std::vector<NamespaceInfo>& namespaces, JsonWriter& writer) {
+            writer.beginArray();
+            for (const auto& ns : namespaces) {
+                writer.beginObject();
+                // Classes by fullName; their contents are in the file's "classes"
+                writer.key("classes");
+                writer.beginArray();
+                for (const auto& cls : ns.classes) {
+                    writer.value(cls.fullName);
+                }
+                writer.endArray();
+                writer.member("name", ns.name);
+                writer.key("nestedNamespaces");
+                writeNamespaces(ns.nestedNamespaces, writer);
+                writer.endObject();
+            }
+            writer.endArray();
+        }
+
+        void writeParseResult(const ParseResult& result, JsonWriter& writer) {
+            writer.key("classes");
+            writeClasses(result.classes, writer);
+            writer.key("enums");
+            writeEnums(result.enums, writer);
+            writer.key("includes");
+            writeIncludes(result.includes, writer);
+            writer.key("namespaces");
+            writeNamespaces(result.namespaces, writer);
+        }
+
+        bool readParseResultMember(std::string_view key, JsonReader& reader, ParseResult& result) {
+            if (key == "classes") readClasses(reader, result.classes);
+            else if (key == "enums") readEnums(reader, result.enums);
+            else if (key == "includes") readStrings(reader, result.includes);
+            else if (key == "namespaces") readNamespaces(reader, result.namespaces);
+            else return false;
+            return true;
+        }
+
+        void resolveNamespaces(ParseResult& result) {
+            if (result.namespaces.empty()) return;
+            std::unordered_map<std::string_view, size_t> classByFullName;
+            for (size_t i = 0; i < result.classes.size(); ++i) {
+                classByFullName.emplace(result.classes[i].fullName, i);
+            }
+            resolveNamespaces(result.namespaces, result.classes, classByFullName);
+        }
+
+        void beginExplorerResult(const std::string& errorMessage, JsonWriter& writer) {
+            writer.beginObject();
+            writer.member("errorMessage", errorMessage);
+            writer.key("files");
+            writer.beginArray();
+        }
+
+        void writeAnalysis(const SourceFileAnalysis& analysis, JsonWriter& writer) {
+            static const ParseResult emptyResult;
+            const ParseResult& parseResult = analysis.parseResult ? *analysis.parseResult : emptyResult;
+
+            writer.beginObject();
+            writer.key("classes");
+            writeClasses(parseResult.classes, writer);
+            writer.key("enums");
+            writeEnums(parseResult.enums, writer);
+            writer.member("errorMessage", analysis.errorMessage);
+            writer.member("filename", analysis.filename);
+            writer.key("includes");
+            writeIncludes(parseResult.includes, writer);
+            writer.key("namespaces");
+            writeNamespaces(parseResult.namespaces, writer);
+            writer.member("path", analysis.path);
+            writer.member("success", analysis.success);
+            writer.endObject();
+        }
+
+        void endExplorerResult(const SourceExplorerResult& result, JsonWriter& writer) {
+            writer.endArray();
+            writer.member("filesProcessed", result.filesProcessed);
+            writer.member("filesWithErrors", result.filesWithErrors);
+            writer.member("success", result.success);
+            writer.endObject();
+        }
+
+        bool readExplorerResult(JsonReader& reader, SourceExplorerResult& result, const SourceFileVisitor* visitor) {
+            if (!reader.beginObject()) return false;
+            std::string_view key;
+            while (reader.nextKey(key)) {
+                if (key == "errorMessage") readInto(reader, result.errorMessage);
+                else if (key == "success") readInto(reader, result.success);
+                else if (key == "filesProcessed") readInto(reader, result.filesProcessed);
+                else if (key == "filesWithErrors") readInto(reader, result.filesWithErrors);
+                else if (key != "files") reader.skipValue();
+                else if (reader.beginArray()) {
+                    while (reader.nextElement()) {
+                        SourceFileAnalysis analysis;
+                        auto parseResult = std::make_shared<ParseResult>();
+                        if (reader.beginObject()) {
+                            std::string_view fileKey;
+                            while (reader.nextKey(fileKey)) {
+                                if (fileKey == "path") readInto(reader, analysis.path);
+                                else if (fileKey == "filename") readInto(reader, analysis.filename);
+                                else if (fileKey == "success") readInto(reader, analysis.success);
+                                else if (fileKey == "errorMessage") readInto(reader, analysis.errorMessage);
+                                else if (!readParseResultMember(fileKey, reader, *parseResult)) reader.skipValue();
+                            }
+                        }
+                        if (reader.failed()) return false;
+                        resolveNamespaces(*parseResult);
+                        parseResult->fileName = analysis.path;
+                        parseResult->success = analysis.success;
+                        parseResult->errorMessage = analysis.errorMessage;
+                        analysis.parseResult = std::move(parseResult);
+
+                        if (visitor == nullptr) {
+                            result.analyses.push_back(std::move(analysis));
+                        } else if (!(*visitor)(analysis)) {
+                            return true;        // Stopped by the visitor
+                        }
+                    }
+                }
+            }
+            return reader.finish();
+        }
+
+        bool readExplorerResultFile(const std::string& filePath, SourceExplorerResult& result,
+                                    const SourceFileVisitor* visitor, std::string& errorMessage) {
+            MappedFile file;
+            if (!file.open(filePath)) {
+                errorMessage = file.getErrorMessage();
+                return false;
+            }
+            JsonReader reader(file.view());
+            if (readExplorerResult(reader, result, visitor)) {
+                return true;
+            }
+            errorMessage = reader.failed() ? "Could not parse " + filePath + ": " + reader.getErrorMessage()
+                                           : "Not a SourceExplorer JSON export: " + filePath;
+            return false;
+        }
+
+    } // namespace JsonModel
+} // namespace UFMTooling
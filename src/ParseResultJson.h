@@ -0,0 +1,64 @@
+#ifndef PARSE_RESULT_JSON_H
+#define PARSE_RESULT_JSON_H
+
+// Internal helpers: conversion between ParseResult and the JSON layout
+// written by SourceExplorer::exportToJson (shared with AnalysisCache and
+// ResultSnapshot).
+// Writers emit keys in sorted order, the order nlohmann::json itself uses;
+// readers pull from a JsonReader and accept the keys in any order.
+
+#include "../include/SimpleHeaderParser.h"
+#include "../include/SourceExplorer.h"
+#include "../include/JsonWriter.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace UFMTooling {
+
+    class JsonReader;
+
+    namespace JsonModel {
+
+        std::string accessSpecifierToString(AccessSpecifier access);
+        AccessSpecifier accessSpecifierFromString(std::string_view str);
+
+        // Write a result's arrays as JSON array values
+        void writeClasses(const std::vector<ClassInfo>& classes, JsonWriter& writer);
+        void writeEnums(const std::vector<EnumInfo>& enums, JsonWriter& writer);
+        void writeIncludes(const std::vector<std::string>& includes, JsonWriter& writer);
+        void writeNamespaces(const std::vector<NamespaceInfo>& namespaces, JsonWriter& writer);
+
+        // Write the "classes", "enums", "includes" and "namespaces" members into the currently open object
+        void writeParseResult(const ParseResult& result, JsonWriter& writer);
+
+        // Read the value of key into result if key is "classes", "enums", "includes" or
+        // "namespaces" (else false, the value left unread). Call resolveNamespaces() once
+        // the object is read: namespaces refer to the classes by fullName.
+        bool readParseResultMember(std::string_view key, JsonReader& reader, ParseResult& result);
+
+        // Replace the classes of result's namespaces, placeholders with only fullName set,
+        // by copies of the file's classes of that fullName
+        void resolveNamespaces(ParseResult& result);
+
+        // SourceExplorerResult document. Top-level keys in sorted order (errorMessage,
+        // files, filesProcessed, filesWithErrors, success), so the counters can follow
+        // streamed files: beginExplorerResult, writeAnalysis per file, endExplorerResult.
+        void beginExplorerResult(const std::string& errorMessage, JsonWriter& writer);
+        void writeAnalysis(const SourceFileAnalysis& analysis, JsonWriter& writer);
+        void endExplorerResult(const SourceExplorerResult& result, JsonWriter& writer);
+
+        // Read a SourceExplorerResult document back (parse results are never null). With a
+        // visitor, each analysis goes to it instead of result.analyses, and reading stops
+        // when it returns false. False if the text is not such a document or is malformed.
+        bool readExplorerResult(JsonReader& reader, SourceExplorerResult& result, const SourceFileVisitor* visitor = nullptr);
+
+        // Same, from a file written by SourceExplorer::exportToJsonFile(), mapped while it
+        // is read; false with errorMessage set if it cannot be opened or read
+        bool readExplorerResultFile(const std::string& filePath, SourceExplorerResult& result,
+                                    const SourceFileVisitor* visitor, std::string& errorMessage);
+
+    } // namespace JsonModel
+} // namespace UFMTooling
+
+#endif // PARSE_RESULT_JSON_H
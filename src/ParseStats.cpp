@@ -0,0 +1,380 @@
+#include "../include/ParseStats.h"
+#include "../include/JsonWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace UFMTooling {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // Stages timed per file, in the order they run
+        const ParseStage fileStages[] = {ParseStage::Read, ParseStage::Tokenize, ParseStage::ParseClasses,
+                                         ParseStage::ParseEnums};
+
+        // The same stages in key order, for the per-file JSON objects
+        const ParseStage fileStageKeys[] = {ParseStage::ParseClasses, ParseStage::ParseEnums, ParseStage::Read,
+                                            ParseStage::Tokenize};
+
+        // A stage run that is not tied to one file
+        struct StageSpan {
+            ParseStage stage;
+            double startMs;
+            double durationMs;
+            std::string detail;
+            unsigned int thread;
+        };
+
+        bool slower(const FileParseStats& a, const FileParseStats& b) {
+            return a.totalMs > b.totalMs;
+        }
+
+        void addStage(ParseStageStats& stats, double ms) {
+            stats.count++;
+            stats.totalMs += ms;
+            stats.maxMs = std::max(stats.maxMs, ms);
+        }
+
+        void writeFile(const FileParseStats& file, JsonWriter& writer) {
+            writer.beginObject();
+            writer.member("allocatedBytes", file.allocatedBytes);
+            writer.member("allocations", file.allocations);
+            writer.member("bytes", file.bytes);
+            writer.member("classes", file.classes);
+            writer.member("enums", file.enums);
+            writer.member("lines", file.lines);
+            writer.member("methods", file.methods);
+            writer.member("path", file.path);
+            writer.key("stagesMs");
+            writer.beginObject();
+            for (ParseStage stage : fileStageKeys) {
+                writer.member(parseStageName(stage), file.stage(stage));
+            }
+            writer.endObject();
+            writer.member("startMs", file.startMs);
+            writer.member("success", file.success);
+            writer.member("thread", file.thread);
+            writer.member("totalMs", file.totalMs);
+            writer.endObject();
+        }
+
+        // One complete ("X") trace event; times in microseconds
+        void beginTraceEvent(JsonWriter& writer, const char* category, const std::string& name,
+                             double startMs, double durationMs, unsigned int thread) {
+            writer.beginObject();
+            writer.member("cat", category);
+            writer.member("dur", durationMs * 1000.0);
+            writer.member("name", name);
+            writer.member("ph", "X");
+            writer.member("pid", 1);
+            writer.member("tid", thread);
+            writer.member("ts", startMs * 1000.0);
+        }
+
+        template <typename Writer>
+        bool writeToFile(const std::string& filePath, Writer write) {
+            try {
+                std::ofstream outFile(filePath, std::ios::binary);
+                if (!outFile.is_open()) {
+                    return false;
+                }
+                return write(outFile);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    }
+
+    const char* parseStageName(ParseStage stage) {
+        switch (stage) {
+            case ParseStage::Walk: return "walk";
+            case ParseStage::Read: return "read";
+            case ParseStage::Tokenize: return "tokenize";
+            case ParseStage::ParseClasses: return "parseClasses";
+            case ParseStage::ParseEnums: return "parseEnums";
+            case ParseStage::Export: return "export";
+            default: return "unknown";
+        }
+    }
+
+    class ParseStats::Impl {
+    public:
+        ParseStatsOptions options;
+        Clock::time_point epoch;
+
+        mutable std::mutex mutex;
+        ParseStageStats stages[parseStageCount];
+        FileParseStats totals;
+        size_t fileCount;
+        std::vector<FileParseStats> files;
+        std::vector<FileParseStats> slowest;    // Min-heap on totalMs, at most options.slowestFiles
+        std::vector<StageSpan> spans;
+        std::vector<std::thread::id> threads;   // Index = small thread id
+
+        explicit Impl(const ParseStatsOptions& opts) : options(opts) {
+            clear();
+        }
+
+        void clear() {
+            epoch = Clock::now();
+            std::fill(std::begin(stages), std::end(stages), ParseStageStats());
+            totals = FileParseStats();
+            fileCount = 0;
+            files.clear();
+            slowest.clear();
+            spans.clear();
+            threads.clear();
+        }
+
+        // Called with the mutex held
+        unsigned int currentThread() {
+            std::thread::id id = std::this_thread::get_id();
+            auto it = std::find(threads.begin(), threads.end(), id);
+            if (it == threads.end()) {
+                threads.push_back(id);
+                return static_cast<unsigned int>(threads.size() - 1);
+            }
+            return static_cast<unsigned int>(it - threads.begin());
+        }
+
+        void addFile(FileParseStats file) {
+            std::lock_guard<std::mutex> lock(mutex);
+            file.thread = currentThread();
+
+            fileCount++;
+            totals.bytes += file.bytes;
+            totals.lines += file.lines;
+            totals.classes += file.classes;
+            totals.methods += file.methods;
+            totals.enums += file.enums;
+            totals.allocations += file.allocations;
+            totals.allocatedBytes += file.allocatedBytes;
+            totals.totalMs += file.totalMs;
+            for (ParseStage stage : fileStages) {
+                double ms = file.stage(stage);
+                totals.stage(stage) += ms;
+                if (ms > 0.0) {
+                    addStage(stages[static_cast<size_t>(stage)], ms);
+                }
+            }
+            if (options.slowestFiles > 0 &&
+                (slowest.size() < options.slowestFiles || file.totalMs > slowest.front().totalMs)) {
+                slowest.push_back(options.bRecordFiles ? file : std::move(file));
+                std::push_heap(slowest.begin(), slowest.end(), slower);
+                if (slowest.size() > options.slowestFiles) {
+                    std::pop_heap(slowest.begin(), slowest.end(), slower);
+                    slowest.pop_back();
+                }
+            }
+            if (options.bRecordFiles) {
+                files.push_back(std::move(file));
+            }
+        }
+
+        std::vector<FileParseStats> sortedSlowest() const {
+            std::vector<FileParseStats> sorted = slowest;
+            std::sort(sorted.begin(), sorted.end(), slower);
+            return sorted;
+        }
+
+        void writeJson(JsonWriter& writer) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            writer.beginObject();
+
+            writer.member("fileCount", fileCount);
+            if (options.bRecordFiles) {
+                writer.key("files");
+                writer.beginArray();
+                for (const auto& file : files) {
+                    writeFile(file, writer);
+                }
+                writer.endArray();
+            }
+
+            writer.key("slowestFiles");
+            writer.beginArray();
+            for (const auto& file : sortedSlowest()) {
+                writeFile(file, writer);
+            }
+            writer.endArray();
+
+            // In pipeline order
+            writer.key("stages");
+            writer.beginArray();
+            for (size_t i = 0; i < parseStageCount; ++i) {
+                writer.beginObject();
+                writer.member("count", stages[i].count);
+                writer.member("maxMs", stages[i].maxMs);
+                writer.member("name", parseStageName(static_cast<ParseStage>(i)));
+                writer.member("totalMs", stages[i].totalMs);
+                writer.endObject();
+            }
+            writer.endArray();
+
+            writer.key("totals");
+            writer.beginObject();
+            writer.member("allocatedBytes", totals.allocatedBytes);
+            writer.member("allocations", totals.allocations);
+            writer.member("bytes", totals.bytes);
+            writer.member("classes", totals.classes);
+            writer.member("enums", totals.enums);
+            writer.member("lines", totals.lines);
+            writer.member("methods", totals.methods);
+            writer.member("parseMs", totals.totalMs);
+            writer.endObject();
+
+            writer.endObject();
+        }
+
+        void writeTrace(JsonWriter& writer) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            writer.beginObject();
+            writer.member("displayTimeUnit", "ms");
+            writer.key("traceEvents");
+            writer.beginArray();
+
+            for (size_t t = 0; t < threads.size(); ++t) {
+                writer.beginObject();
+                writer.key("args");
+                writer.beginObject();
+                writer.member("name", "thread " + std::to_string(t));
+                writer.endObject();
+                writer.member("name", "thread_name");
+                writer.member("ph", "M");
+                writer.member("pid", 1);
+                writer.member("tid", t);
+                writer.endObject();
+            }
+
+            for (const auto& span : spans) {
+                beginTraceEvent(writer, "stage", parseStageName(span.stage), span.startMs, span.durationMs, span.thread);
+                if (!span.detail.empty()) {
+                    writer.key("args");
+                    writer.beginObject();
+                    writer.member("detail", span.detail);
+                    writer.endObject();
+                }
+                writer.endObject();
+            }
+
+            // A file event with its stages nested inside, laid out in the order they ran
+            const std::vector<FileParseStats>& traced = options.bRecordFiles ? files : slowest;
+            for (const auto& file : traced) {
+                beginTraceEvent(writer, "file", file.path, file.startMs, file.totalMs, file.thread);
+                writer.key("args");
+                writer.beginObject();
+                writer.member("allocations", file.allocations);
+                writer.member("bytes", file.bytes);
+                writer.member("classes", file.classes);
+                writer.member("lines", file.lines);
+                writer.member("methods", file.methods);
+                writer.member("success", file.success);
+                writer.endObject();
+                writer.endObject();
+
+                double startMs = file.startMs;
+                for (ParseStage stage : fileStages) {
+                    double ms = file.stage(stage);
+                    if (ms > 0.0) {
+                        beginTraceEvent(writer, "stage", parseStageName(stage), startMs, ms, file.thread);
+                        writer.endObject();
+                    }
+                    startMs += ms;
+                }
+            }
+
+            writer.endArray();
+            writer.endObject();
+        }
+    };
+
+    ParseStats::ParseStats(const ParseStatsOptions& options) : pImpl(new Impl(options)) {}
+
+    ParseStats::~ParseStats() = default;
+
+    void ParseStats::reset() {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->clear();
+    }
+
+    double ParseStats::now() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - pImpl->epoch).count();
+    }
+
+    void ParseStats::recordStage(ParseStage stage, double startMs, double endMs, const std::string& detail) {
+        double durationMs = std::max(endMs - startMs, 0.0);
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        addStage(pImpl->stages[static_cast<size_t>(stage)], durationMs);
+        StageSpan span{stage, startMs, durationMs, detail, pImpl->currentThread()};
+        pImpl->spans.push_back(std::move(span));
+    }
+
+    void ParseStats::recordFile(FileParseStats file) {
+        pImpl->addFile(std::move(file));
+    }
+
+    ParseStageStats ParseStats::getStage(ParseStage stage) const {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        return pImpl->stages[static_cast<size_t>(stage)];
+    }
+
+    FileParseStats ParseStats::getTotals() const {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        return pImpl->totals;
+    }
+
+    size_t ParseStats::getFileCount() const {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        return pImpl->fileCount;
+    }
+
+    std::vector<FileParseStats> ParseStats::getFiles() const {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        return pImpl->files;
+    }
+
+    std::vector<FileParseStats> ParseStats::getSlowestFiles() const {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        return pImpl->sortedSlowest();
+    }
+
+    std::string ParseStats::exportToJson(bool bPretty) const {
+        std::string output;
+        JsonWriter writer(output, bPretty);
+        pImpl->writeJson(writer);
+        return output;
+    }
+
+    bool ParseStats::exportToJson(std::ostream& out, bool bPretty) const {
+        JsonWriter writer(out, bPretty);
+        pImpl->writeJson(writer);
+        writer.flush();
+        return writer.good();
+    }
+
+    bool ParseStats::exportToJsonFile(const std::string& filePath, bool bPretty) const {
+        return writeToFile(filePath, [&](std::ostream& out) { return exportToJson(out, bPretty); });
+    }
+
+    std::string ParseStats::exportToChromeTrace() const {
+        std::string output;
+        JsonWriter writer(output, false);
+        pImpl->writeTrace(writer);
+        return output;
+    }
+
+    bool ParseStats::exportToChromeTrace(std::ostream& out) const {
+        JsonWriter writer(out, false);
+        pImpl->writeTrace(writer);
+        writer.flush();
+        return writer.good();
+    }
+
+    bool ParseStats::exportToChromeTraceFile(const std::string& filePath) const {
+        return writeToFile(filePath, [&](std::ostream& out) { return exportToChromeTrace(out); });
+    }
+
+} // namespace UFMTooling
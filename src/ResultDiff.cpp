@@ -0,0 +1,538 @@
+#include "../include/ResultDiff.h"
+#include "../include/JsonWriter.h"
+#include "ParseResultJson.h"
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace UFMTooling {
+
+    namespace {
+        const uint32_t npos = static_cast<uint32_t>(-1);
+
+        uint64_t hashText(std::string_view text) {
+            return std::hash<std::string_view>()(text);
+        }
+
+        uint64_t mix(uint64_t hash, uint64_t value) {
+            hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+
+        // path without root and the separator after it
+        std::string_view relativePath(std::string_view path, std::string_view root) {
+            if (!root.empty() && path.compare(0, root.size(), root) == 0) {
+                path.remove_prefix(root.size());
+                while (!path.empty() && (path[0] == '/' || path[0] == '\\')) path.remove_prefix(1);
+            }
+            return path;
+        }
+
+        // Keys and comparisons of each kind of declaration. The key hash only has to agree with
+        // sameKey(); type strings are interned, so their ids stand for them.
+        struct ClassKey {
+            static std::string_view key(const ClassInfo& cls) {
+                return cls.fullName.empty() ? std::string_view(cls.name) : std::string_view(cls.fullName);
+            }
+            static uint64_t hash(const ClassInfo& cls) { return hashText(key(cls)); }
+            static bool same(const ClassInfo& a, const ClassInfo& b) { return key(a) == key(b); }
+        };
+
+        struct MemberKey {
+            static uint64_t hash(const MemberInfo& member) { return hashText(member.name); }
+            static bool same(const MemberInfo& a, const MemberInfo& b) { return a.name == b.name; }
+        };
+
+        struct MethodKey {
+            static uint64_t hash(const MethodInfo& method) {
+                uint64_t hash = mix(hashText(method.name), method.isConst ? 1 : 0);
+                for (const auto& param : method.parameters) {
+                    hash = mix(hash, param.type.id());
+                }
+                return hash;
+            }
+            static bool same(const MethodInfo& a, const MethodInfo& b) {
+                if (a.name != b.name || a.isConst != b.isConst || a.parameters.size() != b.parameters.size()) {
+                    return false;
+                }
+                for (size_t i = 0; i < a.parameters.size(); ++i) {
+                    if (a.parameters[i].type != b.parameters[i].type) return false;
+                }
+                return true;
+            }
+        };
+
+        struct EnumKey {
+            static uint64_t hash(const EnumInfo& info) { return hashText(info.name); }
+            static bool same(const EnumInfo& a, const EnumInfo& b) { return a.name == b.name; }
+        };
+
+        // Pair every after declaration with the first unpaired before declaration of the same
+        // key: by position while both sides agree (the common, unchanged case), then through
+        // the before side's key hashes, sorted once
+        template <typename Key, typename T>
+        void matchByKey(const std::vector<T>& before, const std::vector<T>& after,
+                        std::vector<uint32_t>& afterMatch, std::vector<char>& beforeMatched) {
+            afterMatch.assign(after.size(), npos);
+            beforeMatched.assign(before.size(), 0);
+
+            bool bAllPaired = before.size() == after.size();
+            size_t common = std::min(before.size(), after.size());
+            for (size_t i = 0; i < common; ++i) {
+                if (Key::same(before[i], after[i])) {
+                    afterMatch[i] = static_cast<uint32_t>(i);
+                    beforeMatched[i] = 1;
+                } else {
+                    bAllPaired = false;
+                }
+            }
+            if (bAllPaired) return;
+
+            std::vector<std::pair<uint64_t, uint32_t>> keys;
+            for (size_t i = 0; i < before.size(); ++i) {
+                if (!beforeMatched[i]) keys.emplace_back(Key::hash(before[i]), static_cast<uint32_t>(i));
+            }
+            std::sort(keys.begin(), keys.end());
+
+            for (size_t j = 0; j < after.size(); ++j) {
+                if (afterMatch[j] != npos) continue;
+                uint64_t hash = Key::hash(after[j]);
+                auto it = std::lower_bound(keys.begin(), keys.end(), std::make_pair(hash, uint32_t(0)));
+                for (; it != keys.end() && it->first == hash; ++it) {
+                    if (!beforeMatched[it->second] && Key::same(before[it->second], after[j])) {
+                        afterMatch[j] = it->second;
+                        beforeMatched[it->second] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Everything of a declaration but its key, split into what affects the binary
+        // interface and what only affects callers' source (default values)
+        bool sameLayout(const ClassInfo& a, const ClassInfo& b) {
+            if (a.isStruct != b.isStruct || a.isTemplate != b.isTemplate ||
+                a.templateParameters != b.templateParameters || a.baseClasses.size() != b.baseClasses.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < a.baseClasses.size(); ++i) {
+                if (a.baseClasses[i].name != b.baseClasses[i].name || a.baseClasses[i].access != b.baseClasses[i].access) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool sameLayout(const MemberInfo& a, const MemberInfo& b) {
+            return a.type == b.type && a.access == b.access && a.isStatic == b.isStatic && a.isConst == b.isConst;
+        }
+
+        bool sameDefaults(const MemberInfo& a, const MemberInfo& b) {
+            return a.defaultValue == b.defaultValue;
+        }
+
+        bool sameLayout(const MethodInfo& a, const MethodInfo& b) {
+            return a.returnType == b.returnType && a.access == b.access && a.isStatic == b.isStatic &&
+                   a.isVirtual == b.isVirtual && a.isPureVirtual == b.isPureVirtual;
+        }
+
+        bool sameDefaults(const MethodInfo& a, const MethodInfo& b) {
+            for (size_t i = 0; i < a.parameters.size(); ++i) {
+                if (a.parameters[i].defaultValue != b.parameters[i].defaultValue) return false;
+            }
+            return true;
+        }
+
+        // Enum values appended at the end keep the existing ones binary compatible
+        bool isAppended(const EnumInfo& a, const EnumInfo& b) {
+            return a.isClass == b.isClass && a.values.size() <= b.values.size() &&
+                   std::equal(a.values.begin(), a.values.end(), b.values.begin());
+        }
+
+        // Declarations as reported, close to how they were written
+        void appendJoined(std::string& out, const std::vector<std::string>& parts) {
+            for (size_t i = 0; i < parts.size(); ++i) {
+                if (i > 0) out += ", ";
+                out += parts[i];
+            }
+        }
+
+        std::string describe(const ClassInfo& cls) {
+            std::string out;
+            if (cls.isTemplate) {
+                out += "template <";
+                appendJoined(out, cls.templateParameters);
+                out += "> ";
+            }
+            out += cls.isStruct ? "struct " : "class ";
+            out += ClassKey::key(cls);
+            for (size_t i = 0; i < cls.baseClasses.size(); ++i) {
+                out += i == 0 ? " : " : ", ";
+                out += JsonModel::accessSpecifierToString(cls.baseClasses[i].access);
+                out += ' ';
+                out += cls.baseClasses[i].name;
+            }
+            return out;
+        }
+
+        std::string describe(const MemberInfo& member) {
+            std::string out = JsonModel::accessSpecifierToString(member.access) + ": ";
+            if (member.isStatic) out += "static ";
+            if (member.isConst) out += "const ";
+            out += member.type.str();
+            out += ' ';
+            out += member.name;
+            if (!member.defaultValue.empty()) {
+                out += " = ";
+                out += member.defaultValue;
+            }
+            return out;
+        }
+
+        std::string describe(const MethodInfo& method) {
+            std::string out = JsonModel::accessSpecifierToString(method.access) + ": ";
+            if (method.isStatic) out += "static ";
+            if (method.isVirtual) out += "virtual ";
+            if (!method.returnType.empty()) {
+                out += method.returnType.str();
+                out += ' ';
+            }
+            out += method.name;
+            out += '(';
+            for (size_t i = 0; i < method.parameters.size(); ++i) {
+                const ParameterInfo& param = method.parameters[i];
+                if (i > 0) out += ", ";
+                out += param.type.str();
+                if (!param.name.empty()) {
+                    out += ' ';
+                    out += param.name;
+                }
+                if (!param.defaultValue.empty()) {
+                    out += " = ";
+                    out += param.defaultValue;
+                }
+            }
+            out += ')';
+            if (method.isConst) out += " const";
+            if (method.isPureVirtual) out += " = 0";
+            return out;
+        }
+
+        std::string describe(const EnumInfo& info) {
+            std::string out = info.isClass ? "enum class " : "enum ";
+            out += info.name;
+            out += " {";
+            for (size_t i = 0; i < info.values.size(); ++i) {
+                out += i == 0 ? " " : ", ";
+                out += info.values[i].first;
+                if (!info.values[i].second.empty()) {
+                    out += " = ";
+                    out += info.values[i].second;
+                }
+            }
+            out += info.values.empty() ? "}" : " }";
+            return out;
+        }
+
+        // Key of a method as reported: name(parameter types) [const]
+        std::string signature(const MethodInfo& method) {
+            std::string out = method.name + "(";
+            for (size_t i = 0; i < method.parameters.size(); ++i) {
+                if (i > 0) out += ", ";
+                out += method.parameters[i].type.str();
+            }
+            out += ')';
+            if (method.isConst) out += " const";
+            return out;
+        }
+
+        const ParseResult& parsedOf(const SourceFileAnalysis& analysis) {
+            static const ParseResult empty;
+            return analysis.parseResult ? *analysis.parseResult : empty;
+        }
+
+        class Differ {
+        public:
+            Differ(ResultDiffReport& report) : report(report) {}
+
+            void compareFiles(std::string_view path, const SourceFileAnalysis& before, const SourceFileAnalysis& after) {
+                file = path;
+                if (before.success != after.success) {
+                    DiffEntry& entry = add(DiffKind::Changed, DiffEntity::File, std::string(path), true);
+                    entry.before = before.success ? "parsed" : "failed: " + before.errorMessage;
+                    entry.after = after.success ? "parsed" : "failed: " + after.errorMessage;
+                    return;
+                }
+                const ParseResult& oldResult = parsedOf(before);
+                const ParseResult& newResult = parsedOf(after);
+                compareClasses(oldResult.classes, newResult.classes);
+                compareEnums(oldResult.enums, newResult.enums);
+            }
+
+            void fileOnlyOnOneSide(std::string_view path, DiffKind kind) {
+                file = path;
+                DiffEntry& entry = add(kind, DiffEntity::File, std::string(path), kind == DiffKind::Removed);
+                (kind == DiffKind::Removed ? entry.before : entry.after) = std::string(path);
+            }
+
+        private:
+            DiffEntry& add(DiffKind kind, DiffEntity entity, std::string name, bool bBreaking) {
+                report.entries.emplace_back();
+                DiffEntry& entry = report.entries.back();
+                entry.kind = kind;
+                entry.entity = entity;
+                entry.file = std::string(file);
+                entry.name = std::move(name);
+                entry.bBreaking = bBreaking;
+                switch (kind) {
+                    case DiffKind::Added: report.added++; break;
+                    case DiffKind::Removed: report.removed++; break;
+                    case DiffKind::Changed: report.changed++; break;
+                }
+                if (bBreaking) report.breaking++;
+                return entry;
+            }
+
+            void compareClasses(const std::vector<ClassInfo>& before, const std::vector<ClassInfo>& after) {
+                std::vector<uint32_t> afterMatch;
+                std::vector<char> beforeMatched;
+                matchByKey<ClassKey>(before, after, afterMatch, beforeMatched);
+
+                for (size_t i = 0; i < before.size(); ++i) {
+                    if (beforeMatched[i]) continue;
+                    add(DiffKind::Removed, DiffEntity::Class, std::string(ClassKey::key(before[i])), true).before =
+                        describe(before[i]);
+                }
+                for (size_t j = 0; j < after.size(); ++j) {
+                    const ClassInfo& cls = after[j];
+                    if (afterMatch[j] == npos) {
+                        add(DiffKind::Added, DiffEntity::Class, std::string(ClassKey::key(cls)), false).after = describe(cls);
+                        continue;
+                    }
+                    const ClassInfo& old = before[afterMatch[j]];
+                    if (!sameLayout(old, cls)) {
+                        DiffEntry& entry = add(DiffKind::Changed, DiffEntity::Class, std::string(ClassKey::key(cls)), true);
+                        entry.before = describe(old);
+                        entry.after = describe(cls);
+                    }
+                    compareMembers(ClassKey::key(cls), old.members, cls.members);
+                    compareMethods(ClassKey::key(cls), old.methods, cls.methods);
+                }
+            }
+
+            void compareMembers(std::string_view scope, const std::vector<MemberInfo>& before,
+                                const std::vector<MemberInfo>& after) {
+                std::vector<uint32_t> afterMatch;
+                std::vector<char> beforeMatched;
+                matchByKey<MemberKey>(before, after, afterMatch, beforeMatched);
+
+                for (size_t i = 0; i < before.size(); ++i) {
+                    if (beforeMatched[i]) continue;
+                    DiffEntry& entry = add(DiffKind::Removed, DiffEntity::Member, before[i].name, true);
+                    entry.scope = std::string(scope);
+                    entry.before = describe(before[i]);
+                }
+                for (size_t j = 0; j < after.size(); ++j) {
+                    const MemberInfo& member = after[j];
+                    if (afterMatch[j] == npos) {
+                        DiffEntry& entry = add(DiffKind::Added, DiffEntity::Member, member.name, !member.isStatic);
+                        entry.scope = std::string(scope);
+                        entry.after = describe(member);
+                        continue;
+                    }
+                    const MemberInfo& old = before[afterMatch[j]];
+                    bool bLayout = sameLayout(old, member);
+                    if (bLayout && sameDefaults(old, member)) continue;
+                    DiffEntry& entry = add(DiffKind::Changed, DiffEntity::Member, member.name, !bLayout);
+                    entry.scope = std::string(scope);
+                    entry.before = describe(old);
+                    entry.after = describe(member);
+                }
+            }
+
+            void compareMethods(std::string_view scope, const std::vector<MethodInfo>& before,
+                                const std::vector<MethodInfo>& after) {
+                std::vector<uint32_t> afterMatch;
+                std::vector<char> beforeMatched;
+                matchByKey<MethodKey>(before, after, afterMatch, beforeMatched);
+
+                for (size_t i = 0; i < before.size(); ++i) {
+                    if (beforeMatched[i]) continue;
+                    DiffEntry& entry = add(DiffKind::Removed, DiffEntity::Method, signature(before[i]), true);
+                    entry.scope = std::string(scope);
+                    entry.before = describe(before[i]);
+                }
+                for (size_t j = 0; j < after.size(); ++j) {
+                    const MethodInfo& method = after[j];
+                    if (afterMatch[j] == npos) {
+                        DiffEntry& entry = add(DiffKind::Added, DiffEntity::Method, signature(method), method.isVirtual);
+                        entry.scope = std::string(scope);
+                        entry.after = describe(method);
+                        continue;
+                    }
+                    const MethodInfo& old = before[afterMatch[j]];
+                    bool bLayout = sameLayout(old, method);
+                    if (bLayout && sameDefaults(old, method)) continue;
+                    DiffEntry& entry = add(DiffKind::Changed, DiffEntity::Method, signature(method), !bLayout);
+                    entry.scope = std::string(scope);
+                    entry.before = describe(old);
+                    entry.after = describe(method);
+                }
+            }
+
+            void compareEnums(const std::vector<EnumInfo>& before, const std::vector<EnumInfo>& after) {
+                std::vector<uint32_t> afterMatch;
+                std::vector<char> beforeMatched;
+                matchByKey<EnumKey>(before, after, afterMatch, beforeMatched);
+
+                for (size_t i = 0; i < before.size(); ++i) {
+                    if (beforeMatched[i]) continue;
+                    add(DiffKind::Removed, DiffEntity::Enum, before[i].name, true).before = describe(before[i]);
+                }
+                for (size_t j = 0; j < after.size(); ++j) {
+                    const EnumInfo& info = after[j];
+                    if (afterMatch[j] == npos) {
+                        add(DiffKind::Added, DiffEntity::Enum, info.name, false).after = describe(info);
+                        continue;
+                    }
+                    const EnumInfo& old = before[afterMatch[j]];
+                    if (old.isClass == info.isClass && old.values == info.values) continue;
+                    DiffEntry& entry = add(DiffKind::Changed, DiffEntity::Enum, info.name, !isAppended(old, info));
+                    entry.before = describe(old);
+                    entry.after = describe(info);
+                }
+            }
+
+            ResultDiffReport& report;
+            std::string_view file;      // Relative path of the file being compared
+        };
+
+        // Both analyses known to hold the same declarations without looking at them
+        bool unchangedByFingerprint(const SourceFileAnalysis& before, const SourceFileAnalysis& after) {
+            if (before.parseResult && before.parseResult == after.parseResult) {
+                return before.success == after.success;
+            }
+            return before.fingerprint.contentHash != 0 && before.fingerprint.contentHash == after.fingerprint.contentHash &&
+                   before.fingerprint.size == after.fingerprint.size &&
+                   before.fingerprint.optionsHash == after.fingerprint.optionsHash && before.success == after.success;
+        }
+    }
+
+    const char* diffKindName(DiffKind kind) {
+        switch (kind) {
+            case DiffKind::Added: return "added";
+            case DiffKind::Removed: return "removed";
+            case DiffKind::Changed: return "changed";
+        }
+        return "unknown";
+    }
+
+    const char* diffEntityName(DiffEntity entity) {
+        switch (entity) {
+            case DiffEntity::File: return "file";
+            case DiffEntity::Class: return "class";
+            case DiffEntity::Method: return "method";
+            case DiffEntity::Member: return "member";
+            case DiffEntity::Enum: return "enum";
+        }
+        return "unknown";
+    }
+
+    ResultDiffReport ResultDiff::compare(const SourceExplorerResult& before, const SourceExplorerResult& after,
+                                         const ResultDiffOptions& options) {
+        ResultDiffReport report;
+        if (!before.success || !after.success) {
+            const SourceExplorerResult& failed = before.success ? after : before;
+            report.errorMessage = std::string(before.success ? "After" : "Before") + " result is not usable: " +
+                                  failed.errorMessage;
+            return report;
+        }
+
+        // Files of both sides by relative path
+        struct FilePair {
+            std::string_view path;
+            uint32_t before;
+            uint32_t after;
+        };
+        std::vector<FilePair> files;
+        files.reserve(std::max(before.analyses.size(), after.analyses.size()));
+
+        std::unordered_map<std::string_view, uint32_t> beforeByPath;
+        beforeByPath.reserve(before.analyses.size());
+        for (size_t i = 0; i < before.analyses.size(); ++i) {
+            beforeByPath.emplace(relativePath(before.analyses[i].path, options.beforeRoot), static_cast<uint32_t>(i));
+        }
+        std::vector<char> beforeSeen(before.analyses.size(), 0);
+        for (size_t j = 0; j < after.analyses.size(); ++j) {
+            std::string_view path = relativePath(after.analyses[j].path, options.afterRoot);
+            auto it = beforeByPath.find(path);
+            uint32_t match = npos;
+            if (it != beforeByPath.end() && !beforeSeen[it->second]) {
+                match = it->second;
+                beforeSeen[match] = 1;
+            }
+            files.push_back({path, match, static_cast<uint32_t>(j)});
+        }
+        for (size_t i = 0; i < before.analyses.size(); ++i) {
+            if (!beforeSeen[i]) {
+                files.push_back({relativePath(before.analyses[i].path, options.beforeRoot), static_cast<uint32_t>(i), npos});
+            }
+        }
+        std::stable_sort(files.begin(), files.end(),
+                         [](const FilePair& a, const FilePair& b) { return a.path < b.path; });
+
+        Differ differ(report);
+        for (const auto& pair : files) {
+            if (pair.before == npos) {
+                differ.fileOnlyOnOneSide(pair.path, DiffKind::Added);
+            } else if (pair.after == npos) {
+                differ.fileOnlyOnOneSide(pair.path, DiffKind::Removed);
+            } else {
+                const SourceFileAnalysis& oldAnalysis = before.analyses[pair.before];
+                const SourceFileAnalysis& newAnalysis = after.analyses[pair.after];
+                report.filesCompared++;
+                if (options.bSkipByFingerprint && unchangedByFingerprint(oldAnalysis, newAnalysis)) {
+                    report.filesSkipped++;
+                    continue;
+                }
+                differ.compareFiles(pair.path, oldAnalysis, newAnalysis);
+            }
+        }
+
+        report.success = true;
+        return report;
+    }
+
+    bool ResultDiff::writeJson(const ResultDiffReport& report, std::ostream& out, bool bPretty) {
+        JsonWriter writer(out, bPretty);
+        writer.beginObject();
+        writer.member("added", report.added);
+        writer.member("breaking", report.breaking);
+        writer.member("changed", report.changed);
+        writer.key("entries");
+        writer.beginArray();
+        for (const auto& entry : report.entries) {
+            writer.beginObject();
+            writer.member("after", entry.after);
+            writer.member("before", entry.before);
+            writer.member("breaking", entry.bBreaking);
+            writer.member("entity", diffEntityName(entry.entity));
+            writer.member("file", entry.file);
+            writer.member("kind", diffKindName(entry.kind));
+            writer.member("name", entry.name);
+            writer.member("scope", entry.scope);
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.member("errorMessage", report.errorMessage);
+        writer.member("filesCompared", report.filesCompared);
+        writer.member("filesSkipped", report.filesSkipped);
+        writer.member("removed", report.removed);
+        writer.member("success", report.success);
+        writer.endObject();
+        writer.flush();
+        return writer.good();
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,1079 @@
+#include "../include/ResultSnapshot.h"
+#include "../include/MappedFile.h"
+#include "../include/JsonWriter.h"
+#include "ParseResultJson.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace UFMTooling {
+
+    using namespace Snapshot;
+
+    namespace {
+        // File layout: header, table directory, then the tables, each 8-byte aligned.
+        // Integers are stored in host byte order; byteOrder rejects foreign files.
+        // Bump SnapshotVersion whenever a record or the table list changes.
+        const char SnapshotMagic[8] = {'U', 'F', 'M', 'S', 'N', 'A', 'P', 'S'};
+        const uint32_t SnapshotVersion = 2;        // 2: namespaces, preprocessor options hash
+        const uint32_t ByteOrderMark = 0x01020304;
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t byteOrder;
+            uint32_t kind;
+            uint32_t tableCount;
+        };
+
+        struct TableEntry {
+            uint64_t offset;
+            uint64_t count;
+        };
+
+        enum TableId : uint32_t {
+            StringsTable,
+            SummaryTable,
+            NamesTable,
+            ValuesTable,
+            FilesTable,
+            ClassesTable,
+            BaseClassesTable,
+            MembersTable,
+            MethodsTable,
+            ParametersTable,
+            EnumsTable,
+            EnumValuesTable,
+            UMLClassesTable,
+            UMLAttributesTable,
+            UMLMethodsTable,
+            UMLParametersTable,
+            UMLRelationshipsTable,
+            NotesTable,
+            EntitiesTable,
+            EntityFieldsTable,
+            EntityRelationshipsTable,
+            NamespacesTable,
+            TableCount
+        };
+
+        // Row size of each table, in TableId order
+        const size_t RowSizes[TableCount] = {
+            sizeof(char), sizeof(Summary), sizeof(StringRef), sizeof(uint32_t), sizeof(File),
+            sizeof(Class), sizeof(BaseClass), sizeof(Member), sizeof(Method), sizeof(Parameter),
+            sizeof(Enum), sizeof(EnumValue), sizeof(UMLClassRecord), sizeof(UMLAttributeRecord),
+            sizeof(UMLMethodRecord), sizeof(UMLParameterRecord), sizeof(UMLRelationshipRecord),
+            sizeof(Note), sizeof(EntityRecord), sizeof(EntityFieldRecord), sizeof(EntityRelationshipRecord),
+            sizeof(Namespace)
+        };
+
+        size_t alignTo8(size_t offset) {
+            return (offset + 7) & ~static_cast<size_t>(7);
+        }
+
+        uint32_t flag(bool value, uint32_t bit) {
+            return value ? bit : 0;
+        }
+
+        bool hasFlag(uint32_t flags, uint32_t bit) {
+            return (flags & bit) != 0;
+        }
+
+        // Collects the tables of one result, then lays them out in a single buffer
+        class SnapshotBuilder {
+        public:
+            std::string strings;
+            std::vector<Summary> summary;
+            std::vector<StringRef> names;
+            std::vector<uint32_t> values;
+            std::vector<File> files;
+            std::vector<Class> classes;
+            std::vector<BaseClass> baseClasses;
+            std::vector<Member> members;
+            std::vector<Method> methods;
+            std::vector<Parameter> parameters;
+            std::vector<Enum> enums;
+            std::vector<EnumValue> enumValues;
+            std::vector<UMLClassRecord> umlClasses;
+            std::vector<UMLAttributeRecord> umlAttributes;
+            std::vector<UMLMethodRecord> umlMethods;
+            std::vector<UMLParameterRecord> umlParameters;
+            std::vector<UMLRelationshipRecord> umlRelationships;
+            std::vector<Note> notes;
+            std::vector<EntityRecord> entities;
+            std::vector<EntityFieldRecord> entityFields;
+            std::vector<EntityRelationshipRecord> entityRelationships;
+            std::vector<Namespace> namespaces;
+
+            // Identical strings are stored once. Keys view the source result, which
+            // outlives the builder.
+            StringRef ref(std::string_view str) {
+                auto it = interned.find(str);
+                if (it != interned.end()) return it->second;
+                StringRef stored = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(str.size())};
+                strings.append(str.data(), str.size());
+                interned.emplace(str, stored);
+                return stored;
+            }
+
+            Range nameList(const std::vector<std::string>& list) {
+                Range range = {static_cast<uint32_t>(names.size()), static_cast<uint32_t>(list.size())};
+                for (const auto& name : list) {
+                    names.push_back(ref(name));
+                }
+                return range;
+            }
+
+            template <typename T>
+            static Range rangeFrom(const std::vector<T>& table, size_t begin) {
+                return Range{static_cast<uint32_t>(begin), static_cast<uint32_t>(table.size() - begin)};
+            }
+
+            void addSummary(const std::string& title, const std::string& errorMessage, bool success,
+                            int filesProcessed, int filesWithErrors, int filesFromCache) {
+                Summary row = {};
+                row.title = ref(title);
+                row.errorMessage = ref(errorMessage);
+                row.flags = flag(success, Success);
+                row.filesProcessed = filesProcessed;
+                row.filesWithErrors = filesWithErrors;
+                row.filesFromCache = filesFromCache;
+                summary.push_back(row);
+            }
+
+            void addNotes(const std::map<std::string, std::string>& diagramNotes) {
+                for (const auto& note : diagramNotes) {
+                    notes.push_back(Note{ref(note.first), ref(note.second)});
+                }
+            }
+
+            void addClass(const ClassInfo& cls) {
+                // Children first, so the class row can record their ranges
+                size_t baseBegin = baseClasses.size();
+                for (const auto& base : cls.baseClasses) {
+                    baseClasses.push_back(BaseClass{ref(base.name), static_cast<uint32_t>(base.access)});
+                }
+
+                size_t memberBegin = members.size();
+                for (const auto& member : cls.members) {
+                    Member row = {};
+                    row.name = ref(member.name);
+                    row.type = ref(member.type.view());
+                    row.defaultValue = ref(member.defaultValue);
+                    row.access = static_cast<uint32_t>(member.access);
+                    row.flags = flag(member.isStatic, IsStatic) | flag(member.isConst, IsConst);
+                    members.push_back(row);
+                }
+
+                size_t methodBegin = methods.size();
+                for (const auto& method : cls.methods) {
+                    size_t parameterBegin = parameters.size();
+                    for (const auto& param : method.parameters) {
+                        Parameter row = {};
+                        row.name = ref(param.name);
+                        row.type = ref(param.type.view());
+                        row.defaultValue = ref(param.defaultValue);
+                        row.flags = flag(param.isConst, IsConst) | flag(param.isReference, IsReference) |
+                                    flag(param.isPointer, IsPointer);
+                        parameters.push_back(row);
+                    }
+
+                    Method row = {};
+                    row.name = ref(method.name);
+                    row.returnType = ref(method.returnType.view());
+                    row.access = static_cast<uint32_t>(method.access);
+                    row.flags = flag(method.isStatic, IsStatic) | flag(method.isConst, IsConst) |
+                                flag(method.isVirtual, IsVirtual) | flag(method.isPureVirtual, IsPureVirtual) |
+                                flag(method.isConstructor, IsConstructor) | flag(method.isDestructor, IsDestructor) |
+                                flag(method.isOperator, IsOperator);
+                    row.parameters = rangeFrom(parameters, parameterBegin);
+                    methods.push_back(row);
+                }
+
+                Class row = {};
+                row.name = ref(cls.name);
+                row.fullName = ref(cls.fullName);
+                row.flags = flag(cls.isStruct, IsStruct) | flag(cls.isTemplate, IsTemplate);
+                row.baseClasses = rangeFrom(baseClasses, baseBegin);
+                row.members = rangeFrom(members, memberBegin);
+                row.methods = rangeFrom(methods, methodBegin);
+                row.friendClasses = nameList(cls.friendClasses);
+                row.templateParameters = nameList(cls.templateParameters);
+                classes.push_back(row);
+            }
+
+            // Pre-order, so a namespace's subtree is the run of rows after it
+            void addNamespaces(const std::vector<NamespaceInfo>& list, uint32_t parent) {
+                for (const auto& ns : list) {
+                    Namespace row = {};
+                    row.name = ref(ns.name);
+                    row.parent = parent;
+                    size_t classBegin = names.size();
+                    for (const auto& cls : ns.classes) {
+                        names.push_back(ref(cls.fullName));
+                    }
+                    row.classes = rangeFrom(names, classBegin);
+                    namespaces.push_back(row);
+                    addNamespaces(ns.nestedNamespaces, static_cast<uint32_t>(namespaces.size() - 1));
+                }
+            }
+
+            void addAnalysis(const SourceFileAnalysis& analysis) {
+                static const ParseResult emptyResult;
+                const ParseResult& parseResult = analysis.parseResult ? *analysis.parseResult : emptyResult;
+
+                File row = {};
+                row.path = ref(analysis.path);
+                row.filename = ref(analysis.filename);
+                row.errorMessage = ref(analysis.errorMessage);
+                row.parseFileName = ref(parseResult.fileName);
+                row.parseErrorMessage = ref(parseResult.errorMessage);
+                row.flags = flag(analysis.success, Success) | flag(analysis.fromCache, FromCache);
+                row.parseFlags = flag(parseResult.success, Success);
+
+                size_t classBegin = classes.size();
+                for (const auto& cls : parseResult.classes) {
+                    addClass(cls);
+                }
+                row.classes = rangeFrom(classes, classBegin);
+
+                size_t enumBegin = enums.size();
+                for (const auto& enumInfo : parseResult.enums) {
+                    Enum enumRow = {};
+                    size_t valueBegin = enumValues.size();
+                    for (const auto& value : enumInfo.values) {
+                        enumValues.push_back(EnumValue{ref(value.first), ref(value.second)});
+                    }
+                    enumRow.name = ref(enumInfo.name);
+                    enumRow.flags = flag(enumInfo.isClass, IsClass);
+                    enumRow.values = rangeFrom(enumValues, valueBegin);
+                    enums.push_back(enumRow);
+                }
+                row.enums = rangeFrom(enums, enumBegin);
+                row.includes = nameList(parseResult.includes);
+
+                size_t namespaceBegin = namespaces.size();
+                addNamespaces(parseResult.namespaces, NoParent);
+                row.namespaces = rangeFrom(namespaces, namespaceBegin);
+
+                row.lastWriteTime = analysis.fingerprint.lastWriteTime;
+                row.size = analysis.fingerprint.size;
+                row.contentHash = analysis.fingerprint.contentHash;
+                row.optionsHash = analysis.fingerprint.optionsHash;
+                files.push_back(row);
+            }
+
+            void addUMLClass(const UMLClass& cls) {
+                size_t attributeBegin = umlAttributes.size();
+                for (const auto& attribute : cls.attributes) {
+                    UMLAttributeRecord row = {};
+                    row.name = ref(attribute.name);
+                    row.type = ref(attribute.type.view());
+                    row.defaultValue = ref(attribute.defaultValue);
+                    row.stereotype = ref(attribute.stereotype);
+                    row.visibility = static_cast<uint32_t>(attribute.visibility);
+                    row.flags = flag(attribute.isStatic, IsStatic);
+                    umlAttributes.push_back(row);
+                }
+
+                size_t methodBegin = umlMethods.size();
+                for (const auto& method : cls.methods) {
+                    size_t parameterBegin = umlParameters.size();
+                    for (const auto& param : method.parameters) {
+                        umlParameters.push_back(UMLParameterRecord{ref(param.name), ref(param.type.view()),
+                                                                   ref(param.direction), ref(param.defaultValue)});
+                    }
+
+                    UMLMethodRecord row = {};
+                    row.name = ref(method.name);
+                    row.returnType = ref(method.returnType.view());
+                    row.stereotype = ref(method.stereotype);
+                    row.visibility = static_cast<uint32_t>(method.visibility);
+                    row.flags = flag(method.isStatic, IsStatic) | flag(method.isAbstract, IsAbstract);
+                    row.parameters = rangeFrom(umlParameters, parameterBegin);
+                    umlMethods.push_back(row);
+                }
+
+                UMLClassRecord row = {};
+                row.name = ref(cls.name);
+                row.stereotype = ref(cls.stereotype);
+                row.package = ref(cls.package);
+                row.note = ref(cls.note);
+                row.flags = flag(cls.isAbstract, IsAbstract) | flag(cls.isInterface, IsInterface);
+                row.attributes = rangeFrom(umlAttributes, attributeBegin);
+                row.methods = rangeFrom(umlMethods, methodBegin);
+                umlClasses.push_back(row);
+            }
+
+            void addEntity(const Entity& entity) {
+                size_t fieldBegin = entityFields.size();
+                for (const auto& field : entity.fields) {
+                    EntityFieldRecord row = {};
+                    row.name = ref(field.name);
+                    row.type = ref(field.type.view());
+                    row.defaultValue = ref(field.defaultValue);
+                    row.comment = ref(field.comment);
+                    row.flags = flag(field.isPrimaryKey, IsPrimaryKey) | flag(field.isForeignKey, IsForeignKey) |
+                                flag(field.isUnique, IsUnique) | flag(field.isNotNull, IsNotNull);
+                    size_t constraintBegin = values.size();
+                    for (EntityFieldType constraint : field.constraints) {
+                        values.push_back(static_cast<uint32_t>(constraint));
+                    }
+                    row.constraints = rangeFrom(values, constraintBegin);
+                    entityFields.push_back(row);
+                }
+
+                EntityRecord row = {};
+                row.name = ref(entity.name);
+                row.alias = ref(entity.alias);
+                row.schema = ref(entity.schema);
+                row.comment = ref(entity.comment);
+                row.stereotype = ref(entity.stereotype);
+                row.fields = rangeFrom(entityFields, fieldBegin);
+                entities.push_back(row);
+            }
+
+            void addEntityRelationship(const EntityRelationship& relationship) {
+                EntityRelationshipRecord row = {};
+                row.fromEntity = ref(relationship.fromEntity);
+                row.toEntity = ref(relationship.toEntity);
+                row.label = ref(relationship.label);
+                row.fromCardinality = static_cast<uint32_t>(relationship.fromCardinality);
+                row.toCardinality = static_cast<uint32_t>(relationship.toCardinality);
+                row.type = static_cast<uint32_t>(relationship.type);
+                row.flags = flag(relationship.isIdentifying, IsIdentifying);
+                row.fromFields = nameList(relationship.fromFields);
+                row.toFields = nameList(relationship.toFields);
+                entityRelationships.push_back(row);
+            }
+
+            // Header, directory and tables in one 8-byte aligned buffer
+            std::vector<uint64_t> finish(SnapshotKind kind) const {
+                struct Pending {
+                    const void* data;
+                    size_t count;
+                };
+                Pending tables[TableCount] = {
+                    {strings.data(), strings.size()}, {summary.data(), summary.size()},
+                    {names.data(), names.size()}, {values.data(), values.size()},
+                    {files.data(), files.size()}, {classes.data(), classes.size()},
+                    {baseClasses.data(), baseClasses.size()}, {members.data(), members.size()},
+                    {methods.data(), methods.size()}, {parameters.data(), parameters.size()},
+                    {enums.data(), enums.size()}, {enumValues.data(), enumValues.size()},
+                    {umlClasses.data(), umlClasses.size()}, {umlAttributes.data(), umlAttributes.size()},
+                    {umlMethods.data(), umlMethods.size()}, {umlParameters.data(), umlParameters.size()},
+                    {umlRelationships.data(), umlRelationships.size()}, {notes.data(), notes.size()},
+                    {entities.data(), entities.size()}, {entityFields.data(), entityFields.size()},
+                    {entityRelationships.data(), entityRelationships.size()},
+                    {namespaces.data(), namespaces.size()}
+                };
+
+                TableEntry directory[TableCount];
+                size_t offset = alignTo8(sizeof(FileHeader) + sizeof(directory));
+                for (uint32_t id = 0; id < TableCount; ++id) {
+                    directory[id].offset = offset;
+                    directory[id].count = tables[id].count;
+                    offset = alignTo8(offset + tables[id].count * RowSizes[id]);
+                }
+
+                std::vector<uint64_t> buffer(offset / 8, 0);
+                char* out = reinterpret_cast<char*>(buffer.data());
+                FileHeader header;
+                std::memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+                header.version = SnapshotVersion;
+                header.byteOrder = ByteOrderMark;
+                header.kind = static_cast<uint32_t>(kind);
+                header.tableCount = TableCount;
+                std::memcpy(out, &header, sizeof(header));
+                std::memcpy(out + sizeof(header), directory, sizeof(directory));
+                for (uint32_t id = 0; id < TableCount; ++id) {
+                    if (tables[id].count > 0) {
+                        std::memcpy(out + directory[id].offset, tables[id].data, tables[id].count * RowSizes[id]);
+                    }
+                }
+                return buffer;
+            }
+
+        private:
+            std::unordered_map<std::string_view, StringRef> interned;
+        };
+    }
+
+    class ResultSnapshot::Impl {
+    public:
+        std::vector<uint64_t> buffer;       // Built or copied snapshot...
+        MappedFile mapping;                 // ...or the mapped file
+        const char* base;
+        size_t size;
+        SnapshotKind kind;
+        const char* tables[TableCount];
+        size_t counts[TableCount];
+        std::string errorMessage;
+
+        Impl() { reset(); }
+
+        void reset() {
+            buffer.clear();
+            mapping.close();
+            base = nullptr;
+            size = 0;
+            kind = SnapshotKind::None;
+            for (uint32_t id = 0; id < TableCount; ++id) {
+                tables[id] = nullptr;
+                counts[id] = 0;
+            }
+        }
+
+        template <typename T>
+        Table<T> table(TableId id) const {
+            return Table<T>(reinterpret_cast<const T*>(tables[id]), counts[id]);
+        }
+
+        std::string_view str(StringRef ref) const {
+            return ref.size == 0 ? std::string_view() : std::string_view(tables[StringsTable] + ref.offset, ref.size);
+        }
+
+        std::string string(StringRef ref) const {
+            std::string_view view = str(ref);
+            return std::string(view.data(), view.size());
+        }
+
+        std::vector<std::string> nameList(Range range) const {
+            std::vector<std::string> list;
+            list.reserve(range.count);
+            for (const StringRef& name : table<StringRef>(NamesTable).slice(range)) {
+                list.push_back(string(name));
+            }
+            return list;
+        }
+
+        void adopt(std::vector<uint64_t>&& built, const std::string& source) {
+            reset();
+            buffer = std::move(built);
+            bind(reinterpret_cast<const char*>(buffer.data()), buffer.size() * 8, source);
+        }
+
+        void build(const SnapshotBuilder& builder, SnapshotKind snapshotKind) {
+            adopt(builder.finish(snapshotKind), "snapshot");
+        }
+
+        bool load(const std::string& filePath) {
+            reset();
+            if (!mapping.open(filePath)) {
+                errorMessage = mapping.getErrorMessage();
+                return false;
+            }
+
+            // Tables are read in place when the mapping is suitably aligned (always, for
+            // a real mapping); otherwise the contents are copied into aligned storage
+            const char* data = mapping.data();
+            size_t dataSize = mapping.size();
+            if (reinterpret_cast<uintptr_t>(data) % 8 != 0) {
+                std::vector<uint64_t> copy((dataSize + 7) / 8, 0);
+                std::memcpy(copy.data(), data, dataSize);
+                mapping.close();
+                buffer = std::move(copy);
+                data = reinterpret_cast<const char*>(buffer.data());
+            }
+            return bind(data, dataSize, filePath);
+        }
+
+        bool bind(const char* data, size_t dataSize, const std::string& source) {
+            FileHeader header;
+            if (dataSize < sizeof(header)) {
+                return fail("Not a snapshot: " + source);
+            }
+            std::memcpy(&header, data, sizeof(header));
+            if (std::memcmp(header.magic, SnapshotMagic, sizeof(header.magic)) != 0) {
+                return fail("Not a snapshot: " + source);
+            }
+            if (header.version != SnapshotVersion || header.byteOrder != ByteOrderMark || header.tableCount != TableCount ||
+                header.kind > static_cast<uint32_t>(SnapshotKind::EntityDiagram) ||
+                dataSize < sizeof(header) + TableCount * sizeof(TableEntry)) {
+                return fail("Unsupported snapshot version: " + source);
+            }
+
+            TableEntry directory[TableCount];
+            std::memcpy(directory, data + sizeof(header), sizeof(directory));
+            for (uint32_t id = 0; id < TableCount; ++id) {
+                const TableEntry& entry = directory[id];
+                if (entry.offset % 8 != 0 || entry.offset > dataSize ||
+                    entry.count > (dataSize - entry.offset) / RowSizes[id]) {
+                    return fail("Corrupt snapshot: " + source);
+                }
+                tables[id] = data + entry.offset;
+                counts[id] = static_cast<size_t>(entry.count);
+            }
+            base = data;
+            size = dataSize;
+            kind = static_cast<SnapshotKind>(header.kind);
+
+            if (!validate()) {
+                return fail("Corrupt snapshot: " + source);
+            }
+            return true;
+        }
+
+        const Summary& summary() const {
+            static const Summary emptySummary = {};
+            return counts[SummaryTable] > 0 ? table<Summary>(SummaryTable)[0] : emptySummary;
+        }
+
+        std::shared_ptr<const ParseResult> toParseResult(const File& file) const {
+            auto result = std::make_shared<ParseResult>();
+            result->fileName = string(file.parseFileName);
+            result->errorMessage = string(file.parseErrorMessage);
+            result->success = hasFlag(file.parseFlags, Success);
+            result->includes = nameList(file.includes);
+
+            Table<Parameter> parameterTable = table<Parameter>(ParametersTable);
+            result->classes.reserve(file.classes.count);
+            for (const Class& row : table<Class>(ClassesTable).slice(file.classes)) {
+                ClassInfo cls;
+                cls.name = string(row.name);
+                cls.fullName = string(row.fullName);
+                cls.isStruct = hasFlag(row.flags, IsStruct);
+                cls.isTemplate = hasFlag(row.flags, IsTemplate);
+                cls.friendClasses = nameList(row.friendClasses);
+                cls.templateParameters = nameList(row.templateParameters);
+
+                for (const BaseClass& baseRow : table<BaseClass>(BaseClassesTable).slice(row.baseClasses)) {
+                    BaseClassInfo base;
+                    base.name = string(baseRow.name);
+                    base.access = static_cast<AccessSpecifier>(baseRow.access);
+                    cls.baseClasses.push_back(std::move(base));
+                }
+
+                for (const Member& memberRow : table<Member>(MembersTable).slice(row.members)) {
+                    MemberInfo member;
+                    member.name = string(memberRow.name);
+                    member.type = str(memberRow.type);
+                    member.defaultValue = string(memberRow.defaultValue);
+                    member.access = static_cast<AccessSpecifier>(memberRow.access);
+                    member.isStatic = hasFlag(memberRow.flags, IsStatic);
+                    member.isConst = hasFlag(memberRow.flags, IsConst);
+                    cls.members.push_back(std::move(member));
+                }
+
+                for (const Method& methodRow : table<Method>(MethodsTable).slice(row.methods)) {
+                    MethodInfo method;
+                    method.name = string(methodRow.name);
+                    method.returnType = str(methodRow.returnType);
+                    method.access = static_cast<AccessSpecifier>(methodRow.access);
+                    method.isStatic = hasFlag(methodRow.flags, IsStatic);
+                    method.isConst = hasFlag(methodRow.flags, IsConst);
+                    method.isVirtual = hasFlag(methodRow.flags, IsVirtual);
+                    method.isPureVirtual = hasFlag(methodRow.flags, IsPureVirtual);
+                    method.isConstructor = hasFlag(methodRow.flags, IsConstructor);
+                    method.isDestructor = hasFlag(methodRow.flags, IsDestructor);
+                    method.isOperator = hasFlag(methodRow.flags, IsOperator);
+                    for (const Parameter& paramRow : parameterTable.slice(methodRow.parameters)) {
+                        ParameterInfo param;
+                        param.name = string(paramRow.name);
+                        param.type = str(paramRow.type);
+                        param.defaultValue = string(paramRow.defaultValue);
+                        param.isConst = hasFlag(paramRow.flags, IsConst);
+                        param.isReference = hasFlag(paramRow.flags, IsReference);
+                        param.isPointer = hasFlag(paramRow.flags, IsPointer);
+                        method.parameters.push_back(std::move(param));
+                    }
+                    cls.methods.push_back(std::move(method));
+                }
+                result->classes.push_back(std::move(cls));
+            }
+
+            for (const Enum& row : table<Enum>(EnumsTable).slice(file.enums)) {
+                EnumInfo enumInfo;
+                enumInfo.name = string(row.name);
+                enumInfo.isClass = hasFlag(row.flags, IsClass);
+                for (const EnumValue& value : table<EnumValue>(EnumValuesTable).slice(row.values)) {
+                    enumInfo.values.emplace_back(string(value.name), string(value.value));
+                }
+                result->enums.push_back(std::move(enumInfo));
+            }
+
+            Table<Namespace> namespaceRows = table<Namespace>(NamespacesTable).slice(file.namespaces);
+            readNamespaces(namespaceRows, file.namespaces.begin, 0, NoParent, result->namespaces);
+            JsonModel::resolveNamespaces(*result);
+            return result;
+        }
+
+        // Read the namespaces of one parent from row i of a file's pre-order rows (first is
+        // the table row of rows[0]); the classes are resolved by full name afterwards, as
+        // for a JSON import. Returns the row after the last one read.
+        size_t readNamespaces(Table<Namespace> rows, uint32_t first, size_t i, uint32_t parent,
+                              std::vector<NamespaceInfo>& out) const {
+            while (i < rows.size() && rows[i].parent == parent) {
+                NamespaceInfo ns;
+                ns.name = string(rows[i].name);
+                for (const StringRef& fullName : table<StringRef>(NamesTable).slice(rows[i].classes)) {
+                    ns.classes.emplace_back();
+                    ns.classes.back().fullName = string(fullName);
+                }
+                uint32_t row = first + static_cast<uint32_t>(i);
+                i = readNamespaces(rows, first, i + 1, row, ns.nestedNamespaces);
+                out.push_back(std::move(ns));
+            }
+            return i;
+        }
+
+        SourceFileAnalysis toAnalysis(const File& file) const {
+            SourceFileAnalysis analysis;
+            analysis.path = string(file.path);
+            analysis.filename = string(file.filename);
+            analysis.errorMessage = string(file.errorMessage);
+            analysis.success = hasFlag(file.flags, Success);
+            analysis.fromCache = hasFlag(file.flags, FromCache);
+            analysis.fingerprint.lastWriteTime = file.lastWriteTime;
+            analysis.fingerprint.size = file.size;
+            analysis.fingerprint.contentHash = file.contentHash;
+            analysis.fingerprint.optionsHash = file.optionsHash;
+            analysis.parseResult = toParseResult(file);
+            return analysis;
+        }
+
+        void writeJson(JsonWriter& writer) const {
+            const Summary& top = summary();
+            SourceExplorerResult counters;
+            counters.success = hasFlag(top.flags, Success);
+            counters.filesProcessed = top.filesProcessed;
+            counters.filesWithErrors = top.filesWithErrors;
+
+            JsonModel::beginExplorerResult(string(top.errorMessage), writer);
+            for (const File& file : table<File>(FilesTable)) {
+                JsonModel::writeAnalysis(toAnalysis(file), writer);
+            }
+            JsonModel::endExplorerResult(counters, writer);
+        }
+
+    private:
+        bool fail(const std::string& message) {
+            reset();
+            errorMessage = message;
+            return false;
+        }
+
+        // Check every StringRef, Range and enum value once, so readers can index freely
+        bool validate() const {
+            const uint64_t stringSize = counts[StringsTable];
+            auto okString = [stringSize](StringRef ref) {
+                return static_cast<uint64_t>(ref.offset) + ref.size <= stringSize;
+            };
+            auto okRange = [this](Range range, TableId id) {
+                return static_cast<uint64_t>(range.begin) + range.count <= counts[id];
+            };
+
+            if (counts[SummaryTable] > 1) return false;
+            for (const Summary& row : table<Summary>(SummaryTable)) {
+                if (!okString(row.title) || !okString(row.errorMessage)) return false;
+            }
+            for (const StringRef& row : table<StringRef>(NamesTable)) {
+                if (!okString(row)) return false;
+            }
+            for (const File& row : table<File>(FilesTable)) {
+                if (!okString(row.path) || !okString(row.filename) || !okString(row.errorMessage) ||
+                    !okString(row.parseFileName) || !okString(row.parseErrorMessage) ||
+                    !okRange(row.classes, ClassesTable) || !okRange(row.enums, EnumsTable) ||
+                    !okRange(row.includes, NamesTable) || !okRange(row.namespaces, NamespacesTable)) return false;
+            }
+            for (size_t i = 0; i < counts[NamespacesTable]; ++i) {
+                const Namespace& row = table<Namespace>(NamespacesTable)[i];
+                if (!okString(row.name) || !okRange(row.classes, NamesTable) ||
+                    (row.parent != NoParent && row.parent >= i)) return false;
+            }
+            for (const Class& row : table<Class>(ClassesTable)) {
+                if (!okString(row.name) || !okString(row.fullName) || !okRange(row.baseClasses, BaseClassesTable) ||
+                    !okRange(row.members, MembersTable) || !okRange(row.methods, MethodsTable) ||
+                    !okRange(row.friendClasses, NamesTable) || !okRange(row.templateParameters, NamesTable)) return false;
+            }
+            const uint32_t maxAccess = static_cast<uint32_t>(AccessSpecifier::None);
+            for (const BaseClass& row : table<BaseClass>(BaseClassesTable)) {
+                if (!okString(row.name) || row.access > maxAccess) return false;
+            }
+            for (const Member& row : table<Member>(MembersTable)) {
+                if (!okString(row.name) || !okString(row.type) || !okString(row.defaultValue) || row.access > maxAccess) return false;
+            }
+            for (const Method& row : table<Method>(MethodsTable)) {
+                if (!okString(row.name) || !okString(row.returnType) || row.access > maxAccess ||
+                    !okRange(row.parameters, ParametersTable)) return false;
+            }
+            for (const Parameter& row : table<Parameter>(ParametersTable)) {
+                if (!okString(row.name) || !okString(row.type) || !okString(row.defaultValue)) return false;
+            }
+            for (const Enum& row : table<Enum>(EnumsTable)) {
+                if (!okString(row.name) || !okRange(row.values, EnumValuesTable)) return false;
+            }
+            for (const EnumValue& row : table<EnumValue>(EnumValuesTable)) {
+                if (!okString(row.name) || !okString(row.value)) return false;
+            }
+
+            const uint32_t maxVisibility = static_cast<uint32_t>(UMLVisibility::Package);
+            for (const UMLClassRecord& row : table<UMLClassRecord>(UMLClassesTable)) {
+                if (!okString(row.name) || !okString(row.stereotype) || !okString(row.package) || !okString(row.note) ||
+                    !okRange(row.attributes, UMLAttributesTable) || !okRange(row.methods, UMLMethodsTable)) return false;
+            }
+            for (const UMLAttributeRecord& row : table<UMLAttributeRecord>(UMLAttributesTable)) {
+                if (!okString(row.name) || !okString(row.type) || !okString(row.defaultValue) ||
+                    !okString(row.stereotype) || row.visibility > maxVisibility) return false;
+            }
+            for (const UMLMethodRecord& row : table<UMLMethodRecord>(UMLMethodsTable)) {
+                if (!okString(row.name) || !okString(row.returnType) || !okString(row.stereotype) ||
+                    row.visibility > maxVisibility || !okRange(row.parameters, UMLParametersTable)) return false;
+            }
+            for (const UMLParameterRecord& row : table<UMLParameterRecord>(UMLParametersTable)) {
+                if (!okString(row.name) || !okString(row.type) || !okString(row.direction) ||
+                    !okString(row.defaultValue)) return false;
+            }
+            for (const UMLRelationshipRecord& row : table<UMLRelationshipRecord>(UMLRelationshipsTable)) {
+                if (!okString(row.fromClass) || !okString(row.toClass) || !okString(row.label) ||
+                    !okString(row.fromCardinality) || !okString(row.toCardinality) ||
+                    row.type > static_cast<uint32_t>(UMLRelationship::Nesting)) return false;
+            }
+            for (const Note& row : table<Note>(NotesTable)) {
+                if (!okString(row.key) || !okString(row.text)) return false;
+            }
+
+            for (const EntityRecord& row : table<EntityRecord>(EntitiesTable)) {
+                if (!okString(row.name) || !okString(row.alias) || !okString(row.schema) || !okString(row.comment) ||
+                    !okString(row.stereotype) || !okRange(row.fields, EntityFieldsTable)) return false;
+            }
+            for (const EntityFieldRecord& row : table<EntityFieldRecord>(EntityFieldsTable)) {
+                if (!okString(row.name) || !okString(row.type) || !okString(row.defaultValue) ||
+                    !okString(row.comment) || !okRange(row.constraints, ValuesTable)) return false;
+                for (uint32_t constraint : table<uint32_t>(ValuesTable).slice(row.constraints)) {
+                    if (constraint > static_cast<uint32_t>(EntityFieldType::Regular)) return false;
+                }
+            }
+            const uint32_t maxCardinality = static_cast<uint32_t>(Cardinality::OneOrMany);
+            for (const EntityRelationshipRecord& row : table<EntityRelationshipRecord>(EntityRelationshipsTable)) {
+                if (!okString(row.fromEntity) || !okString(row.toEntity) || !okString(row.label) ||
+                    row.fromCardinality > maxCardinality || row.toCardinality > maxCardinality ||
+                    row.type > static_cast<uint32_t>(EntityRelationType::ManyToMany) ||
+                    !okRange(row.fromFields, NamesTable) || !okRange(row.toFields, NamesTable)) return false;
+            }
+            return true;
+        }
+    };
+
+    // ResultSnapshot implementation
+    ResultSnapshot::ResultSnapshot() : pImpl(new Impl()) {}
+
+    ResultSnapshot::~ResultSnapshot() = default;
+
+    ResultSnapshot::ResultSnapshot(ResultSnapshot&& other) noexcept = default;
+
+    ResultSnapshot& ResultSnapshot::operator=(ResultSnapshot&& other) noexcept = default;
+
+    void ResultSnapshot::build(const SourceExplorerResult& result) {
+        SnapshotBuilder builder;
+        builder.addSummary("", result.errorMessage, result.success,
+                           result.filesProcessed, result.filesWithErrors, result.filesFromCache);
+        for (const auto& analysis : result.analyses) {
+            builder.addAnalysis(analysis);
+        }
+        pImpl->build(builder, SnapshotKind::SourceExplorer);
+    }
+
+    void ResultSnapshot::build(const PUMLClassDiagramResult& result) {
+        SnapshotBuilder builder;
+        builder.addSummary(result.title, result.errorMessage, result.success, 0, 0, 0);
+        for (const auto& cls : result.classes) {
+            builder.addUMLClass(cls);
+        }
+        for (const auto& relationship : result.relationships) {
+            UMLRelationshipRecord row = {};
+            row.fromClass = builder.ref(relationship.fromClass);
+            row.toClass = builder.ref(relationship.toClass);
+            row.label = builder.ref(relationship.label);
+            row.fromCardinality = builder.ref(relationship.fromCardinality);
+            row.toCardinality = builder.ref(relationship.toCardinality);
+            row.type = static_cast<uint32_t>(relationship.type);
+            builder.umlRelationships.push_back(row);
+        }
+        builder.addNotes(result.notes);
+        pImpl->build(builder, SnapshotKind::ClassDiagram);
+    }
+
+    void ResultSnapshot::build(const PUMLEntityDiagramResult& result) {
+        SnapshotBuilder builder;
+        builder.addSummary(result.title, result.errorMessage, result.success, 0, 0, 0);
+        for (const auto& entity : result.entities) {
+            builder.addEntity(entity);
+        }
+        for (const auto& relationship : result.relationships) {
+            builder.addEntityRelationship(relationship);
+        }
+        builder.addNotes(result.notes);
+        pImpl->build(builder, SnapshotKind::EntityDiagram);
+    }
+
+    bool ResultSnapshot::importJson(const std::string& jsonFilePath) {
+        SourceExplorerResult result;
+        if (!JsonModel::readExplorerResultFile(jsonFilePath, result, nullptr, pImpl->errorMessage)) {
+            return false;
+        }
+        build(result);
+        return true;
+    }
+
+    void ResultSnapshot::clear() {
+        pImpl->reset();
+    }
+
+    bool ResultSnapshot::save(const std::string& filePath) const {
+        // Written to a temporary file first so readers never map a half-written snapshot
+        std::string tempPath = filePath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                pImpl->errorMessage = "Could not write snapshot: " + tempPath;
+                return false;
+            }
+            if (pImpl->base == nullptr) {
+                // Empty snapshot: still a valid file
+                std::vector<uint64_t> empty = SnapshotBuilder().finish(SnapshotKind::None);
+                out.write(reinterpret_cast<const char*>(empty.data()), static_cast<std::streamsize>(empty.size() * 8));
+            } else {
+                out.write(pImpl->base, static_cast<std::streamsize>(pImpl->size));
+            }
+            if (!out.flush()) {
+                pImpl->errorMessage = "Could not write snapshot: " + tempPath;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        fs::rename(tempPath, filePath, ec);
+        if (ec) {
+            fs::remove(tempPath, ec);
+            pImpl->errorMessage = "Could not write snapshot: " + filePath;
+            return false;
+        }
+        return true;
+    }
+
+    bool ResultSnapshot::load(const std::string& filePath) {
+        return pImpl->load(filePath);
+    }
+
+    const std::string& ResultSnapshot::getErrorMessage() const {
+        return pImpl->errorMessage;
+    }
+
+    SnapshotKind ResultSnapshot::kind() const {
+        return pImpl->kind;
+    }
+
+    std::string_view ResultSnapshot::str(StringRef ref) const {
+        return pImpl->str(ref);
+    }
+
+    const Summary& ResultSnapshot::summary() const {
+        return pImpl->summary();
+    }
+
+    Table<StringRef> ResultSnapshot::names() const { return pImpl->table<StringRef>(NamesTable); }
+    Table<uint32_t> ResultSnapshot::values() const { return pImpl->table<uint32_t>(ValuesTable); }
+    Table<File> ResultSnapshot::files() const { return pImpl->table<File>(FilesTable); }
+    Table<Class> ResultSnapshot::classes() const { return pImpl->table<Class>(ClassesTable); }
+    Table<BaseClass> ResultSnapshot::baseClasses() const { return pImpl->table<BaseClass>(BaseClassesTable); }
+    Table<Member> ResultSnapshot::members() const { return pImpl->table<Member>(MembersTable); }
+    Table<Method> ResultSnapshot::methods() const { return pImpl->table<Method>(MethodsTable); }
+    Table<Parameter> ResultSnapshot::parameters() const { return pImpl->table<Parameter>(ParametersTable); }
+    Table<Enum> ResultSnapshot::enums() const { return pImpl->table<Enum>(EnumsTable); }
+    Table<EnumValue> ResultSnapshot::enumValues() const { return pImpl->table<EnumValue>(EnumValuesTable); }
+    Table<Namespace> ResultSnapshot::namespaces() const { return pImpl->table<Namespace>(NamespacesTable); }
+    Table<UMLClassRecord> ResultSnapshot::umlClasses() const { return pImpl->table<UMLClassRecord>(UMLClassesTable); }
+    Table<UMLAttributeRecord> ResultSnapshot::umlAttributes() const { return pImpl->table<UMLAttributeRecord>(UMLAttributesTable); }
+    Table<UMLMethodRecord> ResultSnapshot::umlMethods() const { return pImpl->table<UMLMethodRecord>(UMLMethodsTable); }
+    Table<UMLParameterRecord> ResultSnapshot::umlParameters() const { return pImpl->table<UMLParameterRecord>(UMLParametersTable); }
+    Table<UMLRelationshipRecord> ResultSnapshot::umlRelationships() const {
+        return pImpl->table<UMLRelationshipRecord>(UMLRelationshipsTable);
+    }
+    Table<Note> ResultSnapshot::notes() const { return pImpl->table<Note>(NotesTable); }
+    Table<EntityRecord> ResultSnapshot::entities() const { return pImpl->table<EntityRecord>(EntitiesTable); }
+    Table<EntityFieldRecord> ResultSnapshot::entityFields() const { return pImpl->table<EntityFieldRecord>(EntityFieldsTable); }
+    Table<EntityRelationshipRecord> ResultSnapshot::entityRelationships() const {
+        return pImpl->table<EntityRelationshipRecord>(EntityRelationshipsTable);
+    }
+
+    bool ResultSnapshot::toResult(SourceExplorerResult& result) const {
+        if (pImpl->kind != SnapshotKind::SourceExplorer) {
+            pImpl->errorMessage = "Snapshot does not hold a SourceExplorerResult";
+            return false;
+        }
+
+        const Summary& top = pImpl->summary();
+        result = SourceExplorerResult();
+        result.errorMessage = pImpl->string(top.errorMessage);
+        result.success = hasFlag(top.flags, Success);
+        result.filesProcessed = top.filesProcessed;
+        result.filesWithErrors = top.filesWithErrors;
+        result.filesFromCache = top.filesFromCache;
+
+        Table<File> fileTable = files();
+        result.analyses.reserve(fileTable.size());
+        for (const File& file : fileTable) {
+            result.analyses.push_back(pImpl->toAnalysis(file));
+        }
+        return true;
+    }
+
+    bool ResultSnapshot::toResult(PUMLClassDiagramResult& result) const {
+        if (pImpl->kind != SnapshotKind::ClassDiagram) {
+            pImpl->errorMessage = "Snapshot does not hold a class diagram";
+            return false;
+        }
+
+        const Impl& impl = *pImpl;
+        const Summary& top = impl.summary();
+        result = PUMLClassDiagramResult();
+        result.title = impl.string(top.title);
+        result.errorMessage = impl.string(top.errorMessage);
+        result.success = hasFlag(top.flags, Success);
+
+        for (const UMLClassRecord& row : umlClasses()) {
+            UMLClass cls;
+            cls.name = impl.string(row.name);
+            cls.stereotype = impl.string(row.stereotype);
+            cls.package = impl.string(row.package);
+            cls.note = impl.string(row.note);
+            cls.isAbstract = hasFlag(row.flags, IsAbstract);
+            cls.isInterface = hasFlag(row.flags, IsInterface);
+
+            for (const UMLAttributeRecord& attributeRow : umlAttributes().slice(row.attributes)) {
+                UMLAttribute attribute;
+                attribute.name = impl.string(attributeRow.name);
+                attribute.type = impl.str(attributeRow.type);
+                attribute.defaultValue = impl.string(attributeRow.defaultValue);
+                attribute.stereotype = impl.string(attributeRow.stereotype);
+                attribute.visibility = static_cast<UMLVisibility>(attributeRow.visibility);
+                attribute.isStatic = hasFlag(attributeRow.flags, IsStatic);
+                cls.attributes.push_back(std::move(attribute));
+            }
+
+            for (const UMLMethodRecord& methodRow : umlMethods().slice(row.methods)) {
+                UMLMethod method;
+                method.name = impl.string(methodRow.name);
+                method.returnType = impl.str(methodRow.returnType);
+                method.stereotype = impl.string(methodRow.stereotype);
+                method.visibility = static_cast<UMLVisibility>(methodRow.visibility);
+                method.isStatic = hasFlag(methodRow.flags, IsStatic);
+                method.isAbstract = hasFlag(methodRow.flags, IsAbstract);
+                for (const UMLParameterRecord& paramRow : umlParameters().slice(methodRow.parameters)) {
+                    UMLParameter param;
+                    param.name = impl.string(paramRow.name);
+                    param.type = impl.str(paramRow.type);
+                    param.direction = impl.string(paramRow.direction);
+                    param.defaultValue = impl.string(paramRow.defaultValue);
+                    method.parameters.push_back(std::move(param));
+                }
+                cls.methods.push_back(std::move(method));
+            }
+            result.classes.push_back(std::move(cls));
+        }
+
+        for (const UMLRelationshipRecord& row : umlRelationships()) {
+            UMLClassRelationship relationship;
+            relationship.fromClass = impl.string(row.fromClass);
+            relationship.toClass = impl.string(row.toClass);
+            relationship.label = impl.string(row.label);
+            relationship.fromCardinality = impl.string(row.fromCardinality);
+            relationship.toCardinality = impl.string(row.toCardinality);
+            relationship.type = static_cast<UMLRelationship>(row.type);
+            result.relationships.push_back(std::move(relationship));
+        }
+
+        for (const Note& note : notes()) {
+            result.notes.emplace(impl.string(note.key), impl.string(note.text));
+        }
+        return true;
+    }
+
+    bool ResultSnapshot::toResult(PUMLEntityDiagramResult& result) const {
+        if (pImpl->kind != SnapshotKind::EntityDiagram) {
+            pImpl->errorMessage = "Snapshot does not hold an entity diagram";
+            return false;
+        }
+
+        const Impl& impl = *pImpl;
+        const Summary& top = impl.summary();
+        result = PUMLEntityDiagramResult();
+        result.title = impl.string(top.title);
+        result.errorMessage = impl.string(top.errorMessage);
+        result.success = hasFlag(top.flags, Success);
+
+        for (const EntityRecord& row : entities()) {
+            Entity entity;
+            entity.name = impl.string(row.name);
+            entity.alias = impl.string(row.alias);
+            entity.schema = impl.string(row.schema);
+            entity.comment = impl.string(row.comment);
+            entity.stereotype = impl.string(row.stereotype);
+
+            for (const EntityFieldRecord& fieldRow : entityFields().slice(row.fields)) {
+                EntityField field;
+                field.name = impl.string(fieldRow.name);
+                field.type = impl.str(fieldRow.type);
+                field.defaultValue = impl.string(fieldRow.defaultValue);
+                field.comment = impl.string(fieldRow.comment);
+                field.isPrimaryKey = hasFlag(fieldRow.flags, IsPrimaryKey);
+                field.isForeignKey = hasFlag(fieldRow.flags, IsForeignKey);
+                field.isUnique = hasFlag(fieldRow.flags, IsUnique);
+                field.isNotNull = hasFlag(fieldRow.flags, IsNotNull);
+                for (uint32_t constraint : values().slice(fieldRow.constraints)) {
+                    field.constraints.push_back(static_cast<EntityFieldType>(constraint));
+                }
+                entity.fields.push_back(std::move(field));
+            }
+            result.entities.push_back(std::move(entity));
+        }
+
+        for (const EntityRelationshipRecord& row : entityRelationships()) {
+            EntityRelationship relationship;
+            relationship.fromEntity = impl.string(row.fromEntity);
+            relationship.toEntity = impl.string(row.toEntity);
+            relationship.label = impl.string(row.label);
+            relationship.fromCardinality = static_cast<Cardinality>(row.fromCardinality);
+            relationship.toCardinality = static_cast<Cardinality>(row.toCardinality);
+            relationship.type = static_cast<EntityRelationType>(row.type);
+            relationship.isIdentifying = hasFlag(row.flags, IsIdentifying);
+            relationship.fromFields = impl.nameList(row.fromFields);
+            relationship.toFields = impl.nameList(row.toFields);
+            result.relationships.push_back(std::move(relationship));
+        }
+
+        for (const Note& note : notes()) {
+            result.notes.emplace(impl.string(note.key), impl.string(note.text));
+        }
+        return true;
+    }
+
+    std::shared_ptr<const ParseResult> ResultSnapshot::toParseResult(size_t file) const {
+        return pImpl->toParseResult(files()[file]);
+    }
+
+    bool ResultSnapshot::exportToJson(std::ostream& out, bool bPretty) const {
+        if (pImpl->kind != SnapshotKind::SourceExplorer) {
+            pImpl->errorMessage = "Snapshot does not hold a SourceExplorerResult";
+            return false;
+        }
+        JsonWriter writer(out, bPretty);
+        pImpl->writeJson(writer);
+        writer.flush();
+        return writer.good();
+    }
+
+    std::string ResultSnapshot::exportToJson(bool bPretty) const {
+        std::string output;
+        if (pImpl->kind == SnapshotKind::SourceExplorer) {
+            JsonWriter writer(output, bPretty);
+            pImpl->writeJson(writer);
+        }
+        return output;
+    }
+
+} // namespace UFMTooling
@@ -1,363 +1,1818 @@
 #include "../include/SimpleHeaderParser.h"
-#include <fstream>
-#include <sstream>
+#include "../include/ArenaParseResult.h"
+#include "../include/MappedFile.h"
+#include "../include/ParseStats.h"
+#include "KeywordTable.h"
+#include "NameIndex.h"
+#include "WorkerThreads.h"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
-#include <regex>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace UFMTooling {
 
     // Helper functions for parsing
     namespace {
         // Trim whitespace from both ends
-        std::string trim(const std::string& str) {
+        std::string_view trim(std::string_view str) {
             size_t first = str.find_first_not_of(" \t\n\r");
-            if (first == std::string::npos) return "";
+            if (first == std::string_view::npos) return std::string_view();
             size_t last = str.find_last_not_of(" \t\n\r");
             return str.substr(first, last - first + 1);
         }
 
-        // Check if a line is a comment
-        bool isComment(const std::string& line) {
-            std::string trimmed = trim(line);
-            return trimmed.empty() || 
-                   trimmed.find("//") == 0 || 
-                   trimmed.find("/*") == 0 ||
-                   trimmed.find("*") == 0;
+        // Kinds of tokens produced by the header lexer
+        enum class TokenKind {
+            Identifier,
+            Number,
+            String,
+            CharLiteral,
+            Punct,
+            Directive   // A whole preprocessor line, starting at '#'
+        };
+
+        // Identifiers the passes look for, recognized once by the lexer
+        enum class Keyword : uint8_t {
+            None,
+            Class,
+            Struct,
+            Enum,
+            Namespace,
+            Using,
+            Template,
+            Public,
+            Protected,
+            Private,
+            Virtual,
+            Static,
+            Inline,
+            Const,
+            Mutable,
+            Friend,
+            Extern
+        };
+
+        constexpr KeywordEntry<Keyword> keywordEntries[] = {
+            {"class", Keyword::Class}, {"struct", Keyword::Struct}, {"enum", Keyword::Enum},
+            {"namespace", Keyword::Namespace}, {"using", Keyword::Using}, {"template", Keyword::Template},
+            {"public", Keyword::Public}, {"protected", Keyword::Protected}, {"private", Keyword::Private},
+            {"virtual", Keyword::Virtual}, {"static", Keyword::Static}, {"inline", Keyword::Inline},
+            {"const", Keyword::Const}, {"mutable", Keyword::Mutable}, {"friend", Keyword::Friend},
+            {"extern", Keyword::Extern}
+        };
+
+        constexpr KeywordTable<Keyword, std::size(keywordEntries)> keywords(keywordEntries, Keyword::None);
+        static_assert(keywords.valid(), "keywords need a perfect hash");
+
+        // Preprocessor directives the lexer handles
+        enum class DirectiveName : uint8_t {
+            None,
+            If,
+            Ifdef,
+            Ifndef,
+            Elif,
+            Elifdef,
+            Elifndef,
+            Else,
+            Endif,
+            Include,
+            Define,
+            Undef
+        };
+
+        constexpr KeywordEntry<DirectiveName> directiveEntries[] = {
+            {"if", DirectiveName::If}, {"ifdef", DirectiveName::Ifdef}, {"ifndef", DirectiveName::Ifndef},
+            {"elif", DirectiveName::Elif}, {"elifdef", DirectiveName::Elifdef}, {"elifndef", DirectiveName::Elifndef},
+            {"else", DirectiveName::Else}, {"endif", DirectiveName::Endif}, {"include", DirectiveName::Include},
+            {"define", DirectiveName::Define}, {"undef", DirectiveName::Undef}
+        };
+
+        constexpr KeywordTable<DirectiveName, std::size(directiveEntries)> directiveNames(directiveEntries, DirectiveName::None);
+        static_assert(directiveNames.valid(), "directive names need a perfect hash");
+
+        struct Token {
+            TokenKind kind;
+            Keyword keyword;        // None unless an Identifier of the keyword table
+            std::string_view text;
+
+            bool is(TokenKind k, std::string_view t) const { return kind == k && text == t; }
+            bool is(Keyword k) const { return keyword == k; }
+            bool isPunct(std::string_view t) const { return is(TokenKind::Punct, t); }
+        };
+
+        // Range of tokens [begin, end) that start on one source line
+        struct LineTokens {
+            size_t begin;
+            size_t end;
+
+            LineTokens() : begin(0), end(0) {}
+            bool empty() const { return begin == end; }
+        };
+
+        // No namespace node, class or scope
+        const size_t noIndex = static_cast<size_t>(-1);
+
+        // Kinds of brace scopes met by the declaration pass
+        enum class ScopeKind {
+            Namespace,
+            Class,
+            Block       // Function body, initializer, extern "C", enum body...
+        };
+
+        struct Scope {
+            ScopeKind kind;
+            size_t index;               // Namespace node or class
+            size_t owner;               // Position in the stack of the innermost namespace or class scope
+            size_t qualifierLength;     // Length of the qualifier before the scope was entered
+            AccessSpecifier access;     // Current access in a class scope
+        };
+
+        // A namespace as met in the file; a reopened namespace shares its node
+        struct NamespaceNode {
+            std::string_view name;
+            std::vector<size_t> classes;    // Classes declared directly in the namespace
+            std::vector<size_t> children;
+        };
+
+        // What the declaration pass needs to know about one line
+        struct LineShape {
+            size_t templateEnd;     // First token after a leading template <...> clause (begin if none)
+            size_t classPos;        // class/struct keyword that may declare a class, or end
+            bool definesClass;      // classPos is followed by '{', or by no ';' (body on a later line)
+            bool hasSemicolon;
+            bool hasOpenParen;
+            bool hasCloseParen;
+        };
+
+        // Declaration pass policies of the ParseDetail levels that tokenize
+        struct FullPolicy {
+            static constexpr bool bMembers = true;
+            static constexpr bool bMethods = true;
+        };
+
+        struct NoMethodsPolicy {
+            static constexpr bool bMembers = true;
+            static constexpr bool bMethods = false;
+        };
+
+        struct TypesPolicy {
+            static constexpr bool bMembers = false;
+            static constexpr bool bMethods = false;
+        };
+
+        // Deep copy of a class into another result's arena (pmr copies would use the default resource)
+        void copyClass(const ArenaClassInfo& from, ArenaClassInfo& to) {
+            std::pmr::memory_resource* resource = to.methods.get_allocator().resource();
+            to.name = from.name;
+            to.fullName = from.fullName;
+            to.isStruct = from.isStruct;
+            to.isTemplate = from.isTemplate;
+            to.baseClasses.assign(from.baseClasses.begin(), from.baseClasses.end());
+            to.members.assign(from.members.begin(), from.members.end());
+            to.friendClasses.assign(from.friendClasses.begin(), from.friendClasses.end());
+            to.templateParameters.assign(from.templateParameters.begin(), from.templateParameters.end());
+            to.methods.reserve(from.methods.size());
+            for (const auto& method : from.methods) {
+                to.methods.emplace_back(resource);
+                ArenaMethodInfo& copy = to.methods.back();
+                copy.name = method.name;
+                copy.returnType = method.returnType;
+                copy.access = method.access;
+                copy.parameters.assign(method.parameters.begin(), method.parameters.end());
+                copy.isStatic = method.isStatic;
+                copy.isConst = method.isConst;
+                copy.isVirtual = method.isVirtual;
+                copy.isPureVirtual = method.isPureVirtual;
+                copy.isConstructor = method.isConstructor;
+                copy.isDestructor = method.isDestructor;
+                copy.isOperator = method.isOperator;
+            }
+        }
+
+        // Merge the namespaces of a later chunk into those of the chunks before it: a
+        // namespace already met gets the later classes and nested namespaces appended
+        void mergeNamespaces(std::vector<NamespaceInfo>& into, std::vector<NamespaceInfo>& from) {
+            for (auto& ns : from) {
+                auto found = std::find_if(into.begin(), into.end(),
+                                          [&](const NamespaceInfo& existing) { return existing.name == ns.name; });
+                if (found == into.end()) {
+                    into.push_back(std::move(ns));
+                    continue;
+                }
+                std::move(ns.classes.begin(), ns.classes.end(), std::back_inserter(found->classes));
+                mergeNamespaces(found->nestedNamespaces, ns.nestedNamespaces);
+            }
+        }
+
+        // Character classes of the prescan of a parallel parse
+        enum class ScanClass : unsigned char {
+            Other,
+            Space,
+            Newline,
+            Word,           // Identifier and number characters
+            Quote,
+            Slash,
+            Hash,
+            Backslash,
+            Open,
+            Close,
+            Semicolon
+        };
+
+        struct ScanTable {
+            ScanClass classes[256];
+
+            constexpr ScanTable() : classes() {
+                for (int c = 'a'; c <= 'z'; ++c) classes[c] = ScanClass::Word;
+                for (int c = 'A'; c <= 'Z'; ++c) classes[c] = ScanClass::Word;
+                for (int c = '0'; c <= '9'; ++c) classes[c] = ScanClass::Word;
+                classes[static_cast<unsigned char>('_')] = ScanClass::Word;
+                classes[static_cast<unsigned char>(' ')] = ScanClass::Space;
+                classes[static_cast<unsigned char>('\t')] = ScanClass::Space;
+                classes[static_cast<unsigned char>('\r')] = ScanClass::Space;
+                classes[static_cast<unsigned char>('\f')] = ScanClass::Space;
+                classes[static_cast<unsigned char>('\v')] = ScanClass::Space;
+                classes[static_cast<unsigned char>('\n')] = ScanClass::Newline;
+                classes[static_cast<unsigned char>('"')] = ScanClass::Quote;
+                classes[static_cast<unsigned char>('\'')] = ScanClass::Quote;
+                classes[static_cast<unsigned char>('/')] = ScanClass::Slash;
+                classes[static_cast<unsigned char>('#')] = ScanClass::Hash;
+                classes[static_cast<unsigned char>('\\')] = ScanClass::Backslash;
+                classes[static_cast<unsigned char>('{')] = ScanClass::Open;
+                classes[static_cast<unsigned char>('}')] = ScanClass::Close;
+                classes[static_cast<unsigned char>(';')] = ScanClass::Semicolon;
+            }
+        };
+
+        constexpr ScanTable scanTable;
+
+        bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        bool isIdentStart(char c) {
+            return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool isIdentChar(char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        // Forwards to another resource and counts what is allocated through it
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            uint64_t allocations;
+            uint64_t bytes;
+
+            explicit CountingResource(std::pmr::memory_resource* upstream)
+                : allocations(0), bytes(0), upstream(upstream) {}
+
+        private:
+            std::pmr::memory_resource* upstream;
+
+            void* do_allocate(size_t size, size_t alignment) override {
+                allocations++;
+                bytes += size;
+                return upstream->allocate(size, alignment);
+            }
+
+            void do_deallocate(void* p, size_t size, size_t alignment) override {
+                upstream->deallocate(p, size, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        // Outcome of a preprocessor condition the lexer can (or cannot) decide
+        enum class Condition {
+            False,
+            True,
+            Unknown
+        };
+
+        // #if/#elif/#else/#endif nesting. A branch is skipped only when its condition is
+        // known to be false or an earlier branch of the same #if was known to be true;
+        // conditions that cannot be decided keep their code.
+        class ConditionalBlocks {
+        public:
+            bool active() const { return frames.empty() || frames.back().active; }
+
+            void open(Condition condition) {
+                Frame frame;
+                if (!active()) {
+                    frame.active = false;
+                    frame.taken = true;     // Nothing in a skipped block is ever active
+                } else {
+                    frame.active = condition != Condition::False;
+                    frame.taken = condition == Condition::True;
+                }
+                frames.push_back(frame);
+            }
+
+            // #elif: only evaluated while no earlier branch was taken
+            bool needsCondition() const { return !frames.empty() && !frames.back().taken; }
+
+            void elif(Condition condition) {
+                if (frames.empty()) return;
+                Frame& frame = frames.back();
+                frame.active = !frame.taken && condition != Condition::False;
+                frame.taken = frame.taken || condition == Condition::True;
+            }
+
+            void otherwise() {
+                if (frames.empty()) return;
+                Frame& frame = frames.back();
+                frame.active = !frame.taken;
+                frame.taken = true;
+            }
+
+            void close() {
+                if (!frames.empty()) frames.pop_back();
+            }
+
+        private:
+            struct Frame {
+                bool active;
+                bool taken;
+            };
+            std::vector<Frame> frames;
+        };
+
+        // Braces the prescan of a parallel parse tells apart
+        enum class BraceKind {
+            Namespace,
+            Linkage,        // extern "C" { ... }
+            Other
+        };
+
+        struct OpenBrace {
+            BraceKind kind;
+            std::vector<std::string_view> names;    // Namespace: a::b::c, empty if anonymous
+        };
+
+        // Where a chunk of a parallel parse starts, and the state of the file there
+        struct ChunkStart {
+            size_t offset;                          // Start of a line
+            ConditionalBlocks blocks;
+            std::unordered_set<std::string_view> defined;
+            std::vector<OpenBrace> enclosing;       // Namespaces and linkage blocks, outermost first
+        };
+
+        // Hand-written single-pass lexer and preprocessing stage: comments, whitespace and
+        // '\' line continuations are skipped, every other token keeps a view into the
+        // original content. Preprocessor lines become one Directive token each; include
+        // targets are collected on the way, and with bSkipDisabledBlocks the tokens of
+        // blocks whose condition is known to be false are dropped.
+        class HeaderLexer {
+        public:
+            HeaderLexer(std::string_view content, const PreprocessorOptions& options)
+                : src(content), pos(0), lineStart(true), options(options) {
+                if (options.bEvaluateDefines) {
+                    defined.insert(options.defines.begin(), options.defines.end());
+                }
+            }
+
+            // Resume at the start of a chunk found by prescan()
+            HeaderLexer(std::string_view content, const PreprocessorOptions& options, const ChunkStart& start)
+                : src(content), pos(0), lineStart(true), options(options), blocks(start.blocks), defined(start.defined) {}
+
+            void tokenize(std::vector<Token>& tokens, std::vector<LineTokens>& lines,
+                          std::pmr::vector<std::string_view>& includes) {
+                tokens.clear();
+                lines.clear();
+                lines.emplace_back();
+
+                while (pos < src.size()) {
+                    char c = src[pos];
+
+                    if (c == '\n') {
+                        newLine(tokens, lines);
+                        ++pos;
+                        continue;
+                    }
+                    if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+                        ++pos;
+                        continue;
+                    }
+                    if (size_t length = continuationLength()) {
+                        pos += length;      // Joined with the next line
+                        continue;
+                    }
+                    if (c == '/' && peek(1) == '/') {
+                        skipLineComment();
+                        continue;
+                    }
+                    if (c == '/' && peek(1) == '*') {
+                        pos += 2;
+                        while (pos < src.size() && !(src[pos] == '*' && peek(1) == '/')) {
+                            if (src[pos] == '\n') newLine(tokens, lines);
+                            ++pos;
+                        }
+                        pos = std::min(pos + 2, src.size());
+                        continue;
+                    }
+
+                    size_t start = pos;
+                    TokenKind kind = TokenKind::Punct;
+
+                    if (c == '#' && lineStart) {
+                        kind = TokenKind::Directive;
+                        skipDirective();
+                        while (pos > start && std::isspace(static_cast<unsigned char>(src[pos - 1]))) --pos;
+                        directive(src.substr(start + 1, pos - start - 1), includes);
+                    } else if (isIdentStart(c)) {
+                        kind = TokenKind::Identifier;
+                        while (pos < src.size() && isIdentChar(src[pos])) ++pos;
+                        std::string_view ident = src.substr(start, pos - start);
+                        if (pos < src.size() && src[pos] == '"' && isRawStringPrefix(ident)) {
+                            kind = TokenKind::String;
+                            skipRawString();
+                        } else if (pos < src.size() && (src[pos] == '"' || src[pos] == '\'') && isEncodingPrefix(ident)) {
+                            kind = src[pos] == '"' ? TokenKind::String : TokenKind::CharLiteral;
+                            skipQuoted(src[pos]);
+                        }
+                    } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                               (c == '.' && std::isdigit(static_cast<unsigned char>(peek(1))))) {
+                        kind = TokenKind::Number;
+                        ++pos;
+                        while (pos < src.size() && (isIdentChar(src[pos]) || src[pos] == '.' || src[pos] == '\'')) ++pos;
+                    } else if (c == '"' || c == '\'') {
+                        kind = c == '"' ? TokenKind::String : TokenKind::CharLiteral;
+                        skipQuoted(c);
+                    } else {
+                        pos += punctLength();
+                    }
+
+                    lineStart = false;
+                    if (!blocks.active()) {
+                        continue;
+                    }
+                    Token token;
+                    token.kind = kind;
+                    token.text = src.substr(start, pos - start);
+                    token.keyword = kind == TokenKind::Identifier ? keywords.find(token.text) : Keyword::None;
+                    tokens.push_back(token);
+                    lines.back().end = tokens.size();
+                }
+            }
+
+            // Structure-only pass of a parallel parse: comments, literals and directives are
+            // handled as in tokenize(), but no token is built; only the brace nesting is
+            // followed. Past every chunkBytes, a chunk starts at the next line that follows a
+            // ';', '{' or '}' while only namespaces and extern "C" blocks are open, so that no
+            // declaration spans two chunks. chunks[0] starts the file. Returns the line count.
+            size_t prescan(size_t chunkBytes, std::vector<ChunkStart>& chunks,
+                           std::pmr::vector<std::string_view>& includes) {
+                chunks.clear();
+                chunks.push_back(ChunkStart{0, blocks, defined, {}});
+
+                std::vector<OpenBrace> open;
+                size_t otherBraces = 0;                 // Open braces of kind Other
+                BraceKind pending = BraceKind::Other;   // What the next '{' opens
+                size_t namesBegin = 0;                  // After the last namespace keyword
+                bool bAfterExtern = false;
+                char last = ';';                        // ';', '{' or '}' if the last active token was one
+                size_t nextChunk = chunkBytes;
+                size_t lineCount = 1;
+                const size_t size = src.size();
+
+                while (pos < size) {
+                    char c = src[pos];
+                    size_t start = pos;
+
+                    switch (scanTable.classes[static_cast<unsigned char>(c)]) {
+                        case ScanClass::Space:
+                            do {
+                                ++pos;
+                            } while (pos < size && scanTable.classes[static_cast<unsigned char>(src[pos])] == ScanClass::Space);
+                            continue;
+
+                        case ScanClass::Newline:
+                            ++pos;
+                            ++lineCount;
+                            lineStart = true;
+                            if (pos >= nextChunk && pos < size && otherBraces == 0 &&
+                                (last == ';' || last == '{' || last == '}')) {
+                                chunks.push_back(ChunkStart{pos, blocks, defined, open});
+                                nextChunk = pos + chunkBytes;
+                            }
+                            continue;
+
+                        case ScanClass::Word: {
+                            // Identifier or number; most of the text goes through this loop
+                            bool bNumber = isDigit(c);
+                            do {
+                                ++pos;
+                            } while (pos < size && scanTable.classes[static_cast<unsigned char>(src[pos])] == ScanClass::Word);
+                            while (bNumber && pos < size && (src[pos] == '.' || src[pos] == '\'' ||
+                                                             scanTable.classes[static_cast<unsigned char>(src[pos])] == ScanClass::Word)) {
+                                ++pos;
+                            }
+                            lineStart = false;
+                            std::string_view word = src.substr(start, pos - start);
+                            bool bRaw = !bNumber && pos < size && src[pos] == '"' && isRawStringPrefix(word);
+                            if (bRaw) {
+                                skipRawString();
+                            }
+                            if (!blocks.active()) continue;
+                            Keyword keyword = bNumber || bRaw ? Keyword::None : keywords.find(word);
+                            if (bRaw) {
+                                pending = bAfterExtern ? BraceKind::Linkage : BraceKind::Other;
+                            } else if (keyword == Keyword::Namespace) {
+                                pending = BraceKind::Namespace;
+                                namesBegin = pos;
+                            } else if (pending == BraceKind::Linkage) {
+                                pending = BraceKind::Other;
+                            }
+                            bAfterExtern = keyword == Keyword::Extern;
+                            last = 'a';
+                            continue;
+                        }
+
+                        case ScanClass::Quote:
+                            skipQuoted(c);
+                            lineStart = false;
+                            if (!blocks.active()) continue;
+                            pending = bAfterExtern && c == '"' ? BraceKind::Linkage : BraceKind::Other;
+                            bAfterExtern = false;
+                            last = 'a';
+                            continue;
+
+                        case ScanClass::Slash:
+                            if (peek(1) == '/') {
+                                skipLineComment();
+                                continue;
+                            }
+                            if (peek(1) == '*') {
+                                size_t close = src.find("*/", pos + 2);
+                                size_t end = close == std::string_view::npos ? size : close + 2;
+                                size_t newlines = static_cast<size_t>(std::count(src.begin() + pos, src.begin() + end, '\n'));
+                                lineCount += newlines;
+                                if (newlines != 0) lineStart = true;   // As in tokenize(): a directive may follow
+                                pos = end;
+                                continue;
+                            }
+                            break;
+
+                        case ScanClass::Hash:
+                            if (lineStart) {
+                                skipDirective();
+                                while (pos > start && std::isspace(static_cast<unsigned char>(src[pos - 1]))) --pos;
+                                directive(src.substr(start + 1, pos - start - 1), includes);
+                                lineStart = false;
+                                continue;
+                            }
+                            break;
+
+                        case ScanClass::Backslash:
+                            if (size_t length = continuationLength()) {
+                                pos += length;
+                                continue;
+                            }
+                            break;
+
+                        case ScanClass::Open:
+                            ++pos;
+                            lineStart = false;
+                            if (!blocks.active()) continue;
+                            {
+                                OpenBrace brace{pending, {}};
+                                if (pending == BraceKind::Namespace &&
+                                    !namespaceNames(src.substr(namesBegin, start - namesBegin), brace.names)) {
+                                    brace.kind = BraceKind::Other;
+                                }
+                                if (brace.kind == BraceKind::Other) ++otherBraces;
+                                open.push_back(std::move(brace));
+                            }
+                            pending = BraceKind::Other;
+                            bAfterExtern = false;
+                            last = '{';
+                            continue;
+
+                        case ScanClass::Close:
+                        case ScanClass::Semicolon:
+                            ++pos;
+                            lineStart = false;
+                            if (!blocks.active()) continue;
+                            if (c == '}' && !open.empty()) {
+                                if (open.back().kind == BraceKind::Other) --otherBraces;
+                                open.pop_back();
+                            }
+                            pending = BraceKind::Other;
+                            bAfterExtern = false;
+                            last = c;
+                            continue;
+
+                        case ScanClass::Other:
+                            break;
+                    }
+
+                    // Any other punctuation
+                    ++pos;
+                    lineStart = false;
+                    if (!blocks.active()) continue;
+                    if (pending == BraceKind::Linkage) pending = BraceKind::Other;
+                    bAfterExtern = false;
+                    last = 'a';
+                }
+                return lineCount;
+            }
+
+        private:
+            std::string_view src;
+            size_t pos;
+            bool lineStart;
+            const PreprocessorOptions& options;
+            ConditionalBlocks blocks;
+            std::unordered_set<std::string_view> defined;   // Views into options.defines or src
+
+            char peek(size_t offset) const {
+                return pos + offset < src.size() ? src[pos + offset] : '\0';
+            }
+
+            // Length of a '\' newline sequence at pos, or 0
+            size_t continuationLength() const {
+                if (src[pos] != '\\') return 0;
+                if (peek(1) == '\n') return 2;
+                if (peek(1) == '\r' && peek(2) == '\n') return 3;
+                return 0;
+            }
+
+            void newLine(const std::vector<Token>& tokens, std::vector<LineTokens>& lines) {
+                LineTokens next;
+                next.begin = next.end = tokens.size();
+                lines.push_back(next);
+                lineStart = true;
+            }
+
+            // Skip to the end of a // comment; a '\' at the end of the line continues it
+            void skipLineComment() {
+                while (pos < src.size() && src[pos] != '\n') {
+                    size_t length = continuationLength();
+                    pos += length != 0 ? length : 1;
+                }
+            }
+
+            // Skip to the end of the logical preprocessor line: continuations and the
+            // newlines inside /* */ comments do not end it
+            void skipDirective() {
+                while (pos < src.size() && src[pos] != '\n') {
+                    if (size_t length = continuationLength()) {
+                        pos += length;
+                    } else if (src[pos] == '/' && peek(1) == '/') {
+                        skipLineComment();
+                    } else if (src[pos] == '/' && peek(1) == '*') {
+                        size_t close = src.find("*/", pos + 2);
+                        pos = close == std::string_view::npos ? src.size() : close + 2;
+                    } else if (src[pos] == '"') {
+                        skipQuoted('"');
+                    } else {
+                        ++pos;
+                    }
+                }
+            }
+
+            // Handle one preprocessor line (text after the '#')
+            void directive(std::string_view text, std::pmr::vector<std::string_view>& includes) {
+                std::string_view rest = trim(text);
+                size_t wordEnd = 0;
+                while (wordEnd < rest.size() && isIdentChar(rest[wordEnd])) ++wordEnd;
+                DirectiveName name = directiveNames.find(rest.substr(0, wordEnd));
+                rest = trim(rest.substr(wordEnd));
+
+                if (options.bSkipDisabledBlocks) {
+                    switch (name) {
+                        case DirectiveName::If:
+                        case DirectiveName::Ifdef:
+                        case DirectiveName::Ifndef:
+                            blocks.open(blocks.active() ? evaluate(name, rest) : Condition::Unknown);
+                            return;
+                        case DirectiveName::Elif:
+                        case DirectiveName::Elifdef:
+                        case DirectiveName::Elifndef:
+                            blocks.elif(blocks.needsCondition() ? evaluate(name, rest) : Condition::Unknown);
+                            return;
+                        case DirectiveName::Else:
+                            blocks.otherwise();
+                            return;
+                        case DirectiveName::Endif:
+                            blocks.close();
+                            return;
+                        default:
+                            break;
+                    }
+                }
+                if (!blocks.active()) {
+                    return;
+                }
+
+                if (name == DirectiveName::Include) {
+                    // #  include  <name> | "name"
+                    if (rest.empty() || (rest[0] != '<' && rest[0] != '"')) return;
+                    size_t close = rest.find_first_of(">\"", 1);
+                    if (close == std::string_view::npos || close == 1) return;
+                    includes.push_back(rest.substr(1, close - 1));
+                } else if (options.bEvaluateDefines && (name == DirectiveName::Define || name == DirectiveName::Undef)) {
+                    std::string_view macro = leadingIdentifier(rest);
+                    if (macro.empty()) return;
+                    if (name == DirectiveName::Define) {
+                        defined.insert(macro);
+                    } else {
+                        defined.erase(macro);
+                    }
+                }
+            }
+
+            // Decide the condition of #if/#ifdef/#ifndef and their #elif forms. Only an
+            // integer, defined(NAME) / defined NAME and their negation with '!' are
+            // understood; defines are only consulted with bEvaluateDefines.
+            Condition evaluate(DirectiveName name, std::string_view argument) const {
+                argument = trim(argument.substr(0, std::min(argument.find("//"), argument.find("/*"))));
+                if (name == DirectiveName::Ifdef || name == DirectiveName::Elifdef) {
+                    return isDefined(wholeIdentifier(argument));
+                }
+                if (name == DirectiveName::Ifndef || name == DirectiveName::Elifndef) {
+                    return negate(isDefined(wholeIdentifier(argument)));
+                }
+
+                bool bNegate = false;
+                if (!argument.empty() && argument[0] == '!') {
+                    bNegate = true;
+                    argument = trim(argument.substr(1));
+                }
+
+                Condition condition = Condition::Unknown;
+                if (!argument.empty() && std::all_of(argument.begin(), argument.end(),
+                                                     [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+                    condition = argument.find_first_not_of('0') == std::string_view::npos ? Condition::False : Condition::True;
+                } else if (argument.compare(0, 7, "defined") == 0 &&
+                           (argument.size() == 7 || !isIdentChar(argument[7]))) {
+                    std::string_view name = trim(argument.substr(7));
+                    if (!name.empty() && name.front() == '(' && name.back() == ')') {
+                        name = trim(name.substr(1, name.size() - 2));
+                    }
+                    condition = isDefined(wholeIdentifier(name));
+                }
+                return bNegate ? negate(condition) : condition;
+            }
+
+            Condition isDefined(std::string_view name) const {
+                if (!options.bEvaluateDefines || name.empty()) return Condition::Unknown;
+                return defined.count(name) != 0 ? Condition::True : Condition::False;
+            }
+
+            static Condition negate(Condition condition) {
+                if (condition == Condition::Unknown) return condition;
+                return condition == Condition::True ? Condition::False : Condition::True;
+            }
+
+            // Names of a namespace definition from the text between the keyword and its '{',
+            // as the declaration pass reads them; false for anything else
+            static bool namespaceNames(std::string_view text, std::vector<std::string_view>& names) {
+                bool bExpectName = true;
+                text = trim(text);
+                while (!text.empty()) {
+                    if (!bExpectName && text.compare(0, 2, "::") == 0) {
+                        bExpectName = true;
+                        text = trim(text.substr(2));
+                        continue;
+                    }
+                    std::string_view name = leadingIdentifier(text);
+                    if (!bExpectName || name.empty()) return false;
+                    text = trim(text.substr(name.size()));
+                    if (name == "inline") continue;
+                    names.push_back(name);
+                    bExpectName = false;
+                }
+                return names.empty() || !bExpectName;
+            }
+
+            static std::string_view leadingIdentifier(std::string_view text) {
+                if (text.empty() || !isIdentStart(text[0])) return std::string_view();
+                size_t end = 1;
+                while (end < text.size() && isIdentChar(text[end])) ++end;
+                return text.substr(0, end);
+            }
+
+            // text if it is exactly one identifier, else empty
+            static std::string_view wholeIdentifier(std::string_view text) {
+                std::string_view name = leadingIdentifier(text);
+                return name.size() == text.size() ? name : std::string_view();
+            }
+
+            static bool isRawStringPrefix(std::string_view ident) {
+                return ident == "R" || ident == "LR" || ident == "uR" || ident == "UR" || ident == "u8R";
+            }
+
+            static bool isEncodingPrefix(std::string_view ident) {
+                return ident == "L" || ident == "u" || ident == "U" || ident == "u8";
+            }
+
+            // Skip a "..." or '...' literal starting at pos (escape aware, stops at end of line)
+            void skipQuoted(char quote) {
+                ++pos;
+                while (pos < src.size() && src[pos] != quote && src[pos] != '\n') {
+                    if (src[pos] == '\\' && pos + 1 < src.size()) ++pos;
+                    ++pos;
+                }
+                if (pos < src.size() && src[pos] == quote) ++pos;
+            }
+
+            // Skip R"delim( ... )delim" starting at the opening quote
+            void skipRawString() {
+                size_t open = src.find('(', pos);
+                if (open == std::string_view::npos) {
+                    skipQuoted('"');
+                    return;
+                }
+                std::string closing = ")";
+                closing.append(src.substr(pos + 1, open - pos - 1));
+                closing.push_back('"');
+                size_t close = src.find(closing, open);
+                pos = close == std::string_view::npos ? src.size() : close + closing.size();
+            }
+
+            size_t punctLength() const {
+                static const char* const twoCharPuncts[] = {
+                    "::", "->", "&&", "||", "==", "!=", "<=", ">=", "++", "--",
+                    "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<"
+                };
+                if (pos + 1 < src.size()) {
+                    for (const char* p : twoCharPuncts) {
+                        if (src[pos] == p[0] && src[pos + 1] == p[1]) return 2;
+                    }
+                }
+                return 1;
+            }
+        };
+
+        // Contiguous source text covered by tokens [begin, end)
+        std::string_view tokenSpan(const std::vector<Token>& tokens, size_t begin, size_t end) {
+            if (begin >= end) return std::string_view();
+            const char* first = tokens[begin].text.data();
+            const char* last = tokens[end - 1].text.data() + tokens[end - 1].text.size();
+            return std::string_view(first, static_cast<size_t>(last - first));
         }
 
-        // Remove comments from a line
-        std::string removeComments(const std::string& line) {
-            size_t pos = line.find("//");
-            if (pos != std::string::npos) {
-                return line.substr(0, pos);
+        // Source text of tokens [begin, end) with the tokens matching 'skip' removed,
+        // keeping the surrounding whitespace exactly as written. Returns a view of the
+        // source when nothing is skipped, otherwise a view of out.
+        template <typename Skip>
+        std::string_view spanWithout(const std::vector<Token>& tokens, size_t begin, size_t end, Skip skip,
+                                     std::string& out) {
+            if (std::none_of(tokens.begin() + begin, tokens.begin() + end, skip)) {
+                return tokenSpan(tokens, begin, end);
+            }
+
+            out.clear();
+            for (size_t i = begin; i < end; ++i) {
+                if (i > begin) {
+                    const char* prevEnd = tokens[i - 1].text.data() + tokens[i - 1].text.size();
+                    out.append(prevEnd, static_cast<size_t>(tokens[i].text.data() - prevEnd));
+                }
+                if (!skip(tokens[i])) {
+                    out.append(tokens[i].text.data(), tokens[i].text.size());
+                }
             }
-            return line;
+            return out;
         }
 
-        // Parse access specifier
-        AccessSpecifier parseAccessSpecifier(const std::string& str) {
-            std::string s = trim(str);
-            if (s == "public" || s == "public:") return AccessSpecifier::Public;
-            if (s == "protected" || s == "protected:") return AccessSpecifier::Protected;
-            if (s == "private" || s == "private:") return AccessSpecifier::Private;
-            return AccessSpecifier::None;
+        // Find the first token in [begin, end) satisfying pred
+        template <typename Pred>
+        size_t findToken(const std::vector<Token>& tokens, size_t begin, size_t end, Pred pred) {
+            for (size_t i = begin; i < end; ++i) {
+                if (pred(tokens[i])) return i;
+            }
+            return end;
         }
 
-        // Check if a string contains a keyword
-        bool containsKeyword(const std::string& str, const std::string& keyword) {
-            return str.find(keyword) != std::string::npos;
+        // Split tokens [begin, end) on top-level commas (outside <>, () and []) into parts
+        void splitOnCommas(const std::vector<Token>& tokens, size_t begin, size_t end, std::vector<LineTokens>& parts) {
+            parts.clear();
+            LineTokens current;
+            current.begin = begin;
+            int depth = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const Token& t = tokens[i];
+                if (t.kind != TokenKind::Punct) continue;
+                if (t.text == "<" || t.text == "(" || t.text == "[") {
+                    depth++;
+                } else if ((t.text == ">" || t.text == ")" || t.text == "]") && depth > 0) {
+                    depth--;
+                } else if (t.text == "," && depth == 0) {
+                    current.end = i;
+                    parts.push_back(current);
+                    current.begin = i + 1;
+                }
+            }
+            current.end = end;
+            parts.push_back(current);
         }
     }
 
     // Implementation class (Pimpl pattern)
     class SimpleHeaderParser::Impl {
     public:
-        std::vector<ClassInfo> classes;
-        std::vector<NamespaceInfo> namespaces;
-        std::vector<EnumInfo> enums;
         std::vector<std::string> warnings;
-        ParseResult lastResult;
+        std::shared_ptr<const ParseResult> lastResult;
+        NameIndex classIndex;       // Class name and fullName -> position in lastResult->classes
+        ParseStats* stats = nullptr;
+        PreprocessorOptions preprocessor;
+        ParallelParseOptions parallel;
+        ParseDetail detail = ParseDetail::Full;
+        bool bCopyFiles = false;    // Read files instead of mapping them
 
-        ParseResult parse(const std::string& content, const std::string& fileName) {
-            ParseResult result;
-            result.fileName = fileName;
-            result.success = true;
+        Impl() : lastResult(std::make_shared<ParseResult>()) {}
+
+        // Start timing a file; every stats call is a no-op without a collector
+        void beginFile(const std::string& fileName) {
+            if (stats == nullptr) {
+                return;
+            }
+            fileStats = FileParseStats();
+            fileStats.path = fileName;
+            fileStats.startMs = stageMark = stats->now();
+        }
+
+        // Charge the time since the previous mark to stage
+        void lap(ParseStage stage) {
+            if (stats == nullptr) {
+                return;
+            }
+            double now = stats->now();
+            fileStats.stage(stage) += now - stageMark;
+            stageMark = now;
+        }
+
+        void finishFile() {
+            if (stats == nullptr) {
+                return;
+            }
+            fileStats.totalMs = stats->now() - fileStats.startMs;
+            stats->recordFile(std::move(fileStats));
+        }
+
+        void setLastResult(std::shared_ptr<const ParseResult> result) {
+            lastResult = std::move(result);
+            classIndex.clear();
+            classIndex.reserve(lastResult->classes.size() * 2);
+            for (size_t i = 0; i < lastResult->classes.size(); ++i) {
+                classIndex.insert(lastResult->classes[i].name, i);
+                classIndex.insert(lastResult->classes[i].fullName, i);
+            }
+        }
 
-            classes.clear();
-            namespaces.clear();
-            enums.clear();
+        // Parse into the regular result structures: the file is parsed into a scratch
+        // arena (reset for every file) and copied out once, with exact-size vectors
+        std::shared_ptr<const ParseResult> parse(std::string_view content, const std::string& fileName) {
             warnings.clear();
+            if (parallel.threadCount != 1 && content.size() >= parallel.minFileBytes &&
+                detail != ParseDetail::IncludesOnly) {
+                size_t chunkBytes = std::max<size_t>(parallel.minChunkBytes, 1);
+                unsigned int threadCount = resolveThreadCount(parallel.threadCount, content.size() / chunkBytes);
+                if (threadCount > 1) {
+                    if (std::shared_ptr<ParseResult> result = parseParallel(content, fileName, threadCount)) {
+                        finishFile();
+                        setLastResult(result);
+                        return result;
+                    }
+                }
+            }
 
-            try {
-                std::istringstream stream(content);
-                std::string line;
-                std::vector<std::string> lines;
+            std::shared_ptr<ParseResult> result;
+            CountingResource counting(&scratch);
+            {
+                std::pmr::memory_resource* resource = &scratch;
+                if (stats != nullptr) {
+                    resource = &counting;
+                }
+                ArenaParseResult arenaResult(resource, ArenaParseResult::BorrowedResource());
+                arenaResult.borrowSource(content);
+                parseInto(arenaResult, fileName);
+                result = std::make_shared<ParseResult>(arenaResult.toParseResult());
+            }
+            scratch.release();
+
+            fileStats.allocations = counting.allocations;
+            fileStats.allocatedBytes = counting.bytes;
+            finishFile();
+
+            setLastResult(result);
+            return result;
+        }
+
+        // The file split by a prescan into chunks of about content / (4 * threadCount) bytes,
+        // parsed by chunkParsers and merged in order. Null if the file has no cut point, or
+        // if a chunk did not end in the state the next one was resumed in.
+        std::shared_ptr<ParseResult> parseParallel(std::string_view content, const std::string& fileName,
+                                                   unsigned int threadCount) {
+            std::shared_ptr<ParseResult> result;
+            CountingResource counting(&scratch);
+            {
+                std::pmr::memory_resource* resource = &scratch;
+                if (stats != nullptr) {
+                    resource = &counting;
+                }
+                std::pmr::vector<std::string_view> includes(resource);
+                HeaderLexer lexer(content, preprocessor);
+                size_t chunkBytes = std::max<size_t>(parallel.minChunkBytes, content.size() / (threadCount * 4));
+                size_t lineCount = lexer.prescan(chunkBytes, chunks, includes);
+                lap(ParseStage::Tokenize);
+                if (chunks.size() < 2) {
+                    return nullptr;
+                }
+
+                threadCount = std::min(threadCount, static_cast<unsigned int>(chunks.size()));
+                while (chunkParsers.size() < threadCount) {
+                    chunkParsers.push_back(std::make_unique<Impl>());
+                }
+
+                // Chunks are claimed in order; the calling thread works as the first parser
+                std::vector<ChunkResult> chunkResults(chunks.size());
+                bool bCount = stats != nullptr;
+                std::atomic<size_t> nextChunk(0);
+                std::exception_ptr error;
+                std::atomic<bool> bFailed(false);
+                auto work = [&](Impl& worker) {
+                    try {
+                        worker.preprocessor = preprocessor;
+                        worker.detail = detail;
+                        for (size_t i = nextChunk++; i < chunks.size() && !bFailed; i = nextChunk++) {
+                            size_t end = i + 1 < chunks.size() ? chunks[i + 1].offset : content.size();
+                            worker.parseChunk(content.substr(chunks[i].offset, end - chunks[i].offset), chunks[i],
+                                              i + 1 < chunks.size() ? &chunks[i + 1] : nullptr, bCount,
+                                              chunkResults[i]);
+                        }
+                    } catch (...) {
+                        if (!bFailed.exchange(true)) {
+                            error = std::current_exception();
+                        }
+                    }
+                };
+                std::vector<std::thread> workers;
+                workers.reserve(threadCount - 1);
+                for (unsigned int t = 1; t < threadCount; ++t) {
+                    workers.emplace_back(work, std::ref(*chunkParsers[t]));
+                }
+                work(*chunkParsers[0]);
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                // A chunk parsed from a state the serial parse would not be in is wrong,
+                // and so may be every chunk after it: parse the whole file serially
+                for (const auto& chunk : chunkResults) {
+                    if (!chunk.bEndsAtNext) {
+                        scratch.release();
+                        return nullptr;
+                    }
+                }
+
+                result = std::make_shared<ParseResult>();
+                result->fileName = fileName;
+                result->success = true;
+                result->includes.assign(includes.begin(), includes.end());
+                size_t classCount = 0;
+                size_t enumCount = 0;
+                for (const auto& chunk : chunkResults) {
+                    classCount += chunk.result.classes.size();
+                    enumCount += chunk.result.enums.size();
+                }
+                result->classes.reserve(classCount);
+                result->enums.reserve(enumCount);
+                for (auto& chunk : chunkResults) {
+                    ParseResult& part = chunk.result;
+                    if (!part.success && result->success) {
+                        result->success = false;
+                        result->errorMessage = part.errorMessage;
+                    }
+                    std::move(part.classes.begin(), part.classes.end(), std::back_inserter(result->classes));
+                    std::move(part.enums.begin(), part.enums.end(), std::back_inserter(result->enums));
+                    mergeNamespaces(result->namespaces, part.namespaces);
+                }
+                lap(ParseStage::ParseClasses);
+
+                if (stats != nullptr) {
+                    fileStats.success = result->success;
+                    fileStats.bytes = content.size();
+                    fileStats.lines = lineCount;
+                    fileStats.classes = classCount;
+                    for (const auto& cls : result->classes) {
+                        fileStats.methods += cls.methods.size();
+                    }
+                    fileStats.enums = enumCount;
+                    // The prescan's own allocations, then those of every chunk
+                    fileStats.allocations = counting.allocations;
+                    fileStats.allocatedBytes = counting.bytes;
+                    for (const auto& chunk : chunkResults) {
+                        fileStats.allocations += chunk.allocations;
+                        fileStats.allocatedBytes += chunk.allocatedBytes;
+                    }
+                }
+            }
+            scratch.release();
+            return result;
+        }
+
+        // Result of one chunk of a parallel parse, with the arena allocations it made
+        struct ChunkResult {
+            ParseResult result;
+            uint64_t allocations = 0;
+            uint64_t allocatedBytes = 0;
+            bool bEndsAtNext = true;        // Ended in the state the next chunk starts from
+        };
+
+        // Parse one chunk of a prescanned file, resuming in the state of its start, and check
+        // that it ends in the state next starts from (null for the last chunk); bCount also
+        // counts the allocations from this parser's arena
+        void parseChunk(std::string_view chunk, const ChunkStart& start, const ChunkStart* next, bool bCount,
+                        ChunkResult& out) {
+            CountingResource counting(&scratch);
+            {
+                std::pmr::memory_resource* resource = &scratch;
+                if (bCount) {
+                    resource = &counting;
+                }
+                ArenaParseResult arenaResult(resource, ArenaParseResult::BorrowedResource());
+                arenaResult.borrowSource(chunk);
+                parseInto(arenaResult, std::string(), &start);
+                out.result = arenaResult.toParseResult();
+            }
+            scratch.release();
+            out.allocations = counting.allocations;
+            out.allocatedBytes = counting.bytes;
+            out.bEndsAtNext = next == nullptr || endsAt(*next);
+        }
 
-                // Read all lines
-                while (std::getline(stream, line)) {
-                    lines.push_back(line);
+        // True if the declaration pass stopped between declarations, in the scopes the
+        // chunk at next is resumed in: the chunk after this one then starts as it would
+        // in a serial parse. The prescan only follows braces, so a declaration it cannot
+        // see (a template clause left open by an unbalanced parenthesis, say) fails this.
+        bool endsAt(const ChunkStart& next) {
+            if (!bBetweenDeclarations || scopes.size() != next.enclosing.size()) {
+                return false;
+            }
+            nameBuffer.clear();
+            for (size_t i = 0; i < scopes.size(); ++i) {
+                const OpenBrace& brace = next.enclosing[i];
+                bool bNamespace = brace.kind == BraceKind::Namespace;
+                if (scopes[i].kind != (bNamespace ? ScopeKind::Namespace : ScopeKind::Block)) {
+                    return false;
+                }
+                for (std::string_view name : brace.names) {
+                    if (name.empty()) continue;
+                    if (!nameBuffer.empty()) nameBuffer.append("::");
+                    nameBuffer.append(name.data(), name.size());
                 }
+            }
+            return qualifier == nameBuffer;
+        }
 
-                // Parse includes
-                parseIncludes(lines, result);
+        // Parse the source text of out into out's arena; start resumes a chunk of a
+        // parallel parse
+        void parseInto(ArenaParseResult& out, const std::string& fileName, const ChunkStart* start = nullptr) {
+            out.fileName = out.store(fileName);
+            out.success = true;
+            target = &out;
 
-                // Parse classes and structs
-                parseClasses(lines, result);
+            size_t lineCount = 0;
+            try {
+                if (detail == ParseDetail::IncludesOnly) {
+                    // The prescan of a parallel parse collects the same includes without
+                    // building tokens; never a chunk, parallel parses are not used
+                    HeaderLexer lexer(out.source(), preprocessor);
+                    lineCount = lexer.prescan(std::numeric_limits<size_t>::max(), chunks, out.includes);
+                    chunks.clear();
+                    lap(ParseStage::Tokenize);
+                } else {
+                    // Tokenize the whole file once; every pass below works on the token stream
+                    HeaderLexer lexer = start != nullptr ? HeaderLexer(out.source(), preprocessor, *start)
+                                                         : HeaderLexer(out.source(), preprocessor);
+                    lexer.tokenize(tokens, lines, out.includes);
+                    lineCount = lines.size();
+                    lap(ParseStage::Tokenize);
 
-                // Parse enums
-                parseEnums(lines, result);
+                    // Parse classes and structs
+                    const std::vector<OpenBrace>* enclosing = start != nullptr ? &start->enclosing : nullptr;
+                    switch (detail) {
+                        case ParseDetail::NoMethods: parseClasses<NoMethodsPolicy>(enclosing); break;
+                        case ParseDetail::Types: parseClasses<TypesPolicy>(enclosing); break;
+                        default: parseClasses<FullPolicy>(enclosing); break;
+                    }
+                    lap(ParseStage::ParseClasses);
 
-                result.classes = classes;
-                result.namespaces = namespaces;
-                result.enums = enums;
+                    // Parse enums
+                    parseEnums();
+                    lap(ParseStage::ParseEnums);
+                }
 
             } catch (const std::exception& e) {
-                result.success = false;
-                result.errorMessage = std::string("Parsing error: ") + e.what();
+                out.success = false;
+                out.errorMessage = std::string("Parsing error: ") + e.what();
+            }
+
+            if (stats != nullptr) {
+                fileStats.success = out.success;
+                fileStats.bytes = out.source().size();
+                fileStats.lines = lineCount;
+                fileStats.classes = out.classes.size();
+                for (const auto& cls : out.classes) {
+                    fileStats.methods += cls.methods.size();
+                }
+                fileStats.enums = out.enums.size();
             }
 
-            lastResult = result;
+            target = nullptr;
+            tokens.clear();
+            lines.clear();
+        }
+
+        std::shared_ptr<const ParseResult> openFailed(const std::string& filePath) {
+            auto result = std::make_shared<ParseResult>();
+            result->success = false;
+            result->errorMessage = "Could not open file: " + filePath;
+            result->fileName = filePath;
+            warnings.clear();
+            setLastResult(result);
+            finishFile();
             return result;
         }
 
     private:
-        void parseIncludes(const std::vector<std::string>& lines, ParseResult& result) {
-            std::regex includeRegex(R"(^\s*#\s*include\s*[<"]([^>"]+)[>"])");
-            for (const auto& line : lines) {
-                std::smatch match;
-                if (std::regex_search(line, match, includeRegex)) {
-                    result.includes.push_back(match[1].str());
-                }
-            }
-        }
-
-        void parseClasses(const std::vector<std::string>& lines, ParseResult& result) {
-            (void)result; // Suppress unused parameter warning
-            for (size_t i = 0; i < lines.size(); ++i) {
-                std::string line = trim(removeComments(lines[i]));
-                
-                // Check for class or struct declaration
-                if ((line.find("class ") != std::string::npos || 
-                     line.find("struct ") != std::string::npos) &&
-                    line.find(";") == std::string::npos) { // Not a forward declaration
-                    
-                    ClassInfo classInfo;
-                    classInfo.isStruct = line.find("struct ") != std::string::npos;
-                    
-                    // Find class name
-                    size_t classPos = line.find(classInfo.isStruct ? "struct " : "class ");
-                    if (classPos != std::string::npos) {
-                        std::string rest = line.substr(classPos + (classInfo.isStruct ? 7 : 6));
-                        rest = trim(rest);
-                        
-                        // Extract class name
-                        size_t nameEnd = rest.find_first_of(" :{");
-                        if (nameEnd != std::string::npos) {
-                            classInfo.name = rest.substr(0, nameEnd);
-                        } else {
-                            classInfo.name = rest;
-                        }
+        std::vector<Token> tokens;
+        std::vector<LineTokens> lines;
+        std::vector<ChunkStart> chunks;         // Parallel parse: where each chunk starts
+        std::vector<std::unique_ptr<Impl>> chunkParsers;
+        std::vector<LineTokens> parts;          // Scratch for splitOnCommas
+        std::string nameBuffer;                 // Scratch for qualified names and namespace keys
+        std::vector<Scope> scopes;              // Declaration pass: enclosing scopes, innermost last
+        std::vector<NamespaceNode> namespaceNodes;
+        std::vector<size_t> rootNamespaces;
+        std::unordered_map<std::string, size_t> namespaceByKey; // "<parent node>/<name>" -> node
+        std::vector<std::string_view> pendingNamespace;         // Names of a namespace before its '{'
+        std::vector<std::string_view> templateParameters;       // Of the last template <...> clause
+        int templateDepth = 0;                  // Open '<' of a template clause continued on the next line
+        int templateParens = 0;                 // Open '(' and '[' inside that clause
+        bool bBetweenDeclarations = true;       // The declaration pass ended with no namespace, template
+                                                // clause or class head still waiting for the next line
+        std::string qualifier;                  // Qualified name of the innermost named scope
+        std::string spanBuffer;                 // Scratch for spanWithout
+        std::pmr::monotonic_buffer_resource scratch;
+        ArenaParseResult* target = nullptr;     // Result being built
+        FileParseStats fileStats;               // File being parsed, when stats are recorded
+        double stageMark = 0.0;
+
+        // A view that stays valid as long as the result: source slices are kept as is,
+        // anything else (text assembled in a scratch buffer) is copied into the arena
+        std::string_view keep(std::string_view str) {
+            std::string_view source = target->source();
+            std::less_equal<const char*> le;
+            if (le(source.data(), str.data()) && le(str.data() + str.size(), source.data() + source.size())) {
+                return str;
+            }
+            return target->store(str);
+        }
+
+        // True for lines holding ordinary code (not blank, not a preprocessor line)
+        bool isCodeLine(const LineTokens& line) const {
+            return !line.empty() && tokens[line.begin].kind != TokenKind::Directive;
+        }
+
+        // One pass over the lines with a stack of the enclosing namespaces, classes and
+        // other braces. Classes are recorded with their qualified name as they are met,
+        // members and methods go to the innermost open class (as far as Policy keeps
+        // them), and the namespace tree is built on the way; no line is scanned twice.
+        template <typename Policy>
+        void parseClasses(const std::vector<OpenBrace>* enclosing) {
+            scopes.clear();
+            namespaceNodes.clear();
+            rootNamespaces.clear();
+            namespaceByKey.clear();
+            pendingNamespace.clear();
+            templateParameters.clear();
+            templateDepth = 0;
+            templateParens = 0;
+            qualifier.clear();
+            if (enclosing != nullptr) {
+                for (const OpenBrace& brace : *enclosing) {
+                    if (brace.kind == BraceKind::Namespace) {
+                        pendingNamespace.assign(brace.names.begin(), brace.names.end());
+                        enterNamespace();
+                    } else {
+                        enterScope(ScopeKind::Block, noIndex, AccessSpecifier::None);
+                    }
+                }
+            }
+            bool bPendingNamespace = false;     // namespace names read, '{' still to come
+            bool bPendingTemplate = false;      // template <...> line, its class still to come
+            size_t pendingClass = noIndex;
 
-                        // Parse inheritance
-                        size_t colonPos = line.find(":");
-                        if (colonPos != std::string::npos) {
-                            parseBaseClasses(line.substr(colonPos + 1), classInfo);
+            for (const LineTokens& line : lines) {
+                if (!isCodeLine(line)) continue;
+
+                LineShape shape = scanLine(line);
+                bool bTemplateClause = shape.templateEnd != line.begin;
+                bool bTemplate = bPendingTemplate || bTemplateClause;
+                bPendingTemplate = bTemplateClause && shape.templateEnd == line.end;
+
+                // Base classes on the lines between the class name and its '{'
+                if (pendingClass != noIndex && tokens[line.begin].isPunct(":")) {
+                    parseBaseClasses(line.begin + 1, line.end, target->classes[pendingClass]);
+                }
+
+                // A class/struct keyword followed by a name, then '{' or nothing
+                // (forward declarations end with ';')
+                bool bClassLine = shape.definesClass;
+
+                for (size_t t = line.begin; t < line.end; ++t) {
+                    const Token& tok = tokens[t];
+                    if (tok.kind == TokenKind::Identifier) {
+                        if (t == shape.classPos && bClassLine) {
+                            pendingClass = declareClass(line, t, bTemplate);
+                        } else if (tok.is(Keyword::Namespace) && (t == line.begin || !tokens[t - 1].is(Keyword::Using))) {
+                            bPendingNamespace = readNamespaceNames(t + 1, line.end);
+                        }
+                    } else if (tok.isPunct("{")) {
+                        if (bPendingNamespace) {
+                            enterNamespace();
+                            bPendingNamespace = false;
+                        } else if (pendingClass != noIndex) {
+                            enterClass(pendingClass);
+                            pendingClass = noIndex;
+                        } else {
+                            enterScope(ScopeKind::Block, noIndex, AccessSpecifier::None);
                         }
+                    } else if (tok.isPunct("}")) {
+                        leaveScope();
+                    } else if (tok.isPunct(";")) {
+                        bPendingNamespace = false;
+                        pendingClass = noIndex;
+                    }
+                }
+                if (!bPendingTemplate) {
+                    templateParameters.clear();
+                }
 
-                        // Parse class body (start at the declaration line so '{' on same line is seen)
-                        i = parseClassBody(lines, i, classInfo);
-                        
-                        classes.push_back(classInfo);
+                // Members and methods of the class whose body the line ends in
+                if constexpr (Policy::bMembers || Policy::bMethods) {
+                    if (pendingClass == noIndex && !scopes.empty() && scopes.back().kind == ScopeKind::Class) {
+                        parseBodyLine<Policy>(line, shape, scopes.back());
                     }
                 }
             }
+            bBetweenDeclarations = !bPendingNamespace && !bPendingTemplate && pendingClass == noIndex &&
+                                   templateDepth == 0;
+
+            target->namespaces.reserve(rootNamespaces.size());
+            for (size_t node : rootNamespaces) {
+                target->namespaces.emplace_back(target->resource());
+                buildNamespace(node, target->namespaces.back());
+            }
         }
 
-        void parseBaseClasses(const std::string& baseStr, ClassInfo& classInfo) {
-            std::string bases = trim(baseStr);
-            size_t bracePos = bases.find("{");
-            if (bracePos != std::string::npos) {
-                bases = bases.substr(0, bracePos);
+        // An access label, method or member line in the body of a class
+        template <typename Policy>
+        void parseBodyLine(const LineTokens& line, const LineShape& shape, Scope& scope) {
+            AccessSpecifier label = findAccessLabel(line);
+            if (label != AccessSpecifier::None) {
+                scope.access = label;
+                return;
             }
 
-            // Split by comma
-            std::istringstream stream(bases);
-            std::string baseClass;
-            while (std::getline(stream, baseClass, ',')) {
-                baseClass = trim(baseClass);
-                if (!baseClass.empty()) {
-                    BaseClassInfo base;
-                    
-                    // Check for access specifier
-                    if (baseClass.find("public ") == 0) {
-                        base.access = AccessSpecifier::Public;
-                        base.name = trim(baseClass.substr(7));
-                    } else if (baseClass.find("protected ") == 0) {
-                        base.access = AccessSpecifier::Protected;
-                        base.name = trim(baseClass.substr(10));
-                    } else if (baseClass.find("private ") == 0) {
-                        base.access = AccessSpecifier::Private;
-                        base.name = trim(baseClass.substr(8));
-                    } else {
-                        base.access = AccessSpecifier::Public;
-                        base.name = baseClass;
-                    }
-                    
-                    classInfo.baseClasses.push_back(base);
+            if (shape.hasOpenParen && shape.hasCloseParen) {
+                // Likely a method
+                if constexpr (Policy::bMethods) {
+                    parseMethod(line, scope.access, target->classes[scope.index]);
+                }
+            } else if (shape.hasSemicolon) {
+                // Likely a member variable
+                if constexpr (Policy::bMembers) {
+                    parseMember(line, scope.access, target->classes[scope.index]);
                 }
             }
         }
 
-        size_t parseClassBody(const std::vector<std::string>& lines, size_t startIdx, ClassInfo& classInfo) {
-            AccessSpecifier currentAccess = classInfo.isStruct ? AccessSpecifier::Public : AccessSpecifier::Private;
-            int braceLevel = 0;
-            bool inClass = false;
+        // Punctuation flags of the line, the class keyword that may declare a class, and
+        // the parameters of a leading template <...> clause (into templateParameters)
+        LineShape scanLine(const LineTokens& line) {
+            LineShape shape;
+            shape.templateEnd = line.begin;
+            shape.classPos = line.end;
+            shape.definesClass = shape.hasSemicolon = shape.hasOpenParen = shape.hasCloseParen = false;
+            bool bClassEnded = false;           // ';' or '{' seen after classPos
 
-            for (size_t i = startIdx; i < lines.size(); ++i) {
-                std::string line = trim(removeComments(lines[i]));
-                
-                if (line.empty()) continue;
+            // A template clause starting here, or continued from the previous lines
+            size_t paramsBegin = line.end;
+            if (templateDepth > 0) {
+                paramsBegin = line.begin;
+            } else if (tokens[line.begin].is(Keyword::Template) && line.begin + 1 < line.end &&
+                       tokens[line.begin + 1].isPunct("<")) {
+                templateParameters.clear();
+                templateDepth = 1;
+                templateParens = 0;
+                paramsBegin = line.begin + 2;
+            }
+            if (paramsBegin != line.end || templateDepth > 0) {
+                // '<' and '>' inside parentheses or brackets are comparisons (bool(X<B)), and
+                // a ';' or '{' outside them means the clause was misread: it ends there, so
+                // that an unbalanced '<' cannot swallow the rest of the file
+                size_t close = line.end;
+                bool bBroken = false;
+                for (size_t t = paramsBegin; t < line.end; ++t) {
+                    const Token& tok = tokens[t];
+                    if (tok.kind != TokenKind::Punct) continue;
+                    if (tok.text == "(" || tok.text == "[") {
+                        templateParens++;
+                    } else if (tok.text == ")" || tok.text == "]") {
+                        if (templateParens > 0) templateParens--;
+                    } else if (templateParens > 0) {
+                        continue;
+                    } else if (tok.text == "<") {
+                        templateDepth++;
+                    } else if (tok.text == ">" && --templateDepth == 0) {
+                        close = t;
+                        break;
+                    } else if (tok.text == ";" || tok.text == "{") {
+                        templateDepth = 0;
+                        close = t;
+                        bBroken = true;
+                        break;
+                    }
+                }
+                splitOnCommas(tokens, paramsBegin, close, parts);
+                for (const auto& part : parts) {
+                    if (!part.empty()) templateParameters.push_back(tokenSpan(tokens, part.begin, part.end));
+                }
+                if (bBroken) {
+                    // The declaration may still be on this line: look for its class keyword
+                    // from the parameters on (declaresClass() skips those of the parameters)
+                    shape.templateEnd = paramsBegin;
+                } else {
+                    shape.templateEnd = close < line.end ? close + 1 : line.end;
+                }
+            }
 
-                // Count braces
-                for (char c : line) {
-                    if (c == '{') {
-                        braceLevel++;
-                        inClass = true;
-                    } else if (c == '}') {
-                        braceLevel--;
-                        if (braceLevel == 0 && inClass) {
-                            return i;
-                        }
+            for (size_t t = line.begin; t < line.end; ++t) {
+                const Token& tok = tokens[t];
+                if (tok.kind == TokenKind::Punct) {
+                    if (shape.classPos != line.end && !bClassEnded && (tok.text == ";" || tok.text == "{")) {
+                        shape.definesClass = tok.text == "{";
+                        bClassEnded = true;
                     }
+                    if (tok.text == ";") shape.hasSemicolon = true;
+                    else if (tok.text == "(") shape.hasOpenParen = true;
+                    else if (tok.text == ")") shape.hasCloseParen = true;
+                } else if (shape.classPos == line.end && t >= shape.templateEnd && t + 1 < line.end &&
+                           (tok.is(Keyword::Class) || tok.is(Keyword::Struct)) && declaresClass(t, line)) {
+                    shape.classPos = t;
                 }
+            }
+            if (shape.classPos != line.end && !bClassEnded) {
+                shape.definesClass = true;
+            }
+            return shape;
+        }
 
-                if (!inClass || braceLevel != 1) continue;
+        // False for the class keyword of enum class, friend class, and of elaborated
+        // types or template parameters (after '<', ',' or '(')
+        bool declaresClass(size_t keywordPos, const LineTokens& line) const {
+            if (keywordPos == line.begin) return true;
+            const Token& prev = tokens[keywordPos - 1];
+            return !(prev.is(Keyword::Enum) || prev.is(Keyword::Friend) || prev.isPunct("<") ||
+                     prev.isPunct(",") || prev.isPunct("("));
+        }
 
-                // Check for access specifier
-                if (line.find("public:") != std::string::npos) {
-                    currentAccess = AccessSpecifier::Public;
-                    continue;
-                } else if (line.find("protected:") != std::string::npos) {
-                    currentAccess = AccessSpecifier::Protected;
-                    continue;
-                } else if (line.find("private:") != std::string::npos) {
-                    currentAccess = AccessSpecifier::Private;
+        // Record the class declared at keywordPos, with its qualified name and base classes
+        size_t declareClass(const LineTokens& line, size_t keywordPos, bool bTemplate) {
+            target->classes.emplace_back(target->resource());
+            size_t index = target->classes.size() - 1;
+            ArenaClassInfo& classInfo = target->classes.back();
+            classInfo.isStruct = tokens[keywordPos].is(Keyword::Struct);
+
+            // Extract class name
+            std::string_view rest = tokenSpan(tokens, keywordPos + 1, line.end);
+            size_t nameEnd = rest.find_first_of(" :{");
+            classInfo.name = rest.substr(0, nameEnd);
+            if (!classInfo.name.empty()) {
+                classInfo.fullName = qualified(classInfo.name);
+            }
+
+            if (bTemplate) {
+                classInfo.isTemplate = true;
+                classInfo.templateParameters.assign(templateParameters.begin(), templateParameters.end());
+            }
+
+            // Parse inheritance
+            size_t colonPos = findToken(tokens, keywordPos + 1, line.end,
+                                        [](const Token& t) { return t.isPunct(":"); });
+            if (colonPos != line.end) {
+                parseBaseClasses(colonPos + 1, line.end, classInfo);
+            }
+
+            // Listed in its namespace unless it is nested in a class
+            size_t owner = scopes.empty() ? noIndex : scopes.back().owner;
+            if (owner != noIndex && scopes[owner].kind == ScopeKind::Namespace) {
+                namespaceNodes[scopes[owner].index].classes.push_back(index);
+            }
+            return index;
+        }
+
+        // name qualified by the enclosing named scopes
+        std::string_view qualified(std::string_view name) {
+            if (qualifier.empty()) return name;
+            nameBuffer.assign(qualifier);
+            nameBuffer.append("::");
+            nameBuffer.append(name.data(), name.size());
+            return target->store(nameBuffer);
+        }
+
+        // Names after a namespace keyword: a, a::b::c, a::inline b, or none (anonymous).
+        // False if what follows is not a namespace definition (alias, attribute...).
+        bool readNamespaceNames(size_t begin, size_t end) {
+            pendingNamespace.clear();
+            bool bExpectName = true;
+            for (size_t t = begin; t < end && !tokens[t].isPunct("{"); ++t) {
+                const Token& tok = tokens[t];
+                if (bExpectName && tok.is(Keyword::Inline)) {
                     continue;
                 }
+                if (bExpectName && tok.kind == TokenKind::Identifier) {
+                    pendingNamespace.push_back(tok.text);
+                    bExpectName = false;
+                } else if (!bExpectName && tok.isPunct("::")) {
+                    bExpectName = true;
+                } else {
+                    return false;
+                }
+            }
+            return pendingNamespace.empty() || !bExpectName;
+        }
+
+        void enterScope(ScopeKind kind, size_t index, AccessSpecifier access) {
+            Scope scope;
+            scope.kind = kind;
+            scope.index = index;
+            scope.owner = kind != ScopeKind::Block ? scopes.size() : (scopes.empty() ? noIndex : scopes.back().owner);
+            scope.qualifierLength = qualifier.size();
+            scope.access = access;
+            scopes.push_back(scope);
+        }
+
+        void leaveScope() {
+            if (scopes.empty()) return;     // Unbalanced '}'
+            qualifier.resize(scopes.back().qualifierLength);
+            scopes.pop_back();
+        }
+
+        void qualify(std::string_view name) {
+            if (name.empty()) return;
+            if (!qualifier.empty()) qualifier.append("::");
+            qualifier.append(name.data(), name.size());
+        }
+
+        void enterClass(size_t index) {
+            const ArenaClassInfo& classInfo = target->classes[index];
+            enterScope(ScopeKind::Class, index, classInfo.isStruct ? AccessSpecifier::Public : AccessSpecifier::Private);
+            qualify(classInfo.name);
+        }
+
+        // Enter the namespaces named in pendingNamespace (one scope for a::b::c)
+        void enterNamespace() {
+            size_t owner = scopes.empty() ? noIndex : scopes.back().owner;
+            size_t node = owner != noIndex && scopes[owner].kind == ScopeKind::Namespace
+                              ? scopes[owner].index : noIndex;
+            size_t qualifierLength = qualifier.size();
+            if (pendingNamespace.empty()) {
+                pendingNamespace.emplace_back();    // Anonymous namespace
+            }
+            for (std::string_view name : pendingNamespace) {
+                node = namespaceNode(node, name);
+                qualify(name);
+            }
 
-                // Parse member or method
-                if (line.find("(") != std::string::npos && line.find(")") != std::string::npos) {
-                    // Likely a method
-                    parseMethod(line, currentAccess, classInfo);
-                } else if (line.find(";") != std::string::npos) {
-                    // Likely a member variable
-                    parseMember(line, currentAccess, classInfo);
+            Scope scope;
+            scope.kind = ScopeKind::Namespace;
+            scope.index = node;
+            scope.owner = scopes.size();
+            scope.qualifierLength = qualifierLength;
+            scope.access = AccessSpecifier::None;
+            scopes.push_back(scope);
+        }
+
+        // Node of namespace name in parent (npos = global), created on first use
+        size_t namespaceNode(size_t parent, std::string_view name) {
+            nameBuffer.assign(std::to_string(parent));
+            nameBuffer.push_back('/');
+            nameBuffer.append(name.data(), name.size());
+            auto found = namespaceByKey.find(nameBuffer);
+            if (found != namespaceByKey.end()) {
+                return found->second;
+            }
+
+            size_t node = namespaceNodes.size();
+            namespaceNodes.emplace_back();
+            namespaceNodes.back().name = name;
+            (parent == noIndex ? rootNamespaces : namespaceNodes[parent].children).push_back(node);
+            namespaceByKey.emplace(nameBuffer, node);
+            return node;
+        }
+
+        void buildNamespace(size_t node, ArenaNamespaceInfo& out) {
+            const NamespaceNode& source = namespaceNodes[node];
+            out.name = source.name;
+            out.classes.reserve(source.classes.size());
+            for (size_t index : source.classes) {
+                out.classes.emplace_back(target->resource());
+                copyClass(target->classes[index], out.classes.back());
+            }
+            out.nestedNamespaces.reserve(source.children.size());
+            for (size_t child : source.children) {
+                out.nestedNamespaces.emplace_back(target->resource());
+                buildNamespace(child, out.nestedNamespaces.back());
+            }
+        }
+
+        void parseBaseClasses(size_t begin, size_t end, ArenaClassInfo& classInfo) {
+            end = findToken(tokens, begin, end, [](const Token& t) { return t.isPunct("{"); });
+
+            splitOnCommas(tokens, begin, end, parts);
+            for (const auto& part : parts) {
+                if (part.empty()) continue;
+
+                ArenaBaseClassInfo base;
+                size_t nameBegin = part.begin;
+
+                // Check for access specifier (and a virtual base marker on either side of it)
+                for (; nameBegin < part.end && nameBegin + 1 < part.end; ++nameBegin) {
+                    const Token& tok = tokens[nameBegin];
+                    if (tok.is(Keyword::Public)) {
+                        base.access = AccessSpecifier::Public;
+                    } else if (tok.is(Keyword::Protected)) {
+                        base.access = AccessSpecifier::Protected;
+                    } else if (tok.is(Keyword::Private)) {
+                        base.access = AccessSpecifier::Private;
+                    } else if (!tok.is(Keyword::Virtual)) {
+                        break;
+                    }
                 }
+
+                base.name = tokenSpan(tokens, nameBegin, part.end);
+                classInfo.baseClasses.push_back(base);
             }
+        }
 
-            return lines.size();
+        // Access specifier label ("public:" etc.) on the line, or None
+        AccessSpecifier findAccessLabel(const LineTokens& line) const {
+            AccessSpecifier found = AccessSpecifier::None;
+            for (size_t t = line.begin; t + 1 < line.end; ++t) {
+                if (!tokens[t + 1].isPunct(":")) continue;
+                if (tokens[t].is(Keyword::Public)) return AccessSpecifier::Public;
+                if (tokens[t].is(Keyword::Protected)) found = AccessSpecifier::Protected;
+                if (tokens[t].is(Keyword::Private) && found == AccessSpecifier::None) found = AccessSpecifier::Private;
+            }
+            return found;
         }
 
-        void parseMethod(const std::string& line, AccessSpecifier access, ClassInfo& classInfo) {
-            MethodInfo method;
+        void parseMethod(const LineTokens& line, AccessSpecifier access, ArenaClassInfo& classInfo) {
+            classInfo.methods.emplace_back(target->resource());
+            ArenaMethodInfo& method = classInfo.methods.back();
             method.access = access;
 
-            std::string cleanLine = trim(line);
-            
-            // Check for modifiers
-            method.isStatic = containsKeyword(cleanLine, "static");
-            method.isVirtual = containsKeyword(cleanLine, "virtual");
-            method.isPureVirtual = containsKeyword(cleanLine, "= 0");
-            
+            size_t parenPos = line.end;
+            size_t lastCloseParen = line.end;
+            for (size_t t = line.begin; t < line.end; ++t) {
+                const Token& tok = tokens[t];
+
+                // Check for modifiers
+                if (tok.is(Keyword::Static)) method.isStatic = true;
+                else if (tok.is(Keyword::Virtual)) method.isVirtual = true;
+                else if (tok.isPunct("=") && t + 1 < line.end && tokens[t + 1].is(TokenKind::Number, "0")) method.isPureVirtual = true;
+                else if (tok.isPunct("(") && parenPos == line.end) parenPos = t;
+                else if (tok.isPunct(")")) lastCloseParen = t;
+            }
+
             // Check for const method - look for const after closing parenthesis
-            size_t closeParenPos = cleanLine.find_last_of(")");
-            if (closeParenPos != std::string::npos) {
-                std::string afterParen = cleanLine.substr(closeParenPos + 1);
-                method.isConst = afterParen.find("const") != std::string::npos;
-            } else {
-                method.isConst = false;
+            if (lastCloseParen != line.end) {
+                method.isConst = findToken(tokens, lastCloseParen + 1, line.end,
+                                           [](const Token& t) { return t.is(Keyword::Const); }) != line.end;
             }
 
             // Extract method signature
-            size_t parenPos = cleanLine.find("(");
-            if (parenPos != std::string::npos) {
-                std::string beforeParen = cleanLine.substr(0, parenPos);
-                
+            if (parenPos != line.end) {
                 // Remove modifiers
-                beforeParen = std::regex_replace(beforeParen, std::regex("\\bstatic\\b"), "");
-                beforeParen = std::regex_replace(beforeParen, std::regex("\\bvirtual\\b"), "");
-                beforeParen = std::regex_replace(beforeParen, std::regex("\\binline\\b"), "");
-                beforeParen = trim(beforeParen);
+                std::string_view signature = spanWithout(tokens, line.begin, parenPos, [](const Token& t) {
+                    return t.is(Keyword::Static) || t.is(Keyword::Virtual) || t.is(Keyword::Inline);
+                }, spanBuffer);
+                std::string_view beforeParen = trim(signature);
 
                 // Split return type and method name
                 size_t lastSpace = beforeParen.find_last_of(" \t");
-                if (lastSpace != std::string::npos) {
-                    method.returnType = trim(beforeParen.substr(0, lastSpace));
-                    method.name = trim(beforeParen.substr(lastSpace + 1));
+                if (lastSpace != std::string_view::npos) {
+                    method.returnType = keep(trim(beforeParen.substr(0, lastSpace)));
+                    method.name = keep(trim(beforeParen.substr(lastSpace + 1)));
                 } else {
-                    method.name = beforeParen; // Constructor or destructor
+                    method.name = keep(beforeParen); // Constructor or destructor
                     method.isConstructor = (method.name == classInfo.name);
-                    method.isDestructor = (method.name == "~" + classInfo.name);
+                    method.isDestructor = method.name.size() == classInfo.name.size() + 1 &&
+                                          method.name[0] == '~' && method.name.substr(1) == classInfo.name;
                 }
 
-                // Parse parameters
-                size_t closeParen = cleanLine.find(")", parenPos);
-                if (closeParen != std::string::npos) {
-                    std::string params = cleanLine.substr(parenPos + 1, closeParen - parenPos - 1);
-                    parseParameters(params, method);
+                // Parse parameters up to the matching ')'
+                int depth = 0;
+                for (size_t t = parenPos; t < line.end; ++t) {
+                    if (tokens[t].isPunct("(")) {
+                        depth++;
+                    } else if (tokens[t].isPunct(")") && --depth == 0) {
+                        parseParameters(parenPos + 1, t, method);
+                        break;
+                    }
                 }
             }
-
-            classInfo.methods.push_back(method);
         }
 
-        void parseParameters(const std::string& paramsStr, MethodInfo& method) {
-            if (trim(paramsStr).empty()) return;
+        void parseParameters(size_t begin, size_t end, ArenaMethodInfo& method) {
+            if (begin >= end) return;
 
-            std::istringstream stream(paramsStr);
-            std::string param;
-            while (std::getline(stream, param, ',')) {
-                param = trim(param);
-                if (!param.empty()) {
-                    ParameterInfo paramInfo;
-                    
-                    paramInfo.isConst = containsKeyword(param, "const");
-                    paramInfo.isReference = containsKeyword(param, "&");
-                    paramInfo.isPointer = containsKeyword(param, "*");
+            splitOnCommas(tokens, begin, end, parts);
+            method.parameters.reserve(parts.size());
+            for (const auto& part : parts) {
+                if (part.empty()) continue;
 
-                    // Simple parameter parsing
-                    size_t lastSpace = param.find_last_of(" \t*&");
-                    if (lastSpace != std::string::npos) {
-                        paramInfo.type = trim(param.substr(0, lastSpace + 1));
-                        std::string nameAndDefault = trim(param.substr(lastSpace + 1));
-                        
-                        size_t equalPos = nameAndDefault.find("=");
-                        if (equalPos != std::string::npos) {
-                            paramInfo.name = trim(nameAndDefault.substr(0, equalPos));
-                            paramInfo.defaultValue = trim(nameAndDefault.substr(equalPos + 1));
-                        } else {
-                            paramInfo.name = nameAndDefault;
-                        }
-                    }
+                ArenaParameterInfo paramInfo;
+                for (size_t t = part.begin; t < part.end; ++t) {
+                    const Token& tok = tokens[t];
+                    if (tok.is(Keyword::Const)) paramInfo.isConst = true;
+                    else if (tok.isPunct("&") || tok.isPunct("&&")) paramInfo.isReference = true;
+                    else if (tok.isPunct("*")) paramInfo.isPointer = true;
+                }
 
-                    method.parameters.push_back(paramInfo);
+                // Simple parameter parsing
+                std::string_view param = tokenSpan(tokens, part.begin, part.end);
+                size_t lastSpace = param.find_last_of(" \t*&");
+                if (lastSpace != std::string_view::npos) {
+                    paramInfo.type = trim(param.substr(0, lastSpace + 1));
+                    std::string_view nameAndDefault = trim(param.substr(lastSpace + 1));
+
+                    size_t equalPos = nameAndDefault.find('=');
+                    if (equalPos != std::string_view::npos) {
+                        paramInfo.name = trim(nameAndDefault.substr(0, equalPos));
+                        paramInfo.defaultValue = trim(nameAndDefault.substr(equalPos + 1));
+                    } else {
+                        paramInfo.name = nameAndDefault;
+                    }
                 }
+
+                method.parameters.push_back(paramInfo);
             }
         }
 
-        void parseMember(const std::string& line, AccessSpecifier access, ClassInfo& classInfo) {
-            MemberInfo member;
+        void parseMember(const LineTokens& line, AccessSpecifier access, ArenaClassInfo& classInfo) {
+            ArenaMemberInfo member;
             member.access = access;
 
-            std::string cleanLine = trim(line);
-            
             // Check for modifiers
-            member.isStatic = containsKeyword(cleanLine, "static");
-            member.isConst = containsKeyword(cleanLine, "const");
+            for (size_t t = line.begin; t < line.end; ++t) {
+                if (tokens[t].is(Keyword::Static)) member.isStatic = true;
+                else if (tokens[t].is(Keyword::Const)) member.isConst = true;
+            }
 
             // Remove semicolon
-            if (cleanLine.back() == ';') {
-                cleanLine = cleanLine.substr(0, cleanLine.length() - 1);
+            size_t end = line.end;
+            if (tokens[end - 1].isPunct(";")) {
+                --end;
             }
 
             // Remove modifiers
-            cleanLine = std::regex_replace(cleanLine, std::regex("\\bstatic\\b"), "");
-            cleanLine = std::regex_replace(cleanLine, std::regex("\\bmutable\\b"), "");
-            cleanLine = trim(cleanLine);
+            std::string_view declaration = spanWithout(tokens, line.begin, end, [](const Token& t) {
+                return t.is(Keyword::Static) || t.is(Keyword::Mutable);
+            }, spanBuffer);
+            std::string_view cleanLine = trim(declaration);
 
             // Extract type and name
             size_t lastSpace = cleanLine.find_last_of(" \t");
-            if (lastSpace != std::string::npos) {
-                member.type = trim(cleanLine.substr(0, lastSpace));
-                std::string nameAndDefault = trim(cleanLine.substr(lastSpace + 1));
-                
-                size_t equalPos = nameAndDefault.find("=");
-                if (equalPos != std::string::npos) {
-                    member.name = trim(nameAndDefault.substr(0, equalPos));
-                    member.defaultValue = trim(nameAndDefault.substr(equalPos + 1));
+            if (lastSpace != std::string_view::npos) {
+                member.type = keep(trim(cleanLine.substr(0, lastSpace)));
+                std::string_view nameAndDefault = trim(cleanLine.substr(lastSpace + 1));
+
+                size_t equalPos = nameAndDefault.find('=');
+                if (equalPos != std::string_view::npos) {
+                    member.name = keep(trim(nameAndDefault.substr(0, equalPos)));
+                    member.defaultValue = keep(trim(nameAndDefault.substr(equalPos + 1)));
                 } else {
-                    member.name = nameAndDefault;
+                    member.name = keep(nameAndDefault);
                 }
             }
 
@@ -366,32 +1821,28 @@ namespace UFMTooling {
             }
         }
 
-        void parseEnums(const std::vector<std::string>& lines, ParseResult& result) {
-            (void)result; // Suppress unused parameter warning
-            for (size_t i = 0; i < lines.size(); ++i) {
-                std::string line = trim(removeComments(lines[i]));
-                
-                if (line.find("enum") != std::string::npos) {
-                    EnumInfo enumInfo;
-                    enumInfo.isClass = line.find("enum class") != std::string::npos;
-                    
-                    // Extract enum name
-                    size_t enumPos = line.find(enumInfo.isClass ? "enum class" : "enum");
-                    if (enumPos != std::string::npos) {
-                        std::string rest = line.substr(enumPos + (enumInfo.isClass ? 10 : 4));
-                        rest = trim(rest);
-                        
-                        size_t nameEnd = rest.find_first_of(" :{");
-                        if (nameEnd != std::string::npos) {
-                            enumInfo.name = rest.substr(0, nameEnd);
-                        } else {
-                            enumInfo.name = rest;
-                        }
+        void parseEnums() {
+            for (const auto& line : lines) {
+                if (!isCodeLine(line)) continue;
 
-                        // Parse enum values (basic implementation)
-                        enums.push_back(enumInfo);
-                    }
+                size_t enumPos = findToken(tokens, line.begin, line.end,
+                                           [](const Token& t) { return t.is(Keyword::Enum); });
+                if (enumPos == line.end) continue;
+
+                target->enums.emplace_back(target->resource());
+                ArenaEnumInfo& enumInfo = target->enums.back();
+                size_t namePos = enumPos + 1;
+                if (namePos < line.end && (tokens[namePos].is(Keyword::Class) || tokens[namePos].is(Keyword::Struct))) {
+                    enumInfo.isClass = true;
+                    namePos++;
                 }
+
+                // Extract enum name
+                std::string_view rest = tokenSpan(tokens, namePos, line.end);
+                size_t nameEnd = rest.find_first_of(" :{");
+                enumInfo.name = rest.substr(0, nameEnd);
+
+                // Parse enum values (basic implementation)
             }
         }
     };
@@ -402,47 +1853,108 @@ namespace UFMTooling {
     SimpleHeaderParser::~SimpleHeaderParser() = default;
 
     ParseResult SimpleHeaderParser::parseFile(const std::string& filePath) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
-            ParseResult result;
-            result.success = false;
-            result.errorMessage = "Could not open file: " + filePath;
-            result.fileName = filePath;
-            return result;
+        return *parseFileShared(filePath);
+    }
+
+    ParseResult SimpleHeaderParser::parseContent(const std::string& content, const std::string& fileName) {
+        pImpl->beginFile(fileName);
+        return *pImpl->parse(content, fileName);
+    }
+
+    std::shared_ptr<const ParseResult> SimpleHeaderParser::parseFileShared(const std::string& filePath) {
+        // Parse straight out of the mapped file; nothing is copied before tokenizing
+        pImpl->beginFile(filePath);
+        MappedFile file;
+        bool bOpened = file.open(filePath, pImpl->bCopyFiles);
+        pImpl->lap(ParseStage::Read);
+        if (!bOpened) {
+            return pImpl->openFailed(filePath);
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return parseContent(buffer.str(), filePath);
+        return pImpl->parse(file.view(), filePath);
     }
 
-    ParseResult SimpleHeaderParser::parseContent(const std::string& content, const std::string& fileName) {
+    std::shared_ptr<const ParseResult> SimpleHeaderParser::parseContentShared(std::string_view content,
+                                                                             const std::string& fileName) {
+        pImpl->beginFile(fileName);
         return pImpl->parse(content, fileName);
     }
 
+    std::shared_ptr<const ArenaParseResult> SimpleHeaderParser::parseFileArena(const std::string& filePath,
+                                                                             std::pmr::memory_resource* upstream) {
+        pImpl->beginFile(filePath);
+        auto result = std::make_shared<ArenaParseResult>(upstream);
+        MappedFile file;
+        bool bOpened = file.open(filePath, pImpl->bCopyFiles);
+        pImpl->lap(ParseStage::Read);
+        if (!bOpened) {
+            result->fileName = result->store(filePath);
+            result->errorMessage = "Could not open file: " + filePath;
+            pImpl->finishFile();
+            return result;
+        }
+
+        // The result keeps the mapping alive, so names can point straight into the file
+        result->adoptSource(std::move(file));
+        pImpl->parseInto(*result, filePath);
+        pImpl->finishFile();
+        return result;
+    }
+
+    std::shared_ptr<const ArenaParseResult> SimpleHeaderParser::parseContentArena(std::string_view content,
+                                                                                const std::string& fileName,
+                                                                                std::pmr::memory_resource* upstream) {
+        pImpl->beginFile(fileName);
+        auto result = std::make_shared<ArenaParseResult>(upstream);
+        result->copySource(content);
+        pImpl->parseInto(*result, fileName);
+        pImpl->finishFile();
+        return result;
+    }
+
+    std::shared_ptr<const ParseResult> SimpleHeaderParser::getLastResult() const {
+        return pImpl->lastResult;
+    }
+
     const std::vector<ClassInfo>& SimpleHeaderParser::getClasses() const {
-        return pImpl->classes;
+        return pImpl->lastResult->classes;
     }
 
     const std::vector<NamespaceInfo>& SimpleHeaderParser::getNamespaces() const {
-        return pImpl->namespaces;
+        return pImpl->lastResult->namespaces;
     }
 
     const std::vector<EnumInfo>& SimpleHeaderParser::getEnums() const {
-        return pImpl->enums;
+        return pImpl->lastResult->enums;
     }
 
     const ClassInfo* SimpleHeaderParser::findClass(const std::string& className) const {
-        for (const auto& cls : pImpl->classes) {
-            if (cls.name == className) {
-                return &cls;
-            }
-        }
-        return nullptr;
+        size_t position = pImpl->classIndex.find(className);
+        return position == NameIndex::npos ? nullptr : &pImpl->lastResult->classes[position];
     }
 
     const std::vector<std::string>& SimpleHeaderParser::getWarnings() const {
         return pImpl->warnings;
     }
 
+    void SimpleHeaderParser::setStats(ParseStats* stats) {
+        pImpl->stats = stats;
+    }
+
+    void SimpleHeaderParser::setPreprocessorOptions(const PreprocessorOptions& options) {
+        pImpl->preprocessor = options;
+    }
+
+    void SimpleHeaderParser::setParseDetail(ParseDetail detail) {
+        pImpl->detail = detail;
+    }
+
+    void SimpleHeaderParser::setParallelOptions(const ParallelParseOptions& options) {
+        pImpl->parallel = options;
+    }
+
+    void SimpleHeaderParser::setCopyFiles(bool bCopy) {
+        pImpl->bCopyFiles = bCopy;
+    }
+
 } // namespace UFMTooling
@@ -1,224 +1,621 @@
 #include "../include/SourceExplorer.h"
 #include "../include/FileSystemExplorer.h"
 #include "../include/SimpleHeaderParser.h"
-#include "../include/third_party/json.hpp"
+#include "../include/JsonWriter.h"
+#include "../include/MappedFile.h"
+#include "ParseResultJson.h"
+#include "WorkerThreads.h"
 #include <fstream>
-
-using json = nlohmann::json;
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace UFMTooling {
 
+    namespace {
+        // Reuse the cached result for a header if its fingerprint still matches.
+        // bRefresh is set when the match was made by content hash and the stored mtime is stale.
+        bool reuseCached(const FileSystemEntry& headerFile, const SourceExplorerOptions& options,
+                         SourceFileAnalysis& analysis, bool& bRefresh) {
+            FileFingerprint& current = analysis.fingerprint;
+            if (!AnalysisCache::fingerprintFile(headerFile.path, false, current)) {
+                return false;
+            }
+
+            // Recorded with the analysis, so a result parsed with other options is not taken for this one
+            current.optionsHash = AnalysisCache::hashOptions(options.preprocessor);
+
+            FileFingerprint stored;
+            std::shared_ptr<const ParseResult> cached;
+            if (!options.cache->find(headerFile.path, stored, &cached) || stored.size != current.size ||
+                stored.optionsHash != current.optionsHash) {
+                return false;
+            }
+
+            if (stored.lastWriteTime != current.lastWriteTime) {
+                // Touched but possibly unchanged (checkout, save without edits)
+                if (!options.bHashContents || stored.contentHash == 0 ||
+                    !AnalysisCache::fingerprintFile(headerFile.path, true, current, options.bCopyFiles) ||
+                    current.contentHash != stored.contentHash) {
+                    return false;
+                }
+            }
+
+            analysis.parseResult = std::move(cached);
+            bRefresh = stored.lastWriteTime != current.lastWriteTime;
+            current.contentHash = stored.contentHash;
+            analysis.success = true;
+            analysis.fromCache = true;
+            return true;
+        }
+
+        // Start the analysis of a header and reuse its cached result if possible.
+        // Returns true if that settled it; bNeedsStore then tells whether the cache needs to
+        // record the analysis again.
+        bool prepareHeader(const FileSystemEntry& headerFile, const SourceExplorerOptions& options,
+                           SourceFileAnalysis& analysis, bool& bNeedsStore) {
+            analysis.path = headerFile.path;
+            analysis.filename = headerFile.name;
+
+            bool bRefresh = false;
+            if (options.cache != nullptr && reuseCached(headerFile, options, analysis, bRefresh)) {
+                bNeedsStore = bRefresh;
+                return true;
+            }
+            return false;
+        }
+
+        // Parse a prepared header, from content when it was already read (else from the file).
+        // Returns true if the cache needs to record the analysis.
+        bool parseHeader(SimpleHeaderParser& parser, const FileSystemEntry& headerFile,
+                         const SourceExplorerOptions& options, SourceFileAnalysis& analysis,
+                         const std::string_view* content) {
+            try {
+                analysis.parseResult = content != nullptr ? parser.parseContentShared(*content, headerFile.path)
+                                                          : parser.parseFileShared(headerFile.path);
+                analysis.success = analysis.parseResult->success;
+                if (!analysis.success) {
+                    analysis.errorMessage = analysis.parseResult->errorMessage;
+                }
+            } catch (const std::exception& e) {
+                analysis.parseResult = std::make_shared<ParseResult>();
+                analysis.success = false;
+                analysis.errorMessage = std::string("Parsing error: ") + e.what();
+            }
+
+            // A lighter result would be taken for a full one by the next exploration
+            if (options.cache == nullptr || !analysis.success || options.detail != ParseDetail::Full) {
+                return false;
+            }
+            if (options.bHashContents) {
+                if (content != nullptr && analysis.fingerprint.size == content->size()) {
+                    // Stat'ed by reuseCached(): only the hash is missing, and the contents are at hand
+                    analysis.fingerprint.contentHash = AnalysisCache::hashContent(*content);
+                } else {
+                    AnalysisCache::fingerprintFile(headerFile.path, true, analysis.fingerprint, options.bCopyFiles);
+                }
+            }
+            return true;
+        }
+
+        // Parse one header file into its analysis slot.
+        // Returns true if the cache needs to record the analysis.
+        bool analyzeHeader(SimpleHeaderParser& parser, const FileSystemEntry& headerFile,
+                           const SourceExplorerOptions& options, SourceFileAnalysis& analysis) {
+            bool bNeedsStore = false;
+            if (prepareHeader(headerFile, options, analysis, bNeedsStore)) {
+                return bNeedsStore;
+            }
+            return parseHeader(parser, headerFile, options, analysis, nullptr);
+        }
+
+        void writeResultJson(JsonWriter& writer, const SourceExplorerResult& result, ParseStats* stats) {
+            double startMs = stats != nullptr ? stats->now() : 0.0;
+            JsonModel::beginExplorerResult(result.errorMessage, writer);
+            for (const auto& analysis : result.analyses) {
+                JsonModel::writeAnalysis(analysis, writer);
+            }
+            JsonModel::endExplorerResult(result, writer);
+            if (stats != nullptr) {
+                stats->recordStage(ParseStage::Export, startMs, stats->now());
+            }
+        }
+
+        // One finished (or in-progress) analysis in the reorder window
+        struct AnalysisSlot {
+            SourceFileAnalysis analysis;
+            bool needsStore;
+            bool ready;
+
+            AnalysisSlot() : needsStore(false), ready(false) {}
+        };
+
+        // Account for a finished analysis, record it in the cache and pass it on.
+        // Returns false if the visitor asked to stop.
+        bool deliver(AnalysisSlot& slot, const SourceExplorerOptions& options,
+                     SourceExplorerResult& result, const SourceFileVisitor& visitor) {
+            const SourceFileAnalysis& analysis = slot.analysis;
+            if (!analysis.success) {
+                result.filesWithErrors++;
+            }
+            if (analysis.fromCache) {
+                result.filesFromCache++;
+            }
+            if (slot.needsStore) {
+                options.cache->store(analysis.path, analysis.fingerprint, analysis.parseResult);
+            }
+            result.filesProcessed++;
+            return visitor(slot.analysis);
+        }
+
+        // A file travelling through the read pipeline
+        struct PipelineSlot {
+            AnalysisSlot slot;
+            MappedFile file;
+            bool bOpened;
+
+            PipelineSlot() : bOpened(false) {}
+        };
+
+        // Pipelined form of analyzeInOrder(): I/O threads prepare and read files into the
+        // ring, parser threads take the files read from a queue, and the exploring thread
+        // delivers the ring in order. Readers wait while readQueueDepth files await a parser
+        // or outputQueueDepth files await delivery; parsers wait for reads.
+        void analyzePipelined(const std::vector<const FileSystemEntry*>& headerFiles, const SourceExplorerOptions& options,
+                              SourceExplorerResult& result, const SourceFileVisitor& visitor) {
+            const ReadPipelineOptions& pipeline = options.pipeline;
+            const size_t fileCount = headerFiles.size();
+            unsigned int parserCount = resolveThreadCount(options.threadCount, fileCount);
+            unsigned int ioCount = pipeline.ioThreads != 0 ? pipeline.ioThreads : parserCount * 4;
+            size_t readDepth = pipeline.readQueueDepth != 0 ? pipeline.readQueueDepth : size_t(ioCount) * 2;
+            ioCount = static_cast<unsigned int>(std::max<size_t>(std::min<size_t>({ioCount, readDepth, fileCount}), 1));
+            const size_t window = pipeline.outputQueueDepth != 0 ? pipeline.outputQueueDepth
+                                                                 : readDepth + size_t(parserCount) * 4;
+
+            std::vector<PipelineSlot> slots(window);
+            std::deque<size_t> readQueue;       // Files read, waiting for a parser
+            std::mutex mutex;
+            std::condition_variable readSpace;  // Readers: room in both queues
+            std::condition_variable fileRead;   // Parsers: readQueue not empty, or no read left
+            std::condition_variable slotReady;  // Exploring thread: the next slot is done
+            size_t nextRead = 0;
+            size_t pendingReads = 0;            // Claimed by a reader, not yet by a parser
+            size_t delivered = 0;
+            bool bAborted = false;
+
+            auto readsFinished = [&]() { return nextRead >= fileCount && pendingReads == 0; };
+
+            // A reader or parser that throws stops the exploration instead of terminating the process
+            std::exception_ptr workerError;     // First exception of a thread, rethrown after the join
+            auto fail = [&]() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!workerError) workerError = std::current_exception();
+                    bAborted = true;
+                }
+                readSpace.notify_all();
+                fileRead.notify_all();
+                slotReady.notify_all();
+            };
+
+            auto readFiles = [&]() {
+                for (;;) {
+                    size_t i;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        readSpace.wait(lock, [&]() {
+                            return bAborted || nextRead >= fileCount ||
+                                   (pendingReads < readDepth && nextRead < delivered + window);
+                        });
+                        if (bAborted || nextRead >= fileCount) {
+                            return;
+                        }
+                        i = nextRead++;
+                        ++pendingReads;
+                    }
+
+                    // The slot is ours until a parser claims it (or, for a cached file,
+                    // until it is delivered)
+                    PipelineSlot& entry = slots[i % window];
+                    const FileSystemEntry& headerFile = *headerFiles[i];
+                    entry.slot.analysis = SourceFileAnalysis();
+                    entry.slot.needsStore = false;
+                    double startMs = options.stats != nullptr ? options.stats->now() : 0.0;
+                    bool bDone = prepareHeader(headerFile, options, entry.slot.analysis, entry.slot.needsStore);
+                    if (!bDone) {
+                        entry.bOpened = entry.file.open(headerFile.path, options.bCopyFiles);
+                        if (entry.bOpened) {
+                            entry.file.prefetch();
+                        }
+                    }
+                    if (options.stats != nullptr) {
+                        options.stats->recordStage(ParseStage::Read, startMs, options.stats->now(), headerFile.path);
+                    }
+
+                    bool bLastRead;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (bDone) {
+                            entry.slot.ready = true;
+                            --pendingReads;
+                        } else {
+                            readQueue.push_back(i);
+                        }
+                        bLastRead = readsFinished();
+                    }
+                    if (bDone) {
+                        slotReady.notify_one();
+                        readSpace.notify_one();
+                    } else {
+                        fileRead.notify_one();
+                    }
+                    if (bLastRead) {
+                        fileRead.notify_all();
+                    }
+                }
+            };
+
+            auto parseFiles = [&]() {
+                SimpleHeaderParser parser;
+                SourceExplorer::configureParser(parser, options);
+                for (;;) {
+                    size_t i;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        fileRead.wait(lock, [&]() { return bAborted || !readQueue.empty() || readsFinished(); });
+                        if (bAborted || readQueue.empty()) {
+                            return;
+                        }
+                        i = readQueue.front();
+                        readQueue.pop_front();
+                        --pendingReads;
+                    }
+                    readSpace.notify_one();
+
+                    PipelineSlot& entry = slots[i % window];
+                    std::string_view content = entry.file.view();
+                    entry.slot.needsStore = parseHeader(parser, *headerFiles[i], options, entry.slot.analysis,
+                                                        entry.bOpened ? &content : nullptr);
+                    entry.file.close();
+                    entry.bOpened = false;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        entry.slot.ready = true;
+                    }
+                    slotReady.notify_one();
+                }
+            };
+
+            std::vector<std::thread> threads;
+            std::exception_ptr error;
+            try {
+                threads.reserve(ioCount + parserCount);
+                for (unsigned int t = 0; t < ioCount + parserCount; ++t) {
+                    threads.emplace_back([&, t]() {
+                        try {
+                            if (t < ioCount) {
+                                readFiles();
+                            } else {
+                                parseFiles();
+                            }
+                        } catch (...) {
+                            fail();
+                        }
+                    });
+                }
+
+                for (size_t i = 0; i < fileCount; ++i) {
+                    AnalysisSlot& slot = slots[i % window].slot;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        slotReady.wait(lock, [&]() { return slot.ready || bAborted; });
+                        if (!slot.ready) {
+                            break;      // A reader or parser failed
+                        }
+                    }
+                    if (!deliver(slot, options, result, visitor)) {
+                        break;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        slot.ready = false;
+                        delivered = i + 1;
+                    }
+                    readSpace.notify_all();
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                bAborted = true;
+            }
+            readSpace.notify_all();
+            fileRead.notify_all();
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (!error) {
+                error = workerError;
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Parse headerFiles and hand each analysis to visitor in path order. Workers never run
+        // more than a small window ahead of the visitor, so only that many finished analyses
+        // are held in memory however large the tree is.
+        void analyzeInOrder(const std::vector<const FileSystemEntry*>& headerFiles, const SourceExplorerOptions& options,
+                            SourceExplorerResult& result, const SourceFileVisitor& visitor) {
+            if (options.pipeline.bEnabled && !headerFiles.empty()) {
+                analyzePipelined(headerFiles, options, result, visitor);
+                return;
+            }
+
+            unsigned int threadCount = resolveThreadCount(options.threadCount, headerFiles.size());
+
+            if (threadCount <= 1) {
+                SimpleHeaderParser parser;
+                SourceExplorer::configureParser(parser, options);
+                AnalysisSlot slot;
+                for (const FileSystemEntry* headerFile : headerFiles) {
+                    slot.analysis = SourceFileAnalysis();
+                    slot.needsStore = analyzeHeader(parser, *headerFile, options, slot.analysis);
+                    if (!deliver(slot, options, result, visitor)) {
+                        break;
+                    }
+                }
+                return;
+            }
+
+            // Each worker owns its parser and claims the next file once its slot in the
+            // ring is free; the exploring thread drains the ring in order
+            const size_t window = static_cast<size_t>(threadCount) * 4;
+            std::vector<AnalysisSlot> slots(window);
+            std::mutex mutex;
+            std::condition_variable slotFree;
+            std::condition_variable slotReady;
+            size_t nextIndex = 0;
+            size_t delivered = 0;
+            bool bAborted = false;
+
+            std::exception_ptr workerError;     // First exception of a worker, rethrown after the join
+
+            // A worker that throws stops the exploration instead of terminating the process
+            auto fail = [&]() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!workerError) workerError = std::current_exception();
+                    bAborted = true;
+                }
+                slotFree.notify_all();
+                slotReady.notify_all();
+            };
+
+            std::vector<std::thread> workers;
+            std::exception_ptr error;
+            try {
+                workers.reserve(threadCount);
+                for (unsigned int t = 0; t < threadCount; ++t) {
+                    workers.emplace_back([&]() {
+                        try {
+                            SimpleHeaderParser parser;
+                            SourceExplorer::configureParser(parser, options);
+                            for (;;) {
+                                size_t i;
+                                {
+                                    std::unique_lock<std::mutex> lock(mutex);
+                                    slotFree.wait(lock, [&]() {
+                                        return bAborted || nextIndex >= headerFiles.size() ||
+                                               nextIndex < delivered + window;
+                                    });
+                                    if (bAborted || nextIndex >= headerFiles.size()) {
+                                        return;
+                                    }
+                                    i = nextIndex++;
+                                }
+
+                                // The slot is ours until the exploring thread has delivered it
+                                AnalysisSlot& slot = slots[i % window];
+                                slot.analysis = SourceFileAnalysis();
+                                slot.needsStore = analyzeHeader(parser, *headerFiles[i], options, slot.analysis);
+                                {
+                                    std::lock_guard<std::mutex> lock(mutex);
+                                    slot.ready = true;
+                                }
+                                slotReady.notify_one();
+                            }
+                        } catch (...) {
+                            fail();
+                        }
+                    });
+                }
+
+                for (size_t i = 0; i < headerFiles.size(); ++i) {
+                    AnalysisSlot& slot = slots[i % window];
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        slotReady.wait(lock, [&]() { return slot.ready || bAborted; });
+                        if (!slot.ready) {
+                            break;      // A worker failed
+                        }
+                    }
+                    if (!deliver(slot, options, result, visitor)) {
+                        break;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        slot.ready = false;
+                        delivered = i + 1;
+                    }
+                    slotFree.notify_all();
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // Release workers still waiting for a slot (early stop or exception)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                bAborted = true;
+            }
+            slotFree.notify_all();
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            if (!error) {
+                error = workerError;
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
     class SourceExplorer::Impl {
     public:
         SourceExplorerResult lastResult;
         FileSystemExplorer fsExplorer;
-        SimpleHeaderParser parser;
-
-        SourceExplorerResult exploreSource(const std::string& basePath, bool bRecursive) {
-            SourceExplorerResult result;
-            
-            // Use FileSystemExplorer to get all files
-            FileSystemExplorerResult fsResult = fsExplorer.explore(basePath, bRecursive);
-            
+        PUMLBatchParser pumlParser;
+        ParseStats* lastStats = nullptr;    // Stats of the last exploration, for the exports
+
+        // Walk basePath and return its header files sorted by path, so the output order
+        // does not depend on directory iteration order or on thread scheduling.
+        // The entries point into fsExplorer's last result.
+        bool collectHeaders(const std::string& basePath, const SourceExplorerOptions& options,
+                            std::vector<const FileSystemEntry*>& headerFiles, std::string& errorMessage) {
+            // Only headers are recorded; the cache and the parser stat files themselves
+            FileSystemExplorerOptions walk = options.walk;
+            walk.bRecursive = options.bRecursive;
+            walk.extensions.assign(1, ".h");
+            walk.bIncludeDirectories = false;
+            walk.bFileSizes = false;
+
+            lastStats = options.stats;
+            double startMs = lastStats != nullptr ? lastStats->now() : 0.0;
+            const FileSystemExplorerResult& fsResult = fsExplorer.explore(basePath, walk);
+            if (lastStats != nullptr) {
+                lastStats->recordStage(ParseStage::Walk, startMs, lastStats->now(), basePath);
+            }
             if (!fsResult.success) {
-                result.errorMessage = fsResult.errorMessage;
-                return result;
+                errorMessage = fsResult.errorMessage;
+                return false;
             }
-            
-            // Filter for .h files
-            std::vector<FileSystemEntry> headerFiles = fsExplorer.getFilesByExtension(".h");
-            
-            result.filesProcessed = 0;
-            result.filesWithErrors = 0;
-            
-            // Parse each header file
-            for (const auto& headerFile : headerFiles) {
-                SourceFileAnalysis analysis;
-                analysis.path = headerFile.path;
-                analysis.filename = headerFile.name;
-                
-                // Parse the header file
-                ParseResult parseResult = parser.parseFile(headerFile.path);
-                analysis.parseResult = parseResult;
-                analysis.success = parseResult.success;
-                
-                if (!parseResult.success) {
-                    analysis.errorMessage = parseResult.errorMessage;
-                    result.filesWithErrors++;
-                } else {
-                    analysis.errorMessage = "";
-                }
-                
-                result.analyses.push_back(analysis);
-                result.filesProcessed++;
+
+            headerFiles = fsExplorer.viewFiles();
+            std::sort(headerFiles.begin(), headerFiles.end(),
+                      [](const FileSystemEntry* a, const FileSystemEntry* b) { return a->path < b->path; });
+            return true;
+        }
+
+        // Results are built in place in lastResult, which explore() hands out by reference
+        const SourceExplorerResult& exploreSource(const std::string& basePath, const SourceExplorerOptions& options) {
+            SourceExplorerResult& result = lastResult;
+            result = SourceExplorerResult();
+            std::vector<const FileSystemEntry*> headerFiles;
+            if (!collectHeaders(basePath, options, headerFiles, result.errorMessage)) {
+                return result;
             }
-            
+
+            result.analyses.reserve(headerFiles.size());
+            analyzeInOrder(headerFiles, options, result, [&result](SourceFileAnalysis& analysis) {
+                result.analyses.push_back(std::move(analysis));
+                return true;
+            });
+
             result.success = true;
-            lastResult = result;
             return result;
         }
 
-        std::string convertToJson() const {
-            json j;
-            
-            j["success"] = lastResult.success;
-            j["filesProcessed"] = lastResult.filesProcessed;
-            j["filesWithErrors"] = lastResult.filesWithErrors;
-            j["errorMessage"] = lastResult.errorMessage;
-            
-            json filesArray = json::array();
-            
-            for (const auto& analysis : lastResult.analyses) {
-                json fileJson;
-                fileJson["path"] = analysis.path;
-                fileJson["filename"] = analysis.filename;
-                fileJson["success"] = analysis.success;
-                fileJson["errorMessage"] = analysis.errorMessage;
-                
-                // Add parse results
-                json classesArray = json::array();
-                for (const auto& cls : analysis.parseResult.classes) {
-                    json classJson;
-                    classJson["name"] = cls.name;
-                    classJson["fullName"] = cls.fullName;
-                    classJson["isStruct"] = cls.isStruct;
-                    classJson["isTemplate"] = cls.isTemplate;
-                    
-                    // Add base classes
-                    json baseClassesArray = json::array();
-                    for (const auto& base : cls.baseClasses) {
-                        json baseJson;
-                        baseJson["name"] = base.name;
-                        baseJson["access"] = accessSpecifierToString(base.access);
-                        baseClassesArray.push_back(baseJson);
-                    }
-                    classJson["baseClasses"] = baseClassesArray;
-                    
-                    // Add members
-                    json membersArray = json::array();
-                    for (const auto& member : cls.members) {
-                        json memberJson;
-                        memberJson["name"] = member.name;
-                        memberJson["type"] = member.type;
-                        memberJson["access"] = accessSpecifierToString(member.access);
-                        memberJson["isStatic"] = member.isStatic;
-                        memberJson["isConst"] = member.isConst;
-                        memberJson["defaultValue"] = member.defaultValue;
-                        membersArray.push_back(memberJson);
-                    }
-                    classJson["members"] = membersArray;
-                    
-                    // Add methods
-                    json methodsArray = json::array();
-                    for (const auto& method : cls.methods) {
-                        json methodJson;
-                        methodJson["name"] = method.name;
-                        methodJson["returnType"] = method.returnType;
-                        methodJson["access"] = accessSpecifierToString(method.access);
-                        methodJson["isStatic"] = method.isStatic;
-                        methodJson["isConst"] = method.isConst;
-                        methodJson["isVirtual"] = method.isVirtual;
-                        methodJson["isPureVirtual"] = method.isPureVirtual;
-                        methodJson["isConstructor"] = method.isConstructor;
-                        methodJson["isDestructor"] = method.isDestructor;
-                        methodJson["isOperator"] = method.isOperator;
-                        
-                        // Add parameters
-                        json parametersArray = json::array();
-                        for (const auto& param : method.parameters) {
-                            json paramJson;
-                            paramJson["name"] = param.name;
-                            paramJson["type"] = param.type;
-                            paramJson["defaultValue"] = param.defaultValue;
-                            paramJson["isConst"] = param.isConst;
-                            paramJson["isReference"] = param.isReference;
-                            paramJson["isPointer"] = param.isPointer;
-                            parametersArray.push_back(paramJson);
-                        }
-                        methodJson["parameters"] = parametersArray;
-                        
-                        methodsArray.push_back(methodJson);
-                    }
-                    classJson["methods"] = methodsArray;
-                    
-                    // Add template parameters
-                    json templateParamsArray = json::array();
-                    for (const auto& tparam : cls.templateParameters) {
-                        templateParamsArray.push_back(tparam);
-                    }
-                    classJson["templateParameters"] = templateParamsArray;
-                    
-                    // Add friend classes
-                    json friendClassesArray = json::array();
-                    for (const auto& friendClass : cls.friendClasses) {
-                        friendClassesArray.push_back(friendClass);
-                    }
-                    classJson["friendClasses"] = friendClassesArray;
-                    
-                    classesArray.push_back(classJson);
-                }
-                fileJson["classes"] = classesArray;
-                
-                // Add enums
-                json enumsArray = json::array();
-                for (const auto& enumInfo : analysis.parseResult.enums) {
-                    json enumJson;
-                    enumJson["name"] = enumInfo.name;
-                    enumJson["isClass"] = enumInfo.isClass;
-                    
-                    json valuesArray = json::array();
-                    for (const auto& value : enumInfo.values) {
-                        json valueJson;
-                        valueJson["name"] = value.first;
-                        valueJson["value"] = value.second;
-                        valuesArray.push_back(valueJson);
-                    }
-                    enumJson["values"] = valuesArray;
-                    
-                    enumsArray.push_back(enumJson);
-                }
-                fileJson["enums"] = enumsArray;
-                
-                // Add includes
-                json includesArray = json::array();
-                for (const auto& include : analysis.parseResult.includes) {
-                    includesArray.push_back(include);
-                }
-                fileJson["includes"] = includesArray;
-                
-                filesArray.push_back(fileJson);
+        const SourceExplorerResult& exploreWithVisitor(const std::string& basePath, const SourceExplorerOptions& options,
+                                                       const SourceFileVisitor& visitor) {
+            SourceExplorerResult& result = lastResult;
+            result = SourceExplorerResult();
+            std::vector<const FileSystemEntry*> headerFiles;
+            if (collectHeaders(basePath, options, headerFiles, result.errorMessage)) {
+                analyzeInOrder(headerFiles, options, result, visitor);
+                result.success = true;
+            }
+            return result;
+        }
+
+        const SourceExplorerResult& importFromFile(const std::string& filePath, const SourceFileVisitor* visitor) {
+            SourceExplorerResult& result = lastResult;
+            result = SourceExplorerResult();
+            std::string errorMessage;
+            if (!JsonModel::readExplorerResultFile(filePath, result, visitor, errorMessage)) {
+                result = SourceExplorerResult();
+                result.errorMessage = errorMessage;
             }
-            
-            j["files"] = filesArray;
-            
-            return j.dump(2); // Pretty print with 2 spaces indentation
+            return result;
         }
 
-        bool saveJsonToFile(const std::string& filePath) const {
+        const SourceExplorerResult& exploreToStream(const std::string& basePath, std::ostream& out,
+                                                    const SourceExplorerOptions& options, bool bPretty) {
+            SourceExplorerResult& result = lastResult;
+            result = SourceExplorerResult();
+            std::vector<const FileSystemEntry*> headerFiles;
+            bool bWalked = collectHeaders(basePath, options, headerFiles, result.errorMessage);
+
+            JsonWriter writer(out, bPretty);
+            JsonModel::beginExplorerResult(result.errorMessage, writer);
+            if (bWalked) {
+                ParseStats* stats = options.stats;
+                analyzeInOrder(headerFiles, options, result, [&writer, stats](SourceFileAnalysis& analysis) {
+                    double startMs = stats != nullptr ? stats->now() : 0.0;
+                    JsonModel::writeAnalysis(analysis, writer);
+                    if (stats != nullptr) {
+                        stats->recordStage(ParseStage::Export, startMs, stats->now(), analysis.path);
+                    }
+                    return true;
+                });
+                result.success = true;
+            }
+            JsonModel::endExplorerResult(result, writer);
+            writer.flush();
+
+            if (result.success && !writer.good()) {
+                result.success = false;
+                result.errorMessage = "Failed to write JSON output";
+            }
+            return result;
+        }
+
+        std::string convertToJson(bool bPretty) const {
+            std::string output;
+            JsonWriter writer(output, bPretty);
+            writeResultJson(writer, lastResult, lastStats);
+            return output;
+        }
+
+        bool saveJsonToStream(std::ostream& out, bool bPretty) const {
+            JsonWriter writer(out, bPretty);
+            writeResultJson(writer, lastResult, lastStats);
+            writer.flush();
+            return writer.good();
+        }
+
+        bool saveJsonToFile(const std::string& filePath, bool bPretty) const {
             try {
-                std::ofstream outFile(filePath);
+                std::ofstream outFile(filePath, std::ios::binary);
                 if (!outFile.is_open()) {
                     return false;
                 }
                 
-                outFile << convertToJson();
-                outFile.close();
-                return true;
+                return saveJsonToStream(outFile, bPretty);
             } catch (const std::exception&) {
                 return false;
             }
         }
 
-    private:
-        std::string accessSpecifierToString(AccessSpecifier access) const {
-            switch (access) {
-                case AccessSpecifier::Public: return "public";
-                case AccessSpecifier::Protected: return "protected";
-                case AccessSpecifier::Private: return "private";
-                case AccessSpecifier::None: return "none";
-                default: return "unknown";
-            }
-        }
     };
 
     // SourceExplorer implementation
@@ -226,20 +623,65 @@ namespace UFMTooling {
 
     SourceExplorer::~SourceExplorer() = default;
 
-    SourceExplorerResult SourceExplorer::explore(const std::string& basePath, bool bRecursive) {
-        return pImpl->exploreSource(basePath, bRecursive);
+    const SourceExplorerResult& SourceExplorer::explore(const std::string& basePath, bool bRecursive) {
+        SourceExplorerOptions options;
+        options.bRecursive = bRecursive;
+        return pImpl->exploreSource(basePath, options);
+    }
+
+    const SourceExplorerResult& SourceExplorer::explore(const std::string& basePath, const SourceExplorerOptions& options) {
+        return pImpl->exploreSource(basePath, options);
+    }
+
+    const SourceExplorerResult& SourceExplorer::explore(const std::string& basePath, const SourceExplorerOptions& options,
+                                                        const SourceFileVisitor& visitor) {
+        return pImpl->exploreWithVisitor(basePath, options, visitor);
+    }
+
+    const SourceExplorerResult& SourceExplorer::exploreToJson(const std::string& basePath, std::ostream& out,
+                                                              const SourceExplorerOptions& options, bool bPretty) {
+        return pImpl->exploreToStream(basePath, out, options, bPretty);
+    }
+
+    std::string SourceExplorer::exportToJson(bool bPretty) const {
+        return pImpl->convertToJson(bPretty);
+    }
+
+    bool SourceExplorer::exportToJson(std::ostream& out, bool bPretty) const {
+        return pImpl->saveJsonToStream(out, bPretty);
     }
 
-    std::string SourceExplorer::exportToJson() const {
-        return pImpl->convertToJson();
+    bool SourceExplorer::exportToJsonFile(const std::string& filePath, bool bPretty) const {
+        return pImpl->saveJsonToFile(filePath, bPretty);
     }
 
-    bool SourceExplorer::exportToJsonFile(const std::string& filePath) const {
-        return pImpl->saveJsonToFile(filePath);
+    const SourceExplorerResult& SourceExplorer::importFromJsonFile(const std::string& filePath) {
+        return pImpl->importFromFile(filePath, nullptr);
+    }
+
+    const SourceExplorerResult& SourceExplorer::importFromJsonFile(const std::string& filePath,
+                                                                   const SourceFileVisitor& visitor) {
+        return pImpl->importFromFile(filePath, &visitor);
     }
 
     const SourceExplorerResult& SourceExplorer::getLastResult() const {
         return pImpl->lastResult;
     }
 
+    void SourceExplorer::configureParser(SimpleHeaderParser& parser, const SourceExplorerOptions& options) {
+        parser.setPreprocessorOptions(options.preprocessor);
+        parser.setParallelOptions(options.parallel);
+        parser.setParseDetail(options.detail);
+        parser.setStats(options.stats);
+        parser.setCopyFiles(options.bCopyFiles);
+    }
+
+    const PUMLBatchResult& SourceExplorer::explorePUML(const std::string& basePath, const PUMLBatchOptions& options) {
+        return pImpl->pumlParser.explore(basePath, options);
+    }
+
+    const PUMLBatchResult& SourceExplorer::getLastPUMLResult() const {
+        return pImpl->pumlParser.getLastResult();
+    }
+
 } // namespace UFMTooling
@@ -0,0 +1,830 @@
+#include "../include/SourceServer.h"
+#include "../include/DirectoryWatcher.h"
+#include "../include/SymbolIndex.h"
+#include "../include/JsonWriter.h"
+#include "../include/StringInterner.h"
+#include "LocalSocket.h"
+#include "ParseResultJson.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace UFMTooling {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // A burst of changes is applied after this long even if it has not ended
+        const auto MaxUpdateDelay = std::chrono::seconds(1);
+
+        // One published state of the tree. Never modified once published; queries
+        // hold it through a shared_ptr while updates build the next one.
+        struct Model {
+            uint64_t generation;
+            SourceExplorerResult result;
+            SymbolIndex index;
+            std::shared_ptr<const PUMLBatchResult> puml;
+
+            // Compact JSON of result, written by the first export request
+            mutable std::once_flag exportOnce;
+            mutable std::string exportJson;
+
+            Model() : generation(0) {}
+        };
+
+        // What an update has to do
+        struct PendingChanges {
+            bool bRescan;                   // Walk the tree again (files may have appeared)
+            bool bPUML;                     // Parse the diagrams again
+            std::set<std::string> headers;  // Known headers modified or removed
+
+            PendingChanges() : bRescan(false), bPUML(false) {}
+
+            bool empty() const { return !bRescan && !bPUML && headers.empty(); }
+        };
+
+        bool hasExtension(const std::string& path, const char* extension) {
+            return fs::path(path).extension() == extension;
+        }
+
+        const SourceFileAnalysis* findAnalysis(const SourceExplorerResult& result, const std::string& path) {
+            auto it = std::lower_bound(result.analyses.begin(), result.analyses.end(), path,
+                                       [](const SourceFileAnalysis& a, const std::string& p) { return a.path < p; });
+            return it != result.analyses.end() && it->path == path ? &*it : nullptr;
+        }
+
+        // Same files with the same (shared) parse results
+        bool sameAnalyses(const SourceExplorerResult& a, const SourceExplorerResult& b) {
+            return std::equal(a.analyses.begin(), a.analyses.end(), b.analyses.begin(), b.analyses.end(),
+                              [](const SourceFileAnalysis& x, const SourceFileAnalysis& y) {
+                                  return x.path == y.path && x.parseResult == y.parseResult && x.success == y.success;
+                              });
+        }
+
+        void countAnalyses(SourceExplorerResult& result) {
+            result.filesProcessed = static_cast<int>(result.analyses.size());
+            result.filesWithErrors = 0;
+            result.filesFromCache = 0;
+            for (const auto& analysis : result.analyses) {
+                if (!analysis.success) result.filesWithErrors++;
+                if (analysis.fromCache) result.filesFromCache++;
+            }
+        }
+
+        const char* diagramTypeName(PUMLDiagramType type) {
+            switch (type) {
+                case PUMLDiagramType::Class: return "class";
+                case PUMLDiagramType::Entity: return "entity";
+                default: return "unknown";
+            }
+        }
+
+        void writeClass(const SymbolIndex& index, const SymbolClass& cls, JsonWriter& writer) {
+            writer.beginObject();
+            writer.key("bases");
+            writer.beginArray();
+            for (std::string_view base : index.baseClasses(cls.id)) {
+                writer.value(base);
+            }
+            writer.endArray();
+            writer.member("file", cls.file);
+            writer.member("fullName", cls.fullName);
+            writer.member("isStruct", cls.isStruct);
+            writer.member("isTemplate", cls.isTemplate);
+            writer.member("name", cls.name);
+            writer.endObject();
+        }
+
+        void writeMethod(const SymbolMethod& method, JsonWriter& writer) {
+            writer.beginObject();
+            writer.member("access", JsonModel::accessSpecifierToString(method.access));
+            writer.member("className", method.className);
+            writer.member("file", method.file);
+            writer.member("isConst", method.isConst);
+            writer.member("isStatic", method.isStatic);
+            writer.member("isVirtual", method.isVirtual);
+            writer.member("name", method.name);
+            writer.endObject();
+        }
+
+        std::string errorResponse(const std::string& message) {
+            std::string response;
+            JsonWriter writer(response, false);
+            writer.beginObject();
+            writer.member("error", message);
+            writer.member("ok", false);
+            writer.endObject();
+            return response;
+        }
+    }
+
+    class SourceServer::Impl {
+    public:
+        std::string basePath;
+        SourceServerOptions options;
+        std::string endpoint;
+        std::string errorMessage;
+
+        // Published model
+        mutable std::mutex modelMutex;
+        std::shared_ptr<const Model> model;
+
+        // Model updates: only the updater thread (and start(), before it runs) touches these
+        SourceExplorer explorer;
+        PUMLBatchParser pumlParser;
+        AnalysisCache cache;
+        FileSystemExplorer directoryWalker;
+        DirectoryWatcher watcher;
+        std::atomic<bool> bWatching;        // Native watcher covers the tree; else polling
+        std::map<std::string, FileFingerprint> pumlFingerprints;   // Polling only
+        std::thread updater;
+
+        // Clients
+        struct Client {
+            LocalConnection connection;
+            std::thread thread;
+            bool done;                      // Guarded by clientsMutex
+
+            Client() : done(false) {}
+        };
+        LocalListener listener;
+        bool bListening;
+        std::thread acceptor;
+        std::mutex clientsMutex;
+        std::list<std::unique_ptr<Client>> clients;
+
+        // Lifecycle and status
+        mutable std::mutex stateMutex;
+        std::condition_variable stateChanged;
+        bool running;
+        bool shutdownRequested;
+        std::atomic<bool> stopping;
+        std::atomic<uint64_t> requests;
+        double lastUpdateMs;
+        std::string statusError;
+        uint64_t refreshesRequested;        // refresh() calls, answered in order by the updater
+        uint64_t refreshesDone;
+
+        Impl() : bWatching(false), bListening(false), running(false), shutdownRequested(false), stopping(false),
+                 requests(0), lastUpdateMs(0.0), refreshesRequested(0), refreshesDone(0) {}
+
+        std::shared_ptr<const Model> snapshot() const {
+            std::lock_guard<std::mutex> lock(modelMutex);
+            return model;
+        }
+
+        void setStatusError(const std::string& message) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            statusError = message;
+        }
+
+        // Directories the walks descend into, for the watcher
+        void watchTree() {
+            if (!watcher.isNative()) {
+                bWatching = false;
+                return;
+            }
+
+            std::set<std::string> directories;
+            directories.insert(basePath);
+            auto collect = [&](FileSystemExplorerOptions walk, bool bRecursive) {
+                walk.bRecursive = bRecursive;
+                walk.bIncludeDirectories = true;
+                walk.bFileSizes = false;
+                walk.extensions.assign(1, ".h");
+                if (!directoryWalker.explore(basePath, walk).success) return;
+                for (const FileSystemEntry* entry : directoryWalker.viewDirectories()) {
+                    directories.insert(entry->path);
+                }
+            };
+            collect(options.explore.walk, options.explore.bRecursive);
+            if (options.bPUML) {
+                collect(options.puml.walk, options.puml.bRecursive);
+            }
+
+            bWatching = watcher.watch(basePath, std::vector<std::string>(directories.begin(), directories.end()));
+            if (!bWatching) {
+                setStatusError(watcher.getErrorMessage() + "; polling instead");
+            }
+        }
+
+        // Polling: did any diagram change since the last check?
+        bool pumlFilesChanged() {
+            FileSystemExplorerOptions walk = options.puml.walk;
+            walk.bRecursive = options.puml.bRecursive;
+            walk.extensions.assign(1, ".puml");
+            walk.bIncludeDirectories = false;
+            walk.bFileSizes = false;
+
+            std::map<std::string, FileFingerprint> current;
+            for (const auto& entry : directoryWalker.explore(basePath, walk).entries) {
+                AnalysisCache::fingerprintFile(entry.path, false, current[entry.path]);
+            }
+            bool bChanged = current.size() != pumlFingerprints.size() ||
+                            !std::equal(current.begin(), current.end(), pumlFingerprints.begin(),
+                                        [](const auto& a, const auto& b) {
+                                            return a.first == b.first && a.second.lastWriteTime == b.second.lastWriteTime &&
+                                                   a.second.size == b.second.size;
+                                        });
+            pumlFingerprints.swap(current);
+            return bChanged;
+        }
+
+        void classify(const DirectoryChange& change, const Model& current, PendingChanges& pending) const {
+            if (change.kind == DirectoryChangeKind::Overflow || change.isDirectory) {
+                pending.bRescan = true;
+                pending.bPUML = options.bPUML;
+                return;
+            }
+            if (hasExtension(change.path, ".puml")) {
+                pending.bPUML = options.bPUML;
+            } else if (hasExtension(change.path, ".h")) {
+                // Known headers are updated on their own (editors often save by renaming a
+                // new file over the old one); a new header may or may not pass the walk filters
+                if (findAnalysis(current.result, change.path) != nullptr) {
+                    pending.headers.insert(change.path);
+                } else if (change.kind != DirectoryChangeKind::Removed) {
+                    pending.bRescan = true;
+                }
+            }
+        }
+
+        // Reparse modified headers and drop removed ones, without walking the tree
+        void patchHeaders(SourceExplorerResult& result, const std::set<std::string>& headers) {
+            SimpleHeaderParser parser;
+            SourceExplorer::configureParser(parser, options.explore);
+            for (const auto& path : headers) {
+                auto it = std::lower_bound(result.analyses.begin(), result.analyses.end(), path,
+                                           [](const SourceFileAnalysis& a, const std::string& p) { return a.path < p; });
+                if (it == result.analyses.end() || it->path != path) continue;
+
+                std::error_code error;
+                if (!fs::is_regular_file(path, error)) {
+                    cache.erase(path);
+                    result.analyses.erase(it);
+                    continue;
+                }
+
+                SourceFileAnalysis& analysis = *it;
+                analysis.fromCache = false;
+                analysis.errorMessage.clear();
+                AnalysisCache::fingerprintFile(path, options.explore.bHashContents, analysis.fingerprint,
+                                               options.explore.bCopyFiles);
+                analysis.fingerprint.optionsHash = AnalysisCache::hashOptions(options.explore.preprocessor);
+                try {
+                    analysis.parseResult = parser.parseFileShared(path);
+                    analysis.success = analysis.parseResult->success;
+                    if (!analysis.success) {
+                        analysis.errorMessage = analysis.parseResult->errorMessage;
+                    }
+                } catch (const std::exception& e) {
+                    analysis.parseResult = std::make_shared<ParseResult>();
+                    analysis.success = false;
+                    analysis.errorMessage = std::string("Parsing error: ") + e.what();
+                }
+
+                if (analysis.success && options.explore.detail == ParseDetail::Full) {
+                    cache.store(path, analysis.fingerprint, analysis.parseResult);
+                } else {
+                    cache.erase(path);
+                }
+            }
+            countAnalyses(result);
+        }
+
+        // Build and publish the next model. bForce publishes even if nothing changed.
+        bool update(const PendingChanges& pending, bool bForce, std::string& error) {
+            Clock::time_point start = Clock::now();
+            std::shared_ptr<const Model> current = snapshot();
+            auto next = std::make_shared<Model>();
+
+            if (pending.bRescan || !current) {
+                for (const auto& path : pending.headers) {
+                    cache.erase(path);      // Edits within the mtime resolution
+                }
+                SourceExplorerOptions exploreOptions = options.explore;
+                exploreOptions.cache = &cache;
+                const SourceExplorerResult& result = explorer.explore(basePath, exploreOptions);
+                if (!result.success) {
+                    error = result.errorMessage;
+                    return false;
+                }
+                next->result = result;
+            } else {
+                next->result = current->result;
+                patchHeaders(next->result, pending.headers);
+            }
+
+            if (options.bPUML && (pending.bPUML || !current)) {
+                next->puml = std::make_shared<PUMLBatchResult>(pumlParser.explore(basePath, options.puml));
+            } else {
+                next->puml = current ? current->puml : std::make_shared<PUMLBatchResult>();
+            }
+
+            if (current && !bForce && pending.bRescan && !pending.bPUML && sameAnalyses(current->result, next->result)) {
+                return true;    // Polling found nothing new
+            }
+            if (pending.bRescan && current) {
+                watchTree();
+            }
+
+            next->index.build(next->result);
+            next->generation = current ? current->generation + 1 : 1;
+            {
+                std::lock_guard<std::mutex> modelLock(modelMutex);
+                model = std::move(next);
+            }
+            std::lock_guard<std::mutex> stateLock(stateMutex);
+            lastUpdateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            return true;
+        }
+
+        // Wait for watcher events, or sleep when polling; false once stopping
+        bool waitForChanges(std::vector<DirectoryChange>& changes, int timeoutMs) {
+            if (bWatching) {
+                if (watcher.wait(changes, timeoutMs)) return !stopping;
+                if (stopping) return false;
+                bWatching = false;
+                setStatusError(watcher.getErrorMessage() + "; polling instead");
+            }
+            std::unique_lock<std::mutex> lock(stateMutex);
+            auto sleep = timeoutMs < 0 ? std::chrono::milliseconds(options.pollIntervalMs)
+                                       : std::chrono::milliseconds(timeoutMs);
+            stateChanged.wait_for(lock, sleep, [this]() { return stopping || refreshesRequested != refreshesDone; });
+            return !stopping;
+        }
+
+        // The refresh() calls made so far, if some are not answered yet
+        bool refreshRequested(uint64_t& requested) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            requested = refreshesRequested;
+            return refreshesRequested != refreshesDone;
+        }
+
+        void updateLoop() {
+            PendingChanges pending;
+            Clock::time_point firstChange;
+            std::vector<DirectoryChange> changes;
+            for (;;) {
+                int timeout;
+                if (!pending.empty()) {
+                    timeout = static_cast<int>(options.debounceMs);
+                } else {
+                    timeout = bWatching ? -1 : static_cast<int>(options.pollIntervalMs);
+                }
+
+                changes.clear();
+                if (!waitForChanges(changes, timeout)) return;
+
+                uint64_t requested;
+                if (refreshRequested(requested)) {
+                    // A full update also covers the changes seen so far
+                    PendingChanges all;
+                    all.bRescan = true;
+                    all.bPUML = options.bPUML;
+                    std::string error;
+                    if (!update(all, true, error)) {
+                        setStatusError(error);
+                    } else if (!bWatching && options.bPUML) {
+                        pumlFilesChanged();
+                    }
+                    pending = PendingChanges();
+                    {
+                        std::lock_guard<std::mutex> lock(stateMutex);
+                        refreshesDone = requested;
+                    }
+                    stateChanged.notify_all();
+                    continue;
+                }
+
+                bool bPolled = !bWatching && changes.empty() && pending.empty();
+                if (bPolled) {
+                    pending.bRescan = true;
+                    pending.bPUML = options.bPUML && pumlFilesChanged();
+                } else if (!changes.empty()) {
+                    std::shared_ptr<const Model> current = snapshot();
+                    bool bWasEmpty = pending.empty();
+                    for (const auto& change : changes) {
+                        classify(change, *current, pending);
+                    }
+                    if (bWasEmpty) {
+                        firstChange = Clock::now();
+                    }
+                    // Let the burst settle, within limits
+                    if (!pending.empty() && Clock::now() - firstChange < MaxUpdateDelay) continue;
+                }
+                if (pending.empty()) continue;
+
+                std::string error;
+                if (!update(pending, false, error)) {
+                    setStatusError(error);
+                }
+                pending = PendingChanges();
+            }
+        }
+
+        void serve(Client& client) {
+            std::string line;
+            while (!stopping && client.connection.readLine(line)) {
+                bool bShutdown = false;
+                std::string response = handleRequest(line, &bShutdown);
+                response.push_back('\n');
+                bool bWritten = client.connection.write(response);
+                if (bShutdown) {
+                    requestShutdown();      // Only now, as stop() cuts the connections
+                }
+                if (!bWritten) break;
+            }
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            client.connection.close();
+            client.done = true;
+        }
+
+        void acceptLoop() {
+            for (;;) {
+                std::unique_ptr<Client> client(new Client());
+                if (!listener.accept(client->connection)) return;
+
+                std::lock_guard<std::mutex> lock(clientsMutex);
+                for (auto it = clients.begin(); it != clients.end();) {
+                    if ((*it)->done) {
+                        (*it)->thread.join();
+                        it = clients.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                Client* raw = client.get();
+                clients.push_back(std::move(client));
+                raw->thread = std::thread([this, raw]() { serve(*raw); });
+            }
+        }
+
+        void writeStatus(JsonWriter& writer) const {
+            SourceServerStatus status = getStatus();
+            writer.beginObject();
+            writer.member("basePath", status.basePath);
+            writer.member("classes", status.classes);
+            writer.member("endpoint", status.endpoint);
+            writer.member("errorMessage", status.errorMessage);
+            writer.member("files", status.files);
+            writer.member("filesWithErrors", status.filesWithErrors);
+            writer.member("generation", status.generation);
+            writer.member("internedBytes", status.internedBytes);
+            writer.member("internedStrings", status.internedStrings);
+            writer.member("lastUpdateMs", status.lastUpdateMs);
+            writer.member("methods", status.methods);
+            writer.member("pumlFiles", status.pumlFiles);
+            writer.member("requests", status.requests);
+            writer.member("running", status.running);
+            writer.member("watcher", status.watcher);
+            writer.endObject();
+        }
+
+        void requestShutdown() {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                shutdownRequested = true;
+            }
+            stateChanged.notify_all();
+        }
+
+        // With bShutdown, a shutdown request is left to the caller (set to true) instead of made at once
+        std::string handleRequest(const std::string& request, bool* bShutdown = nullptr) {
+            requests++;
+            std::string line = request.substr(0, request.find('\n'));
+            size_t first = line.find_first_not_of(" \t\r");
+            size_t last = line.find_last_not_of(" \t\r");
+            line = first == std::string::npos ? std::string() : line.substr(first, last - first + 1);
+            size_t space = line.find_first_of(" \t");
+            std::string command = line.substr(0, space);
+            std::string argument;
+            if (space != std::string::npos) {
+                argument = line.substr(line.find_first_not_of(" \t", space));
+            }
+
+            std::shared_ptr<const Model> current = snapshot();
+            if (!current) {
+                return errorResponse("Server not started");
+            }
+            const SymbolIndex& index = current->index;
+            bool bNeedsName = command == "class" || command == "derived" || command == "method" || command == "includers";
+            if (bNeedsName && argument.empty()) {
+                return errorResponse("Missing name: " + command + " <name>");
+            }
+
+            if (command == "export") {
+                std::call_once(current->exportOnce, [&current]() {
+                    JsonWriter writer(current->exportJson, false);
+                    JsonModel::beginExplorerResult(current->result.errorMessage, writer);
+                    for (const auto& analysis : current->result.analyses) {
+                        JsonModel::writeAnalysis(analysis, writer);
+                    }
+                    JsonModel::endExplorerResult(current->result, writer);
+                });
+                return "{\"ok\":true,\"result\":" + current->exportJson + "}";
+            }
+            if (command == "refresh") {
+                refresh();
+            } else if (command == "shutdown") {
+                if (bShutdown != nullptr) {
+                    *bShutdown = true;
+                } else {
+                    requestShutdown();
+                }
+                return "{\"ok\":true}";
+            }
+
+            std::string response;
+            JsonWriter writer(response, false);
+            writer.beginObject();
+            writer.member("ok", true);
+            writer.key("result");
+            if (command == "status" || command == "refresh") {
+                writeStatus(writer);
+            } else if (command == "files") {
+                writer.beginArray();
+                for (const auto& analysis : current->result.analyses) {
+                    writer.beginObject();
+                    writer.member("classes", analysis.parseResult ? analysis.parseResult->classes.size() : size_t(0));
+                    writer.member("errorMessage", analysis.errorMessage);
+                    writer.member("path", analysis.path);
+                    writer.member("success", analysis.success);
+                    writer.endObject();
+                }
+                writer.endArray();
+            } else if (command == "class" || command == "derived") {
+                writer.beginArray();
+                for (const SymbolClass& cls : command == "class" ? index.findClasses(argument)
+                                                                 : index.derivedClasses(argument, true)) {
+                    writeClass(index, cls, writer);
+                }
+                writer.endArray();
+            } else if (command == "method") {
+                writer.beginArray();
+                for (const SymbolMethod& method : index.findMethods(argument)) {
+                    writeMethod(method, writer);
+                }
+                writer.endArray();
+            } else if (command == "includers") {
+                writer.beginArray();
+                for (std::string_view file : index.filesIncluding(argument)) {
+                    writer.value(file);
+                }
+                writer.endArray();
+            } else if (command == "puml") {
+                const PUMLBatchResult& puml = *current->puml;
+                writer.beginObject();
+                writer.member("classDiagrams", puml.classDiagrams);
+                writer.member("entityDiagrams", puml.entityDiagrams);
+                writer.key("files");
+                writer.beginArray();
+                for (const auto& analysis : puml.analyses) {
+                    writer.beginObject();
+                    writer.member("classes", analysis.classDiagram.classes.size());
+                    writer.member("entities", analysis.entityDiagram.entities.size());
+                    writer.member("errorMessage", analysis.errorMessage);
+                    writer.member("path", analysis.path);
+                    writer.member("success", analysis.success);
+                    writer.member("type", diagramTypeName(analysis.type));
+                    writer.endObject();
+                }
+                writer.endArray();
+                writer.member("filesProcessed", puml.filesProcessed);
+                writer.member("filesWithErrors", puml.filesWithErrors);
+                writer.endObject();
+            } else {
+                return errorResponse(command.empty() ? "Empty request" : "Unknown request: " + command);
+            }
+            writer.endObject();
+            return response;
+        }
+
+        // Have the updater thread update the model and wait for it, so the watcher and
+        // the walks are only ever used by that thread
+        void refresh() {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            if (!running) return;
+            uint64_t ticket = ++refreshesRequested;
+            stateChanged.notify_all();
+            watcher.wake();
+            stateChanged.wait(lock, [this, ticket]() { return refreshesDone >= ticket || !running; });
+        }
+
+        SourceServerStatus getStatus() const {
+            SourceServerStatus status;
+            std::shared_ptr<const Model> current = snapshot();
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                status.running = running;
+                status.lastUpdateMs = lastUpdateMs;
+                status.errorMessage = statusError;
+            }
+            status.basePath = basePath;
+            status.endpoint = bListening ? endpoint : std::string();
+            status.watcher = bWatching ? DirectoryWatcher::backendName() : "polling";
+            status.requests = requests;
+            status.internedStrings = StringInterner::global().size();
+            status.internedBytes = StringInterner::global().storedBytes();
+            if (current) {
+                status.generation = current->generation;
+                status.files = current->result.analyses.size();
+                status.filesWithErrors = static_cast<size_t>(current->result.filesWithErrors);
+                status.classes = current->index.classCount();
+                status.methods = current->index.methodCount();
+                status.pumlFiles = current->puml ? current->puml->analyses.size() : 0;
+            }
+            return status;
+        }
+
+        bool start(const std::string& path, const SourceServerOptions& serverOptions) {
+            stop();
+            basePath = path;
+            options = serverOptions;
+            // Watched files are rewritten under the server: a mapping truncated during a
+            // reparse or rescan would fault (SIGBUS) and take the daemon down, so read copies
+            options.explore.bCopyFiles = true;
+            options.puml.bCopyFiles = true;
+            endpoint = options.endpoint.empty() ? SourceServer::defaultEndpoint(path) : options.endpoint;
+            errorMessage.clear();
+            statusError.clear();
+            {
+                std::lock_guard<std::mutex> lock(modelMutex);
+                model.reset();
+            }
+            if (!options.cacheFile.empty()) {
+                cache.load(options.cacheFile);      // A missing cache file just means a cold start
+            }
+
+            watcher.clear();
+            PendingChanges all;
+            if (!update(all, true, errorMessage)) {
+                release();
+                return false;
+            }
+            watchTree();
+            if (!bWatching && options.bPUML) {
+                pumlFilesChanged();                 // Baseline for polling
+            }
+
+            bListening = endpoint != "-";
+            if (bListening && !listener.listen(endpoint, errorMessage)) {
+                release();
+                return false;
+            }
+
+            stopping = false;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                running = true;
+                shutdownRequested = false;
+                refreshesRequested = refreshesDone = 0;
+            }
+            updater = std::thread([this]() { updateLoop(); });
+            if (bListening) {
+                acceptor = std::thread([this]() { acceptLoop(); });
+            }
+            return true;
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (!running) return;
+                running = false;
+                stopping = true;
+            }
+            stateChanged.notify_all();
+            watcher.interrupt();
+            if (acceptor.joinable()) {
+                listener.interrupt();
+                acceptor.join();
+            }
+            if (updater.joinable()) {
+                updater.join();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(clientsMutex);
+                for (auto& client : clients) {
+                    if (!client->done) client->connection.shutdown();
+                }
+            }
+            for (auto& client : clients) {
+                client->thread.join();
+            }
+            clients.clear();
+            listener.close();
+            bListening = false;
+            watcher.clear();
+            bWatching = false;
+
+            if (!options.cacheFile.empty() && !cache.save(options.cacheFile)) {
+                setStatusError("Could not save cache file: " + options.cacheFile);
+            }
+        }
+
+        // Undo what a failed start() set up; the threads were not started yet
+        void release() {
+            listener.close();
+            bListening = false;
+            watcher.clear();
+            bWatching = false;
+            pumlFingerprints.clear();
+            cache.clear();
+            std::lock_guard<std::mutex> lock(modelMutex);
+            model.reset();
+        }
+
+        void wait() {
+            {
+                std::unique_lock<std::mutex> lock(stateMutex);
+                stateChanged.wait(lock, [this]() { return shutdownRequested || !running; });
+            }
+            stop();
+        }
+    };
+
+    // SourceServer implementation
+    SourceServer::SourceServer() : pImpl(new Impl()) {}
+
+    SourceServer::~SourceServer() {
+        pImpl->stop();
+    }
+
+    bool SourceServer::start(const std::string& basePath, const SourceServerOptions& options) {
+        return pImpl->start(basePath, options);
+    }
+
+    void SourceServer::stop() {
+        pImpl->stop();
+    }
+
+    void SourceServer::wait() {
+        pImpl->wait();
+    }
+
+    std::string SourceServer::handleRequest(const std::string& request) {
+        return pImpl->handleRequest(request);
+    }
+
+    void SourceServer::refresh() {
+        pImpl->refresh();
+    }
+
+    SourceServerStatus SourceServer::getStatus() const {
+        return pImpl->getStatus();
+    }
+
+    const std::string& SourceServer::getErrorMessage() const {
+        return pImpl->errorMessage;
+    }
+
+    std::string SourceServer::defaultEndpoint(const std::string& basePath) {
+        std::error_code error;
+        fs::path absolute = fs::absolute(basePath, error).lexically_normal();
+        std::string key = absolute.string();
+        while (key.size() > 1 && (key.back() == '/' || key.back() == '\\')) {
+            key.pop_back();
+        }
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx",
+                      static_cast<unsigned long long>(AnalysisCache::hashContent(key)));
+#ifdef _WIN32
+        return std::string("\\\\.\\pipe\\ufmtooling-") + hash;
+#else
+        // In a directory of the user, created private by the listener, so no other user
+        // can reach the socket or put something in its place
+        fs::path directory = fs::temp_directory_path(error);
+        if (error) directory = "/tmp";
+        directory /= "ufmtooling-" + std::to_string(static_cast<unsigned long>(::getuid()));
+        return (directory / (std::string(hash) + ".sock")).string();
+#endif
+    }
+
+    bool SourceServer::query(const std::string& endpoint, const std::string& request, std::string& response) {
+        LocalConnection connection;
+        if (!connection.connect(endpoint)) {
+            return false;
+        }
+        std::string line = request.substr(0, request.find('\n'));
+        line.push_back('\n');
+        return connection.write(line) && connection.readLine(response);
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,189 @@
+#include "../include/StringInterner.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace UFMTooling {
+
+    namespace {
+        using Entry = StringInterner::Entry;
+
+        const size_t ShardCount = 32;
+
+        // Ids map to entries through blocks of doubling size: block b holds
+        // FirstBlockSize << b ids, so the directory never moves and is read without a lock
+        const size_t FirstBlockBits = 10;
+        const size_t FirstBlockSize = size_t(1) << FirstBlockBits;
+        const size_t BlockCount = 32 - FirstBlockBits + 1;
+
+        // Index of the highest set bit of a non-zero value
+        unsigned highestBit(uint64_t value) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(63 - __builtin_clzll(value));
+#endif
+        }
+
+        // Distinguishes interners in the thread caches; never reused, so a slot left by a
+        // destroyed interner cannot match a new one at the same address
+        std::atomic<uint64_t> nextSerial(1);
+
+        // Per-thread, direct-mapped cache of recently interned strings
+        struct CacheSlot {
+            uint64_t serial;
+            const Entry* entry;
+        };
+        const size_t CacheSlots = 256;
+        thread_local CacheSlot threadCache[CacheSlots];
+    }
+
+    class StringInterner::Impl {
+    public:
+        struct Shard {
+            mutable std::mutex mutex;
+            std::deque<Entry> entries;          // A deque keeps the entries (and the map's views) in place
+            std::unordered_map<std::string_view, const Entry*> byText;
+        };
+
+        const uint64_t serial;
+        Shard shards[ShardCount];
+        std::atomic<std::atomic<const Entry*>*> directory[BlockCount];  // Id -> entry
+        std::atomic<uint32_t> nextId;
+        std::atomic<size_t> bytes;
+
+        Impl() : serial(nextSerial.fetch_add(1)), nextId(1), bytes(0) {
+            for (auto& block : directory) {
+                block.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~Impl() {
+            for (auto& block : directory) {
+                delete[] block.load(std::memory_order_relaxed);
+            }
+        }
+
+        static void locate(Symbol id, size_t& block, size_t& offset) {
+            uint64_t position = uint64_t(id) + FirstBlockSize;
+            block = highestBit(position) - FirstBlockBits;
+            offset = static_cast<size_t>(position - (uint64_t(FirstBlockSize) << block));
+        }
+
+        // Make id findable by view(); called with the entry's shard locked
+        void publish(Symbol id, const Entry* entry) {
+            size_t block, offset;
+            locate(id, block, offset);
+            std::atomic<const Entry*>* slots = directory[block].load(std::memory_order_acquire);
+            if (!slots) {
+                std::atomic<const Entry*>* fresh = new std::atomic<const Entry*>[FirstBlockSize << block]();
+                if (directory[block].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel)) {
+                    slots = fresh;
+                } else {
+                    delete[] fresh;             // Another shard allocated it first
+                }
+            }
+            slots[offset].store(entry, std::memory_order_release);
+        }
+
+        const Entry* entryOf(Symbol id) const {
+            if (id == 0) return nullptr;
+            size_t block, offset;
+            locate(id, block, offset);
+            if (block >= BlockCount) return nullptr;
+            std::atomic<const Entry*>* slots = directory[block].load(std::memory_order_acquire);
+            return slots ? slots[offset].load(std::memory_order_acquire) : nullptr;
+        }
+
+        const Entry* intern(std::string_view text) {
+            if (text.empty()) return nullptr;
+            size_t hash = std::hash<std::string_view>()(text);
+
+            CacheSlot& cached = threadCache[hash % CacheSlots];
+            if (cached.serial == serial && cached.entry->text == text) {
+                return cached.entry;
+            }
+
+            Shard& shard = shards[(hash >> 16) % ShardCount];
+            const Entry* entry;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                auto it = shard.byText.find(text);
+                if (it != shard.byText.end()) {
+                    entry = it->second;
+                } else {
+                    shard.entries.emplace_back();
+                    Entry& stored = shard.entries.back();
+                    stored.text.assign(text.data(), text.size());
+                    stored.id = nextId.fetch_add(1, std::memory_order_relaxed);
+                    shard.byText.emplace(stored.text, &stored);
+                    publish(stored.id, &stored);
+                    bytes.fetch_add(text.size(), std::memory_order_relaxed);
+                    entry = &stored;
+                }
+            }
+            cached.serial = serial;
+            cached.entry = entry;
+            return entry;
+        }
+
+        const Entry* find(std::string_view text) const {
+            if (text.empty()) return nullptr;
+            size_t hash = std::hash<std::string_view>()(text);
+            const Shard& shard = shards[(hash >> 16) % ShardCount];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.byText.find(text);
+            return it != shard.byText.end() ? it->second : nullptr;
+        }
+    };
+
+    StringInterner::StringInterner() : pImpl(new Impl()) {}
+
+    StringInterner::~StringInterner() = default;
+
+    StringInterner& StringInterner::global() {
+        // Leaked on purpose: results in static storage may outlive any destruction order
+        static StringInterner* interner = new StringInterner();
+        return *interner;
+    }
+
+    Symbol StringInterner::intern(std::string_view text) {
+        const Entry* entry = pImpl->intern(text);
+        return entry ? entry->id : 0;
+    }
+
+    const StringInterner::Entry* StringInterner::internEntry(std::string_view text) {
+        return pImpl->intern(text);
+    }
+
+    Symbol StringInterner::find(std::string_view text) const {
+        const Entry* entry = pImpl->find(text);
+        return entry ? entry->id : 0;
+    }
+
+    std::string_view StringInterner::view(Symbol id) const {
+        const Entry* entry = pImpl->entryOf(id);
+        return entry ? std::string_view(entry->text) : std::string_view();
+    }
+
+    size_t StringInterner::size() const {
+        return pImpl->nextId.load(std::memory_order_relaxed) - 1;
+    }
+
+    size_t StringInterner::storedBytes() const {
+        return pImpl->bytes.load(std::memory_order_relaxed);
+    }
+
+    const std::string& InternedString::emptyString() {
+        static const std::string empty;
+        return empty;
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,689 @@
+#include "../include/SymbolIndex.h"
+#include "../include/MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace UFMTooling {
+
+    namespace {
+        // File layout: header, column table, then the columns, each 8-byte aligned.
+        // Integers are written in host byte order; byteOrder rejects foreign files.
+        const char IndexMagic[8] = {'U', 'F', 'M', 'S', 'Y', 'M', 'I', 'X'};
+        const uint32_t IndexVersion = 1;
+        const uint32_t ByteOrderMark = 0x01020304;
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t byteOrder;
+            uint32_t columnCount;
+            uint32_t reserved;
+        };
+
+        struct ColumnEntry {
+            uint64_t offset;
+            uint64_t count;
+        };
+
+        const uint32_t NoId = static_cast<uint32_t>(-1);
+
+        // Class flags
+        const uint32_t ClassIsStruct = 1u << 0;
+        const uint32_t ClassIsTemplate = 1u << 1;
+
+        // Method flags; the low two bits hold the AccessSpecifier
+        const uint32_t MethodAccessMask = 3u;
+        const uint32_t MethodIsStatic = 1u << 2;
+        const uint32_t MethodIsConst = 1u << 3;
+        const uint32_t MethodIsVirtual = 1u << 4;
+        const uint32_t MethodIsPureVirtual = 1u << 5;
+        const uint32_t MethodIsConstructor = 1u << 6;
+        const uint32_t MethodIsDestructor = 1u << 7;
+
+        // A read-only array that is either owned (after build()) or a view into the
+        // mapped index file (after load())
+        template <typename T>
+        struct Column {
+            const T* data;
+            size_t count;
+            std::vector<T> owned;
+
+            Column() : data(nullptr), count(0) {}
+
+            void assign(std::vector<T>&& values) {
+                owned = std::move(values);
+                data = owned.data();
+                count = owned.size();
+            }
+
+            void view(const T* values, size_t valueCount) {
+                std::vector<T>().swap(owned);
+                data = values;
+                count = valueCount;
+            }
+
+            void reset() { view(nullptr, 0); }
+
+            size_t size() const { return count; }
+            const T& operator[](size_t i) const { return data[i]; }
+            const T* begin() const { return data; }
+            const T* end() const { return data + count; }
+        };
+
+        size_t alignTo8(size_t offset) {
+            return (offset + 7) & ~static_cast<size_t>(7);
+        }
+
+        // Every value is a valid position in a container of 'limit' elements
+        bool idsBelow(const Column<uint32_t>& column, size_t limit) {
+            return std::all_of(column.begin(), column.end(), [limit](uint32_t id) { return id < limit; });
+        }
+
+        // CSR offsets: 'rows' + 1 non-decreasing values starting at 0 and ending at 'total'
+        bool validOffsets(const Column<uint32_t>& column, size_t rows, size_t total) {
+            if (column.size() != rows + 1 || column[0] != 0 || column[rows] != total) return false;
+            for (size_t i = 0; i < rows; ++i) {
+                if (column[i] > column[i + 1]) return false;
+            }
+            return true;
+        }
+    }
+
+    class SymbolIndex::Impl {
+    public:
+        // String table: string i is stringData[stringOffsets[i] .. stringOffsets[i + 1])
+        Column<char> stringData;
+        Column<uint32_t> stringOffsets;
+        Column<uint32_t> sortedStrings;         // String ids in lexicographic order
+
+        // Files, in the analyses' order, and their include edges (CSR)
+        Column<uint32_t> filePath;
+        Column<uint32_t> filesByPath;           // File positions sorted by path
+        Column<uint32_t> fileIncludeBegin;
+        Column<uint32_t> includeName;
+        Column<uint32_t> includerName;          // Edges sorted by include name id...
+        Column<uint32_t> includerFile;          // ...and the file of each
+
+        // Classes and their bases (CSR)
+        Column<uint32_t> className;
+        Column<uint32_t> classFullName;
+        Column<uint32_t> classFile;
+        Column<uint32_t> classFlags;
+        Column<uint32_t> classBaseBegin;
+        Column<uint32_t> baseName;
+        Column<uint32_t> baseAccess;
+        Column<uint32_t> derivedBase;           // Base edges sorted by base name id...
+        Column<uint32_t> derivedClass;          // ...and the deriving class of each
+        Column<uint32_t> classesByName;         // Class ids sorted by name
+        Column<uint32_t> classesByFullName;     // Class ids sorted by full name
+
+        // Methods (CSR per class)
+        Column<uint32_t> classMethodBegin;
+        Column<uint32_t> methodName;
+        Column<uint32_t> methodClass;
+        Column<uint32_t> methodFlags;
+        Column<uint32_t> methodsByName;         // Method ids sorted by name
+
+        MappedFile mapping;                     // Backing storage after load()
+        std::string errorMessage;
+
+        static const uint32_t ColumnCount = 25;
+
+        // Visit the columns in file order
+        template <typename Self, typename Fn>
+        static void forEachColumn(Self& self, Fn fn) {
+            fn(self.stringData);
+            fn(self.stringOffsets);
+            fn(self.sortedStrings);
+            fn(self.filePath);
+            fn(self.filesByPath);
+            fn(self.fileIncludeBegin);
+            fn(self.includeName);
+            fn(self.includerName);
+            fn(self.includerFile);
+            fn(self.className);
+            fn(self.classFullName);
+            fn(self.classFile);
+            fn(self.classFlags);
+            fn(self.classBaseBegin);
+            fn(self.baseName);
+            fn(self.baseAccess);
+            fn(self.derivedBase);
+            fn(self.derivedClass);
+            fn(self.classesByName);
+            fn(self.classesByFullName);
+            fn(self.classMethodBegin);
+            fn(self.methodName);
+            fn(self.methodClass);
+            fn(self.methodFlags);
+            fn(self.methodsByName);
+        }
+
+        void clear() {
+            forEachColumn(*this, [](auto& column) { column.reset(); });
+            mapping.close();
+        }
+
+        std::string_view stringAt(uint32_t id) const {
+            return std::string_view(stringData.data + stringOffsets[id], stringOffsets[id + 1] - stringOffsets[id]);
+        }
+
+        // Id of an interned string, or NoId
+        uint32_t lookup(std::string_view str) const {
+            auto it = std::lower_bound(sortedStrings.begin(), sortedStrings.end(), str,
+                                       [this](uint32_t id, std::string_view value) { return stringAt(id) < value; });
+            return it != sortedStrings.end() && stringAt(*it) == str ? *it : NoId;
+        }
+
+        // Range of 'order' (positions sorted by the string names[position]) whose string equals str
+        std::pair<const uint32_t*, const uint32_t*> equalNames(const Column<uint32_t>& order, const Column<uint32_t>& names,
+                                                               std::string_view str) const {
+            auto less = [this, &names](uint32_t position, std::string_view value) { return stringAt(names[position]) < value; };
+            auto greater = [this, &names](std::string_view value, uint32_t position) { return value < stringAt(names[position]); };
+            const uint32_t* first = std::lower_bound(order.begin(), order.end(), str, less);
+            return std::make_pair(first, std::upper_bound(first, order.end(), str, greater));
+        }
+
+        // Range of 'keys' (sorted ids) equal to id
+        static std::pair<const uint32_t*, const uint32_t*> equalIds(const Column<uint32_t>& keys, uint32_t id) {
+            return std::equal_range(keys.begin(), keys.end(), id);
+        }
+
+        SymbolClass makeClass(uint32_t id) const {
+            SymbolClass cls;
+            cls.id = id;
+            cls.name = stringAt(className[id]);
+            cls.fullName = stringAt(classFullName[id]);
+            cls.file = stringAt(filePath[classFile[id]]);
+            cls.isStruct = (classFlags[id] & ClassIsStruct) != 0;
+            cls.isTemplate = (classFlags[id] & ClassIsTemplate) != 0;
+            return cls;
+        }
+
+        SymbolMethod makeMethod(uint32_t id) const {
+            SymbolMethod method;
+            uint32_t flags = methodFlags[id];
+            method.classId = methodClass[id];
+            method.name = stringAt(methodName[id]);
+            method.className = stringAt(className[method.classId]);
+            method.file = stringAt(filePath[classFile[method.classId]]);
+            method.access = static_cast<AccessSpecifier>(flags & MethodAccessMask);
+            method.isStatic = (flags & MethodIsStatic) != 0;
+            method.isConst = (flags & MethodIsConst) != 0;
+            method.isVirtual = (flags & MethodIsVirtual) != 0;
+            return method;
+        }
+
+        void build(const SourceExplorerResult& result) {
+            clear();
+
+            // Intern every string once; keys are views into result, which outlives the build
+            std::string strings;
+            std::vector<uint32_t> offsets(1, 0);
+            std::unordered_map<std::string_view, uint32_t> ids;
+            auto intern = [&](std::string_view str) {
+                auto it = ids.find(str);
+                if (it != ids.end()) return it->second;
+                uint32_t id = static_cast<uint32_t>(offsets.size() - 1);
+                strings.append(str.data(), str.size());
+                offsets.push_back(static_cast<uint32_t>(strings.size()));
+                ids.emplace(str, id);
+                return id;
+            };
+
+            std::vector<uint32_t> paths, includeBegin(1, 0), includes;
+            std::vector<uint32_t> names, fullNames, files, flags, baseBegin(1, 0), bases, accesses;
+            std::vector<uint32_t> methodBegin(1, 0), methods, owners, methodBits;
+
+            for (const auto& analysis : result.analyses) {
+                uint32_t file = static_cast<uint32_t>(paths.size());
+                paths.push_back(intern(analysis.path));
+                if (!analysis.parseResult) {
+                    includeBegin.push_back(static_cast<uint32_t>(includes.size()));
+                    continue;
+                }
+
+                for (const auto& include : analysis.parseResult->includes) {
+                    includes.push_back(intern(include));
+                }
+                includeBegin.push_back(static_cast<uint32_t>(includes.size()));
+
+                for (const auto& cls : analysis.parseResult->classes) {
+                    uint32_t classId = static_cast<uint32_t>(names.size());
+                    names.push_back(intern(cls.name));
+                    fullNames.push_back(intern(cls.fullName.empty() ? cls.name : cls.fullName));
+                    files.push_back(file);
+                    flags.push_back((cls.isStruct ? ClassIsStruct : 0) | (cls.isTemplate ? ClassIsTemplate : 0));
+
+                    for (const auto& base : cls.baseClasses) {
+                        bases.push_back(intern(base.name));
+                        accesses.push_back(static_cast<uint32_t>(base.access));
+                    }
+                    baseBegin.push_back(static_cast<uint32_t>(bases.size()));
+
+                    for (const auto& method : cls.methods) {
+                        methods.push_back(intern(method.name));
+                        owners.push_back(classId);
+                        methodBits.push_back((static_cast<uint32_t>(method.access) & MethodAccessMask) |
+                                             (method.isStatic ? MethodIsStatic : 0) |
+                                             (method.isConst ? MethodIsConst : 0) |
+                                             (method.isVirtual ? MethodIsVirtual : 0) |
+                                             (method.isPureVirtual ? MethodIsPureVirtual : 0) |
+                                             (method.isConstructor ? MethodIsConstructor : 0) |
+                                             (method.isDestructor ? MethodIsDestructor : 0));
+                    }
+                    methodBegin.push_back(static_cast<uint32_t>(methods.size()));
+                }
+            }
+
+            stringData.assign(std::vector<char>(strings.begin(), strings.end()));
+            stringOffsets.assign(std::move(offsets));
+            size_t stringCount = stringOffsets.size() - 1;
+
+            std::vector<uint32_t> sorted(stringCount);
+            for (size_t i = 0; i < stringCount; ++i) sorted[i] = static_cast<uint32_t>(i);
+            std::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b) { return stringAt(a) < stringAt(b); });
+            sortedStrings.assign(std::move(sorted));
+
+            // Positions 0..n-1 ordered by the string each one names (ties by position)
+            auto orderByName = [this](const std::vector<uint32_t>& keys) {
+                std::vector<uint32_t> order(keys.size());
+                for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+                std::stable_sort(order.begin(), order.end(), [this, &keys](uint32_t a, uint32_t b) {
+                    return stringAt(keys[a]) < stringAt(keys[b]);
+                });
+                return order;
+            };
+
+            // Edge lists sorted by target id, for equal_range lookups
+            auto sortEdges = [](std::vector<uint32_t>& keys, std::vector<uint32_t>& values) {
+                std::vector<uint32_t> order(keys.size());
+                for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+                std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+                std::vector<uint32_t> sortedKeys(keys.size()), sortedValues(keys.size());
+                for (size_t i = 0; i < order.size(); ++i) {
+                    sortedKeys[i] = keys[order[i]];
+                    sortedValues[i] = values[order[i]];
+                }
+                keys.swap(sortedKeys);
+                values.swap(sortedValues);
+            };
+
+            std::vector<uint32_t> edgeNames(includes), edgeFiles;
+            for (size_t file = 0; file + 1 < includeBegin.size(); ++file) {
+                edgeFiles.insert(edgeFiles.end(), includeBegin[file + 1] - includeBegin[file], static_cast<uint32_t>(file));
+            }
+            sortEdges(edgeNames, edgeFiles);
+
+            std::vector<uint32_t> derivedNames(bases), derivedClasses;
+            for (size_t cls = 0; cls + 1 < baseBegin.size(); ++cls) {
+                derivedClasses.insert(derivedClasses.end(), baseBegin[cls + 1] - baseBegin[cls], static_cast<uint32_t>(cls));
+            }
+            sortEdges(derivedNames, derivedClasses);
+
+            filesByPath.assign(orderByName(paths));
+            classesByName.assign(orderByName(names));
+            classesByFullName.assign(orderByName(fullNames));
+            methodsByName.assign(orderByName(methods));
+
+            filePath.assign(std::move(paths));
+            fileIncludeBegin.assign(std::move(includeBegin));
+            includeName.assign(std::move(includes));
+            includerName.assign(std::move(edgeNames));
+            includerFile.assign(std::move(edgeFiles));
+            className.assign(std::move(names));
+            classFullName.assign(std::move(fullNames));
+            classFile.assign(std::move(files));
+            classFlags.assign(std::move(flags));
+            classBaseBegin.assign(std::move(baseBegin));
+            baseName.assign(std::move(bases));
+            baseAccess.assign(std::move(accesses));
+            derivedBase.assign(std::move(derivedNames));
+            derivedClass.assign(std::move(derivedClasses));
+            classMethodBegin.assign(std::move(methodBegin));
+            methodName.assign(std::move(methods));
+            methodClass.assign(std::move(owners));
+            methodFlags.assign(std::move(methodBits));
+        }
+
+        bool save(const std::string& path) {
+            std::vector<ColumnEntry> table;
+            size_t offset = alignTo8(sizeof(FileHeader) + ColumnCount * sizeof(ColumnEntry));
+            forEachColumn(*this, [&](const auto& column) {
+                ColumnEntry entry;
+                entry.offset = offset;
+                entry.count = column.size();
+                table.push_back(entry);
+                offset = alignTo8(offset + column.size() * sizeof(column[0]));
+            });
+
+            FileHeader header;
+            std::memcpy(header.magic, IndexMagic, sizeof(header.magic));
+            header.version = IndexVersion;
+            header.byteOrder = ByteOrderMark;
+            header.columnCount = ColumnCount;
+            header.reserved = 0;
+
+            // Written to a temporary file first so readers never map a half-written index
+            std::string tempPath = path + ".tmp";
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                if (!out) {
+                    errorMessage = "Could not write symbol index: " + tempPath;
+                    return false;
+                }
+
+                size_t written = 0;
+                auto write = [&](const void* data, size_t size) {
+                    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                    written += size;
+                };
+                auto pad = [&]() {
+                    static const char zeros[8] = {};
+                    write(zeros, alignTo8(written) - written);
+                };
+
+                write(&header, sizeof(header));
+                write(table.data(), table.size() * sizeof(ColumnEntry));
+                pad();
+                forEachColumn(*this, [&](const auto& column) {
+                    write(column.data, column.size() * sizeof(column[0]));
+                    pad();
+                });
+
+                if (!out.flush()) {
+                    errorMessage = "Could not write symbol index: " + tempPath;
+                    return false;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tempPath, path, ec);
+            if (ec) {
+                std::filesystem::remove(tempPath, ec);
+                errorMessage = "Could not write symbol index: " + path;
+                return false;
+            }
+            return true;
+        }
+
+        bool load(const std::string& path) {
+            clear();
+            if (!mapping.open(path)) {
+                errorMessage = mapping.getErrorMessage();
+                return false;
+            }
+
+            const char* base = mapping.data();
+            size_t size = mapping.size();
+            FileHeader header;
+            if (size < sizeof(header)) {
+                return fail("Not a symbol index: " + path);
+            }
+            std::memcpy(&header, base, sizeof(header));
+            if (std::memcmp(header.magic, IndexMagic, sizeof(header.magic)) != 0) {
+                return fail("Not a symbol index: " + path);
+            }
+            if (header.version != IndexVersion || header.byteOrder != ByteOrderMark || header.columnCount != ColumnCount ||
+                size < sizeof(header) + ColumnCount * sizeof(ColumnEntry)) {
+                return fail("Unsupported symbol index version: " + path);
+            }
+
+            std::vector<ColumnEntry> table(ColumnCount);
+            std::memcpy(table.data(), base + sizeof(header), ColumnCount * sizeof(ColumnEntry));
+
+            // Columns are used in place when the mapping is suitably aligned, copied otherwise
+            bool bAligned = reinterpret_cast<uintptr_t>(base) % 8 == 0;
+            size_t index = 0;
+            bool bInBounds = true;
+            forEachColumn(*this, [&](auto& column) {
+                using T = typename std::remove_reference<decltype(column[0])>::type;
+                using Value = typename std::remove_const<T>::type;
+                const ColumnEntry& entry = table[index++];
+                if (entry.offset > size || entry.count > (size - entry.offset) / sizeof(Value)) {
+                    bInBounds = false;
+                    return;
+                }
+                const char* data = base + entry.offset;
+                size_t count = static_cast<size_t>(entry.count);
+                if (bAligned && entry.offset % alignof(Value) == 0) {
+                    column.view(reinterpret_cast<const Value*>(data), count);
+                } else {
+                    std::vector<Value> copy(count);
+                    std::memcpy(copy.data(), data, count * sizeof(Value));
+                    column.assign(std::move(copy));
+                }
+            });
+
+            if (!bInBounds || !validate()) {
+                return fail("Corrupt symbol index: " + path);
+            }
+            return true;
+        }
+
+    private:
+        bool fail(const std::string& message) {
+            clear();
+            errorMessage = message;
+            return false;
+        }
+
+        // Check every id and offset once, so queries can index without bounds checks
+        bool validate() const {
+            if (stringOffsets.size() == 0) return false;
+            size_t strings = stringOffsets.size() - 1;
+            size_t files = filePath.size();
+            size_t classes = className.size();
+            size_t includes = includeName.size();
+            size_t bases = baseName.size();
+            size_t methods = methodName.size();
+
+            if (!validOffsets(stringOffsets, strings, stringData.size())) return false;
+            if (sortedStrings.size() != strings || !idsBelow(sortedStrings, strings)) return false;
+
+            if (filesByPath.size() != files || !idsBelow(filesByPath, files) || !idsBelow(filePath, strings)) return false;
+            if (!validOffsets(fileIncludeBegin, files, includes) || !idsBelow(includeName, strings)) return false;
+            if (includerName.size() != includes || includerFile.size() != includes ||
+                !idsBelow(includerName, strings) || !idsBelow(includerFile, files)) return false;
+
+            if (classFullName.size() != classes || classFile.size() != classes || classFlags.size() != classes ||
+                classesByName.size() != classes || classesByFullName.size() != classes) return false;
+            if (!idsBelow(className, strings) || !idsBelow(classFullName, strings) || !idsBelow(classFile, files) ||
+                !idsBelow(classesByName, classes) || !idsBelow(classesByFullName, classes)) return false;
+
+            if (!validOffsets(classBaseBegin, classes, bases) || baseAccess.size() != bases ||
+                !idsBelow(baseName, strings)) return false;
+            if (derivedBase.size() != bases || derivedClass.size() != bases ||
+                !idsBelow(derivedBase, strings) || !idsBelow(derivedClass, classes)) return false;
+
+            if (!validOffsets(classMethodBegin, classes, methods) || methodClass.size() != methods ||
+                methodFlags.size() != methods || methodsByName.size() != methods) return false;
+            return idsBelow(methodName, strings) && idsBelow(methodClass, classes) && idsBelow(methodsByName, methods);
+        }
+    };
+
+    // SymbolIndex implementation
+    SymbolIndex::SymbolIndex() : pImpl(new Impl()) {}
+
+    SymbolIndex::~SymbolIndex() = default;
+
+    SymbolIndex::SymbolIndex(SymbolIndex&& other) noexcept = default;
+
+    SymbolIndex& SymbolIndex::operator=(SymbolIndex&& other) noexcept = default;
+
+    void SymbolIndex::build(const SourceExplorerResult& result) {
+        pImpl->build(result);
+    }
+
+    void SymbolIndex::clear() {
+        pImpl->clear();
+    }
+
+    bool SymbolIndex::save(const std::string& filePath) const {
+        return pImpl->save(filePath);
+    }
+
+    bool SymbolIndex::load(const std::string& filePath) {
+        return pImpl->load(filePath);
+    }
+
+    const std::string& SymbolIndex::getErrorMessage() const {
+        return pImpl->errorMessage;
+    }
+
+    size_t SymbolIndex::fileCount() const {
+        return pImpl->filePath.size();
+    }
+
+    size_t SymbolIndex::classCount() const {
+        return pImpl->className.size();
+    }
+
+    size_t SymbolIndex::methodCount() const {
+        return pImpl->methodName.size();
+    }
+
+    std::string_view SymbolIndex::filePath(uint32_t file) const {
+        return pImpl->stringAt(pImpl->filePath[file]);
+    }
+
+    SymbolClass SymbolIndex::classAt(uint32_t id) const {
+        return pImpl->makeClass(id);
+    }
+
+    std::vector<SymbolClass> SymbolIndex::findClasses(std::string_view name) const {
+        std::vector<uint32_t> ids;
+        auto byName = pImpl->equalNames(pImpl->classesByName, pImpl->className, name);
+        auto byFullName = pImpl->equalNames(pImpl->classesByFullName, pImpl->classFullName, name);
+        ids.insert(ids.end(), byName.first, byName.second);
+        ids.insert(ids.end(), byFullName.first, byFullName.second);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        std::vector<SymbolClass> classes;
+        classes.reserve(ids.size());
+        for (uint32_t id : ids) {
+            classes.push_back(pImpl->makeClass(id));
+        }
+        return classes;
+    }
+
+    std::vector<std::string_view> SymbolIndex::baseClasses(uint32_t id) const {
+        std::vector<std::string_view> bases;
+        for (uint32_t i = pImpl->classBaseBegin[id]; i < pImpl->classBaseBegin[id + 1]; ++i) {
+            bases.push_back(pImpl->stringAt(pImpl->baseName[i]));
+        }
+        return bases;
+    }
+
+    std::vector<SymbolClass> SymbolIndex::derivedClasses(std::string_view baseName, bool bTransitive) const {
+        std::vector<SymbolClass> derived;
+        std::vector<bool> seen(classCount(), false);
+        std::vector<std::string_view> pending(1, baseName);
+
+        while (!pending.empty()) {
+            std::string_view name = pending.back();
+            pending.pop_back();
+            uint32_t id = pImpl->lookup(name);
+            if (id == NoId) continue;
+
+            auto range = Impl::equalIds(pImpl->derivedBase, id);
+            for (const uint32_t* edge = range.first; edge != range.second; ++edge) {
+                uint32_t cls = pImpl->derivedClass[edge - pImpl->derivedBase.begin()];
+                if (seen[cls]) continue;
+                seen[cls] = true;
+                derived.push_back(pImpl->makeClass(cls));
+                if (bTransitive) {
+                    pending.push_back(derived.back().name);
+                    if (derived.back().fullName != derived.back().name) {
+                        pending.push_back(derived.back().fullName);
+                    }
+                }
+            }
+        }
+
+        std::sort(derived.begin(), derived.end(), [](const SymbolClass& a, const SymbolClass& b) { return a.id < b.id; });
+        return derived;
+    }
+
+    std::vector<SymbolMethod> SymbolIndex::findMethods(std::string_view name) const {
+        std::vector<SymbolMethod> methods;
+        auto range = pImpl->equalNames(pImpl->methodsByName, pImpl->methodName, name);
+        for (const uint32_t* it = range.first; it != range.second; ++it) {
+            methods.push_back(pImpl->makeMethod(*it));
+        }
+        return methods;
+    }
+
+    std::vector<std::string_view> SymbolIndex::filesDeclaringMethod(std::string_view name) const {
+        std::vector<uint32_t> fileIds;
+        auto range = pImpl->equalNames(pImpl->methodsByName, pImpl->methodName, name);
+        for (const uint32_t* it = range.first; it != range.second; ++it) {
+            fileIds.push_back(pImpl->classFile[pImpl->methodClass[*it]]);
+        }
+        std::sort(fileIds.begin(), fileIds.end());
+        fileIds.erase(std::unique(fileIds.begin(), fileIds.end()), fileIds.end());
+
+        std::vector<std::string_view> files;
+        for (uint32_t file : fileIds) {
+            files.push_back(filePath(file));
+        }
+        return files;
+    }
+
+    std::vector<std::string_view> SymbolIndex::includesOf(std::string_view path) const {
+        std::vector<std::string_view> includes;
+        auto range = pImpl->equalNames(pImpl->filesByPath, pImpl->filePath, path);
+        for (const uint32_t* it = range.first; it != range.second; ++it) {
+            for (uint32_t i = pImpl->fileIncludeBegin[*it]; i < pImpl->fileIncludeBegin[*it + 1]; ++i) {
+                includes.push_back(pImpl->stringAt(pImpl->includeName[i]));
+            }
+        }
+        return includes;
+    }
+
+    std::vector<std::string_view> SymbolIndex::filesIncluding(std::string_view includeName) const {
+        std::vector<std::string_view> files;
+        uint32_t id = pImpl->lookup(includeName);
+        if (id == NoId) return files;
+
+        auto range = Impl::equalIds(pImpl->includerName, id);
+        uint32_t last = NoId;
+        for (const uint32_t* edge = range.first; edge != range.second; ++edge) {
+            uint32_t file = pImpl->includerFile[edge - pImpl->includerName.begin()];
+            if (file != last) {
+                files.push_back(filePath(file));
+                last = file;
+            }
+        }
+        return files;
+    }
+
+    std::vector<SymbolClass> SymbolIndex::classesWithPrefix(std::string_view prefix, size_t limit) const {
+        std::vector<SymbolClass> classes;
+        const Impl& impl = *pImpl;
+        const uint32_t* it = std::lower_bound(impl.classesByName.begin(), impl.classesByName.end(), prefix,
+            [&impl](uint32_t id, std::string_view value) { return impl.stringAt(impl.className[id]) < value; });
+        for (; it != impl.classesByName.end() && (limit == 0 || classes.size() < limit); ++it) {
+            if (impl.stringAt(impl.className[*it]).compare(0, prefix.size(), prefix) != 0) break;
+            classes.push_back(impl.makeClass(*it));
+        }
+        return classes;
+    }
+
+    std::vector<SymbolMethod> SymbolIndex::methodsWithPrefix(std::string_view prefix, size_t limit) const {
+        std::vector<SymbolMethod> methods;
+        const Impl& impl = *pImpl;
+        const uint32_t* it = std::lower_bound(impl.methodsByName.begin(), impl.methodsByName.end(), prefix,
+            [&impl](uint32_t id, std::string_view value) { return impl.stringAt(impl.methodName[id]) < value; });
+        for (; it != impl.methodsByName.end() && (limit == 0 || methods.size() < limit); ++it) {
+            if (impl.stringAt(impl.methodName[*it]).compare(0, prefix.size(), prefix) != 0) break;
+            methods.push_back(impl.makeMethod(*it));
+        }
+        return methods;
+    }
+
+} // namespace UFMTooling
@@ -0,0 +1,35 @@
+#ifndef WORKER_THREADS_H
+#define WORKER_THREADS_H
+
+// Internal helper: number of worker threads for a parsing run, shared by the
+// explorers that parse files on a pool.
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace UFMTooling {
+
+    // requested, else UFM_TOOLING_THREADS, else hardware concurrency; never more than workItems
+    inline unsigned int resolveThreadCount(unsigned int requested, size_t workItems) {
+        unsigned int count = requested;
+        if (count == 0) {
+            if (const char* env = std::getenv("UFM_TOOLING_THREADS")) {
+                count = static_cast<unsigned int>(std::strtoul(env, nullptr, 10));
+            }
+        }
+        if (count == 0) {
+            count = std::thread::hardware_concurrency();
+        }
+        if (count == 0) {
+            count = 1;
+        }
+        if (workItems < count) {
+            count = static_cast<unsigned int>(std::max<size_t>(workItems, 1));
+        }
+        return count;
+    }
+
+} // namespace UFMTooling
+
+#endif // WORKER_THREADS_H
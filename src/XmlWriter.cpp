@@ -0,0 +1,238 @@
+#include "../include/XmlWriter.h"
+#include <charconv>
+#include <vector>
+
+namespace UFMTooling {
+
+    namespace {
+        // Flush to the stream once this much output is buffered
+        const size_t FlushThreshold = 64 * 1024;
+
+        // Replacement for each byte: nullptr = copy as is, "" = drop (not representable
+        // in XML 1.0), otherwise an entity. Attributes also keep tabs and line breaks,
+        // which attribute-value normalization would otherwise turn into spaces.
+        struct EscapeTable {
+            const char* text[256];
+            const char* attribute[256];
+
+            EscapeTable() {
+                for (int c = 0; c < 256; ++c) {
+                    text[c] = c < 0x20 && c != '\t' && c != '\n' && c != '\r' ? "" : nullptr;
+                    attribute[c] = text[c];
+                }
+                text[static_cast<unsigned char>('&')] = attribute[static_cast<unsigned char>('&')] = "&amp;";
+                text[static_cast<unsigned char>('<')] = attribute[static_cast<unsigned char>('<')] = "&lt;";
+                text[static_cast<unsigned char>('>')] = attribute[static_cast<unsigned char>('>')] = "&gt;";
+                attribute[static_cast<unsigned char>('"')] = "&quot;";
+                attribute[static_cast<unsigned char>('\'')] = "&apos;";
+                attribute[static_cast<unsigned char>('\t')] = "&#9;";
+                attribute[static_cast<unsigned char>('\n')] = "&#10;";
+                attribute[static_cast<unsigned char>('\r')] = "&#13;";
+            }
+        };
+
+        const EscapeTable escapeTable;
+    }
+
+    class XmlWriter::Impl {
+    public:
+        // One entry per open element
+        struct Element {
+            size_t nameOffset;      // Start of the name in names
+            bool hasChildren;
+            bool hasText;
+        };
+
+        std::ostream* stream;
+        std::string ownBuffer;
+        std::string& buffer;        // Stream mode: ownBuffer; string mode: the caller's string
+        bool pretty;
+        bool failed;
+        bool startTagOpen;          // The innermost start tag still takes attributes
+
+        std::vector<Element> elements;
+        std::string names;          // Names of the open elements, back to back
+
+        Impl(std::ostream* out, std::string* target, bool bPretty)
+            : stream(out), buffer(target ? *target : ownBuffer), pretty(bPretty), failed(false), startTagOpen(false) {
+            if (stream) {
+                ownBuffer.reserve(FlushThreshold + 4096);
+            }
+        }
+
+        void newlineAndIndent(size_t depth) {
+            buffer.push_back('\n');
+            buffer.append(depth * 2, ' ');
+        }
+
+        void closeStartTag() {
+            if (startTagOpen) {
+                buffer.push_back('>');
+                startTagOpen = false;
+            }
+        }
+
+        void escape(std::string_view str, const char* const* table) {
+            size_t runStart = 0;
+            for (size_t i = 0; i < str.size(); ++i) {
+                const char* replacement = table[static_cast<unsigned char>(str[i])];
+                if (replacement == nullptr) continue;
+
+                buffer.append(str.data() + runStart, i - runStart);
+                buffer.append(replacement);
+                runStart = i + 1;
+            }
+            buffer.append(str.data() + runStart, str.size() - runStart);
+        }
+
+        void begin(std::string_view name) {
+            closeStartTag();
+            if (!elements.empty()) {
+                elements.back().hasChildren = true;
+                if (pretty) {
+                    newlineAndIndent(elements.size());
+                }
+            }
+            buffer.push_back('<');
+            buffer.append(name);
+            elements.push_back(Element{ names.size(), false, false });
+            names.append(name);
+            startTagOpen = true;
+        }
+
+        void end() {
+            if (elements.empty()) return;
+            Element element = elements.back();
+            elements.pop_back();
+
+            if (startTagOpen) {
+                buffer.append(pretty ? " />" : "/>");
+                startTagOpen = false;
+            } else {
+                if (pretty && element.hasChildren && !element.hasText) {
+                    newlineAndIndent(elements.size());
+                }
+                buffer.append("</");
+                buffer.append(names, element.nameOffset, std::string::npos);
+                buffer.push_back('>');
+            }
+            names.resize(element.nameOffset);
+
+            if (pretty && elements.empty()) {
+                buffer.push_back('\n');
+            }
+            maybeFlush();
+        }
+
+        void attribute(std::string_view name, std::string_view value) {
+            if (!startTagOpen) return;
+            buffer.push_back(' ');
+            buffer.append(name);
+            buffer.append("=\"");
+            escape(value, escapeTable.attribute);
+            buffer.push_back('"');
+        }
+
+        template <typename T>
+        void numberAttribute(std::string_view name, T number) {
+            char digits[32];
+            auto res = std::to_chars(digits, digits + sizeof(digits), number);
+            attribute(name, std::string_view(digits, static_cast<size_t>(res.ptr - digits)));
+        }
+
+        void text(std::string_view str) {
+            if (elements.empty()) return;
+            closeStartTag();
+            elements.back().hasText = true;
+            escape(str, escapeTable.text);
+        }
+
+        void maybeFlush() {
+            if (stream && buffer.size() >= FlushThreshold) {
+                flush();
+            }
+        }
+
+        void flush() {
+            if (!stream || buffer.empty()) return;
+            stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            if (!*stream) {
+                failed = true;
+            }
+            buffer.clear();
+        }
+    };
+
+    // XmlWriter implementation
+    XmlWriter::XmlWriter(std::ostream& out, bool bPretty) : pImpl(new Impl(&out, nullptr, bPretty)) {}
+
+    XmlWriter::XmlWriter(std::string& out, bool bPretty) : pImpl(new Impl(nullptr, &out, bPretty)) {}
+
+    XmlWriter::~XmlWriter() {
+        while (!pImpl->elements.empty()) {
+            pImpl->end();
+        }
+        pImpl->flush();
+    }
+
+    void XmlWriter::declaration() {
+        pImpl->buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+        if (pImpl->pretty) {
+            pImpl->buffer.push_back('\n');
+        }
+    }
+
+    void XmlWriter::beginElement(std::string_view name) {
+        pImpl->begin(name);
+    }
+
+    void XmlWriter::endElement() {
+        pImpl->end();
+    }
+
+    void XmlWriter::attribute(std::string_view name, std::string_view value) {
+        pImpl->attribute(name, value);
+    }
+
+    void XmlWriter::attribute(std::string_view name, const char* value) {
+        pImpl->attribute(name, std::string_view(value));
+    }
+
+    void XmlWriter::attribute(std::string_view name, const std::string& value) {
+        pImpl->attribute(name, std::string_view(value));
+    }
+
+    void XmlWriter::attribute(std::string_view name, bool value) {
+        pImpl->attribute(name, value ? std::string_view("true") : std::string_view("false"));
+    }
+
+    void XmlWriter::attributeSigned(std::string_view name, long long number) {
+        pImpl->numberAttribute(name, number);
+    }
+
+    void XmlWriter::attributeUnsigned(std::string_view name, unsigned long long number) {
+        pImpl->numberAttribute(name, number);
+    }
+
+    void XmlWriter::text(std::string_view str) {
+        pImpl->text(str);
+    }
+
+    void XmlWriter::textElement(std::string_view name, std::string_view str) {
+        pImpl->begin(name);
+        pImpl->text(str);
+        pImpl->end();
+    }
+
+    void XmlWriter::flush() {
+        pImpl->flush();
+        if (pImpl->stream) {
+            pImpl->stream->flush();
+        }
+    }
+
+    bool XmlWriter::good() const {
+        return !pImpl->failed && (!pImpl->stream || static_cast<bool>(*pImpl->stream));
+    }
+
+} // namespace UFMTooling